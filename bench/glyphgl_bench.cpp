@@ -0,0 +1,341 @@
+// Benchmark harness for the atlas bake and text render paths
+//
+// Usage: glyphgl_bench [--bake] [--render] [--size px] [--iterations n] [--seconds s] font.ttf
+//
+// Every result is printed as one JSON object per line on stdout, so runs can
+// be diffed or collected by scripts; progress and errors go to stderr.
+//
+//   {"suite":"bake","charset":"latin1","glyphs":190,"mode":"sdf","phase":"rasterize","iterations":5,"min_ms":1.92,"median_ms":1.97}
+//   {"suite":"render","path":"vertex","effects":"bold","length":64,"draws":41210,"seconds":0.50,"draws_per_sec":82420.0,"glyphs_per_sec":5274880.0}
+//
+// The bake suite is headless. It times each phase of glyph_atlas_create_ex
+// on its own through the public building blocks (font load, rasterize, SDF,
+// pack), then the complete call, for several charset sizes. The render suite
+// opens a hidden GLFW window and measures glyph_renderer_draw_text calls
+// per second for several string lengths, effect flags and both render paths.
+#include <GLFW/glfw3.h>
+#include <glyph.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ms(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+struct bench_charset
+{
+    const char* name;
+    int first, last; // Inclusive codepoint range
+};
+
+static const bench_charset charsets[] = {
+    {"ascii", 32, 126},
+    {"latin1", 32, 255},
+    {"european", 32, 0x52F}, // Latin, Greek and Cyrillic blocks
+};
+
+// Builds the UTF-8 charset string of a codepoint range, keeping only glyphs the font has
+static std::string build_charset(const glyph_font_t* font, const bench_charset& charset, int* count)
+{
+    std::string text;
+    *count = 0;
+    for (int cp = charset.first; cp <= charset.last; cp++) {
+        if (cp >= 0x7F && cp < 0xA0) continue; // C1 controls
+        if (cp > ' ' && glyph_ttf_find_glyph_index(font, cp) == 0) continue;
+        if (cp < 0x80) {
+            text += (char)cp;
+        } else if (cp < 0x800) {
+            text += (char)(0xC0 | (cp >> 6));
+            text += (char)(0x80 | (cp & 0x3F));
+        } else {
+            text += (char)(0xE0 | (cp >> 12));
+            text += (char)(0x80 | ((cp >> 6) & 0x3F));
+            text += (char)(0x80 | (cp & 0x3F));
+        }
+        (*count)++;
+    }
+    return text;
+}
+
+static void print_timing(const char* charset, int glyphs, const char* mode, const char* phase, std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    printf("{\"suite\":\"bake\",\"charset\":\"%s\",\"glyphs\":%d,\"mode\":\"%s\",\"phase\":\"%s\",\"iterations\":%d,"
+           "\"min_ms\":%.4f,\"median_ms\":%.4f}\n",
+           charset, glyphs, mode, phase, (int)samples.size(), samples.front(), samples[samples.size() / 2]);
+    fflush(stdout);
+}
+
+struct bench_bitmap
+{
+    unsigned char* data;
+    int width, height;
+};
+
+// Times each bake phase separately, then glyph_atlas_create_ex as a whole
+static int run_bake(const char* font_path, float pixel_height, int iterations)
+{
+    glyph_font_t font;
+    if (!glyph_ttf_load_font_from_file(&font, font_path)) {
+        fprintf(stderr, "glyphgl_bench: cannot load %s\n", font_path);
+        return 0;
+    }
+    float scale = glyph_ttf_scale_for_pixel_height(&font, pixel_height);
+    const int spread = glyph_atlas_default_config().sdf_spread;
+
+    for (const bench_charset& charset : charsets) {
+        int count;
+        std::string text = build_charset(&font, charset, &count);
+        std::vector<int> indices;
+        for (size_t i = 0; i < text.size();) indices.push_back(glyph_ttf_find_glyph_index(&font, glyph_utf8_decode(text.c_str(), &i)));
+
+        std::vector<double> load, rasterize, sdf, pack, total_coverage, total_sdf;
+        for (int it = 0; it < iterations; it++) {
+            // Font load: map or read the file and parse its tables
+            bench_clock::time_point start = bench_clock::now();
+            glyph_font_t loaded;
+            if (glyph_ttf_load_font_from_file(&loaded, font_path)) glyph_ttf_free_font(&loaded);
+            load.push_back(elapsed_ms(start));
+
+            // Rasterize: coverage bitmaps of every glyph, with a reused scratch buffer
+            glyph_raster_scratch_t raster_scratch;
+            memset(&raster_scratch, 0, sizeof(raster_scratch));
+            std::vector<bench_bitmap> bitmaps(indices.size());
+            start = bench_clock::now();
+            for (size_t g = 0; g < indices.size(); g++) {
+                int xoff, yoff;
+                bitmaps[g].data = glyph_ttf_get_glyph_bitmap_ex(&font, indices[g], scale, scale, &bitmaps[g].width, &bitmaps[g].height,
+                                                                &xoff, &yoff, &raster_scratch);
+            }
+            rasterize.push_back(elapsed_ms(start));
+            glyph_raster_scratch_free(&raster_scratch);
+
+            // SDF: distance transform of every coverage bitmap
+            glyph_sdf_scratch_t sdf_scratch;
+            memset(&sdf_scratch, 0, sizeof(sdf_scratch));
+            start = bench_clock::now();
+            for (bench_bitmap& bitmap : bitmaps) {
+                if (!bitmap.data) continue;
+                unsigned char* field = glyph_ttf_get_glyph_sdf_bitmap_ex(bitmap.data, bitmap.width, bitmap.height, spread, spread, &sdf_scratch);
+                glyph_ttf_free_bitmap(field);
+            }
+            sdf.push_back(elapsed_ms(start));
+            glyph_sdf_scratch_free(&sdf_scratch);
+
+            // Pack: skyline placement of the padded rectangles into the smallest square power of two
+            const int padding = glyph_atlas_default_config().padding;
+            std::vector<glyph_atlas_rect_t> rects(bitmaps.size());
+            for (size_t g = 0; g < bitmaps.size(); g++) {
+                rects[g].w = bitmaps[g].data ? bitmaps[g].width + padding : 0;
+                rects[g].h = bitmaps[g].data ? bitmaps[g].height + padding : 0;
+                glyph_ttf_free_bitmap(bitmaps[g].data);
+            }
+            start = bench_clock::now();
+            for (int size = 64; size <= GLYPHGL_ATLAS_MAX_SIZE; size *= 2) {
+                if (glyph_atlas_pack_rects(GLYPH_ATLAS_PACKER_SKYLINE, rects.data(), (int)rects.size(), size - padding, size - padding)) break;
+            }
+            pack.push_back(elapsed_ms(start));
+
+            // Complete bakes, the figure applications actually pay
+            start = bench_clock::now();
+            glyph_atlas_t atlas = glyph_atlas_create_ex(font_path, pixel_height, text.c_str(), GLYPH_ENCODING_UTF8, GLYPH_ATLAS_COVERAGE, NULL);
+            total_coverage.push_back(elapsed_ms(start));
+            glyph_atlas_free(&atlas);
+
+            start = bench_clock::now();
+            atlas = glyph_atlas_create_ex(font_path, pixel_height, text.c_str(), GLYPH_ENCODING_UTF8, GLYPH_ATLAS_SDF, NULL);
+            total_sdf.push_back(elapsed_ms(start));
+            glyph_atlas_free(&atlas);
+        }
+
+        print_timing(charset.name, count, "coverage", "load", load);
+        print_timing(charset.name, count, "coverage", "rasterize", rasterize);
+        print_timing(charset.name, count, "sdf", "sdf", sdf);
+        print_timing(charset.name, count, "coverage", "pack", pack);
+        print_timing(charset.name, count, "coverage", "total", total_coverage);
+        print_timing(charset.name, count, "sdf", "total", total_sdf);
+    }
+
+    glyph_ttf_free_font(&font);
+    return 1;
+}
+
+struct bench_effects
+{
+    const char* name;
+    int flags;
+    int sdf; // Drawn by the SDF renderer
+};
+
+static const bench_effects effect_sets[] = {
+    {"none", 0, 0},
+    {"bold", GLYPHGL_BOLD, 0},
+    {"italic", GLYPHGL_ITALIC, 0},
+    {"underline", GLYPHGL_UNDERLINE, 0},
+    {"bold_italic_underline", GLYPHGL_BOLD | GLYPHGL_ITALIC | GLYPHGL_UNDERLINE, 0},
+    {"sdf", GLYPHGL_SDF, 1},
+    {"sdf_bold", GLYPHGL_SDF | GLYPHGL_BOLD, 1},
+};
+
+static const int string_lengths[] = {8, 64, 512, 4096};
+
+// Measures draw_text calls per second; the GPU is drained before the clock stops
+static void run_render_case(glyph_renderer_t* renderer, const char* path, const bench_effects& effects, const std::string& text, double seconds)
+{
+    for (int i = 0; i < 16; i++) {
+        glyph_renderer_draw_text(renderer, text.c_str(), 0.0f, 40.0f, 1.0f, 1.0f, 1.0f, 1.0f, effects.flags); // Warm-up
+    }
+    glFinish();
+
+    long draws = 0;
+    double elapsed = 0.0;
+    bench_clock::time_point start = bench_clock::now();
+    while (elapsed < seconds * 1000.0) {
+        for (int i = 0; i < 16; i++) {
+            glyph_renderer_draw_text(renderer, text.c_str(), 0.0f, 40.0f, 1.0f, 1.0f, 1.0f, 1.0f, effects.flags);
+        }
+        draws += 16;
+        elapsed = elapsed_ms(start);
+    }
+    glFinish();
+    elapsed = elapsed_ms(start) / 1000.0;
+
+    printf("{\"suite\":\"render\",\"path\":\"%s\",\"effects\":\"%s\",\"length\":%d,\"draws\":%ld,\"seconds\":%.3f,"
+           "\"draws_per_sec\":%.1f,\"glyphs_per_sec\":%.1f}\n",
+           path, effects.name, (int)text.size(), draws, elapsed, draws / elapsed, (double)draws * text.size() / elapsed);
+    fflush(stdout);
+}
+
+// Measures full 200x60 terminal redraws per second: one draw_text per line, or one grid draw with one changed row
+static void run_terminal_case(glyph_renderer_t* renderer, const char* path, double seconds)
+{
+    const int columns = 200, rows = 60;
+    float line_height = renderer->atlas.pixel_height;
+    std::vector<std::string> lines(rows);
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) lines[row] += (char)('!' + (row + column) % 90);
+    }
+
+    int use_grid = strcmp(path, "grid") == 0;
+    glyph_grid_t grid = {0};
+    if (use_grid) {
+        grid = glyph_grid_create(renderer, columns, rows);
+        if (!grid.vao) return;
+        for (int row = 0; row < rows; row++) glyph_grid_set_text(renderer, &grid, row, 0, lines[row].c_str(), 1.0f, 1.0f, 1.0f, 0);
+    }
+
+    long frames = 0;
+    double elapsed = 0.0;
+    bench_clock::time_point start = bench_clock::now();
+    while (elapsed < seconds * 1000.0) {
+        if (use_grid) {
+            int row = (int)(frames % rows); // A scrolling log rewrites one line per frame
+            glyph_grid_set_text(renderer, &grid, row, 0, lines[(row + frames) % rows].c_str(), 1.0f, 1.0f, 1.0f, 0);
+            glyph_grid_draw(renderer, &grid, 0.0f, line_height, 1.0f);
+        } else {
+            for (int row = 0; row < rows; row++) {
+                glyph_renderer_draw_text(renderer, lines[row].c_str(), 0.0f, line_height * (row + 1), 1.0f, 1.0f, 1.0f, 1.0f, 0);
+            }
+        }
+        frames++;
+        elapsed = elapsed_ms(start);
+    }
+    glFinish();
+    elapsed = elapsed_ms(start) / 1000.0;
+    glyph_grid_free(&grid);
+
+    printf("{\"suite\":\"terminal\",\"path\":\"%s\",\"columns\":%d,\"rows\":%d,\"frames\":%ld,\"seconds\":%.3f,\"frames_per_sec\":%.1f}\n",
+           path, columns, rows, frames, elapsed, frames / elapsed);
+    fflush(stdout);
+}
+
+static int run_render(const char* font_path, float pixel_height, double seconds)
+{
+    if (!glfwInit()) {
+        fprintf(stderr, "glyphgl_bench: glfwInit failed, skipping the render suite\n");
+        return 0;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(1280, 720, "glyphgl_bench", NULL, NULL);
+    if (!window) {
+        fprintf(stderr, "glyphgl_bench: cannot create a GL 3.3 window, skipping the render suite\n");
+        glfwTerminate();
+        return 0;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    glyph_renderer_t renderers[2] = {
+        glyph_renderer_create(font_path, pixel_height, NULL, GLYPH_ENCODING_UTF8, NULL, 0),
+        glyph_renderer_create(font_path, pixel_height, NULL, GLYPH_ENCODING_UTF8, NULL, 1),
+    };
+    int ok = renderers[0].initialized && renderers[1].initialized;
+    if (!ok) fprintf(stderr, "glyphgl_bench: cannot create renderers for %s\n", font_path);
+
+    glViewport(0, 0, 1280, 720);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    for (int r = 0; ok && r < 2; r++) glyph_renderer_set_projection(&renderers[r], 1280, 720);
+
+    const std::string pangram = "The quick brown fox jumps over the lazy dog. ";
+    for (int instanced = 0; ok && instanced < 2; instanced++) {
+        const char* path = instanced ? "instanced" : "vertex";
+        for (glyph_renderer_t& renderer : renderers) glyph_renderer_set_instanced(&renderer, instanced);
+        for (const bench_effects& effects : effect_sets) {
+            for (int length : string_lengths) {
+                std::string text;
+                while ((int)text.size() < length) text += pangram;
+                text.resize(length);
+                run_render_case(&renderers[effects.sdf], path, effects, text, seconds);
+            }
+        }
+    }
+    for (int instanced = 0; ok && instanced < 2; instanced++) {
+        glyph_renderer_set_instanced(&renderers[0], instanced);
+        run_terminal_case(&renderers[0], instanced ? "instanced" : "vertex", seconds);
+    }
+    if (ok) run_terminal_case(&renderers[0], "grid", seconds);
+
+    for (glyph_renderer_t& renderer : renderers) glyph_renderer_free(&renderer);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const char* font_path = NULL;
+    int bake = 0, render = 0, iterations = 5;
+    float pixel_height = 32.0f;
+    double seconds = 0.5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--bake")) bake = 1;
+        else if (!strcmp(argv[i], "--render")) render = 1;
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc) pixel_height = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else font_path = argv[i];
+    }
+    if (!font_path || pixel_height <= 0.0f || iterations <= 0 || seconds <= 0.0) {
+        fprintf(stderr, "usage: glyphgl_bench [--bake] [--render] [--size px] [--iterations n] [--seconds s] font.ttf\n");
+        return 2;
+    }
+    if (!bake && !render) bake = render = 1; // Both suites by default
+
+    int ok = 1;
+    if (bake) ok = run_bake(font_path, pixel_height, iterations) && ok;
+    if (render) ok = run_render(font_path, pixel_height, seconds) && ok;
+    return ok ? 0 : 1;
+}
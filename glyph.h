@@ -68,6 +68,67 @@
  * v1.0.9 | 2025-11-14
  * | - Provided detailed comments on every aspect of the GlyphGL.
  * | - Renamed variables for readability and consistancy.
+ * v1.1.0 | [Unreleased]
+ * | - 'glyph_atlas_find_char' is now O(1) through a codepoint index built in 'glyph_atlas_create'
+ * | - Added 'glyph_atlas_create_ex' and 'glyph_atlas_config_t'; glyph rasterization can run on a thread pool or a user job system
+ * | - Replaced the bubble sort + shelf packer with pluggable skyline/MaxRects/shelf packers ('glyph_atlas_pack_rects')
+ * | - Atlases now grow from the smallest fitting power-of-2 size; 'GLYPHGL_ATLAS_WIDTH/HEIGHT' are minimums (default 256)
+ * | - Added dynamic atlases ('glyph_atlas_config_t.dynamic'): glyphs are rasterized on first use, evicted LRU-style and uploaded with 'glTexSubImage2D'
+ * | - Added 'glyph_renderer_create_ex' taking an atlas configuration
+ * | - Atlases store 8-bit single-channel coverage ('glyph_image_create_gray'); both modes upload it as GL_R8 without a staging copy
+ * | - Added 'glyph_renderer_set_stream_mode': vertices can stream through a fenced ring of unsynchronized or persistently mapped VBO regions
+ * | - Added 'glyph_renderer_begin/queue_text/flush' for batching many strings into one draw call; vertices carry color and effect flags ('glyph_vertex_t')
+ * | - Built-in shaders read 'TextColor'/'Effects' from the vertex stage; custom shaders using the 'textColor'/'effects' uniforms still work
+ * | - Added 'glyph_renderer_set_instanced': one 16-byte 'glyph_instance_t' per glyph, expanded in the vertex shader from a glyph-metrics texture
+ * | - Added retained text objects ('glyph_text_create/draw/set_string/free'): geometry is built once, position/scale/color are shader uniforms
+ * | - 'GLYPHGL_VERTEX_BUFFER_SIZE' is now the GPU upload capacity in vertices (default 18432); longer strings and batches are drawn in chunks instead of overflowing the VBO
+ * | - CPU batch buffers are sized exactly from character count and active effects; 'GLYPH_STREAM_SUBDATA' orphans the VBO before each upload
+ * | - SDF glyphs use an exact O(n) Euclidean distance transform seeded from anti-aliased coverage ('glyph_ttf_get_glyph_sdf_bitmap_ex', 'glyph_sdf_scratch_t')
+ * | - SDF spread is configurable ('glyph_atlas_config_t.sdf_spread') and added as a border around each glyph; SDFs now encode inside as 128-255
+ * | - The SDF shader path antialiases the edge with 'smoothstep' over 'fwidth'; underlines are no longer hidden in SDF mode
+ * | - Added multi-channel SDF atlases ('GLYPH_ATLAS_MSDF', glyph_msdf.h) generated from the outlines, keeping corners sharp when scaled up
+ * | - MSDF atlases are uploaded as GL_RGB8 and shaded via the channel median ('GLYPHGL_MSDF' is set automatically); custom effect shaders still sample '.r'
+ * | - New glyph rasterizer: exact-area coverage across every pixel an edge crosses, curve flattening adapted to size, SSE2/NEON accumulation ('GLYPHGL_NO_SIMD' opts out)
+ * | - Rasterization reuses one accumulation buffer per worker ('glyph_ttf_get_glyph_bitmap_ex', 'glyph_raster_scratch_t'); glyph bitmaps no longer mix 'calloc' with 'GLYPH_FREE'
+ * | - Composite glyphs (most accented Latin, Vietnamese, many CJK) are rasterized with their component offsets and scale/2x2 transforms
+ * | - Composite components are decoded once per atlas build into a per-font cache ('glyph_ttf_cache_components'); 'numGlyphs' now comes from 'maxp'
+ * | - cmap format 4 segments and format 12/13 groups are binary-searched instead of scanned
+ * | - 'glyph_ttf_init' builds a dense codepoint -> glyph table for the BMP ('GLYPHGL_GLYPH_INDEX_CACHE' sets the range, 0 disables; off in minimal mode)
+ * | - Font files are memory-mapped (mmap / MapViewOfFile) and parsed in place instead of read into a heap copy ('GLYPHGL_NO_MMAP' restores fread)
+ * | - 'glyph_ttf_load_font_from_memory' and 'glyph_atlas_config_t.font_data' load fonts from caller-owned memory without copying
+ * | - Binary atlas cache files ('glyph_atlas_save_cache', 'glyph_atlas_load_cache'), keyed by font bytes, size, charset and SDF mode
+ * | - 'glyph_atlas_config_t.cache_path' reuses a matching cache or rebuilds and writes it; 'glyph_renderer_create_from_atlas_file' skips the font entirely
+ * | - 'glyph_write_png' compresses with LZ77 + Huffman DEFLATE and adaptive row filters instead of stored blocks (a 1024x512 atlas: 1.5 MB -> 78 KB)
+ * | - PNG export streams scanlines into 64 KB IDAT chunks instead of holding raw and compressed copies; single-channel images are written as grayscale
+ * | - Pair kerning from GPOS ('kern' feature, PairPos formats 1/2) or the legacy 'kern' table ('glyph_ttf_get_glyph_kerning')
+ * | - Atlases precompute a codepoint-pair kerning hash for the charset ('glyph_atlas_get_kerning', 'glyph_atlas_config_t.kerning'); layout applies it with one probe per glyph
+ * | - Atlas cache files (format version 2) store the kerning pairs
+ * | - Text measurement without GL ('glyph_renderer_measure_text'): width, line height, ink bounds and per-character positions in caller storage
+ * | - Measured layouts draw or queue without being laid out again ('glyph_renderer_draw_layout', 'glyph_renderer_queue_layout')
+ * | - Font collections ('glyph_collection_create'): several faces and sizes merged into one texture and drawn by one program; mixed-face batches flush in one draw call
+ * | - 'glyph_atlas_merge' packs static atlases into one shared atlas and turns them into lookup views
+ * | - Uniform locations are resolved once per program; the draw path no longer calls 'glGetUniformLocation'
+ * | - 'glyph_renderer_set_time' feeds the effect 'time' uniform, uploaded only when it changes
+ * | - Opt-in GL binding tracking ('glyph_gl_set_state_tracking', 'glyph_gl_invalidate_state'): redundant binds are skipped and draws no longer unbind
+ * | - 'GLYPHGL_UNIFORM_BUFFER' moves the projection into a 'GlyphFrame' uniform block shared by both programs ('GLYPHGL_FRAME_BINDING')
+ * | - Shared program cache keyed by shader source (effect and GLSL version): renderers with the same effect link one program
+ * | - Program binaries persist across runs with 'glyph_gl_set_program_binary_dir' (glGetProgramBinary / glProgramBinary)
+ * | - 'glyph_renderer_set_effect' switches effects per draw over the same atlas; 'glyph_effect_precompile' builds every built-in effect up front
+ * | - Projection updates are deferred to the next draw of each program instead of binding every program
+ * | - Fixed custom effects ('glyph_effect_create_custom') being replaced by the default shaders
+ * | - Shader sources are rebuilt after 'glyph_gl_set_opengl_version' instead of keeping the first version used
+ * | - Bold is synthesized in the fragment shader (SDF dilation, or a second coverage tap) instead of a second quad per glyph
+ * | - Underline is one quad per string instead of one per glyph, and runs unbroken under spaces
+ * | - Added the 'glyphgl_bench' target (GLYPHGL_BUILD_BENCH): per-phase bake timings and draw_text throughput as JSON lines
+ * | - 'GLYPHGL_STATS' compiles in per-renderer counters ('glyph_renderer_get_stats', 'glyph_renderer_reset_stats'): glyphs, uploads, draw calls, regrowths, '?' fallbacks, atlas fill
+ * | - Atlas builds record per-phase timings in 'glyph_atlas_t.bake_stats' (GLYPHGL_STATS builds)
+ * | - 'glyph_renderer_set_gpu_timing' wraps text draws in GL_TIME_ELAPSED queries, collected without stalling
+ * | - Atlas builds take their working memory from 'glyph_atlas_config_t.allocator' ('glyph_allocator_t', NULL = GLYPH_MALLOC)
+ * | - Added 'glyph_arena_t' bump allocator; outlines, coverage and glyph bitmaps of a build live in per-worker arenas released at once
+ * | - Background atlas builds without GL ('glyph_atlas_build_start'/'_create'/'_run', polled with 'glyph_atlas_build_poll' or a callback)
+ * | - 'glyph_renderer_create_from_build' finalizes a build on the GL thread; 'glyph_renderer_create_from_atlas_ex' can upload through a PBO
+ * | - 'glyph_ttf_cache_outline' keeps decoded outlines per font; 'glyph_atlas_create_sizes' bakes several sizes/modes from one parse
+ * | - 'glyph_grid_t' draws fixed-pitch text grids from a GPU cell buffer, re-uploading only changed rows
  * ========================================================
  */
 
@@ -98,15 +159,24 @@
 #ifndef __GLYPH_H
 #define __GLYPH_H
 
-/* Configurable atlas dimensions - can be overridden at compile time for memory optimization */
+/* Configurable minimum atlas dimensions - can be overridden at compile time */
 #ifndef GLYPHGL_ATLAS_WIDTH
-#define GLYPHGL_ATLAS_WIDTH 2048  /* Default atlas width in pixels */
+#define GLYPHGL_ATLAS_WIDTH 256  /* Minimum atlas width in pixels */
 #endif
 #ifndef GLYPHGL_ATLAS_HEIGHT
-#define GLYPHGL_ATLAS_HEIGHT 2048  /* Default atlas height in pixels */
+#define GLYPHGL_ATLAS_HEIGHT 256  /* Minimum atlas height in pixels */
 #endif
 #ifndef GLYPHGL_VERTEX_BUFFER_SIZE
-#define GLYPHGL_VERTEX_BUFFER_SIZE 73728  /* Default vertex buffer size (vertices) */
+#define GLYPHGL_VERTEX_BUFFER_SIZE 18432  /* GPU vertex capacity per upload (vertices); longer strings are drawn in chunks */
+#endif
+#ifndef GLYPHGL_STREAM_REGIONS
+#define GLYPHGL_STREAM_REGIONS 3  /* Ring regions used by the mapped streaming modes */
+#endif
+#ifndef GLYPHGL_EFFECT_VARIANTS
+#define GLYPHGL_EFFECT_VARIANTS 8  /* Effect programs a renderer keeps ready for glyph_renderer_set_effect */
+#endif
+#ifndef GLYPHGL_STATS_QUERIES
+#define GLYPHGL_STATS_QUERIES 32  /* GPU timer queries in flight per renderer (GLYPHGL_STATS builds) */
 #endif
 
 
@@ -120,10 +190,11 @@
 #endif
 
 /* Text styling bitmask flags - can be combined with bitwise OR */
-#define GLYPHGL_BOLD        (1 << 0)  /* Render text with bold effect (duplicate glyphs offset) */
+#define GLYPHGL_BOLD        (1 << 0)  /* Render text with bold effect (thickened in the fragment shader) */
 #define GLYPHGL_ITALIC      (1 << 1)  /* Apply italic shear transformation to glyphs */
 #define GLYPHGL_UNDERLINE   (1 << 2)  /* Draw underline beneath text */
 #define GLYPHGL_SDF         (1 << 3)  /* Enable Signed Distance Field rendering for scalable text */
+#define GLYPHGL_MSDF        (1 << 4)  /* Multi-channel SDF atlas (set automatically for GLYPH_ATLAS_MSDF atlases) */
 
 #include "glyph_atlas.h"
 
@@ -137,6 +208,146 @@
 #define GLYPHGL_CHARSET_DEFAULT GLYPHGL_CHARSET_BASIC "€£¥¢₹₽±×÷√∫πΩ°∞≠≈≤≥∑∏∂∇∀∃∈∉⊂⊃∩∪←↑→↓"
 
 
+/*
+ * Strategies for streaming batched vertices to the GPU
+ *
+ * GLYPH_STREAM_SUBDATA:    glBufferSubData into offset 0 of a single VBO (default).
+ *                          Simple, but the driver may stall or copy when the previous draw still reads it.
+ * GLYPH_STREAM_MAP_RANGE:  Ring of GLYPHGL_STREAM_REGIONS regions written with unsynchronized
+ *                          glMapBufferRange; a fence per region guards reuse (GL 3.2 / ES 3.0).
+ * GLYPH_STREAM_PERSISTENT: Same ring, but the buffer is created with glBufferStorage and stays
+ *                          mapped persistently and coherently, so each draw is a plain memcpy (GL 4.4).
+ */
+typedef enum {
+    GLYPH_STREAM_SUBDATA = 0,
+    GLYPH_STREAM_MAP_RANGE,
+    GLYPH_STREAM_PERSISTENT
+} glyph_stream_mode_t;
+
+/*
+ * Interleaved vertex streamed to the GPU (20 bytes)
+ *
+ * Color and effects travel with every vertex so strings of different styles
+ * can share a draw call.
+ */
+typedef struct {
+    float x, y;                 /* Screen-space position */
+    float u, v;                 /* Atlas texture coordinates ((-1, -1) = solid, e.g. underline) */
+    unsigned char r, g, b;      /* Text color (normalized in the shader) */
+    unsigned char flags;        /* Effects bitmask (GLYPHGL_UNDERLINE, GLYPHGL_SDF, ...) */
+} glyph_vertex_t;
+
+/*
+ * Glyph instance for the instanced render path (16 bytes)
+ *
+ * The vertex shader expands each instance into a quad using the glyph's
+ * metrics texels, replacing 6 full vertices (120 bytes) per glyph.
+ */
+typedef struct {
+    float x, y;                 /* Pen position on the baseline (underline: its top-left corner) */
+    unsigned short glyph;       /* Index into atlas.chars (underline: width in 1/4 pixels) */
+    unsigned short scale;       /* Text scale in 1/256 steps (256 = 1.0) */
+    unsigned char r, g, b;      /* Text color (normalized in the shader) */
+    unsigned char flags;        /* Effects bitmask; bit 7 marks a run underline */
+} glyph_instance_t;
+
+/* Elements of one batched string sharing a color and effects (uniform-driven shaders only) */
+typedef struct {
+    size_t first;               /* First vertex (or instance) in the batch */
+    size_t count;               /* Vertex (or instance) count */
+    float r, g, b;              /* Text color */
+    int effects;                /* Effects bitmask */
+} glyph_renderer__run_t;
+
+/*
+ * Position of one character in a measured layout (glyph_renderer_measure_text)
+ *
+ * Positions already include kerning and scale; a layout can be drawn again
+ * with glyph_renderer_draw_layout without decoding or kerning the string.
+ */
+typedef struct {
+    float x;                    /* Pen position of the glyph origin, relative to the text start */
+    float advance;              /* Scaled advance to the next pen position (before kerning) */
+    int codepoint;              /* Codepoint laid out ('?' for missing characters, -1 if nothing can be shown) */
+    int index;                  /* Index into atlas.chars at measure time (-1 if none) */
+    size_t offset;              /* Byte offset of the character in the string */
+} glyph_layout_glyph_t;
+
+/*
+ * Metrics of a measured string
+ *
+ * Ink bounds cover the glyph quads as drawn (without bold/underline/italic
+ * extensions), relative to the baseline start point in screen coordinates.
+ */
+typedef struct {
+    float width;                /* Pen advance of the whole string */
+    float height;               /* Line height (atlas pixel height times scale) */
+    float ink_x0, ink_y0;       /* Top-left corner of the drawn glyphs (0 when nothing is drawn) */
+    float ink_x1, ink_y1;       /* Bottom-right corner of the drawn glyphs */
+    size_t num_glyphs;          /* Characters measured; only the first max_glyphs positions are stored */
+} glyph_text_metrics_t;
+
+/*
+ * Uniform locations of one renderer program
+ *
+ * Resolved once when the program is linked so the draw path never looks
+ * uniforms up by name. Locations the program does not declare are -1.
+ */
+typedef struct {
+    GLint projection;           /* mat4 projection (-1 when read from the GlyphFrame block) */
+    GLint text_offset;          /* vec2 textOffset (retained text transform) */
+    GLint text_scale;           /* float textScale */
+    GLint text_tint;            /* vec3 textTint */
+    GLint text_color;           /* vec3 textColor (custom effect shaders) */
+    GLint effects;              /* int effects (custom effect shaders) */
+    GLint time;                 /* float time (animated effects) */
+    GLuint frame_block;         /* GlyphFrame block index (GL_INVALID_INDEX if absent) */
+    float cached_time;          /* time last uploaded to this program */
+    int stale;                  /* Program uniforms must be re-sent before the next draw (new, switched or resized) */
+} glyph_renderer__uniforms_t;
+
+/* Cell placement uniforms of the grid program (set on every glyph_grid_draw) */
+typedef struct {
+    GLint origin;               /* vec2 gridOrigin */
+    GLint step;                 /* vec2 gridStep */
+    GLint scale;                /* float gridScale */
+    GLint underline;            /* float gridUnderline */
+    GLint columns;              /* int gridColumns */
+} glyph_renderer__grid_uniforms_t;
+
+#ifndef GLYPHGL_MINIMAL
+/* Programs of an effect the renderer switched away from, kept for switching back */
+typedef struct {
+    glyph_effect_t effect;                        /* Effect the programs were built for */
+    GLuint shader;                                /* Vertex path program */
+    glyph_renderer__uniforms_t uniforms;          /* Its uniform locations */
+    GLuint instance_shader;                       /* Instanced path program (0 if never needed) */
+    glyph_renderer__uniforms_t instance_uniforms; /* Its uniform locations */
+    int color_uniforms;                           /* Program reads textColor/effects uniforms */
+} glyph_renderer__variant_t;
+#endif
+
+/*
+ * Per-renderer counters (glyph_renderer_get_stats, GLYPHGL_STATS builds)
+ *
+ * Counters accumulate from renderer creation or the last
+ * glyph_renderer_reset_stats call; reset once per frame to read per-frame
+ * costs. In builds without GLYPHGL_STATS every field reads zero.
+ */
+typedef struct {
+    size_t glyphs;              /* Characters laid out into vertices or instances (retained text builds included) */
+    size_t vertices;            /* Vertices (instances on the instanced path) streamed to the GPU */
+    size_t bytes;               /* Vertex and instance bytes uploaded, retained text buffers included */
+    size_t texture_bytes;       /* Atlas and glyph metrics texels uploaded after creation */
+    size_t draw_calls;          /* glDrawArrays / glDrawArraysInstanced calls */
+    size_t buffer_grows;        /* CPU-side vertex/instance buffer reallocations */
+    size_t missing_glyphs;      /* Lookups that fell back to '?' (measurement included) */
+    float atlas_fill;           /* Fraction of the atlas in use: packed glyph area, or occupied slots of a dynamic atlas */
+    double gpu_ms;              /* GPU time of timed draws whose results arrived (see glyph_renderer_set_gpu_timing) */
+    size_t gpu_samples;         /* Draws that gpu_ms covers */
+    glyph_atlas_bake_stats_t bake; /* Phase timings of the renderer's atlas */
+} glyph_renderer_stats_t;
+
 /*
  * Forward declaration for UTF-8 decoding function used internally
  */
@@ -151,44 +362,242 @@ static int glyph_utf8_decode(const char* str, size_t* index);
  */
 typedef struct {
     glyph_atlas_t atlas;                /* Glyph atlas containing pre-rasterized character data */
+    glyph_atlas_t* lookup;              /* Atlas resolving codepoints, kerning and line height (NULL = atlas; a collection face) */
     GLuint texture;                     /* OpenGL texture object for atlas storage */
     GLuint shader;                      /* Compiled shader program for text rendering */
     GLuint vao;                         /* Vertex Array Object for vertex attribute setup */
     GLuint vbo;                         /* Vertex Buffer Object for batched vertex data */
-    float* vertex_buffer;               /* CPU-side vertex buffer for batching glyph quads */
-    size_t vertex_buffer_size;          /* Current allocated size of vertex buffer (in floats) */
+    glyph_vertex_t* vertex_buffer;      /* CPU-side vertex buffer for batching glyph quads */
+    size_t vertex_buffer_size;          /* Current allocated size of vertex buffer (in vertices) */
+    size_t queued_count;                /* Vertices (instances when instanced) queued since glyph_renderer_begin */
+    int batching;                       /* Set between glyph_renderer_begin and glyph_renderer_flush */
+    glyph_renderer__run_t* runs;        /* Style runs of the current batch (uniform-driven shaders only) */
+    int num_runs;                       /* Number of runs in use */
+    int runs_capacity;                  /* Allocated run slots */
+    int color_uniforms;                 /* Program reads textColor/effects uniforms instead of vertex attributes */
+    float projection[16];               /* Current projection, shared by both programs */
+    glyph_renderer__uniforms_t uniforms;          /* Uniform locations of shader */
+    glyph_renderer__uniforms_t instance_uniforms; /* Uniform locations of instance_shader */
+    float time;                         /* Effect animation time (glyph_renderer_set_time) */
+    int has_time;                       /* glyph_renderer_set_time was called; time is uploaded from then on */
+    GLuint frame_ubo;                   /* GlyphFrame uniform buffer (GLYPHGL_UNIFORM_BUFFER builds, 0 otherwise) */
+    int frame_dirty;                    /* frame_ubo must be refreshed before its next use */
+    float cached_transform[6];          /* textOffset, textScale and textTint last set on the vertex program */
+    int instanced;                      /* Draw through glyph instances (glyph_renderer_set_instanced) */
+    GLuint instance_shader;             /* Program expanding instances into quads (0 until first enabled) */
+    GLuint instance_vao;                /* VAO with the unit quad and per-instance attributes */
+    GLuint quad_vbo;                    /* Static unit quad corners */
+    GLuint metrics_texture;             /* RGBA32F per-glyph rect and offsets, two texels per glyph */
+    int metrics_capacity;               /* Glyph slots allocated in metrics_texture */
+    int metrics_dirty;                  /* Metrics must be re-uploaded before the next instanced or grid draw */
+    glyph_instance_t* instance_buffer;  /* CPU-side instance buffer */
+    size_t instance_buffer_size;        /* Allocated instances */
+    GLuint grid_shader;                 /* Program drawing glyph_grid_t cells (0 until the first grid is created) */
+    glyph_renderer__uniforms_t grid_uniforms;       /* Uniform locations of grid_shader */
+    glyph_renderer__grid_uniforms_t grid_locations; /* Its cell placement uniforms */
     int initialized;                    /* Flag indicating if renderer was successfully created */
     glyph_encoding_type_t char_type;    /* Character encoding type (ASCII or UTF-8) */
     float cached_text_color[3];         /* Cached RGB color values to avoid redundant uniform updates */
     int cached_effects;                 /* Cached effects bitmask to avoid redundant uniform updates */
 #ifndef GLYPHGL_MINIMAL
     glyph_effect_t effect;              /* Custom shader effect configuration (disabled in minimal mode) */
+    glyph_renderer__variant_t variants[GLYPHGL_EFFECT_VARIANTS]; /* Inactive effects, most recent last */
+    int num_variants;                   /* Variants in use */
+#endif
+    glyph_stream_mode_t stream_mode;    /* How vertices reach the VBO (see glyph_renderer_set_stream_mode) */
+    size_t stream_region_size;          /* Bytes per ring region (whole VBO in GLYPH_STREAM_SUBDATA mode), caps one upload */
+    size_t stream_offset;               /* Write cursor inside the current region, in bytes */
+    int stream_region;                  /* Ring region currently being written */
+    GLsync stream_fences[GLYPHGL_STREAM_REGIONS]; /* Fences signaled once the GPU is done with each region */
+    unsigned char* stream_mapped;       /* Persistent mapping of the whole VBO (GLYPH_STREAM_PERSISTENT only) */
+#ifdef GLYPHGL_STATS
+    glyph_renderer_stats_t stats;       /* Counters since creation or the last glyph_renderer_reset_stats */
+    int gpu_timing;                     /* Draws are wrapped in GL_TIME_ELAPSED queries */
+    GLuint queries[GLYPHGL_STATS_QUERIES]; /* Timer query ring (created on first enable) */
+    int query_head;                     /* Next ring slot to start */
+    int queries_pending;                /* Slots ending at query_head that await their result */
 #endif
 } glyph_renderer_t;
 
 
 /*
- * Creates and initializes a new glyph renderer with the specified font and configuration
+ * Configures the vertex layout of the bound VAO for the bound VBO
  *
- * This function performs the complete setup of a text renderer, including:
- * - Loading and parsing the TrueType font file
- * - Generating a glyph atlas with the specified character set
- * - Creating OpenGL texture, shader, and buffer objects
- * - Setting up vertex attributes for batched rendering
- * - Initializing performance caches for uniform values
+ * Layout (glyph_vertex_t): position (vec2), texture coords (vec2),
+ * color (normalized ubyte vec3) and effects (ubyte read as float).
+ */
+static inline void glyph_renderer__setup_vertex_attribs(void) {
+    GLsizei stride = (GLsizei)sizeof(glyph_vertex_t);
+    glyph__glEnableVertexAttribArray(0);
+    glyph__glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(glyph_vertex_t, x));
+    glyph__glEnableVertexAttribArray(1);
+    glyph__glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(glyph_vertex_t, u));
+    glyph__glEnableVertexAttribArray(2);
+    glyph__glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(glyph_vertex_t, r));
+    glyph__glEnableVertexAttribArray(3);
+    glyph__glVertexAttribPointer(3, 1, GL_UNSIGNED_BYTE, GL_FALSE, stride, (void*)offsetof(glyph_vertex_t, flags));
+}
+
+/*
+ * Looks up the uniforms the renderer drives in a freshly linked program
+ *
+ * In GLYPHGL_UNIFORM_BUFFER builds a GlyphFrame block, if declared, is
+ * attached to GLYPHGL_FRAME_BINDING.
  *
  * Parameters:
- *   font_path: Path to the TrueType (.ttf) font file
- *   pixel_height: Desired font size in pixels (affects glyph quality and atlas size)
- *   charset: String containing all characters to include in the atlas
+ *   program: Linked shader program
+ *   uniforms: Receives the locations
+ */
+static inline void glyph_renderer__resolve_uniforms(GLuint program, glyph_renderer__uniforms_t* uniforms) {
+    uniforms->projection = glyph__glGetUniformLocation(program, "projection");
+    uniforms->text_offset = glyph__glGetUniformLocation(program, "textOffset");
+    uniforms->text_scale = glyph__glGetUniformLocation(program, "textScale");
+    uniforms->text_tint = glyph__glGetUniformLocation(program, "textTint");
+    uniforms->text_color = glyph__glGetUniformLocation(program, "textColor");
+    uniforms->effects = glyph__glGetUniformLocation(program, "effects");
+    uniforms->time = glyph__glGetUniformLocation(program, "time");
+    uniforms->cached_time = 0.0f;
+    uniforms->stale = 1;
+#ifdef GLYPHGL_UNIFORM_BUFFER
+    uniforms->frame_block = glyph__glGetUniformBlockIndex(program, "GlyphFrame");
+    if (uniforms->frame_block != GL_INVALID_INDEX) glyph__glUniformBlockBinding(program, uniforms->frame_block, GLYPHGL_FRAME_BINDING);
+#else
+    uniforms->frame_block = GL_INVALID_INDEX;
+#endif
+}
+
+/*
+ * Sets the retained-text transform uniforms of the vertex program
+ *
+ * Immediate and batched text use the identity (offset 0, scale 1, tint 1);
+ * glyph_text_draw applies the object's position, scale and color. Values are
+ * cached so switching back to identity is free when nothing changed.
+ * Expects renderer->shader to be bound.
+ *
+ * Parameters:
+ *   renderer: Pointer to glyph renderer
+ *   x, y: Offset added after scaling
+ *   scale: Uniform scale applied to the geometry
+ *   r, g, b: Tint multiplied with the vertex colors
+ */
+static inline void glyph_renderer__set_transform(glyph_renderer_t* renderer, float x, float y, float scale, float r, float g, float b) {
+    float* cached = renderer->cached_transform;
+    if (cached[0] == x && cached[1] == y && cached[2] == scale && cached[3] == r && cached[4] == g && cached[5] == b) return;
+
+    glyph__glUniform2f(renderer->uniforms.text_offset, x, y);
+    glyph__glUniform1f(renderer->uniforms.text_scale, scale);
+    glyph__glUniform3f(renderer->uniforms.text_tint, r, g, b);
+    cached[0] = x;
+    cached[1] = y;
+    cached[2] = scale;
+    cached[3] = r;
+    cached[4] = g;
+    cached[5] = b;
+}
+
+#ifndef GLYPHGL_MINIMAL
+/*
+ * Picks the shader sources of an effect
+ *
+ * Effects carrying both sources (built-in effects and
+ * glyph_effect_create_custom) use them, anything else the default shaders.
+ *
+ * Parameters:
+ *   effect: Effect configuration
+ *   vertex_source, fragment_source: Receive the sources to link
+ */
+static inline void glyph_renderer__effect_sources(const glyph_effect_t* effect, const char** vertex_source, const char** fragment_source) {
+    if (effect->vertex_shader && effect->fragment_shader) {
+        *vertex_source = effect->vertex_shader;
+        *fragment_source = effect->fragment_shader;
+    } else {
+        *vertex_source = glyph__get_vertex_shader_source_cached();
+        *fragment_source = glyph__get_fragment_shader_source_cached();
+    }
+}
+#endif
+
+/*
+ * Gets the instanced-path program matching the renderer's effect
+ *
+ * Pairs the instanced vertex stage with the effect's fragment stage and
+ * stores the program in renderer->instance_shader.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: 1 on success, 0 if the program failed to build
+ */
+static inline int glyph_renderer__acquire_instance_program(glyph_renderer_t* renderer) {
+    const char* fragment_source = glyph__get_fragment_shader_source_cached();
+#ifndef GLYPHGL_MINIMAL
+    const char* vertex_source;
+    glyph_renderer__effect_sources(&renderer->effect, &vertex_source, &fragment_source);
+#endif
+    GLuint program = glyph__program_acquire(glyph__get_instanced_vertex_shader_source_cached(), fragment_source);
+    if (!program) return 0;
+
+    glyph_renderer__resolve_uniforms(program, &renderer->instance_uniforms);
+    glyph__glUseProgram(program);
+    glyph__glUniform1i(glyph__glGetUniformLocation(program, "textTexture"), 0);
+    glyph__glUniform1i(glyph__glGetUniformLocation(program, "glyphMetrics"), 1);
+    glyph__glUseProgram(0);
+    glyph_gl_invalidate_state();
+    renderer->instance_shader = program;
+    return 1;
+}
+
+/*
+ * Fills the bound atlas texture through a pixel unpack buffer
+ *
+ * The image is copied into a freshly orphaned buffer and the texture is
+ * specified from it, so glTexImage2D returns without waiting for the
+ * driver to consume client memory and the transfer overlaps later work.
+ * The buffer is deleted right away; GL keeps it alive until the copy ends.
+ *
+ * Returns: 1 on success, 0 if mapping failed (nothing was uploaded)
+ */
+static inline int glyph_renderer__upload_pbo(const glyph_image_t* image, GLenum internal_format, GLenum format) {
+    size_t size = (size_t)image->width * image->height * image->channels;
+    GLuint pbo = 0;
+    glyph__glGenBuffers(1, &pbo);
+    glyph__glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glyph__glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+    void* dst = glyph__glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    int uploaded = 0;
+    if (dst) {
+        memcpy(dst, image->data, size);
+        if (glyph__glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+            glTexImage2D(GL_TEXTURE_2D, 0, internal_format, image->width, image->height, 0, format, GL_UNSIGNED_BYTE, (const void*)0);
+            uploaded = 1;
+        }
+    }
+    glyph__glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glyph__glDeleteBuffers(1, &pbo);
+    return uploaded;
+}
+
+/*
+ * Creates a glyph renderer around an existing atlas, choosing the upload path
+ *
+ * Uploads the atlas texture and creates the shader, buffer and vertex array
+ * objects. The renderer takes ownership of the atlas (it is freed with the
+ * renderer, or immediately on failure). This is the only GL step of a
+ * renderer; the atlas itself can be built on another thread
+ * (glyph_atlas_build_start) and finalized here.
+ *
+ * Parameters:
+ *   atlas: Atlas from glyph_atlas_create_ex, glyph_atlas_load_cache or glyph_atlas_build_take
  *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
  *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
- *   use_sdf: Enable SDF rendering (GLYPHGL_SDF flag) for scalable text
+ *   use_pbo: Non-zero: stage the texture in a pixel unpack buffer so the
+ *            transfer runs asynchronously (falls back to a direct upload
+ *            without GL_PIXEL_UNPACK_BUFFER support)
  *
  * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
  *          Check renderer.initialized field to verify success
  */
-static inline glyph_renderer_t glyph_renderer_create(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type, void* effect, int use_sdf) {
+static inline glyph_renderer_t glyph_renderer_create_from_atlas_ex(glyph_atlas_t atlas, glyph_encoding_type_t char_type, void* effect, int use_pbo) {
     /* Set up default effect if none provided (only in full mode) */
 #ifndef GLYPHGL_MINIMAL
     glyph_effect_t default_effect = {(glyph_effect_type_t)GLYPH_EFFECT_NONE, NULL, NULL};
@@ -205,6 +614,7 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
         #ifdef GLYPHGL_DEBUG
         GLYPH_LOG("Failed to load OpenGL functions\n");
         #endif
+        glyph_atlas_free(&atlas);
         return renderer;
     }
 
@@ -216,69 +626,41 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
     renderer.effect = *(glyph_effect_t*)effect;
 #endif
 
-    /* Generate glyph atlas from font file - this is the core text processing step */
-    renderer.atlas = glyph_atlas_create(font_path, pixel_height, charset, char_type, use_sdf);
+    renderer.atlas = atlas;
     if (!renderer.atlas.chars || !renderer.atlas.image.data) {
         #ifdef GLYPHGL_DEBUG
         GLYPH_LOG("Failed to create font atlas\n");
         #endif
-        return renderer;
-    }
-
-    /* Create OpenGL texture for glyph atlas - different paths for minimal vs full mode */
-    // Defer atlas channel copy for minimal builds - upload directly from RGB data
-#ifndef GLYPHGL_MINIMAL
-    /* Full mode: Extract red channel from RGB atlas for GL_RED texture format */
-    /* This reduces texture memory usage and is optimal for luminance-based alpha */
-    unsigned char* red_channel = (unsigned char*)GLYPH_MALLOC(renderer.atlas.image.width * renderer.atlas.image.height);
-    if (!red_channel) {
         glyph_atlas_free(&renderer.atlas);
         return renderer;
     }
 
-    /* Copy red channel from RGB data (glyph rasterization produces grayscale) */
-    for (unsigned int i = 0; i < renderer.atlas.image.width * renderer.atlas.image.height; i++) {
-        red_channel[i] = renderer.atlas.image.data[i * 3];
-    }
-
-    /* Create and configure OpenGL texture with red channel data */
-    glGenTextures(1, &renderer.texture);
-    glBindTexture(GL_TEXTURE_2D, renderer.texture);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, renderer.atlas.image.width, renderer.atlas.image.height,
-                  0, GL_RED, GL_UNSIGNED_BYTE, red_channel);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    GLYPH_FREE(red_channel);
-#else
-    /* Minimal mode: Upload RGB texture directly (no channel extraction) */
-    /* Simpler but uses more memory - suitable for basic rendering without effects */
+    /* Create OpenGL texture for glyph atlas */
+    /* The atlas is single-channel coverage (or RGB for MSDF), so both full and minimal */
+    /* mode upload it as-is into a GL_R8/GL_RGB8 texture */
+    int msdf = renderer.atlas.image.channels == 3;
     glGenTextures(1, &renderer.texture);
     glBindTexture(GL_TEXTURE_2D, renderer.texture);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, renderer.atlas.image.width, renderer.atlas.image.height,
-                  0, GL_RGB, GL_UNSIGNED_BYTE, renderer.atlas.image.data);
+    if (!use_pbo || !glyph_gl_supports_pixel_buffer() ||
+        !glyph_renderer__upload_pbo(&renderer.atlas.image, msdf ? GL_RGB8 : GL_R8, msdf ? GL_RGB : GL_RED)) {
+        glTexImage2D(GL_TEXTURE_2D, 0, msdf ? GL_RGB8 : GL_R8, renderer.atlas.image.width, renderer.atlas.image.height,
+                      0, msdf ? GL_RGB : GL_RED, GL_UNSIGNED_BYTE, renderer.atlas.image.data);
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-#endif
 
-    /* Create shader program - use custom effect shaders or default based on configuration */
+    /* Get the shader program - shared with every renderer using the same effect, compiled on first use */
 #ifndef GLYPHGL_MINIMAL
-    if (renderer.effect.type == GLYPH_EFFECT_NONE) {
-        /* Use default shaders for basic text rendering */
-        renderer.shader = glyph__create_program(glyph__get_vertex_shader_source_cached(), glyph__get_fragment_shader_source_cached());
-    } else {
-        /* Use custom effect shaders for advanced rendering features */
-        renderer.shader = glyph__create_program(renderer.effect.vertex_shader, renderer.effect.fragment_shader);
-    }
+    const char* vertex_source;
+    const char* fragment_source;
+    glyph_renderer__effect_sources(&renderer.effect, &vertex_source, &fragment_source);
+    renderer.shader = glyph__program_acquire(vertex_source, fragment_source);
 #else
     /* Minimal mode always uses default shaders */
-    renderer.shader = glyph__create_program(glyph__get_vertex_shader_source_cached(), glyph__get_fragment_shader_source_cached());
+    renderer.shader = glyph__program_acquire(glyph__get_vertex_shader_source_cached(), glyph__get_fragment_shader_source_cached());
 #endif
     if (!renderer.shader) {
         /* Cleanup on shader compilation failure */
@@ -293,28 +675,44 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
     glyph__glBindVertexArray(renderer.vao);
     glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer.vbo);
     /* Allocate GPU buffer for batched vertex data - will be updated each draw call */
-    glyph__glBufferData(GL_ARRAY_BUFFER, sizeof(float) * GLYPHGL_VERTEX_BUFFER_SIZE, NULL, GL_DYNAMIC_DRAW);
-    /* Configure vertex attributes: position (vec2) and texture coords (vec2) */
-    glyph__glEnableVertexAttribArray(0);
-    glyph__glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glyph__glEnableVertexAttribArray(1);
-    glyph__glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    renderer.stream_region_size = sizeof(glyph_vertex_t) * GLYPHGL_VERTEX_BUFFER_SIZE;
+    glyph__glBufferData(GL_ARRAY_BUFFER, renderer.stream_region_size, NULL, GL_DYNAMIC_DRAW);
+    glyph_renderer__setup_vertex_attribs();
     glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
     glyph__glBindVertexArray(0);
 
     /* Allocate CPU-side vertex buffer for batching glyph quads before GPU upload */
-    renderer.vertex_buffer_size = GLYPHGL_VERTEX_BUFFER_SIZE * 4; /* Initial size for vertices (float * 4 per vertex) */
-    renderer.vertex_buffer = (float*)GLYPH_MALLOC(sizeof(float) * renderer.vertex_buffer_size);
+    renderer.vertex_buffer_size = GLYPHGL_VERTEX_BUFFER_SIZE; /* Initial capacity in vertices */
+    renderer.vertex_buffer = (glyph_vertex_t*)GLYPH_MALLOC(sizeof(glyph_vertex_t) * renderer.vertex_buffer_size);
     if (!renderer.vertex_buffer) {
         /* Cleanup on memory allocation failure */
         glyph__glDeleteVertexArrays(1, &renderer.vao);
         glyph__glDeleteBuffers(1, &renderer.vbo);
         glDeleteTextures(1, &renderer.texture);
-        glyph__glDeleteProgram(renderer.shader);
+        glyph__program_release(renderer.shader);
         glyph_atlas_free(&renderer.atlas);
         return renderer;
     }
 
+    /* Custom effect shaders may still take color and effects from uniforms */
+    glyph_renderer__resolve_uniforms(renderer.shader, &renderer.uniforms);
+    renderer.color_uniforms = renderer.uniforms.text_color >= 0 || renderer.uniforms.effects >= 0;
+
+#ifdef GLYPHGL_UNIFORM_BUFFER
+    /* One GlyphFrame buffer feeds the projection to both programs */
+    glyph__glGenBuffers(1, &renderer.frame_ubo);
+    glyph__glBindBuffer(GL_UNIFORM_BUFFER, renderer.frame_ubo);
+    glyph__glBufferData(GL_UNIFORM_BUFFER, sizeof(renderer.projection), NULL, GL_DYNAMIC_DRAW);
+    glyph__glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    renderer.frame_dirty = 1;
+#endif
+
+    /* Binds above bypassed the tracker */
+    glyph_gl_invalidate_state();
+
+    /* Uniforms (identity text transform, projection) are sent by the first draw */
+    renderer.cached_transform[0] = -1.0f;
+
     /* Initialize uniform caches to invalid values to force first update */
     renderer.cached_text_color[0] = -1.0f;
     renderer.cached_text_color[1] = -1.0f;
@@ -327,291 +725,2614 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
 }
 
 /*
- * Frees all resources associated with a glyph renderer
+ * Creates a glyph renderer around an existing atlas
  *
- * This function performs complete cleanup of OpenGL objects, memory buffers,
- * and atlas data. It should be called when the renderer is no longer needed
- * to prevent memory leaks and resource exhaustion.
+ * Same as glyph_renderer_create_from_atlas_ex with a direct texture upload.
  *
  * Parameters:
- *   renderer: Pointer to the glyph_renderer_t to free
+ *   atlas: Atlas from glyph_atlas_create_ex or glyph_atlas_load_cache (owned by the renderer)
+ *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
+ *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
  *
- * Note: Safe to call on uninitialized or NULL renderers (no-op in these cases)
+ * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
  */
-static inline void glyph_renderer_free(glyph_renderer_t* renderer) {
-    /* Early return for invalid or uninitialized renderers */
-    if (!renderer || !renderer->initialized) return;
-
-    /* Clean up OpenGL objects in reverse order of creation */
-    glyph__glDeleteVertexArrays(1, &renderer->vao);
-    glyph__glDeleteBuffers(1, &renderer->vbo);
-    glDeleteTextures(1, &renderer->texture);
-    glyph__glDeleteProgram(renderer->shader);
-
-    /* Free glyph atlas and its associated memory */
-    glyph_atlas_free(&renderer->atlas);
-
-    /* Free CPU-side vertex buffer */
-    GLYPH_FREE(renderer->vertex_buffer);
-
-    /* Mark renderer as uninitialized to prevent double-free */
-    renderer->initialized = 0;
+static inline glyph_renderer_t glyph_renderer_create_from_atlas(glyph_atlas_t atlas, glyph_encoding_type_t char_type, void* effect) {
+    return glyph_renderer_create_from_atlas_ex(atlas, char_type, effect, 0);
 }
 
 /*
- * Sets the orthographic projection matrix for 2D text rendering
+ * Finalizes a background atlas build into a renderer (call on the GL thread)
  *
- * Configures the coordinate system to match window dimensions, mapping
- * pixel coordinates directly to screen space. This is essential for
- * proper text positioning and scaling.
+ * Takes the atlas out of the build and uploads it. Blocks if the build is
+ * still running, so poll glyph_atlas_build_poll (or wait for its callback)
+ * first to keep frames smooth. The build itself is not freed.
  *
  * Parameters:
- *   renderer: Pointer to initialized glyph renderer
- *   width: Window/screen width in pixels
- *   height: Window/screen height in pixels
+ *   build: Build from glyph_atlas_build_start or glyph_atlas_build_create
+ *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
+ *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
+ *   use_pbo: Non-zero to upload through a pixel unpack buffer
  *
- * The projection matrix transforms coordinates from (0,0) at bottom-left
- * to (width,height) at top-right, which is standard for 2D GUI rendering.
+ * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
  */
-static inline void glyph_renderer_set_projection(glyph_renderer_t* renderer, int width, int height) {
-    if (!renderer || !renderer->initialized) return;
-
-    /* Create orthographic projection matrix for pixel-perfect 2D rendering */
-    float projection[16] = {
-        2.0f / width, 0.0f, 0.0f, 0.0f,      /* Scale X: map width to [-1,1] range */
-        0.0f, -2.0f / height, 0.0f, 0.0f,     /* Scale Y: map height to [-1,1] range (flipped) */
-        0.0f, 0.0f, -1.0f, 0.0f,             /* Z: standard orthographic */
-        -1.0f, 1.0f, 0.0f, 1.0f              /* Translation: center at (0,0) */
-    };
-
-    /* Upload projection matrix to shader uniform */
-    glyph__glUseProgram(renderer->shader);
-    glyph__glUniformMatrix4fv(glyph__glGetUniformLocation(renderer->shader, "projection"), 1, GL_FALSE, projection);
-    glyph__glUseProgram(0);
+static inline glyph_renderer_t glyph_renderer_create_from_build(glyph_atlas_build_t* build, glyph_encoding_type_t char_type, void* effect, int use_pbo) {
+    return glyph_renderer_create_from_atlas_ex(glyph_atlas_build_take(build), char_type, effect, use_pbo);
 }
 
 /*
- * Updates the projection matrix when window dimensions change
+ * Creates and initializes a new glyph renderer with the specified font and configuration
  *
- * This is a convenience function identical to glyph_renderer_set_projection,
- * provided for handling window resize events. Call this whenever the
- * rendering window is resized to maintain correct text positioning.
+ * This function performs the complete setup of a text renderer, including:
+ * - Loading and parsing the TrueType font file
+ * - Generating a glyph atlas with the specified character set
+ * - Creating OpenGL texture, shader, and buffer objects
+ * - Setting up vertex attributes for batched rendering
+ * - Initializing performance caches for uniform values
  *
  * Parameters:
- *   renderer: Pointer to initialized glyph renderer
- *   width: New window width in pixels
- *   height: New window height in pixels
+ *   font_path: Path to the TrueType (.ttf) font file
+ *   pixel_height: Desired font size in pixels (affects glyph quality and atlas size)
+ *   charset: String containing all characters to include in the atlas
+ *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
+ *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
+ *   use_sdf: Enable SDF rendering (GLYPHGL_SDF flag) for scalable text
+ *   atlas_config: Atlas build configuration (NULL for defaults); set 'dynamic'
+ *                 to rasterize glyphs outside 'charset' on first use, or
+ *                 'cache_path' to reuse a binary atlas cache across runs
  *
- * Note: This function is functionally identical to set_projection but
- *       named for semantic clarity during window resize handling.
+ * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
+ *          Check renderer.initialized field to verify success
  */
-static inline void glyph_renderer_update_projection(glyph_renderer_t* renderer, int width, int height) {
-    if (!renderer || !renderer->initialized) return;
+static inline glyph_renderer_t glyph_renderer_create_ex(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type, void* effect, int use_sdf, const glyph_atlas_config_t* atlas_config) {
+    /* Generate glyph atlas from font file - this is the core text processing step */
+    glyph_atlas_t atlas = glyph_atlas_create_ex(font_path, pixel_height, charset, char_type, use_sdf, atlas_config);
+    return glyph_renderer_create_from_atlas(atlas, char_type, effect);
+}
 
-    /* Recalculate orthographic projection for new dimensions */
-    float projection[16] = {
-        2.0f / width, 0.0f, 0.0f, 0.0f,
-        0.0f, -2.0f / height, 0.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        -1.0f, 1.0f, 0.0f, 1.0f
-    };
+/*
+ * Creates a glyph renderer straight from a binary atlas cache file
+ *
+ * No font is parsed and nothing is rasterized: the file written by
+ * glyph_atlas_save_cache (or by a build with 'cache_path' set) is mapped,
+ * validated and uploaded to GL.
+ *
+ * Parameters:
+ *   atlas_path: Binary atlas cache file
+ *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
+ *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
+ *
+ * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
+ */
+static inline glyph_renderer_t glyph_renderer_create_from_atlas_file(const char* atlas_path, glyph_encoding_type_t char_type, void* effect) {
+    return glyph_renderer_create_from_atlas(glyph_atlas_load_cache(atlas_path, 0), char_type, effect);
+}
 
-    /* Update shader uniform with new projection matrix */
-    glyph__glUseProgram(renderer->shader);
-    glyph__glUniformMatrix4fv(glyph__glGetUniformLocation(renderer->shader, "projection"), 1, GL_FALSE, projection);
-    glyph__glUseProgram(0);
+/*
+ * Creates and initializes a new glyph renderer with the default atlas configuration
+ *
+ * Equivalent to glyph_renderer_create_ex with atlas_config == NULL.
+ *
+ * Parameters:
+ *   font_path: Path to the TrueType (.ttf) font file
+ *   pixel_height: Desired font size in pixels (affects glyph quality and atlas size)
+ *   charset: String containing all characters to include in the atlas
+ *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
+ *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
+ *   use_sdf: Enable SDF rendering (GLYPHGL_SDF flag) for scalable text
+ *
+ * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
+ */
+static inline glyph_renderer_t glyph_renderer_create(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type, void* effect, int use_sdf) {
+    return glyph_renderer_create_ex(font_path, pixel_height, charset, char_type, effect, use_sdf, NULL);
 }
 
 /*
- * Renders text to the screen with specified styling and effects
+ * Uploads glyphs added to a dynamic atlas since the last upload
  *
- * This is the core rendering function that processes text strings, looks up
- * glyph data from the atlas, applies text effects, and batches everything
- * into a single OpenGL draw call for optimal performance.
+ * Only the dirty rectangle is sent with glTexSubImage2D; GL_UNPACK_ROW_LENGTH
+ * lets the driver read it straight out of the CPU-side atlas image.
+ * Expects the atlas texture to be bound to GL_TEXTURE_2D.
  *
  * Parameters:
  *   renderer: Pointer to initialized glyph renderer
- *   text: UTF-8 or ASCII string to render
- *   x, y: Screen coordinates for text baseline start position
- *   scale: Text scaling factor (1.0 = normal size)
- *   r, g, b: Text color as RGB values (0.0-1.0 range)
- *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: 1 if glyphs were uploaded (atlas entries changed), 0 otherwise
+ */
+static inline int glyph_renderer__upload_atlas(glyph_renderer_t* renderer) {
+    int x, y, w, h;
+    if (!glyph_atlas_cache_take_dirty(&renderer->atlas, &x, &y, &w, &h)) return 0;
+
+    size_t channels = renderer->atlas.image.channels;
+    const unsigned char* src = renderer->atlas.image.data + ((size_t)y * renderer->atlas.image.width + x) * channels;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)renderer->atlas.image.width);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, channels == 3 ? GL_RGB : GL_RED, GL_UNSIGNED_BYTE, src);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    GLYPH_STAT(renderer->stats.texture_bytes += (size_t)w * h * channels);
+    return 1;
+}
+
+/*
+ * Releases the fences and persistent mapping of a streaming VBO
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__stream_release(glyph_renderer_t* renderer) {
+    for (int i = 0; i < GLYPHGL_STREAM_REGIONS; i++) {
+        if (renderer->stream_fences[i]) {
+            glyph__glDeleteSync(renderer->stream_fences[i]);
+            renderer->stream_fences[i] = NULL;
+        }
+    }
+    if (renderer->stream_mapped) {
+        glyph__gl_bind_array_buffer(renderer->vbo);
+        glyph__glUnmapBuffer(GL_ARRAY_BUFFER);
+        glyph__gl_unbind_array_buffer();
+        renderer->stream_mapped = NULL;
+    }
+}
+
+/*
+ * Selects how batched vertices are streamed to the GPU
+ *
+ * Recreates the VBO for the requested strategy. Unsupported modes degrade
+ * gracefully (GLYPH_STREAM_PERSISTENT -> GLYPH_STREAM_MAP_RANGE ->
+ * GLYPH_STREAM_SUBDATA), so the returned mode is the one actually in use.
+ * Must be called with the renderer's GL context current.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   mode: Requested streaming strategy
+ *
+ * Returns: Streaming mode now in effect
+ */
+static inline glyph_stream_mode_t glyph_renderer_set_stream_mode(glyph_renderer_t* renderer, glyph_stream_mode_t mode) {
+    if (!renderer || !renderer->initialized) return GLYPH_STREAM_SUBDATA;
+
+    /* Walk down the fallback chain until the context supports the mode */
+    if (mode == GLYPH_STREAM_PERSISTENT && !glyph_gl_supports_buffer_storage()) {
+        GLYPH_LOG("Persistent buffer mapping unavailable, streaming with glMapBufferRange\n");
+        mode = GLYPH_STREAM_MAP_RANGE;
+    }
+    if (mode == GLYPH_STREAM_MAP_RANGE && !glyph_gl_supports_map_buffer_range()) {
+        GLYPH_LOG("Unsynchronized buffer mapping unavailable, streaming with glBufferSubData\n");
+        mode = GLYPH_STREAM_SUBDATA;
+    }
+    if (mode == renderer->stream_mode) return mode;
+
+    /* Replace the VBO: immutable storage cannot be respecified in place */
+    glyph_renderer__stream_release(renderer);
+    glyph__glDeleteBuffers(1, &renderer->vbo);
+    glyph_gl_invalidate_state(); /* The new buffer may reuse the old name */
+    glyph__glGenBuffers(1, &renderer->vbo);
+    glyph__glBindVertexArray(renderer->vao);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+
+    renderer->stream_region_size = sizeof(glyph_vertex_t) * GLYPHGL_VERTEX_BUFFER_SIZE;
+    renderer->stream_offset = 0;
+    renderer->stream_region = 0;
+    renderer->stream_mode = mode;
+
+    if (mode == GLYPH_STREAM_SUBDATA) {
+        glyph__glBufferData(GL_ARRAY_BUFFER, renderer->stream_region_size, NULL, GL_DYNAMIC_DRAW);
+    } else if (mode == GLYPH_STREAM_MAP_RANGE) {
+        glyph__glBufferData(GL_ARRAY_BUFFER, renderer->stream_region_size * GLYPHGL_STREAM_REGIONS, NULL, GL_STREAM_DRAW);
+    } else {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr total = (GLsizeiptr)(renderer->stream_region_size * GLYPHGL_STREAM_REGIONS);
+        glyph__glBufferStorage(GL_ARRAY_BUFFER, total, NULL, flags);
+        renderer->stream_mapped = (unsigned char*)glyph__glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags);
+        if (!renderer->stream_mapped) {
+            /* Mapping failed - rebuild as a mutable ring instead */
+            GLYPH_LOG("Failed to map persistent vertex buffer\n");
+            glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glyph__glBindVertexArray(0);
+            return glyph_renderer_set_stream_mode(renderer, GLYPH_STREAM_MAP_RANGE);
+        }
+    }
+
+    glyph_renderer__setup_vertex_attribs();
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glyph__glBindVertexArray(0);
+    return mode;
+}
+
+/*
+ * Moves the stream cursor to the next ring region
+ *
+ * Fences the region being left so its pending draws are tracked, then waits
+ * until the GPU has finished reading the region being entered. With enough
+ * regions in flight the wait returns immediately.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__stream_advance(glyph_renderer_t* renderer) {
+    renderer->stream_fences[renderer->stream_region] = glyph__glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    renderer->stream_region = (renderer->stream_region + 1) % GLYPHGL_STREAM_REGIONS;
+    renderer->stream_offset = 0;
+
+    GLsync fence = renderer->stream_fences[renderer->stream_region];
+    if (!fence) return;
+    for (;;) {
+        GLenum result = glyph__glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull); /* 1s per wait */
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) break;
+    }
+    glyph__glDeleteSync(fence);
+    renderer->stream_fences[renderer->stream_region] = NULL;
+}
+
+/*
+ * Copies a batch of vertices into the VBO using the active streaming mode
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   data: Interleaved vertex data
+ *   vertex_count: Number of vertices in data
+ *   stride: Size of one vertex in bytes
+ *
+ * Returns: Index of the first uploaded vertex for glDrawArrays, or -1 if the
+ *          batch does not fit into one stream region (see
+ *          glyph_renderer__chunk_capacity)
+ */
+static inline GLint glyph_renderer__stream_vertices(glyph_renderer_t* renderer, const void* data, size_t vertex_count, size_t stride) {
+    size_t bytes = vertex_count * stride;
+
+    if (bytes > renderer->stream_region_size) {
+        GLYPH_LOG("Vertex batch of %lu bytes exceeds the %lu byte stream region\n", (unsigned long)bytes, (unsigned long)renderer->stream_region_size);
+        return -1;
+    }
+    GLYPH_STAT(renderer->stats.vertices += vertex_count);
+    GLYPH_STAT(renderer->stats.bytes += bytes);
+
+    if (renderer->stream_mode == GLYPH_STREAM_SUBDATA) {
+        /* Orphan the storage so the upload never waits for draws still reading the previous batch */
+        glyph__gl_bind_array_buffer(renderer->vbo);
+        glyph__glBufferData(GL_ARRAY_BUFFER, renderer->stream_region_size, NULL, GL_DYNAMIC_DRAW);
+        glyph__glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+        glyph__gl_unbind_array_buffer();
+        return 0;
+    }
+
+    /* Leave room for aligning the batch start to a whole vertex */
+    if (bytes + stride > renderer->stream_region_size) {
+        GLYPH_LOG("Vertex batch of %lu bytes exceeds the %lu byte stream region\n", (unsigned long)bytes, (unsigned long)renderer->stream_region_size);
+        return -1;
+    }
+
+    size_t region_base = (size_t)renderer->stream_region * renderer->stream_region_size;
+    size_t start = (region_base + renderer->stream_offset + stride - 1) / stride * stride;
+    if (start + bytes > region_base + renderer->stream_region_size) {
+        glyph_renderer__stream_advance(renderer);
+        region_base = (size_t)renderer->stream_region * renderer->stream_region_size;
+        start = (region_base + stride - 1) / stride * stride;
+    }
+
+    if (renderer->stream_mode == GLYPH_STREAM_PERSISTENT) {
+        /* Coherent mapping: the copy is visible to the next draw without a flush */
+        memcpy(renderer->stream_mapped + start, data, bytes);
+    } else {
+        /* Unsynchronized: the fences already guarantee the GPU is not reading this range */
+        glyph__gl_bind_array_buffer(renderer->vbo);
+        void* dst = glyph__glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)start, (GLsizeiptr)bytes,
+                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            memcpy(dst, data, bytes);
+            glyph__glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            glyph__glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)start, bytes, data);
+        }
+        glyph__gl_unbind_array_buffer();
+    }
+
+    renderer->stream_offset = start + bytes - region_base;
+    return (GLint)(start / stride);
+}
+
+/*
+ * Frees all resources associated with a glyph renderer
+ *
+ * This function performs complete cleanup of OpenGL objects, memory buffers,
+ * and atlas data. It should be called when the renderer is no longer needed
+ * to prevent memory leaks and resource exhaustion.
+ *
+ * Parameters:
+ *   renderer: Pointer to the glyph_renderer_t to free
+ *
+ * Note: Safe to call on uninitialized or NULL renderers (no-op in these cases)
+ */
+static inline void glyph_renderer_free(glyph_renderer_t* renderer) {
+    /* Early return for invalid or uninitialized renderers */
+    if (!renderer || !renderer->initialized) return;
+
+    /* Clean up OpenGL objects in reverse order of creation */
+    glyph_renderer__stream_release(renderer);
+    if (renderer->instance_vao) {
+        glyph__glDeleteVertexArrays(1, &renderer->instance_vao);
+        glyph__glDeleteBuffers(1, &renderer->quad_vbo);
+    }
+    if (renderer->metrics_texture) glDeleteTextures(1, &renderer->metrics_texture);
+    glyph__program_release(renderer->instance_shader);
+    glyph__program_release(renderer->grid_shader);
+#ifndef GLYPHGL_MINIMAL
+    for (int i = 0; i < renderer->num_variants; i++) {
+        glyph__program_release(renderer->variants[i].shader);
+        glyph__program_release(renderer->variants[i].instance_shader);
+    }
+#endif
+    if (renderer->frame_ubo) glyph__glDeleteBuffers(1, &renderer->frame_ubo);
+#ifdef GLYPHGL_STATS
+    if (renderer->queries[0]) glyph__glDeleteQueries(GLYPHGL_STATS_QUERIES, renderer->queries);
+#endif
+    glyph__glDeleteVertexArrays(1, &renderer->vao);
+    glyph__glDeleteBuffers(1, &renderer->vbo);
+    glDeleteTextures(1, &renderer->texture);
+    glyph__program_release(renderer->shader);
+    glyph_gl_invalidate_state(); /* Deleted names may be handed out again */
+
+    /* Free glyph atlas and its associated memory */
+    glyph_atlas_free(&renderer->atlas);
+
+    /* Free CPU-side vertex buffer and batch runs */
+    GLYPH_FREE(renderer->vertex_buffer);
+    GLYPH_FREE(renderer->runs);
+    GLYPH_FREE(renderer->instance_buffer);
+
+    /* Mark renderer as uninitialized to prevent double-free */
+    renderer->initialized = 0;
+}
+
+/*
+ * Stores a projection matrix for every renderer program
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   projection: Column-major 4x4 matrix
+ */
+static inline void glyph_renderer__upload_projection(glyph_renderer_t* renderer, const float projection[16]) {
+    memcpy(renderer->projection, projection, sizeof(renderer->projection));
+
+    /* Sent with the next draw of each program; GlyphFrame blocks take it from one buffer update */
+    renderer->frame_dirty = 1;
+    renderer->uniforms.stale = 1;
+    renderer->instance_uniforms.stale = 1;
+    renderer->grid_uniforms.stale = 1;
+}
+
+/*
+ * Sets the orthographic projection matrix for 2D text rendering
+ *
+ * Configures the coordinate system to match window dimensions, mapping
+ * pixel coordinates directly to screen space. This is essential for
+ * proper text positioning and scaling.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   width: Window/screen width in pixels
+ *   height: Window/screen height in pixels
+ *
+ * The projection matrix transforms coordinates from (0,0) at bottom-left
+ * to (width,height) at top-right, which is standard for 2D GUI rendering.
+ */
+static inline void glyph_renderer_set_projection(glyph_renderer_t* renderer, int width, int height) {
+    if (!renderer || !renderer->initialized) return;
+
+    /* Create orthographic projection matrix for pixel-perfect 2D rendering */
+    float projection[16] = {
+        2.0f / width, 0.0f, 0.0f, 0.0f,      /* Scale X: map width to [-1,1] range */
+        0.0f, -2.0f / height, 0.0f, 0.0f,     /* Scale Y: map height to [-1,1] range (flipped) */
+        0.0f, 0.0f, -1.0f, 0.0f,             /* Z: standard orthographic */
+        -1.0f, 1.0f, 0.0f, 1.0f              /* Translation: center at (0,0) */
+    };
+
+    /* Upload projection matrix to shader uniform */
+    glyph_renderer__upload_projection(renderer, projection);
+}
+
+/*
+ * Updates the projection matrix when window dimensions change
+ *
+ * This is a convenience function identical to glyph_renderer_set_projection,
+ * provided for handling window resize events. Call this whenever the
+ * rendering window is resized to maintain correct text positioning.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   width: New window width in pixels
+ *   height: New window height in pixels
+ *
+ * Note: This function is functionally identical to set_projection but
+ *       named for semantic clarity during window resize handling.
+ */
+static inline void glyph_renderer_update_projection(glyph_renderer_t* renderer, int width, int height) {
+    if (!renderer || !renderer->initialized) return;
+
+    /* Recalculate orthographic projection for new dimensions */
+    float projection[16] = {
+        2.0f / width, 0.0f, 0.0f, 0.0f,
+        0.0f, -2.0f / height, 0.0f, 0.0f,
+        0.0f, 0.0f, -1.0f, 0.0f,
+        -1.0f, 1.0f, 0.0f, 1.0f
+    };
+
+    /* Update shader uniform with new projection matrix */
+    glyph_renderer__upload_projection(renderer, projection);
+}
+
+/*
+ * Sets the animation time read by effect shaders ('uniform float time')
+ *
+ * The value is uploaded on the next draw, and only to programs that declare
+ * the uniform and have not received this value yet, so calling it once per
+ * frame costs at most one glUniform1f per program.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   seconds: Animation time in seconds
+ */
+static inline void glyph_renderer_set_time(glyph_renderer_t* renderer, float seconds) {
+    if (!renderer || !renderer->initialized) return;
+    renderer->time = seconds;
+    if (!renderer->has_time) {
+        renderer->has_time = 1;
+        renderer->uniforms.stale = 1;
+        renderer->instance_uniforms.stale = 1;
+        renderer->grid_uniforms.stale = 1;
+    }
+}
+
+/*
+ * Packs a color channel into a normalized vertex byte
+ *
+ * Parameters:
+ *   c: Channel value (clamped to 0.0-1.0)
+ *
+ * Returns: Channel as 0-255
+ */
+static inline unsigned char glyph_renderer__color_byte(float c) {
+    if (c <= 0.0f) return 0;
+    if (c >= 1.0f) return 255;
+    return (unsigned char)(c * 255.0f + 0.5f);
+}
+
+/*
+ * Writes one textured quad as two triangles (6 vertices)
+ *
+ * Parameters:
+ *   out: Destination for 6 vertices
+ *   x, y: Bottom-left corner in screen space
+ *   w, h: Quad size
+ *   u1, v1, u2, v2: Texture rectangle (v1 at the bottom edge)
+ *   shear: Horizontal offset of the top edge (italic slant)
+ *   color: Vertex color bytes (RGB)
+ *   flags: Effects bitmask stored in every vertex
+ */
+static inline void glyph_renderer__emit_quad(glyph_vertex_t* out, float x, float y, float w, float h,
+                                             float u1, float v1, float u2, float v2, float shear,
+                                             const unsigned char color[3], unsigned char flags) {
+    /* Corner order: top-left, bottom-left, bottom-right, top-left, bottom-right, top-right */
+    const float px[6] = {x - shear, x, x + w, x - shear, x + w, x + w - shear};
+    const float py[6] = {y + h, y, y, y + h, y, y + h};
+    const float pu[6] = {u1, u1, u2, u1, u2, u2};
+    const float pv[6] = {v2, v1, v1, v2, v1, v2};
+    for (int i = 0; i < 6; i++) {
+        out[i].x = px[i];
+        out[i].y = py[i];
+        out[i].u = pu[i];
+        out[i].v = pv[i];
+        out[i].r = color[0];
+        out[i].g = color[1];
+        out[i].b = color[2];
+        out[i].flags = flags;
+    }
+}
+
+/*
+ * Counts the characters of a string, an upper bound on the glyphs it draws
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (selects the encoding)
+ *   text: String to measure
+ *   text_len: Length of text in bytes
+ *
+ * Returns: Number of codepoints in text
+ */
+static inline size_t glyph_renderer__glyph_count(const glyph_renderer_t* renderer, const char* text, size_t text_len) {
+    if (renderer->char_type != GLYPH_ENCODING_UTF8) return text_len;
+    size_t count = 0;
+    for (size_t i = 0; i < text_len; i++) {
+        if (((unsigned char)text[i] & 0xC0) != 0x80) count++; /* Skip continuation bytes */
+    }
+    return count;
+}
+
+/*
+ * Reports whether bold is synthesized by the fragment stage
+ *
+ * The built-in fragment shader thickens bold glyphs itself (SDF dilation,
+ * or a second coverage tap one texel to the left), so each glyph stays one
+ * quad. Effect shaders only see geometry and get a second, offset quad.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: 1 for the built-in fragment shader, 0 for effect shaders
+ */
+static inline int glyph_renderer__shader_bold(const glyph_renderer_t* renderer) {
+#ifndef GLYPHGL_MINIMAL
+    return renderer->effect.fragment_shader == NULL;
+#else
+    (void)renderer;
+    return 1;
+#endif
+}
+
+/*
+ * Returns the number of quads (or instances) emitted per visible glyph
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   effects: Bitmask of text effects
+ *
+ * Returns: 1 for the glyph itself, plus one for bold under effect shaders
+ */
+static inline size_t glyph_renderer__quads_per_glyph(const glyph_renderer_t* renderer, int effects) {
+#ifndef GLYPHGL_MINIMAL
+    return 1 + ((effects & GLYPHGL_BOLD) && !glyph_renderer__shader_bold(renderer) ? 1 : 0);
+#else
+    (void)renderer;
+    (void)effects;
+    return 1;
+#endif
+}
+
+/*
+ * Returns the number of quads (or instances) emitted once per laid-out run
+ *
+ * Parameters:
+ *   effects: Bitmask of text effects
+ *
+ * Returns: 1 for the merged underline, 0 otherwise
+ */
+static inline size_t glyph_renderer__quads_per_run(int effects) {
+#ifndef GLYPHGL_MINIMAL
+    return (effects & GLYPHGL_UNDERLINE) ? 1 : 0;
+#else
+    (void)effects;
+    return 0;
+#endif
+}
+
+/*
+ * Ensures a CPU-side batch buffer holds at least the requested elements
+ *
+ * Grows by at least half the current capacity so repeated appends stay
+ * amortized without doubling the footprint of one long string.
+ *
+ * Parameters:
+ *   renderer: Renderer owning the buffer (counts regrowths in GLYPHGL_STATS builds)
+ *   buffer: In/out pointer to the buffer
+ *   capacity: In/out capacity in elements
+ *   required: Elements needed
+ *   element_size: Size of one element in bytes
+ *
+ * Returns: 1 on success, 0 on allocation failure (buffer left untouched)
+ */
+static inline int glyph_renderer__reserve(glyph_renderer_t* renderer, void** buffer, size_t* capacity, size_t required, size_t element_size) {
+    (void)renderer;
+    if (required <= *capacity) return 1;
+    size_t new_capacity = *capacity + *capacity / 2;
+    if (new_capacity < required) new_capacity = required;
+    void* new_buffer = GLYPH_REALLOC(*buffer, new_capacity * element_size);
+    if (!new_buffer) {
+        GLYPH_LOG("Failed to grow batch buffer to %lu elements\n", (unsigned long)new_capacity);
+        return 0;
+    }
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+    GLYPH_STAT(renderer->stats.buffer_grows++);
+    return 1;
+}
+
+/*
+ * Returns the atlas that resolves codepoints for layout
+ *
+ * A plain renderer looks glyphs up in its own atlas; a collection renderer
+ * looks them up in the selected face, whose records live in the shared atlas.
+ */
+static inline glyph_atlas_t* glyph_renderer__lookup(const glyph_renderer_t* renderer) {
+    return renderer->lookup ? renderer->lookup : (glyph_atlas_t*)&renderer->atlas;
+}
+
+/*
+ * Decodes the next character of a string and resolves its atlas glyph
+ *
+ * Drawing and measurement both step through text with this, so they agree
+ * on fallback and kerning: missing characters become '?', and the pen
+ * moves by the pair adjustment against the previous character.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: String being laid out
+ *   index: In/out byte offset, moved past the character
+ *   prev_codepoint: In/out codepoint of the previous character (-1 for none)
+ *   pen_x: In/out pen position, kerned before the glyph
+ *   scale: Text scaling factor (1.0 = normal size)
+ *
+ * Returns: Atlas glyph, or NULL if neither the character nor '?' is available
+ */
+static inline glyph_atlas_char_t* glyph_renderer__next_glyph(glyph_renderer_t* renderer, const char* text, size_t* index,
+                                                             int* prev_codepoint, float* pen_x, float scale) {
+    /* Decode next character based on encoding type */
+    int codepoint;
+    if (renderer->char_type == GLYPH_ENCODING_UTF8) {
+        codepoint = glyph_utf8_decode(text, index); /* Handle multi-byte UTF-8 sequences */
+    } else {
+        codepoint = (unsigned char)text[*index]; /* Simple ASCII byte */
+        (*index)++;
+    }
+
+    /* Look up glyph data in atlas (rasterized on demand in dynamic atlases) */
+    glyph_atlas_t* atlas = glyph_renderer__lookup(renderer);
+    glyph_atlas_char_t* ch = glyph_atlas_get_char(atlas, codepoint);
+    if (!ch) {
+        /* Fallback to question mark for missing characters */
+        ch = glyph_atlas_get_char(atlas, '?');
+        GLYPH_STAT(renderer->stats.missing_glyphs++);
+    }
+
+    /* Apply pair kerning against the previous character */
+    if (ch && *prev_codepoint >= 0) *pen_x += glyph_atlas_get_kerning(atlas, *prev_codepoint, ch->codepoint) * scale;
+    *prev_codepoint = ch ? ch->codepoint : -1;
+    return ch;
+}
+
+/*
+ * Returns how far the pen moves past a glyph
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   ch: Glyph from glyph_renderer__next_glyph (NULL advances half an em)
+ *   scale: Text scaling factor (1.0 = normal size)
+ */
+static inline float glyph_renderer__advance(const glyph_renderer_t* renderer, const glyph_atlas_char_t* ch, float scale) {
+    return ch ? ch->advance * scale : glyph_renderer__lookup(renderer)->pixel_height * 0.5f * scale;
+}
+
+/*
+ * Writes the quads of one glyph
+ *
+ * Bold widens the quad by one atlas texel for the fragment stage to fill
+ * (or adds an offset copy under effect shaders); underline is drawn once
+ * per run by glyph_renderer__emit_underline.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   out: Destination with room for 6 * glyph_renderer__quads_per_glyph vertices
+ *   ch: Glyph to draw (NULL or empty glyphs write nothing)
+ *   pen_x, y: Pen position on the baseline
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   color: Vertex color bytes (RGB)
+ *   flags: Effects bitmask stored in every vertex
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: Number of vertices written
+ */
+static inline size_t glyph_renderer__emit_glyph(const glyph_renderer_t* renderer, glyph_vertex_t* out, const glyph_atlas_char_t* ch,
+                                                float pen_x, float y, float scale, const unsigned char color[3], unsigned char flags, int effects) {
+    if (!ch || ch->width == 0) return 0; /* Whitespace and missing glyphs only advance the pen */
+    size_t vertex_count = 0;
+
+    /* Calculate glyph quad position and size in screen space */
+    float xpos = pen_x + ch->xoff * scale;     /* Apply left bearing offset */
+    float ypos = y - ch->yoff * scale;         /* Apply baseline offset (inverted Y) */
+    float w = ch->width * scale;               /* Scaled glyph width */
+    float h = ch->height * scale;              /* Scaled glyph height */
+
+    /* Calculate texture coordinates for glyph in atlas */
+    float tex_x1 = (float)ch->x / renderer->atlas.image.width;
+    float tex_y1 = (float)ch->y / renderer->atlas.image.height;
+    float tex_x2 = (float)(ch->x + ch->width) / renderer->atlas.image.width;
+    float tex_y2 = (float)(ch->y + ch->height) / renderer->atlas.image.height;
+
+    /* Apply italic effect by shearing the top edge of the glyph quad (costs no extra vertices) */
+    float shear = 0.0f;
+#ifndef GLYPHGL_MINIMAL
+    if (effects & GLYPHGL_ITALIC) {
+        shear = 0.2f * h; /* Shear factor for italic slant */
+    }
+
+    if (effects & GLYPHGL_BOLD) {
+        float bold_offset = 1.0f * scale; /* One atlas texel of extra thickness */
+        if (!glyph_renderer__shader_bold(renderer)) {
+            /* Effect shaders cannot thicken the glyph: draw a duplicate with offset */
+            glyph_renderer__emit_quad(out + vertex_count, xpos + bold_offset, ypos, w, h, tex_x1, tex_y1, tex_x2, tex_y2, shear, color, flags);
+            vertex_count += 6;
+        } else {
+            /* Extend the quad into the right padding; the fragment stage draws the offset copy there */
+            w += bold_offset;
+            tex_x2 = (float)(ch->x + ch->width + 1) / renderer->atlas.image.width;
+        }
+    }
+#else
+    (void)effects;
+#endif
+
+    /* Build vertex data for glyph quad directly in the batch buffer */
+    glyph_renderer__emit_quad(out + vertex_count, xpos, ypos, w, h, tex_x1, tex_y1, tex_x2, tex_y2, shear, color, flags);
+    vertex_count += 6;
+    return vertex_count;
+}
+
+/*
+ * Returns the top edge of the underline drawn beneath a baseline
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   y: Screen Y coordinate of the text baseline
+ *   scale: Text scaling factor (1.0 = normal size)
+ */
+static inline float glyph_renderer__underline_y(const glyph_renderer_t* renderer, float y, float scale) {
+    return y + glyph_renderer__lookup(renderer)->pixel_height * scale * 0.07f; /* Slightly below the baseline */
+}
+
+/*
+ * Writes the underline of a run as one quad spanning its pen range
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   out: Destination with room for 6 vertices
+ *   x0, x1: Pen positions at the start and end of the run
+ *   y: Screen Y coordinate of the text baseline
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   color: Vertex color bytes (RGB)
+ *   flags: Effects bitmask stored in every vertex
+ *
+ * Returns: Number of vertices written (0 for an empty run)
+ */
+static inline size_t glyph_renderer__emit_underline(const glyph_renderer_t* renderer, glyph_vertex_t* out, float x0, float x1,
+                                                    float y, float scale, const unsigned char color[3], unsigned char flags) {
+    if (x1 <= x0) return 0;
+    /* (-1, -1) texture coordinates tell the shader to skip sampling */
+    glyph_renderer__emit_quad(out, x0, glyph_renderer__underline_y(renderer, y, scale), x1 - x0, 2.0f,
+                              -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, color, flags);
+    return 6;
+}
+
+/*
+ * Builds the instance fields shared by every glyph of a string
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects
+ *
+ * Returns: Instance with scale, color and flags set
+ */
+static inline glyph_instance_t glyph_renderer__instance_base(const glyph_renderer_t* renderer, float scale, float r, float g, float b, int effects) {
+    glyph_instance_t base;
+    float scale_q = scale * 256.0f + 0.5f;
+    base.x = 0.0f;
+    base.y = 0.0f;
+    base.glyph = 0;
+    base.scale = (unsigned short)(scale_q <= 0.0f ? 0.0f : (scale_q >= 65535.0f ? 65535.0f : scale_q));
+    base.r = glyph_renderer__color_byte(r);
+    base.g = glyph_renderer__color_byte(g);
+    base.b = glyph_renderer__color_byte(b);
+#ifndef GLYPHGL_MINIMAL
+    base.flags = (unsigned char)((effects | (renderer->atlas.msdf ? GLYPHGL_MSDF : 0)) & 0x7F);
+#else
+    base.flags = (unsigned char)((effects | (renderer->atlas.msdf ? GLYPHGL_MSDF : 0)) & 0x7F & ~GLYPHGL_ITALIC); /* Minimal mode has no italic shear */
+#endif
+    return base;
+}
+
+/*
+ * Writes the instances of one glyph: the glyph, plus a bold copy under effect shaders
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   out: Destination with room for glyph_renderer__quads_per_glyph instances
+ *   ch: Glyph to draw (NULL or empty glyphs write nothing)
+ *   pen_x, y: Pen position on the baseline
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   base: Shared fields from glyph_renderer__instance_base
+ *   effects: Bitmask of text effects
+ *
+ * Returns: Number of instances written
+ */
+static inline size_t glyph_renderer__emit_instances(const glyph_renderer_t* renderer, glyph_instance_t* out, const glyph_atlas_char_t* ch,
+                                                    float pen_x, float y, float scale, const glyph_instance_t* base, int effects) {
+    size_t index = ch ? (size_t)(ch - renderer->atlas.chars) : 0;
+    if (!ch || ch->width == 0 || index > 0xFFFF) return 0;
+    size_t instance_count = 0;
+
+    out[instance_count] = *base;
+    out[instance_count].x = pen_x;
+    out[instance_count].y = y;
+    out[instance_count++].glyph = (unsigned short)index;
+
+#ifndef GLYPHGL_MINIMAL
+    if ((effects & GLYPHGL_BOLD) && !glyph_renderer__shader_bold(renderer)) {
+        out[instance_count] = out[0];
+        out[instance_count++].x += 1.0f * scale; /* Same offset as the vertex path */
+    }
+#else
+    (void)scale;
+    (void)effects;
+#endif
+    return instance_count;
+}
+
+/*
+ * Writes the underline of a run as one instance spanning its pen range
+ *
+ * Underline instances are flagged with bit 7 and carry their width in
+ * quarter pixels in place of the glyph index (runs are capped at 16383
+ * pixels); their position is the underline's top-left corner.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   out: Destination with room for 1 instance
+ *   x0, x1: Pen positions at the start and end of the run
+ *   y: Screen Y coordinate of the text baseline
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   base: Shared fields from glyph_renderer__instance_base
+ *
+ * Returns: Number of instances written (0 for an empty run)
+ */
+static inline size_t glyph_renderer__emit_underline_instance(const glyph_renderer_t* renderer, glyph_instance_t* out, float x0, float x1,
+                                                             float y, float scale, const glyph_instance_t* base) {
+    float width_q = (x1 - x0) * 4.0f + 0.5f;
+    if (width_q < 1.0f) return 0;
+    *out = *base;
+    out->x = x0;
+    out->y = glyph_renderer__underline_y(renderer, y, scale);
+    out->glyph = (unsigned short)(width_q >= 65535.0f ? 65535.0f : width_q);
+    out->flags |= 0x80;
+    return 1;
+}
+
+/*
+ * Lays out a string and appends its glyph quads to the CPU vertex buffer
+ *
+ * Vertices are written after those already queued and carry the color and
+ * effects, so strings with different styles can share one draw call. The
+ * buffer grows to exactly what the string can emit: 6 vertices per
+ * character (12 for bold under effect shaders) plus 6 for an underline.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to lay out (whole characters only)
+ *   text_len: Length of text in bytes
+ *   pen_x: In/out horizontal pen position, left after the last character
+ *   prev_codepoint: In/out codepoint laid out just before text (-1 for none),
+ *                   kerned against the first character
+ *   y: Screen Y coordinate of the text baseline
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: Number of vertices appended, or (size_t)-1 on allocation failure
+ */
+static inline size_t glyph_renderer__append_text(glyph_renderer_t* renderer, const char* text, size_t text_len, float* pen_x, int* prev_codepoint,
+                                                 float y, float scale, float r, float g, float b, int effects) {
+    /* Size the batch buffer from the character count and the active effects */
+    size_t required = renderer->queued_count + 6 * (glyph_renderer__quads_per_glyph(renderer, effects) * glyph_renderer__glyph_count(renderer, text, text_len) +
+                                                    glyph_renderer__quads_per_run(effects));
+    if (!glyph_renderer__reserve(renderer, (void**)&renderer->vertex_buffer, &renderer->vertex_buffer_size, required, sizeof(glyph_vertex_t))) {
+        return (size_t)-1; /* Memory allocation failure - skip rendering */
+    }
+    glyph_vertex_t* vertices = renderer->vertex_buffer + renderer->queued_count;
+    size_t vertex_count = 0;
+
+    const unsigned char color[3] = {glyph_renderer__color_byte(r), glyph_renderer__color_byte(g), glyph_renderer__color_byte(b)};
+    const unsigned char flags = (unsigned char)((effects | (renderer->atlas.msdf ? GLYPHGL_MSDF : 0)) & 0xFF);
+
+    /* Process each character in the text string */
+    float current_x = *pen_x; /* Track horizontal position for kerning */
+    size_t i = 0;
+    while (i < text_len) {
+        glyph_atlas_char_t* ch = glyph_renderer__next_glyph(renderer, text, &i, prev_codepoint, &current_x, scale);
+        vertex_count += glyph_renderer__emit_glyph(renderer, vertices + vertex_count, ch, current_x, y, scale, color, flags, effects);
+        GLYPH_STAT(renderer->stats.glyphs++);
+
+        /* Advance cursor to next character position */
+        current_x += glyph_renderer__advance(renderer, ch, scale);
+    }
+
+    /* One underline for the whole string instead of one per glyph */
+    if (glyph_renderer__quads_per_run(effects)) {
+        vertex_count += glyph_renderer__emit_underline(renderer, vertices + vertex_count, *pen_x, current_x, y, scale, color, flags);
+    }
+
+    renderer->queued_count += vertex_count;
+    *pen_x = current_x;
+    return vertex_count;
+}
+
+/*
+ * Lays out a string as glyph instances for the instanced render path
+ *
+ * Emits one instance per visible glyph and one underline instance per
+ * string; the vertex shader derives the quads from the metrics texture.
+ *
+ * Parameters: Same as glyph_renderer__append_text
+ *
+ * Returns: Number of instances appended, or (size_t)-1 on allocation failure
+ */
+static inline size_t glyph_renderer__append_instances(glyph_renderer_t* renderer, const char* text, size_t text_len, float* pen_x, int* prev_codepoint,
+                                                      float y, float scale, float r, float g, float b, int effects) {
+    size_t required = renderer->queued_count + glyph_renderer__quads_per_glyph(renderer, effects) * glyph_renderer__glyph_count(renderer, text, text_len) +
+                      glyph_renderer__quads_per_run(effects);
+    if (!glyph_renderer__reserve(renderer, (void**)&renderer->instance_buffer, &renderer->instance_buffer_size, required, sizeof(glyph_instance_t))) {
+        return (size_t)-1;
+    }
+    glyph_instance_t* instances = renderer->instance_buffer + renderer->queued_count;
+    size_t instance_count = 0;
+    glyph_instance_t base = glyph_renderer__instance_base(renderer, scale, r, g, b, effects);
+
+    float current_x = *pen_x;
+    size_t i = 0;
+    while (i < text_len) {
+        glyph_atlas_char_t* ch = glyph_renderer__next_glyph(renderer, text, &i, prev_codepoint, &current_x, scale);
+        instance_count += glyph_renderer__emit_instances(renderer, instances + instance_count, ch, current_x, y, scale, &base, effects);
+        GLYPH_STAT(renderer->stats.glyphs++);
+        current_x += glyph_renderer__advance(renderer, ch, scale);
+    }
+    if (glyph_renderer__quads_per_run(effects)) {
+        instance_count += glyph_renderer__emit_underline_instance(renderer, instances + instance_count, *pen_x, current_x, y, scale, &base);
+    }
+
+    renderer->queued_count += instance_count;
+    *pen_x = current_x;
+    return instance_count;
+}
+
+/*
+ * Appends the glyphs of a measured layout for whichever render path is active
+ *
+ * Static atlases reuse the stored glyph indices; dynamic atlases resolve
+ * each codepoint again so evicted glyphs come back and used ones stay
+ * resident.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   glyphs: Positions from glyph_renderer_measure_text
+ *   count: Number of positions
+ *   x, y: Screen coordinates of the text baseline start
+ *   scale: Scale the layout was measured with
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: Number of vertices or instances appended, or (size_t)-1 on
+ *          allocation failure
+ */
+static inline size_t glyph_renderer__append_layout(glyph_renderer_t* renderer, const glyph_layout_glyph_t* glyphs, size_t count,
+                                                   float x, float y, float scale, float r, float g, float b, int effects) {
+    size_t per_quad = renderer->instanced ? 1 : 6;
+    size_t required = renderer->queued_count + per_quad * (glyph_renderer__quads_per_glyph(renderer, effects) * count + glyph_renderer__quads_per_run(effects));
+    int reserved = renderer->instanced
+        ? glyph_renderer__reserve(renderer, (void**)&renderer->instance_buffer, &renderer->instance_buffer_size, required, sizeof(glyph_instance_t))
+        : glyph_renderer__reserve(renderer, (void**)&renderer->vertex_buffer, &renderer->vertex_buffer_size, required, sizeof(glyph_vertex_t));
+    if (!reserved) return (size_t)-1;
+
+    const unsigned char color[3] = {glyph_renderer__color_byte(r), glyph_renderer__color_byte(g), glyph_renderer__color_byte(b)};
+    const unsigned char flags = (unsigned char)((effects | (renderer->atlas.msdf ? GLYPHGL_MSDF : 0)) & 0xFF);
+    glyph_instance_t base = glyph_renderer__instance_base(renderer, scale, r, g, b, effects);
+
+    size_t emitted = 0;
+    for (size_t i = 0; i < count; i++) {
+        const glyph_layout_glyph_t* glyph = &glyphs[i];
+        if (glyph->codepoint < 0) continue;
+        const glyph_atlas_char_t* ch = NULL;
+        if (!renderer->atlas.cache && glyph->index >= 0 && glyph->index < renderer->atlas.num_chars &&
+            renderer->atlas.chars[glyph->index].codepoint == glyph->codepoint) {
+            ch = &renderer->atlas.chars[glyph->index];
+        } else {
+            ch = glyph_atlas_get_char(glyph_renderer__lookup(renderer), glyph->codepoint);
+        }
+
+        if (renderer->instanced) {
+            emitted += glyph_renderer__emit_instances(renderer, renderer->instance_buffer + renderer->queued_count + emitted, ch,
+                                                      x + glyph->x, y, scale, &base, effects);
+        } else {
+            emitted += glyph_renderer__emit_glyph(renderer, renderer->vertex_buffer + renderer->queued_count + emitted, ch,
+                                                  x + glyph->x, y, scale, color, flags, effects);
+        }
+    }
+
+    GLYPH_STAT(renderer->stats.glyphs += count);
+
+    /* Underline from the first pen position to the end of the last advance */
+    if (glyph_renderer__quads_per_run(effects) && count > 0) {
+        float x0 = x + glyphs[0].x;
+        float x1 = x + glyphs[count - 1].x + glyphs[count - 1].advance;
+        if (renderer->instanced) {
+            emitted += glyph_renderer__emit_underline_instance(renderer, renderer->instance_buffer + renderer->queued_count + emitted,
+                                                               x0, x1, y, scale, &base);
+        } else {
+            emitted += glyph_renderer__emit_underline(renderer, renderer->vertex_buffer + renderer->queued_count + emitted,
+                                                      x0, x1, y, scale, color, flags);
+        }
+    }
+
+    renderer->queued_count += emitted;
+    return emitted;
+}
+
+/*
+ * Lays out a string for whichever render path is active
+ *
+ * Returns: Number of vertices or instances appended, or (size_t)-1 on
+ *          allocation failure
+ */
+static inline size_t glyph_renderer__append(glyph_renderer_t* renderer, const char* text, size_t text_len, float* pen_x, int* prev_codepoint,
+                                            float y, float scale, float r, float g, float b, int effects) {
+    if (renderer->instanced) return glyph_renderer__append_instances(renderer, text, text_len, pen_x, prev_codepoint, y, scale, r, g, b, effects);
+    return glyph_renderer__append_text(renderer, text, text_len, pen_x, prev_codepoint, y, scale, r, g, b, effects);
+}
+
+/*
+ * Brings the per-frame inputs of the bound program up to date
+ *
+ * Uploads the animation time when the program declares it and it changed
+ * since the program last saw it. In GLYPHGL_UNIFORM_BUFFER builds, binds
+ * the GlyphFrame buffer and refreshes it after a projection change.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   uniforms: Uniform locations of the bound program
+ */
+static inline void glyph_renderer__apply_frame(glyph_renderer_t* renderer, glyph_renderer__uniforms_t* uniforms) {
+    if (uniforms->time >= 0 && uniforms->cached_time != renderer->time) {
+        glyph__glUniform1f(uniforms->time, renderer->time);
+        uniforms->cached_time = renderer->time;
+    }
+#ifdef GLYPHGL_UNIFORM_BUFFER
+    if (uniforms->frame_block == GL_INVALID_INDEX) return;
+    glyph__gl_bind_uniform_buffer(renderer->frame_ubo);
+    if (renderer->frame_dirty) {
+        glyph__glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(renderer->projection), renderer->projection);
+        renderer->frame_dirty = 0;
+    }
+#endif
+}
+
+/*
+ * Makes a renderer program current and re-sends uniforms it may have lost
+ *
+ * Programs are shared between renderers (glyph__program_acquire), so when
+ * another renderer set uniforms on this one since, or the renderer changed
+ * its projection or effect, every cached uniform value is re-sent.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   program: renderer->shader or renderer->instance_shader
+ *   uniforms: Uniform locations of program
+ */
+static inline void glyph_renderer__use_program(glyph_renderer_t* renderer, GLuint program, glyph_renderer__uniforms_t* uniforms) {
+    glyph__gl_use_program(program);
+    int claimed = glyph__program_claim(program, renderer);
+    if (claimed || uniforms->stale) {
+        if (uniforms->projection >= 0) glyph__glUniformMatrix4fv(uniforms->projection, 1, GL_FALSE, renderer->projection);
+        if (uniforms->time >= 0 && renderer->has_time) {
+            glyph__glUniform1f(uniforms->time, renderer->time);
+            uniforms->cached_time = renderer->time;
+        }
+        if (uniforms == &renderer->uniforms) renderer->cached_transform[0] = -1.0f;
+        renderer->cached_text_color[0] = -1.0f;
+        renderer->cached_effects = -1;
+        uniforms->stale = 0;
+    }
+    glyph_renderer__apply_frame(renderer, uniforms);
+}
+
+/*
+ * Binds the program, VAO and textures of the active render path
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__bind(glyph_renderer_t* renderer) {
+    if (renderer->instanced) {
+        glyph_renderer__use_program(renderer, renderer->instance_shader, &renderer->instance_uniforms);
+        glyph__gl_bind_vertex_array(renderer->instance_vao);
+        glyph__gl_bind_texture(1, renderer->metrics_texture);
+    } else {
+        glyph_renderer__use_program(renderer, renderer->shader, &renderer->uniforms);
+        glyph__gl_bind_vertex_array(renderer->vao);
+        glyph_renderer__set_transform(renderer, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+    }
+    glyph__gl_bind_texture(0, renderer->texture);
+}
+
+/*
+ * Uploads per-glyph metrics for the instanced path
+ *
+ * Each glyph takes two RGBA32F texels, 256 glyphs per row:
+ * (atlas x, atlas y, width, height) and (xoff, yoff, advance, 0).
+ * The texture grows in whole rows as a dynamic atlas gains entries.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__upload_metrics(glyph_renderer_t* renderer) {
+    int count = renderer->atlas.num_chars;
+    renderer->metrics_dirty = 0;
+    if (count <= 0) return;
+
+    int rows = (count + 255) / 256;
+    float* data = (float*)GLYPH_MALLOC((size_t)rows * 256 * 8 * sizeof(float));
+    if (!data) {
+        renderer->metrics_dirty = 1; /* Retry on the next draw */
+        return;
+    }
+    memset(data, 0, (size_t)rows * 256 * 8 * sizeof(float));
+    for (int i = 0; i < count; i++) {
+        const glyph_atlas_char_t* ch = &renderer->atlas.chars[i];
+        float* texels = data + (size_t)i * 8;
+        texels[0] = (float)ch->x;
+        texels[1] = (float)ch->y;
+        texels[2] = (float)ch->width;
+        texels[3] = (float)ch->height;
+        texels[4] = (float)ch->xoff;
+        texels[5] = (float)ch->yoff;
+        texels[6] = (float)ch->advance;
+    }
+
+    glyph__gl_bind_texture(1, renderer->metrics_texture);
+    if (count > renderer->metrics_capacity) {
+        renderer->metrics_capacity = rows * 256;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 512, rows, 0, GL_RGBA, GL_FLOAT, NULL);
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 512, rows, GL_RGBA, GL_FLOAT, data);
+    GLYPH_STAT(renderer->stats.texture_bytes += (size_t)rows * 256 * 8 * sizeof(float));
+    glyph__gl_active_texture(0);
+    GLYPH_FREE(data);
+}
+
+/*
+ * Brings the atlas texture (and glyph metrics when instanced) up to date
+ *
+ * Atlas changes mark the metrics dirty even on the vertex path, so grids
+ * and a later switch to instancing see the new glyphs. Expects the atlas
+ * texture to be bound to GL_TEXTURE_2D on unit 0.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__prepare_textures(glyph_renderer_t* renderer) {
+    if (glyph_renderer__upload_atlas(renderer)) renderer->metrics_dirty = 1;
+    if (renderer->instanced && renderer->metrics_dirty) glyph_renderer__upload_metrics(renderer);
+}
+
+/*
+ * Streams queued vertices or instances of the active path to the GPU
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   first: First queued element to upload
+ *   count: Number of elements
+ *
+ * Returns: GPU index of the first element, or -1 if it could not be uploaded
+ */
+static inline GLint glyph_renderer__stream_queued(glyph_renderer_t* renderer, size_t first, size_t count) {
+    if (renderer->instanced) {
+        return glyph_renderer__stream_vertices(renderer, renderer->instance_buffer + first, count, sizeof(glyph_instance_t));
+    }
+    return glyph_renderer__stream_vertices(renderer, renderer->vertex_buffer + first, count, sizeof(glyph_vertex_t));
+}
+
+#ifdef GLYPHGL_STATS
+/*
+ * Adds finished timer queries to the GPU time, oldest first
+ *
+ * Stops at the first query whose result is not available yet, so this
+ * never waits for the GPU.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__stats_collect(glyph_renderer_t* renderer) {
+    while (renderer->queries_pending > 0) {
+        int slot = (renderer->query_head - renderer->queries_pending + GLYPHGL_STATS_QUERIES) % GLYPHGL_STATS_QUERIES;
+        GLint available = 0;
+        glyph__glGetQueryObjectiv(renderer->queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return;
+
+        glyph__gl_uint64_t elapsed = 0;
+        glyph__glGetQueryObjectui64v(renderer->queries[slot], GL_QUERY_RESULT, &elapsed);
+        renderer->stats.gpu_ms += (double)elapsed / 1000000.0;
+        renderer->stats.gpu_samples++;
+        renderer->queries_pending--;
+    }
+}
+
+/*
+ * Starts timing the next draw when GPU timing is enabled
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: 1 if a GL_TIME_ELAPSED query was begun (end it after the draw),
+ *          0 when timing is off or every query of the ring is still in flight
+ */
+static inline int glyph_renderer__stats_query_begin(glyph_renderer_t* renderer) {
+    if (!renderer->gpu_timing) return 0;
+    if (renderer->queries_pending == GLYPHGL_STATS_QUERIES) {
+        glyph_renderer__stats_collect(renderer);
+        if (renderer->queries_pending == GLYPHGL_STATS_QUERIES) return 0; /* Draw goes untimed */
+    }
+    glyph__glBeginQuery(GL_TIME_ELAPSED, renderer->queries[renderer->query_head]);
+    renderer->query_head = (renderer->query_head + 1) % GLYPHGL_STATS_QUERIES;
+    renderer->queries_pending++;
+    return 1;
+}
+#endif
+
+/*
+ * Draws streamed elements of the active path
+ *
+ * Instanced draws re-point the per-instance attributes at the batch instead
+ * of relying on base-instance draws (GL 4.2). Expects the path's VAO bound.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   first: GPU index of the first element (from glyph_renderer__stream_queued)
+ *   count: Number of elements
+ */
+static inline void glyph_renderer__draw_range(glyph_renderer_t* renderer, GLint first, size_t count) {
+    GLYPH_STAT(renderer->stats.draw_calls++);
+    GLYPH_STAT(int timed = glyph_renderer__stats_query_begin(renderer));
+    if (!renderer->instanced) {
+        glDrawArrays(GL_TRIANGLES, first, (GLsizei)count);
+        GLYPH_STAT(if (timed) glyph__glEndQuery(GL_TIME_ELAPSED));
+        return;
+    }
+
+    size_t offset = (size_t)first * sizeof(glyph_instance_t);
+    GLsizei stride = (GLsizei)sizeof(glyph_instance_t);
+    glyph__gl_bind_array_buffer(renderer->vbo);
+    glyph__glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(glyph_instance_t, x)));
+    glyph__glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_FALSE, stride, (void*)(offset + offsetof(glyph_instance_t, glyph)));
+    glyph__glVertexAttribPointer(3, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(offset + offsetof(glyph_instance_t, r)));
+    glyph__glVertexAttribPointer(4, 1, GL_UNSIGNED_BYTE, GL_FALSE, stride, (void*)(offset + offsetof(glyph_instance_t, flags)));
+    glyph__gl_unbind_array_buffer();
+    glyph__glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)count);
+    GLYPH_STAT(if (timed) glyph__glEndQuery(GL_TIME_ELAPSED));
+}
+
+/*
+ * Updates the textColor/effects uniforms read by custom effect shaders
+ *
+ * Built-in shaders take color and effects from the vertices instead, so this
+ * is only called when the program declares the uniforms.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (program bound)
+ *   r, g, b: Text color
+ *   effects: Effects bitmask
+ */
+static inline void glyph_renderer__set_color_uniforms(glyph_renderer_t* renderer, float r, float g, float b, int effects) {
+    const glyph_renderer__uniforms_t* uniforms = renderer->instanced ? &renderer->instance_uniforms : &renderer->uniforms;
+
+    /* Performance optimization: Only update uniforms if values have changed */
+    if (renderer->cached_text_color[0] != r || renderer->cached_text_color[1] != g || renderer->cached_text_color[2] != b) {
+        glyph__glUniform3f(uniforms->text_color, r, g, b);
+        renderer->cached_text_color[0] = r;
+        renderer->cached_text_color[1] = g;
+        renderer->cached_text_color[2] = b;
+    }
+#ifndef GLYPHGL_MINIMAL
+    if (renderer->cached_effects != effects) {
+        glyph__glUniform1i(uniforms->effects, effects);
+        renderer->cached_effects = effects;
+    }
+#else
+    (void)effects;
+#endif
+}
+
+/*
+ * Returns how many elements of the active path one upload can hold
+ *
+ * The cap is one stream region (GLYPHGL_VERTEX_BUFFER_SIZE vertices), less
+ * one element of alignment slack in the ring modes. On the vertex path it
+ * is rounded down to whole quads so chunks never split a glyph.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: Maximum element count per glyph_renderer__stream_queued call
+ */
+static inline size_t glyph_renderer__chunk_capacity(const glyph_renderer_t* renderer) {
+    size_t stride = renderer->instanced ? sizeof(glyph_instance_t) : sizeof(glyph_vertex_t);
+    size_t capacity = renderer->stream_region_size / stride;
+    if (renderer->stream_mode != GLYPH_STREAM_SUBDATA && capacity > 0) capacity--;
+    if (!renderer->instanced) capacity -= capacity % 6;
+    return capacity > 0 ? capacity : 1;
+}
+
+/*
+ * Uploads and draws a range of queued elements, chunked to the GPU buffer
+ *
+ * Ranges longer than glyph_renderer__chunk_capacity are streamed and drawn
+ * piece by piece, so no string or batch is ever too long to draw. With
+ * use_runs set, each chunk is drawn as the parts of the batch's style runs
+ * it covers, after setting that run's uniforms.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (path bound)
+ *   first: First queued element
+ *   count: Number of elements
+ *   use_runs: Nonzero to draw per style run (uniform-driven shaders)
+ */
+static inline void glyph_renderer__submit(glyph_renderer_t* renderer, size_t first, size_t count, int use_runs) {
+    size_t chunk = glyph_renderer__chunk_capacity(renderer);
+    int run = 0;
+    for (size_t done = 0; done < count; done += chunk) {
+        size_t start = first + done;
+        size_t n = count - done < chunk ? count - done : chunk;
+        GLint gpu_first = glyph_renderer__stream_queued(renderer, start, n);
+        if (gpu_first < 0) return;
+
+        if (!use_runs) {
+            glyph_renderer__draw_range(renderer, gpu_first, n);
+            continue;
+        }
+
+        /* Runs are sorted and contiguous: skip those that ended in earlier chunks */
+        while (run < renderer->num_runs && renderer->runs[run].first + renderer->runs[run].count <= start) run++;
+        for (int i = run; i < renderer->num_runs && renderer->runs[i].first < start + n; i++) {
+            glyph_renderer__run_t* r = &renderer->runs[i];
+            size_t run_start = r->first > start ? r->first : start;
+            size_t run_end = r->first + r->count < start + n ? r->first + r->count : start + n;
+            glyph_renderer__set_color_uniforms(renderer, r->r, r->g, r->b, r->effects);
+            glyph_renderer__draw_range(renderer, gpu_first + (GLint)(run_start - start), run_end - run_start);
+        }
+    }
+}
+
+/*
+ * Finds where the next layout segment of an immediate draw ends
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (selects the encoding)
+ *   text: String being drawn
+ *   pos: Byte offset of the segment start
+ *   text_len: Length of text in bytes
+ *   max_chars: Maximum characters in the segment
+ *
+ * Returns: Byte offset just past the segment, on a character boundary
+ */
+static inline size_t glyph_renderer__segment_end(const glyph_renderer_t* renderer, const char* text, size_t pos, size_t text_len, size_t max_chars) {
+    if (renderer->char_type != GLYPH_ENCODING_UTF8) return text_len - pos < max_chars ? text_len : pos + max_chars;
+    for (size_t chars = 0; pos < text_len && chars < max_chars; chars++) {
+        pos++;
+        while (pos < text_len && ((unsigned char)text[pos] & 0xC0) == 0x80) pos++;
+    }
+    return pos;
+}
+
+/*
+ * Renders text to the screen with specified styling and effects
+ *
+ * This is the core rendering function that processes text strings, looks up
+ * glyph data from the atlas, applies text effects, and batches everything
+ * into a single OpenGL draw call for optimal performance. To draw many
+ * strings with one call, use glyph_renderer_begin/queue_text/flush instead.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to render
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
  *
  * Performance features:
  * - Vertex batching: All glyphs rendered in single draw call
  * - Uniform caching: Only updates shader uniforms when values change
- * - Dynamic buffer growth: Expands vertex buffer as needed
+ * - Bounded buffers: Strings longer than one GPU upload are laid out and
+ *   drawn in segments, so memory use does not grow with string length
  * - Effect stacking: Multiple effects can be applied simultaneously
  */
-static inline void glyph_renderer_draw_text(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
-                                  float r, float g, float b, int effects) {
-    /* Validate renderer state */
-    if (!renderer || !renderer->initialized) return;
+static inline void glyph_renderer_draw_text(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
+                                  float r, float g, float b, int effects) {
+    /* Validate renderer state */
+    if (!renderer || !renderer->initialized) return;
+
+    /* Bind shader program and OpenGL state for rendering */
+    glyph_renderer__bind(renderer);
+    if (renderer->color_uniforms) glyph_renderer__set_color_uniforms(renderer, r, g, b, effects);
+
+    /* Start a new use period so glyphs of this string are not evicted while it is built.
+       Inside a batch the period started at glyph_renderer_begin, protecting queued strings too. */
+    if (!renderer->batching) glyph_atlas_cache_tick(&renderer->atlas);
+
+    /* Lay out after any queued strings, which stay untouched, one GPU upload worth of characters at a time */
+    size_t first = renderer->queued_count;
+    size_t text_len = strlen(text);
+    size_t per_quad = renderer->instanced ? 1 : 6;
+    size_t per_char = glyph_renderer__quads_per_glyph(renderer, effects) * per_quad;
+    size_t run_quads = glyph_renderer__quads_per_run(effects) * per_quad; /* Each segment draws its own underline */
+    size_t capacity = glyph_renderer__chunk_capacity(renderer);
+    size_t segment_chars = capacity > run_quads ? (capacity - run_quads) / per_char : 0;
+    if (segment_chars == 0) segment_chars = 1;
+
+    float pen_x = x;
+    int prev_codepoint = -1; /* Carried across segments so kerning does not break at their seams */
+    size_t pos = 0;
+    while (pos < text_len) {
+        size_t end = glyph_renderer__segment_end(renderer, text, pos, text_len, segment_chars);
+        size_t vertex_count = glyph_renderer__append(renderer, text + pos, end - pos, &pen_x, &prev_codepoint, y, scale, r, g, b, effects);
+        if (vertex_count == (size_t)-1) break;
+
+        /* Push newly cached glyphs to the texture before drawing */
+        glyph_renderer__prepare_textures(renderer);
+
+        /* Upload batched vertex data to GPU and execute draw call - usually a single one */
+        if (vertex_count > 0) glyph_renderer__submit(renderer, first, vertex_count, 0);
+        renderer->queued_count = first;
+        pos = end;
+    }
+
+    /* Clean up OpenGL state */
+    glyph__gl_release();
+}
+
+/*
+ * Starts a frame-level text batch
+ *
+ * Strings queued with glyph_renderer_queue_text are accumulated in the CPU
+ * vertex buffer and submitted together by glyph_renderer_flush. Dynamic atlas
+ * glyphs used anywhere in the batch stay resident until the flush.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer_begin(glyph_renderer_t* renderer) {
+    if (!renderer || !renderer->initialized) return;
+
+    renderer->batching = 1;
+    renderer->queued_count = 0;
+    renderer->num_runs = 0;
+    glyph_atlas_cache_tick(&renderer->atlas);
+}
+
+/*
+ * Records the style of elements just queued for uniform-driven shaders
+ *
+ * Extends the last run when the style matches, otherwise starts a new one.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   first: First vertex (or instance) queued
+ *   count: Vertices (or instances) queued
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects
+ */
+static inline void glyph_renderer__add_run(glyph_renderer_t* renderer, size_t first, size_t count, float r, float g, float b, int effects) {
+    /* Uniform-driven shaders need one draw per style: extend the last run or start a new one */
+    if (renderer->num_runs > 0) {
+        glyph_renderer__run_t* last = &renderer->runs[renderer->num_runs - 1];
+        if (last->r == r && last->g == g && last->b == b && last->effects == effects) {
+            last->count += count;
+            return;
+        }
+    }
+    if (renderer->num_runs == renderer->runs_capacity) {
+        int new_capacity = renderer->runs_capacity ? renderer->runs_capacity * 2 : 16;
+        glyph_renderer__run_t* new_runs = (glyph_renderer__run_t*)GLYPH_REALLOC(renderer->runs, new_capacity * sizeof(glyph_renderer__run_t));
+        if (!new_runs) {
+            renderer->queued_count = first; /* Drop the string rather than draw it with the wrong style */
+            return;
+        }
+        renderer->runs = new_runs;
+        renderer->runs_capacity = new_capacity;
+    }
+    glyph_renderer__run_t* run = &renderer->runs[renderer->num_runs++];
+    run->first = first;
+    run->count = count;
+    run->r = r;
+    run->g = g;
+    run->b = b;
+    run->effects = effects;
+}
+
+/*
+ * Queues a string for the current batch without issuing any GL calls
+ *
+ * Starts a batch implicitly if glyph_renderer_begin was not called.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to render
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ */
+static inline void glyph_renderer_queue_text(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
+                                             float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized) return;
+    if (!renderer->batching) glyph_renderer_begin(renderer);
+
+    size_t first = renderer->queued_count;
+    float pen_x = x;
+    int prev_codepoint = -1;
+    size_t vertex_count = glyph_renderer__append(renderer, text, strlen(text), &pen_x, &prev_codepoint, y, scale, r, g, b, effects);
+    if (vertex_count == 0 || vertex_count == (size_t)-1 || !renderer->color_uniforms) return;
+    glyph_renderer__add_run(renderer, first, vertex_count, r, g, b, effects);
+}
+
+/*
+ * Submits every string queued since glyph_renderer_begin
+ *
+ * The built-in shaders read color and effects per vertex, so the whole
+ * batch is one draw call per GPU upload (GLYPHGL_VERTEX_BUFFER_SIZE
+ * vertices); custom shaders using the textColor/effects uniforms get one
+ * draw per run of equal style.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer_flush(glyph_renderer_t* renderer) {
+    if (!renderer || !renderer->initialized) return;
+
+    size_t vertex_count = renderer->queued_count;
+    renderer->batching = 0;
+    renderer->queued_count = 0;
+    if (vertex_count == 0) {
+        renderer->num_runs = 0;
+        return;
+    }
+
+    glyph_renderer__bind(renderer);
+    glyph_renderer__prepare_textures(renderer);
+
+    glyph_renderer__submit(renderer, 0, vertex_count, renderer->color_uniforms);
+    renderer->num_runs = 0;
+
+    /* Clean up OpenGL state */
+    glyph__gl_release();
+}
+
+/*
+ * Creates the glyph metrics texture shared by the instanced path and grids
+ *
+ * The texels are filled by glyph_renderer__upload_metrics on the next draw
+ * that needs them. Does nothing when the texture already exists.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer__create_metrics(glyph_renderer_t* renderer) {
+    if (renderer->metrics_texture) return;
+    glGenTextures(1, &renderer->metrics_texture);
+    glBindTexture(GL_TEXTURE_2D, renderer->metrics_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    renderer->metrics_capacity = 0;
+    renderer->metrics_dirty = 1;
+    glyph_gl_invalidate_state(); /* Setup binds bypassed the tracker */
+}
+
+/*
+ * Switches between the per-vertex and the instanced render path
+ *
+ * The instanced path uploads one 16-byte glyph_instance_t per glyph instead
+ * of 6 vertices and expands quads in the vertex shader from a per-glyph
+ * metrics texture. It requires GL 3.3 / ES 3.0; its program, unit quad and
+ * metrics texture are created on first use. Any pending batch is flushed.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   enable: Nonzero to draw through instances, 0 for the vertex path
+ *
+ * Returns: 1 if the instanced path is now active, 0 otherwise
+ */
+static inline int glyph_renderer_set_instanced(glyph_renderer_t* renderer, int enable) {
+    if (!renderer || !renderer->initialized) return 0;
+    if (renderer->batching) glyph_renderer_flush(renderer);
+    if ((enable != 0) == (renderer->instanced != 0)) return renderer->instanced;
+
+    /* The programs keep separate uniform state */
+    renderer->cached_text_color[0] = -1.0f;
+    renderer->cached_effects = -1;
+
+    if (!enable) {
+        renderer->instanced = 0;
+        return 0;
+    }
+
+    if (!renderer->instance_vao) {
+        if (!glyph_gl_supports_instancing()) {
+            GLYPH_LOG("Instanced rendering requires OpenGL 3.3 or OpenGL ES 3.0\n");
+            return 0;
+        }
+
+        /* Unit quad in the same corner order as glyph_renderer__emit_quad */
+        static const float corners[12] = {0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+        glyph__glGenVertexArrays(1, &renderer->instance_vao);
+        glyph__glGenBuffers(1, &renderer->quad_vbo);
+        glyph__glBindVertexArray(renderer->instance_vao);
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->quad_vbo);
+        glyph__glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glyph__glEnableVertexAttribArray(0);
+        glyph__glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        /* Per-instance attributes; their pointers are set per draw */
+        for (GLuint attrib = 1; attrib <= 4; attrib++) {
+            glyph__glEnableVertexAttribArray(attrib);
+            glyph__glVertexAttribDivisor(attrib, 1);
+        }
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glyph__glBindVertexArray(0);
+        glyph_renderer__create_metrics(renderer);
+        glyph_gl_invalidate_state(); /* Setup binds bypassed the tracker */
+    }
+
+    /* Pair the instanced vertex stage with the renderer's fragment stage */
+    if (!renderer->instance_shader && !glyph_renderer__acquire_instance_program(renderer)) return 0;
+
+    renderer->metrics_dirty = 1;
+    renderer->instanced = 1;
+    return 1;
+}
+
+#ifndef GLYPHGL_MINIMAL
+/*
+ * Switches the effect a renderer draws with, keeping its atlas and buffers
+ *
+ * Programs come from the shared program cache, so an effect that any
+ * renderer already uses (or that glyph_effect_precompile prepared) is not
+ * compiled again. The renderer also keeps the programs of its last
+ * GLYPHGL_EFFECT_VARIANTS effects, making a switch back a few assignments,
+ * cheap enough to change effects between draws. Any pending batch is flushed.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   effect: Effect to draw with (NULL for the default shaders)
+ *
+ * Returns: 1 on success, 0 if the effect's program failed to build (the
+ *          current effect stays active)
+ */
+static inline int glyph_renderer_set_effect(glyph_renderer_t* renderer, const glyph_effect_t* effect) {
+    if (!renderer || !renderer->initialized) return 0;
+
+    glyph_effect_t target = {(glyph_effect_type_t)GLYPH_EFFECT_NONE, NULL, NULL};
+    if (effect) target = *effect;
+    if (target.vertex_shader == renderer->effect.vertex_shader && target.fragment_shader == renderer->effect.fragment_shader) {
+        renderer->effect.type = target.type;
+        return 1;
+    }
+    if (renderer->batching) glyph_renderer_flush(renderer);
+
+    /* Reuse the programs kept from an earlier switch, or get them from the program cache */
+    glyph_renderer__variant_t next;
+    int found = -1;
+    for (int i = 0; i < renderer->num_variants; i++) {
+        if (renderer->variants[i].effect.vertex_shader == target.vertex_shader &&
+            renderer->variants[i].effect.fragment_shader == target.fragment_shader) {
+            found = i;
+            break;
+        }
+    }
+    if (found >= 0) {
+        next = renderer->variants[found];
+        renderer->num_variants--;
+        memmove(&renderer->variants[found], &renderer->variants[found + 1], (size_t)(renderer->num_variants - found) * sizeof(next));
+    } else {
+        const char* vertex_source;
+        const char* fragment_source;
+        memset(&next, 0, sizeof(next));
+        glyph_renderer__effect_sources(&target, &vertex_source, &fragment_source);
+        next.shader = glyph__program_acquire(vertex_source, fragment_source);
+        if (!next.shader) return 0;
+        glyph_renderer__resolve_uniforms(next.shader, &next.uniforms);
+        next.color_uniforms = next.uniforms.text_color >= 0 || next.uniforms.effects >= 0;
+    }
+    next.effect = target;
+
+    /* Keep the current programs, dropping the least recently used when full */
+    if (renderer->num_variants == GLYPHGL_EFFECT_VARIANTS) {
+        glyph__program_release(renderer->variants[0].shader);
+        glyph__program_release(renderer->variants[0].instance_shader);
+        renderer->num_variants--;
+        memmove(&renderer->variants[0], &renderer->variants[1], (size_t)renderer->num_variants * sizeof(next));
+    }
+    glyph_renderer__variant_t* current = &renderer->variants[renderer->num_variants++];
+    current->effect = renderer->effect;
+    current->shader = renderer->shader;
+    current->uniforms = renderer->uniforms;
+    current->instance_shader = renderer->instance_shader;
+    current->instance_uniforms = renderer->instance_uniforms;
+    current->color_uniforms = renderer->color_uniforms;
+
+    renderer->effect = next.effect;
+    renderer->shader = next.shader;
+    renderer->uniforms = next.uniforms;
+    renderer->instance_shader = next.instance_shader;
+    renderer->instance_uniforms = next.instance_uniforms;
+    renderer->color_uniforms = next.color_uniforms;
+    renderer->uniforms.stale = 1;
+    renderer->instance_uniforms.stale = 1;
+
+    if (renderer->instanced && !renderer->instance_shader && !glyph_renderer__acquire_instance_program(renderer)) {
+        GLYPH_LOG("Instanced program for the effect failed to build, using the vertex path\n");
+        renderer->instanced = 0;
+    }
+    return 1;
+}
+#endif
+
+/*
+ * Measures a string with the draw path's decoding, fallback and kerning
+ *
+ * Issues no GL calls and, on static atlases, allocates nothing; dynamic
+ * atlases rasterize glyphs they have not cached yet, as drawing would.
+ * The stored positions can be passed to glyph_renderer_draw_layout or
+ * glyph_renderer_queue_layout to draw the string without laying it out again.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to measure (whole characters only)
+ *   text_len: Length of text in bytes
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   glyphs: Optional caller storage for per-character positions (NULL for metrics only)
+ *   max_glyphs: Capacity of glyphs; num_glyphs in the result tells how many were needed
+ *
+ * Returns: Metrics of the string, zero-initialized on invalid arguments
+ */
+static inline glyph_text_metrics_t glyph_renderer_measure_text_n(glyph_renderer_t* renderer, const char* text, size_t text_len, float scale,
+                                                                 glyph_layout_glyph_t* glyphs, size_t max_glyphs) {
+    glyph_text_metrics_t metrics;
+    memset(&metrics, 0, sizeof(metrics));
+    if (!renderer || !renderer->initialized || !text) return metrics;
+    metrics.height = glyph_renderer__lookup(renderer)->pixel_height * scale;
+
+    float pen_x = 0.0f;
+    int prev_codepoint = -1;
+    int has_ink = 0;
+    size_t i = 0;
+    while (i < text_len) {
+        size_t offset = i;
+        glyph_atlas_char_t* ch = glyph_renderer__next_glyph(renderer, text, &i, &prev_codepoint, &pen_x, scale);
+        float advance = glyph_renderer__advance(renderer, ch, scale);
+
+        if (glyphs && metrics.num_glyphs < max_glyphs) {
+            glyph_layout_glyph_t* glyph = &glyphs[metrics.num_glyphs];
+            glyph->x = pen_x;
+            glyph->advance = advance;
+            glyph->codepoint = ch ? ch->codepoint : -1;
+            glyph->index = ch ? (int)(ch - renderer->atlas.chars) : -1;
+            glyph->offset = offset;
+        }
+        metrics.num_glyphs++;
+
+        /* Grow the ink box by the quad glyph_renderer__emit_glyph would draw */
+        if (ch && ch->width > 0) {
+            float x0 = pen_x + ch->xoff * scale;
+            float y0 = -ch->yoff * scale;
+            float x1 = x0 + ch->width * scale;
+            float y1 = y0 + ch->height * scale;
+            if (!has_ink) {
+                metrics.ink_x0 = x0;
+                metrics.ink_y0 = y0;
+                metrics.ink_x1 = x1;
+                metrics.ink_y1 = y1;
+                has_ink = 1;
+            } else {
+                if (x0 < metrics.ink_x0) metrics.ink_x0 = x0;
+                if (y0 < metrics.ink_y0) metrics.ink_y0 = y0;
+                if (x1 > metrics.ink_x1) metrics.ink_x1 = x1;
+                if (y1 > metrics.ink_y1) metrics.ink_y1 = y1;
+            }
+        }
+        pen_x += advance;
+    }
+
+    metrics.width = pen_x;
+    return metrics;
+}
+
+/*
+ * Measures a NUL-terminated string (see glyph_renderer_measure_text_n)
+ */
+static inline glyph_text_metrics_t glyph_renderer_measure_text(glyph_renderer_t* renderer, const char* text, float scale,
+                                                               glyph_layout_glyph_t* glyphs, size_t max_glyphs) {
+    return glyph_renderer_measure_text_n(renderer, text, text ? strlen(text) : 0, scale, glyphs, max_glyphs);
+}
+
+/*
+ * Draws a measured layout without decoding or kerning its string again
+ *
+ * Any slice of a layout can be drawn, e.g. one wrapped line, by passing a
+ * sub-range of the positions and an x that cancels the first glyph's offset.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   glyphs: Positions from glyph_renderer_measure_text
+ *   count: Number of positions to draw
+ *   x, y: Screen coordinates of the layout's baseline start
+ *   scale: Scale the layout was measured with
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ */
+static inline void glyph_renderer_draw_layout(glyph_renderer_t* renderer, const glyph_layout_glyph_t* glyphs, size_t count,
+                                              float x, float y, float scale, float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized || !glyphs || count == 0) return;
+
+    glyph_renderer__bind(renderer);
+    if (renderer->color_uniforms) glyph_renderer__set_color_uniforms(renderer, r, g, b, effects);
+    if (!renderer->batching) glyph_atlas_cache_tick(&renderer->atlas);
+
+    /* Same segmenting as glyph_renderer_draw_text: one GPU upload worth of glyphs at a time */
+    size_t first = renderer->queued_count;
+    size_t per_quad = renderer->instanced ? 1 : 6;
+    size_t per_glyph = glyph_renderer__quads_per_glyph(renderer, effects) * per_quad;
+    size_t run_quads = glyph_renderer__quads_per_run(effects) * per_quad;
+    size_t capacity = glyph_renderer__chunk_capacity(renderer);
+    size_t segment_glyphs = capacity > run_quads ? (capacity - run_quads) / per_glyph : 0;
+    if (segment_glyphs == 0) segment_glyphs = 1;
+
+    for (size_t pos = 0; pos < count; pos += segment_glyphs) {
+        size_t n = count - pos < segment_glyphs ? count - pos : segment_glyphs;
+        size_t vertex_count = glyph_renderer__append_layout(renderer, glyphs + pos, n, x, y, scale, r, g, b, effects);
+        if (vertex_count == (size_t)-1) break;
+
+        glyph_renderer__prepare_textures(renderer);
+        if (vertex_count > 0) glyph_renderer__submit(renderer, first, vertex_count, 0);
+        renderer->queued_count = first;
+    }
 
-    /* Bind shader program and OpenGL state for rendering */
-    glyph__glUseProgram(renderer->shader);
-    glyph__glBindVertexArray(renderer->vao);
-    glyph__glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, renderer->texture);
+    glyph__gl_release();
+}
 
-    /* Performance optimization: Only update uniforms if values have changed */
-    if (renderer->cached_text_color[0] != r || renderer->cached_text_color[1] != g || renderer->cached_text_color[2] != b) {
-        glyph__glUniform3f(glyph__glGetUniformLocation(renderer->shader, "textColor"), r, g, b);
-        renderer->cached_text_color[0] = r;
-        renderer->cached_text_color[1] = g;
-        renderer->cached_text_color[2] = b;
+/*
+ * Queues a measured layout for the current batch without issuing any GL calls
+ *
+ * Starts a batch implicitly if glyph_renderer_begin was not called.
+ *
+ * Parameters: Same as glyph_renderer_draw_layout
+ */
+static inline void glyph_renderer_queue_layout(glyph_renderer_t* renderer, const glyph_layout_glyph_t* glyphs, size_t count,
+                                               float x, float y, float scale, float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized || !glyphs) return;
+    if (!renderer->batching) glyph_renderer_begin(renderer);
+
+    size_t first = renderer->queued_count;
+    size_t vertex_count = glyph_renderer__append_layout(renderer, glyphs, count, x, y, scale, r, g, b, effects);
+    if (vertex_count == 0 || vertex_count == (size_t)-1 || !renderer->color_uniforms) return;
+    glyph_renderer__add_run(renderer, first, vertex_count, r, g, b, effects);
+}
+
+/*
+ * Retained text object
+ *
+ * Holds the vertices of one string in its own VAO/VBO, laid out once at the
+ * origin with scale 1 and white color. Drawing only binds the object and
+ * sets its position, scale and color through uniforms.
+ */
+typedef struct {
+    GLuint vao;                     /* Vertex array bound to the object's VBO */
+    GLuint vbo;                     /* Static vertex data of the laid-out string */
+    GLsizei vertex_count;           /* Vertices in vbo */
+    int effects;                    /* Effects bitmask baked into the geometry */
+    char* text;                     /* Copy of the string, for rebuilding after atlas changes */
+    unsigned int generation;        /* Dynamic atlas eviction generation the geometry was built against */
+} glyph_text_t;
+
+/*
+ * Lays out a text object's string and uploads it to the object's VBO
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text_obj: Text object with vao/vbo and text set
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static inline int glyph_text__build(glyph_renderer_t* renderer, glyph_text_t* text_obj) {
+    /* Keep the glyphs resident while laying out (a running batch already protects them) */
+    if (!renderer->batching) glyph_atlas_cache_tick(&renderer->atlas);
+
+    /* Lay out behind any queued vertices; the instanced path does not use the vertex buffer */
+    size_t saved_count = renderer->queued_count;
+    size_t first = renderer->instanced ? 0 : saved_count;
+    renderer->queued_count = first;
+    float pen_x = 0.0f;
+    int prev_codepoint = -1;
+    size_t vertex_count = glyph_renderer__append_text(renderer, text_obj->text, strlen(text_obj->text), &pen_x, &prev_codepoint, 0.0f, 1.0f,
+                                                      1.0f, 1.0f, 1.0f, text_obj->effects);
+    renderer->queued_count = saved_count;
+    if (vertex_count == (size_t)-1) return 0; /* Vertex buffer could not grow */
+
+    glyph__gl_bind_array_buffer(text_obj->vbo);
+    glyph__glBufferData(GL_ARRAY_BUFFER, vertex_count * sizeof(glyph_vertex_t), renderer->vertex_buffer + first, GL_STATIC_DRAW);
+    glyph__gl_unbind_array_buffer();
+    GLYPH_STAT(renderer->stats.vertices += vertex_count);
+    GLYPH_STAT(renderer->stats.bytes += vertex_count * sizeof(glyph_vertex_t));
+
+    text_obj->vertex_count = (GLsizei)vertex_count;
+    text_obj->generation = renderer->atlas.cache ? renderer->atlas.cache->generation : 0;
+    return 1;
+}
+
+/*
+ * Creates a retained text object for a string that rarely changes
+ *
+ * UTF-8 decoding, glyph lookup and vertex generation happen once here
+ * instead of on every frame.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to lay out
+ *   effects: Bitmask of text effects baked into the geometry (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: Initialized glyph_text_t, or zero-initialized struct on failure
+ */
+static inline glyph_text_t glyph_text_create(glyph_renderer_t* renderer, const char* text, int effects) {
+    glyph_text_t text_obj = {0};
+    if (!renderer || !renderer->initialized || !text) return text_obj;
+
+    size_t len = strlen(text);
+    text_obj.text = (char*)GLYPH_MALLOC(len + 1);
+    if (!text_obj.text) return text_obj;
+    memcpy(text_obj.text, text, len + 1);
+    text_obj.effects = effects;
+
+    glyph__glGenVertexArrays(1, &text_obj.vao);
+    glyph__glGenBuffers(1, &text_obj.vbo);
+    glyph__gl_bind_vertex_array(text_obj.vao);
+    glyph__gl_bind_array_buffer(text_obj.vbo);
+    glyph_renderer__setup_vertex_attribs();
+    glyph__gl_unbind_array_buffer();
+    glyph__gl_bind_vertex_array(0);
+
+    if (!glyph_text__build(renderer, &text_obj)) {
+        glyph__glDeleteVertexArrays(1, &text_obj.vao);
+        glyph__glDeleteBuffers(1, &text_obj.vbo);
+        glyph_gl_invalidate_state();
+        GLYPH_FREE(text_obj.text);
+        glyph_text_t empty = {0};
+        return empty;
     }
-#ifndef GLYPHGL_MINIMAL
-    if (renderer->cached_effects != effects) {
-        glyph__glUniform1i(glyph__glGetUniformLocation(renderer->shader, "effects"), effects);
-        renderer->cached_effects = effects;
+    return text_obj;
+}
+
+/*
+ * Replaces the string of a text object and rebuilds its geometry
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text_obj: Text object from glyph_text_create
+ *   text: New string
+ *
+ * Returns: 1 on success, 0 on failure (the object keeps its previous string)
+ */
+static inline int glyph_text_set_string(glyph_renderer_t* renderer, glyph_text_t* text_obj, const char* text) {
+    if (!renderer || !renderer->initialized || !text_obj || !text_obj->vao || !text) return 0;
+
+    size_t len = strlen(text);
+    char* copy = (char*)GLYPH_MALLOC(len + 1);
+    if (!copy) return 0;
+    memcpy(copy, text, len + 1);
+    GLYPH_FREE(text_obj->text);
+    text_obj->text = copy;
+    return glyph_text__build(renderer, text_obj);
+}
+
+/*
+ * Draws a text object with one bind and one draw call
+ *
+ * Position, scale and color are applied by the vertex shader, so they can
+ * change every frame without touching the geometry. Dynamic atlases that
+ * evicted glyphs since the object was built trigger a rebuild first.
+ * Custom effects need the default vertex stage (all built-in effects use it).
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text_obj: Text object from glyph_text_create
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ */
+static inline void glyph_text_draw(glyph_renderer_t* renderer, glyph_text_t* text_obj, float x, float y, float scale,
+                                   float r, float g, float b) {
+    if (!renderer || !renderer->initialized || !text_obj || !text_obj->vao) return;
+
+    if (renderer->atlas.cache && renderer->atlas.cache->generation != text_obj->generation) {
+        if (!glyph_text__build(renderer, text_obj)) return;
     }
-#endif
+    if (text_obj->vertex_count == 0) return;
 
-    /* Calculate text length and estimate vertex buffer requirements */
-    size_t text_len = strlen(text);
-    /* Conservative estimate: 24 floats per glyph * 3 for max effects (normal + bold + underline) */
-    size_t required_size = sizeof(float) * 24 * text_len * 3;
-    if (required_size > renderer->vertex_buffer_size) {
-        /* Grow vertex buffer dynamically to accommodate text */
-        size_t new_size = required_size * 2; /* Double size to minimize future reallocations */
-        float* new_buffer = (float*)GLYPH_REALLOC(renderer->vertex_buffer, new_size);
-        if (!new_buffer) return; /* Memory allocation failure - skip rendering */
-        renderer->vertex_buffer = new_buffer;
-        renderer->vertex_buffer_size = new_size;
-    }
-    float* vertices = renderer->vertex_buffer;
-    size_t vertex_count = 0;
+    glyph_renderer__use_program(renderer, renderer->shader, &renderer->uniforms);
+    glyph__gl_bind_vertex_array(text_obj->vao);
+    glyph__gl_bind_texture(0, renderer->texture);
+    glyph_renderer__prepare_textures(renderer);
 
-    /* Process each character in the text string */
-    float current_x = x; /* Track horizontal position for kerning */
-    size_t i = 0;
-    while (i < text_len) {
-        /* Decode next character based on encoding type */
-        int codepoint;
-        if (renderer->char_type == GLYPH_ENCODING_UTF8) {
-            codepoint = glyph_utf8_decode(text, &i); /* Handle multi-byte UTF-8 sequences */
+    glyph_renderer__set_transform(renderer, x, y, scale, r, g, b);
+    if (renderer->color_uniforms) {
+        if (!renderer->instanced) {
+            glyph_renderer__set_color_uniforms(renderer, r, g, b, text_obj->effects);
         } else {
-            codepoint = (unsigned char)text[i]; /* Simple ASCII byte */
-            i++;
+            /* The uniform cache tracks the instanced program; set the vertex program directly */
+            glyph__glUniform3f(renderer->uniforms.text_color, r, g, b);
+            glyph__glUniform1i(renderer->uniforms.effects, text_obj->effects);
         }
+    }
+    GLYPH_STAT(renderer->stats.draw_calls++);
+    GLYPH_STAT(int timed = glyph_renderer__stats_query_begin(renderer));
+    glDrawArrays(GL_TRIANGLES, 0, text_obj->vertex_count);
+    GLYPH_STAT(if (timed) glyph__glEndQuery(GL_TIME_ELAPSED));
+
+    glyph__gl_release();
+}
+
+/*
+ * Frees the GPU buffers and string copy of a text object
+ *
+ * Parameters:
+ *   text_obj: Text object from glyph_text_create (safe on zero-initialized objects)
+ */
+static inline void glyph_text_free(glyph_text_t* text_obj) {
+    if (!text_obj || !text_obj->vao) return;
+
+    glyph__glDeleteVertexArrays(1, &text_obj->vao);
+    glyph__glDeleteBuffers(1, &text_obj->vbo);
+    glyph_gl_invalidate_state(); /* Deleted names may be handed out again */
+    GLYPH_FREE(text_obj->text);
+    memset(text_obj, 0, sizeof(*text_obj));
+}
+
+/* Glyph index of a blank grid cell */
+#define GLYPH_GRID_EMPTY 0xFFFF
+
+/*
+ * One cell of a text grid as uploaded to the GPU (6 bytes)
+ */
+typedef struct {
+    unsigned short glyph;       /* Index into atlas.chars (GLYPH_GRID_EMPTY for a blank cell) */
+    unsigned char r, g, b;      /* Text color (normalized in the shader) */
+    unsigned char flags;        /* Effects bitmask (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE, ...) */
+} glyph_grid_cell_t;
+
+/*
+ * Retained fixed-pitch text grid (terminals, log views)
+ *
+ * The cells live in the grid's own VBO and are placed by the vertex shader
+ * from their instance number, with glyph metrics read from the renderer's
+ * metrics texture, so a redraw uploads only the rows that changed and
+ * issues one instanced draw. Every cell advances by cell_width; there is no
+ * kerning. Grids always use the built-in shaders (custom effects do not
+ * apply) and need GL 3.3 / ES 3.0.
+ */
+typedef struct {
+    GLuint vao;                     /* Vertex array bound to the cell VBO */
+    GLuint vbo;                     /* columns * rows cells */
+    int columns;                    /* Cells per row */
+    int rows;                       /* Number of rows */
+    float cell_width;               /* Horizontal pen step at scale 1 (may be changed at any time) */
+    float line_height;              /* Vertical step between baselines at scale 1 (may be changed at any time) */
+    glyph_grid_cell_t* cells;       /* CPU copy of the cells, row-major */
+    int* codepoints;                /* Codepoint of each cell (-1 = blank), for re-resolving after atlas evictions */
+    int dirty_first;                /* First row to upload before the next draw */
+    int dirty_last;                 /* Last row to upload (below dirty_first when clean) */
+    unsigned int generation;        /* Dynamic atlas eviction generation the glyph indices were resolved against */
+} glyph_grid_t;
 
-        /* Look up glyph data in atlas */
-        glyph_atlas_char_t* ch = glyph_atlas_find_char(&renderer->atlas, codepoint);
+/*
+ * Resolves one codepoint to a grid cell
+ *
+ * Missing characters become '?', like in drawn text.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   cell: Cell to fill
+ *   codepoint: Character to show (-1 for a blank cell)
+ *   base: Color and flags from glyph_renderer__instance_base
+ */
+static inline void glyph_grid__resolve_cell(glyph_renderer_t* renderer, glyph_grid_cell_t* cell, int codepoint, const glyph_instance_t* base) {
+    glyph_atlas_char_t* ch = NULL;
+    if (codepoint >= 0) {
+        glyph_atlas_t* atlas = glyph_renderer__lookup(renderer);
+        ch = glyph_atlas_get_char(atlas, codepoint);
         if (!ch) {
-            /* Fallback to question mark for missing characters */
-            ch = glyph_atlas_find_char(&renderer->atlas, '?');
-        }
-        if (!ch || ch->width == 0) {
-            /* Skip invalid/missing glyphs, advance cursor */
-            current_x += ch ? ch->advance * scale : (renderer->atlas.pixel_height * 0.5f * scale);
-            continue;
+            ch = glyph_atlas_get_char(atlas, '?');
+            GLYPH_STAT(renderer->stats.missing_glyphs++);
         }
+        GLYPH_STAT(renderer->stats.glyphs++);
+    }
+    size_t index = ch ? (size_t)(ch - renderer->atlas.chars) : GLYPH_GRID_EMPTY;
+    cell->glyph = (unsigned short)(index < GLYPH_GRID_EMPTY ? index : GLYPH_GRID_EMPTY);
+    cell->r = base->r;
+    cell->g = base->g;
+    cell->b = base->b;
+    cell->flags = base->flags;
+}
 
-        /* Calculate glyph quad position and size in screen space */
-        float xpos = current_x + ch->xoff * scale; /* Apply left bearing offset */
-        float ypos = y - ch->yoff * scale;         /* Apply baseline offset (inverted Y) */
-        float w = ch->width * scale;               /* Scaled glyph width */
-        float h = ch->height * scale;              /* Scaled glyph height */
-
-        /* Calculate texture coordinates for glyph in atlas */
-        float tex_x1 = (float)ch->x / renderer->atlas.image.width;
-        float tex_y1 = (float)ch->y / renderer->atlas.image.height;
-        float tex_x2 = (float)(ch->x + ch->width) / renderer->atlas.image.width;
-        float tex_y2 = (float)(ch->y + ch->height) / renderer->atlas.image.height;
-
-        /* Build vertex data for glyph quad (two triangles = 6 vertices) */
-        /* Format: [pos_x, pos_y, tex_u, tex_v] per vertex */
-        float glyph_vertices[24] = {
-            /* Triangle 1 */
-            xpos,     ypos + h,   tex_x1, tex_y2,  /* Top-left */
-            xpos,     ypos,       tex_x1, tex_y1,  /* Bottom-left */
-            xpos + w, ypos,       tex_x2, tex_y1,  /* Bottom-right */
-
-            /* Triangle 2 */
-            xpos,     ypos + h,   tex_x1, tex_y2,  /* Top-left */
-            xpos + w, ypos,       tex_x2, tex_y1,  /* Bottom-right */
-            xpos + w, ypos + h,   tex_x2, tex_y2   /* Top-right */
-        };
-
-        /* Apply italic effect by shearing glyph vertices */
-#ifndef GLYPHGL_MINIMAL
-        if (effects & GLYPHGL_ITALIC) {
-            float shear = 0.2f; /* Shear factor for italic slant */
-            /* Apply shear to top vertices of both triangles */
-            glyph_vertices[0] -= shear * h;   /* Triangle 1 top-left X */
-            glyph_vertices[12] -= shear * h;  /* Triangle 2 top-left X */
-            glyph_vertices[20] -= shear * h;  /* Triangle 2 top-right X */
-        }
-#endif
+/* Adds rows to the range uploaded by the next glyph_grid_draw */
+static inline void glyph_grid__mark_rows(glyph_grid_t* grid, int first, int last) {
+    if (first < grid->dirty_first) grid->dirty_first = first;
+    if (last > grid->dirty_last) grid->dirty_last = last;
+}
 
-        /* Copy base glyph vertices to batch buffer */
-        memcpy(vertices + vertex_count * 4, glyph_vertices, sizeof(glyph_vertices));
-        vertex_count += 6;
+/*
+ * Re-resolves every cell after a dynamic atlas evicted glyphs
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   grid: Grid whose glyph indices may be stale
+ */
+static inline void glyph_grid__rebuild(glyph_renderer_t* renderer, glyph_grid_t* grid) {
+    /* Keep the grid's glyphs resident while resolving (a running batch already protects them) */
+    if (!renderer->batching) glyph_atlas_cache_tick(&renderer->atlas);
+
+    size_t count = (size_t)grid->columns * grid->rows;
+    for (size_t i = 0; i < count; i++) {
+        glyph_grid_cell_t* cell = &grid->cells[i];
+        glyph_instance_t base;
+        base.r = cell->r;
+        base.g = cell->g;
+        base.b = cell->b;
+        base.flags = cell->flags;
+        glyph_grid__resolve_cell(renderer, cell, grid->codepoints[i], &base);
+    }
+    grid->generation = renderer->atlas.cache ? renderer->atlas.cache->generation : 0;
+    glyph_grid__mark_rows(grid, 0, grid->rows - 1);
+}
 
-        /* Render additional geometry for text effects */
-#ifndef GLYPHGL_MINIMAL
-        if (effects & GLYPHGL_BOLD) {
-            /* Create bold effect by rendering duplicate glyph with offset */
-            float bold_offset = 1.0f * scale; /* Pixel offset for bold thickness */
-            float bold_vertices[24] = {
-                /* Offset duplicate of base glyph */
-                xpos + bold_offset,     ypos + h,   tex_x1, tex_y2,
-                xpos + bold_offset,     ypos,       tex_x1, tex_y1,
-                xpos + w + bold_offset, ypos,       tex_x2, tex_y1,
-
-                xpos + bold_offset,     ypos + h,   tex_x1, tex_y2,
-                xpos + w + bold_offset, ypos,       tex_x2, tex_y1,
-                xpos + w + bold_offset, ypos + h,   tex_x2, tex_y2
-            };
-
-            /* Apply italic shear to bold glyph if both effects active */
-            if (effects & GLYPHGL_ITALIC) {
-                float shear = 0.2f;
-                bold_vertices[0] -= shear * h;
-                bold_vertices[12] -= shear * h;
-                bold_vertices[20] -= shear * h;
-            }
+/*
+ * Builds the grid program of a renderer on first use
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: 1 on success, 0 if the program failed to build
+ */
+static inline int glyph_grid__acquire_program(glyph_renderer_t* renderer) {
+    if (renderer->grid_shader) return 1;
+    GLuint program = glyph__program_acquire(glyph__get_grid_vertex_shader_source_cached(), glyph__get_fragment_shader_source_cached());
+    if (!program) return 0;
+
+    glyph_renderer__resolve_uniforms(program, &renderer->grid_uniforms);
+    renderer->grid_locations.origin = glyph__glGetUniformLocation(program, "gridOrigin");
+    renderer->grid_locations.step = glyph__glGetUniformLocation(program, "gridStep");
+    renderer->grid_locations.scale = glyph__glGetUniformLocation(program, "gridScale");
+    renderer->grid_locations.underline = glyph__glGetUniformLocation(program, "gridUnderline");
+    renderer->grid_locations.columns = glyph__glGetUniformLocation(program, "gridColumns");
+    glyph__glUseProgram(program);
+    glyph__glUniform1i(glyph__glGetUniformLocation(program, "textTexture"), 0);
+    glyph__glUniform1i(glyph__glGetUniformLocation(program, "glyphMetrics"), 1);
+    glyph__glUseProgram(0);
+    glyph_gl_invalidate_state();
+    renderer->grid_shader = program;
+    return 1;
+}
 
-            /* Add bold glyph vertices to batch */
-            memcpy(vertices + vertex_count * 4, bold_vertices, sizeof(bold_vertices));
-            vertex_count += 6;
+/*
+ * Creates a blank text grid
+ *
+ * The cell width defaults to the advance of 'M' (monospace fonts advance
+ * every glyph by the same amount) and the line height to the atlas pixel
+ * height; both fields can be overwritten before drawing.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   columns: Cells per row
+ *   rows: Number of rows
+ *
+ * Returns: Initialized glyph_grid_t, or zero-initialized struct on failure
+ */
+static inline glyph_grid_t glyph_grid_create(glyph_renderer_t* renderer, int columns, int rows) {
+    glyph_grid_t grid = {0};
+    if (!renderer || !renderer->initialized || columns <= 0 || rows <= 0) return grid;
+    if (!glyph_gl_supports_instancing()) {
+        GLYPH_LOG("Text grids require OpenGL 3.3 or OpenGL ES 3.0\n");
+        return grid;
+    }
+    if (!glyph_grid__acquire_program(renderer)) return grid;
+    glyph_renderer__create_metrics(renderer);
+
+    size_t count = (size_t)columns * rows;
+    grid.cells = (glyph_grid_cell_t*)GLYPH_MALLOC(count * sizeof(glyph_grid_cell_t));
+    grid.codepoints = (int*)GLYPH_MALLOC(count * sizeof(int));
+    if (!grid.cells || !grid.codepoints) {
+        GLYPH_FREE(grid.cells);
+        GLYPH_FREE(grid.codepoints);
+        glyph_grid_t empty = {0};
+        return empty;
+    }
+    for (size_t i = 0; i < count; i++) {
+        memset(&grid.cells[i], 0, sizeof(glyph_grid_cell_t));
+        grid.cells[i].glyph = GLYPH_GRID_EMPTY;
+        grid.codepoints[i] = -1;
+    }
+    grid.columns = columns;
+    grid.rows = rows;
+    glyph_atlas_t* atlas = glyph_renderer__lookup(renderer);
+    grid.line_height = atlas->pixel_height;
+    grid.cell_width = glyph_renderer__advance(renderer, glyph_atlas_get_char(atlas, 'M'), 1.0f);
+    grid.dirty_first = rows;
+    grid.dirty_last = -1;
+    grid.generation = renderer->atlas.cache ? renderer->atlas.cache->generation : 0;
+
+    /* Per-cell attributes; the quad corners come from gl_VertexID */
+    GLsizei stride = (GLsizei)sizeof(glyph_grid_cell_t);
+    glyph__glGenVertexArrays(1, &grid.vao);
+    glyph__glGenBuffers(1, &grid.vbo);
+    glyph__gl_bind_vertex_array(grid.vao);
+    glyph__gl_bind_array_buffer(grid.vbo);
+    glyph__glBufferData(GL_ARRAY_BUFFER, count * sizeof(glyph_grid_cell_t), grid.cells, GL_DYNAMIC_DRAW);
+    glyph__glEnableVertexAttribArray(0);
+    glyph__glVertexAttribPointer(0, 1, GL_UNSIGNED_SHORT, GL_FALSE, stride, (void*)offsetof(glyph_grid_cell_t, glyph));
+    glyph__glEnableVertexAttribArray(1);
+    glyph__glVertexAttribPointer(1, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(glyph_grid_cell_t, r));
+    glyph__glEnableVertexAttribArray(2);
+    glyph__glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, stride, (void*)offsetof(glyph_grid_cell_t, flags));
+    for (GLuint attrib = 0; attrib <= 2; attrib++) glyph__glVertexAttribDivisor(attrib, 1);
+    glyph__gl_unbind_array_buffer();
+    glyph__gl_bind_vertex_array(0);
+    GLYPH_STAT(renderer->stats.bytes += count * sizeof(glyph_grid_cell_t));
+    return grid;
+}
+
+/*
+ * Writes a string into one row of a grid, one character per cell
+ *
+ * Characters past the end of the row are dropped; cells outside the
+ * string keep their contents. Only the touched row is uploaded again.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   grid: Grid from glyph_grid_create
+ *   row: Row to write
+ *   column: First cell to write
+ *   text: UTF-8 or ASCII string (per the renderer's encoding)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE, GLYPHGL_SDF)
+ *
+ * Returns: Number of cells written
+ */
+static inline int glyph_grid_set_text(glyph_renderer_t* renderer, glyph_grid_t* grid, int row, int column, const char* text,
+                                      float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized || !grid || !grid->vao || !text) return 0;
+    if (row < 0 || row >= grid->rows || column < 0 || column >= grid->columns) return 0;
+
+    glyph_instance_t base = glyph_renderer__instance_base(renderer, 1.0f, r, g, b, effects);
+#ifdef GLYPHGL_MINIMAL
+    base.flags &= (unsigned char)~GLYPHGL_UNDERLINE; /* Minimal mode draws no underlines */
+#endif
+    size_t cell_index = (size_t)row * grid->columns + column;
+    size_t text_len = strlen(text);
+    size_t i = 0;
+    int written = 0;
+    while (i < text_len && column + written < grid->columns) {
+        int codepoint;
+        if (renderer->char_type == GLYPH_ENCODING_UTF8) {
+            codepoint = glyph_utf8_decode(text, &i);
+        } else {
+            codepoint = (unsigned char)text[i++];
         }
+        grid->codepoints[cell_index] = codepoint;
+        glyph_grid__resolve_cell(renderer, &grid->cells[cell_index], codepoint, &base);
+        cell_index++;
+        written++;
+    }
+    if (written > 0) glyph_grid__mark_rows(grid, row, row);
+    return written;
+}
 
-        if (effects & GLYPHGL_UNDERLINE) {
-            /* Render underline as a thin quad beneath the text */
-            float underline_y = y + h * 0.1f; /* Position slightly below baseline */
-            float underline_vertices[24] = {
-                /* Horizontal line quad spanning glyph advance width */
-                current_x, underline_y + 2, 0.0f, 0.0f,     /* Top-left of line */
-                current_x, underline_y,     0.0f, 0.0f,     /* Bottom-left of line */
-                current_x + ch->advance * scale, underline_y,     0.0f, 0.0f, /* Bottom-right */
-
-                current_x, underline_y + 2, 0.0f, 0.0f,     /* Top-left */
-                current_x + ch->advance * scale, underline_y,     0.0f, 0.0f, /* Bottom-right */
-                current_x + ch->advance * scale, underline_y + 2, 0.0f, 0.0f  /* Top-right */
-            };
-            /* Add underline vertices to batch */
-            memcpy(vertices + vertex_count * 4, underline_vertices, sizeof(underline_vertices));
-            vertex_count += 6;
+/*
+ * Blanks one row of a grid, or all of them
+ *
+ * Parameters:
+ *   grid: Grid from glyph_grid_create
+ *   row: Row to clear (-1 for every row)
+ */
+static inline void glyph_grid_clear(glyph_grid_t* grid, int row) {
+    if (!grid || !grid->vao || row >= grid->rows) return;
+    int first = row < 0 ? 0 : row;
+    int last = row < 0 ? grid->rows - 1 : row;
+    for (size_t i = (size_t)first * grid->columns; i < (size_t)(last + 1) * grid->columns; i++) {
+        memset(&grid->cells[i], 0, sizeof(glyph_grid_cell_t));
+        grid->cells[i].glyph = GLYPH_GRID_EMPTY;
+        grid->codepoints[i] = -1;
+    }
+    glyph_grid__mark_rows(grid, first, last);
+}
+
+/*
+ * Draws a grid with at most one buffer update and one draw call
+ *
+ * Rows written since the last draw are uploaded as one contiguous range;
+ * an unchanged grid uploads nothing. Row n has its baseline at
+ * y + n * line_height * scale (rows run down the screen). Dynamic atlases
+ * that evicted glyphs since the cells were written trigger a re-resolve
+ * of the whole grid first.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   grid: Grid from glyph_grid_create
+ *   x, y: Screen coordinates of the first row's baseline start
+ *   scale: Text scaling factor (1.0 = normal size)
+ */
+static inline void glyph_grid_draw(glyph_renderer_t* renderer, glyph_grid_t* grid, float x, float y, float scale) {
+    if (!renderer || !renderer->initialized || !grid || !grid->vao) return;
+
+    if (renderer->atlas.cache && renderer->atlas.cache->generation != grid->generation) glyph_grid__rebuild(renderer, grid);
+    if (grid->dirty_first <= grid->dirty_last) {
+        size_t first = (size_t)grid->dirty_first * grid->columns;
+        size_t count = (size_t)(grid->dirty_last - grid->dirty_first + 1) * grid->columns;
+        glyph__gl_bind_array_buffer(grid->vbo);
+        glyph__glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(first * sizeof(glyph_grid_cell_t)), (GLsizeiptr)(count * sizeof(glyph_grid_cell_t)),
+                               grid->cells + first);
+        glyph__gl_unbind_array_buffer();
+        GLYPH_STAT(renderer->stats.vertices += count);
+        GLYPH_STAT(renderer->stats.bytes += count * sizeof(glyph_grid_cell_t));
+        grid->dirty_first = grid->rows;
+        grid->dirty_last = -1;
+    }
+
+    glyph_renderer__use_program(renderer, renderer->grid_shader, &renderer->grid_uniforms);
+    glyph__gl_bind_vertex_array(grid->vao);
+    glyph__gl_bind_texture(1, renderer->metrics_texture);
+    glyph__gl_bind_texture(0, renderer->texture);
+    glyph_renderer__prepare_textures(renderer);
+    if (renderer->metrics_dirty) glyph_renderer__upload_metrics(renderer);
+
+    const glyph_renderer__grid_uniforms_t* locations = &renderer->grid_locations;
+    glyph__glUniform2f(locations->origin, x, y);
+    glyph__glUniform2f(locations->step, grid->cell_width * scale, grid->line_height * scale);
+    glyph__glUniform1f(locations->scale, scale);
+    glyph__glUniform1f(locations->underline, glyph_renderer__underline_y(renderer, 0.0f, scale));
+    glyph__glUniform1i(locations->columns, grid->columns);
+
+    GLYPH_STAT(renderer->stats.draw_calls++);
+    GLYPH_STAT(int timed = glyph_renderer__stats_query_begin(renderer));
+    glyph__glDrawArraysInstanced(GL_TRIANGLES, 0, 12, (GLsizei)((size_t)grid->columns * grid->rows));
+    GLYPH_STAT(if (timed) glyph__glEndQuery(GL_TIME_ELAPSED));
+
+    glyph__gl_release();
+}
+
+/*
+ * Frees the GPU buffers and cell copies of a grid
+ *
+ * Parameters:
+ *   grid: Grid from glyph_grid_create (safe on zero-initialized grids)
+ */
+static inline void glyph_grid_free(glyph_grid_t* grid) {
+    if (!grid || !grid->vao) return;
+
+    glyph__glDeleteVertexArrays(1, &grid->vao);
+    glyph__glDeleteBuffers(1, &grid->vbo);
+    glyph_gl_invalidate_state(); /* Deleted names may be handed out again */
+    GLYPH_FREE(grid->cells);
+    GLYPH_FREE(grid->codepoints);
+    memset(grid, 0, sizeof(*grid));
+}
+
+/*
+ * Face of a font collection: one font file at one size
+ */
+typedef struct {
+    const char* font_path;              /* Path to .ttf font file (ignored when font_data is set) */
+    const unsigned char* font_data;     /* Optional in-memory font file (not copied) */
+    size_t font_data_size;              /* Size of font_data in bytes */
+    float pixel_height;                 /* Font size in pixels */
+    const char* charset;                /* Characters to bake (NULL for the default charset) */
+} glyph_collection_face_t;
+
+/*
+ * Several faces and sizes drawn by one renderer
+ *
+ * Every face is baked into its own static atlas, then all of them are
+ * merged into the renderer's single texture (glyph_atlas_merge), so the
+ * whole collection owns one texture, one program and one set of buffers.
+ * Strings of different faces can be queued into the same batch and are
+ * submitted together by one glyph_renderer_flush.
+ */
+typedef struct {
+    glyph_renderer_t renderer;          /* Shared renderer; its atlas holds the glyphs of every face */
+    glyph_atlas_t* faces;               /* Per-face lookup views (index, kerning, metrics) */
+    int num_faces;                      /* Number of faces */
+} glyph_collection_t;
+
+/*
+ * Creates a font collection from a list of faces
+ *
+ * Parameters:
+ *   faces: Face descriptions, in the order they are selected by index
+ *   num_faces: Number of faces
+ *   char_type: Character encoding (GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII)
+ *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
+ *   use_sdf: GLYPH_ATLAS_COVERAGE (0), GLYPH_ATLAS_SDF (1) or GLYPH_ATLAS_MSDF (2), shared by every face
+ *   atlas_config: Optional build settings applied to every face (NULL for defaults;
+ *                 dynamic mode, cache files and per-face font data are overridden)
+ *
+ * Returns: Initialized collection, or zero-initialized struct on failure
+ *          Check collection.renderer.initialized field to verify success
+ */
+static inline glyph_collection_t glyph_collection_create(const glyph_collection_face_t* faces, int num_faces, glyph_encoding_type_t char_type,
+                                                         void* effect, int use_sdf, const glyph_atlas_config_t* atlas_config) {
+    glyph_collection_t collection;
+    memset(&collection, 0, sizeof(collection));
+    if (!faces || num_faces <= 0) return collection;
+
+    collection.faces = (glyph_atlas_t*)GLYPH_MALLOC(num_faces * sizeof(glyph_atlas_t));
+    if (!collection.faces) return collection;
+
+    /* Bake each face tightly; the merged texture is sized from their used regions */
+    glyph_atlas_config_t config = atlas_config ? *atlas_config : glyph_atlas_default_config();
+    config.dynamic = 0;
+    config.cache_path = NULL;
+    config.min_width = 1;
+    config.min_height = 1;
+    int built = 0;
+    for (; built < num_faces; built++) {
+        config.font_data = faces[built].font_data;
+        config.font_data_size = faces[built].font_data_size;
+        collection.faces[built] = glyph_atlas_create_ex(faces[built].font_path, faces[built].pixel_height, faces[built].charset,
+                                                        char_type, use_sdf, &config);
+        if (!collection.faces[built].chars || !collection.faces[built].image.data) {
+            GLYPH_LOG("Failed to build collection face %d\n", built);
+            glyph_atlas_free(&collection.faces[built]);
+            break;
         }
-#endif
+    }
 
-        /* Advance cursor to next character position */
-        current_x += ch->advance * scale;
+    glyph_atlas_t merged;
+    memset(&merged, 0, sizeof(merged));
+    if (built == num_faces) merged = glyph_atlas_merge(collection.faces, num_faces, config.padding);
+    if (!merged.chars) {
+        for (int f = 0; f < built; f++) glyph_atlas_free(&collection.faces[f]);
+        GLYPH_FREE(collection.faces);
+        collection.faces = NULL;
+        return collection;
     }
 
-    /* Upload batched vertex data to GPU and execute draw call */
-    glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
-    glyph__glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_count * 4 * sizeof(float), vertices);
-    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    /* The renderer owns the merged atlas and compiles the program once for all faces */
+    collection.renderer = glyph_renderer_create_from_atlas(merged, char_type, effect);
+    if (!collection.renderer.initialized) {
+        for (int f = 0; f < num_faces; f++) glyph_atlas_free(&collection.faces[f]);
+        GLYPH_FREE(collection.faces);
+        collection.faces = NULL;
+        return collection;
+    }
+    collection.num_faces = num_faces;
+    collection.renderer.lookup = &collection.faces[0];
+    return collection;
+}
+
+/*
+ * Selects the face used by subsequent layout on the collection's renderer
+ *
+ * The returned renderer works with every glyph_renderer_* text function
+ * (draw, queue, measure, layouts, text objects). Switching faces inside
+ * a batch keeps the queued strings, so mixed-face text still flushes in
+ * one draw call.
+ *
+ * Parameters:
+ *   collection: Pointer to initialized collection
+ *   face: Face index in creation order (clamped to the valid range)
+ *
+ * Returns: Pointer to the collection's renderer, or NULL if not initialized
+ */
+static inline glyph_renderer_t* glyph_collection_face(glyph_collection_t* collection, int face) {
+    if (!collection || !collection->renderer.initialized) return NULL;
+    if (face < 0) face = 0;
+    if (face >= collection->num_faces) face = collection->num_faces - 1;
+    collection->renderer.lookup = &collection->faces[face];
+    return &collection->renderer;
+}
 
-    /* Render all batched glyphs in single draw call - highly efficient! */
-    glDrawArrays(GL_TRIANGLES, 0, vertex_count);
+/*
+ * Frees a font collection, its faces and its renderer
+ *
+ * Parameters:
+ *   collection: Collection from glyph_collection_create (safe on zero-initialized structs)
+ */
+static inline void glyph_collection_free(glyph_collection_t* collection) {
+    if (!collection) return;
+    for (int f = 0; f < collection->num_faces; f++) glyph_atlas_free(&collection->faces[f]);
+    GLYPH_FREE(collection->faces);
+    collection->renderer.lookup = NULL;
+    glyph_renderer_free(&collection->renderer);
+    memset(collection, 0, sizeof(*collection));
+}
 
-    /* Clean up OpenGL state */
-    glyph__glBindVertexArray(0);
-    glyph__glUseProgram(0);
+/*
+ * Reads the renderer's counters
+ *
+ * Finished GPU timer queries are collected first (without waiting), so
+ * gpu_ms trails the CPU counters by the frames the GPU is behind. The
+ * atlas fill ratio and bake timings are read from the atlas at call time.
+ * Without GLYPHGL_STATS this returns a zero-initialized struct.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: Copy of the counters since creation or the last reset
+ */
+static inline glyph_renderer_stats_t glyph_renderer_get_stats(glyph_renderer_t* renderer) {
+    glyph_renderer_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+#ifdef GLYPHGL_STATS
+    if (!renderer || !renderer->initialized) return stats;
+    glyph_renderer__stats_collect(renderer);
+    stats = renderer->stats;
+
+    const glyph_atlas_t* atlas = &renderer->atlas;
+    const glyph_atlas_cache_t* cache = atlas->cache;
+    if (cache) {
+        int num_slots = cache->columns * cache->rows;
+        stats.atlas_fill = num_slots > 0 ? (float)(num_slots - cache->num_free_slots) / (float)num_slots : 0.0f;
+    } else {
+        stats.atlas_fill = atlas->occupancy;
+    }
+    stats.bake = atlas->bake_stats;
+#else
+    (void)renderer;
+#endif
+    return stats;
+}
+
+/*
+ * Starts a new measurement interval, typically once per frame
+ *
+ * Clears every counter. Timer queries still in flight are kept and
+ * count towards the next interval when their results arrive.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer_reset_stats(glyph_renderer_t* renderer) {
+#ifdef GLYPHGL_STATS
+    if (!renderer || !renderer->initialized) return;
+    memset(&renderer->stats, 0, sizeof(renderer->stats));
+#else
+    (void)renderer;
+#endif
+}
+
+/*
+ * Wraps every text draw call in a GL_TIME_ELAPSED query
+ *
+ * Results are reported through glyph_renderer_get_stats (gpu_ms and
+ * gpu_samples). Timer queries cannot nest, so leave timing off while the
+ * application has its own GL_TIME_ELAPSED query active around text draws.
+ * Requires GLYPHGL_STATS and GL 3.3 / ARB_timer_query.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   enable: Non-zero to time draws, 0 to stop (pending results are still collected)
+ *
+ * Returns: 1 if GPU timing is now active, 0 otherwise
+ */
+static inline int glyph_renderer_set_gpu_timing(glyph_renderer_t* renderer, int enable) {
+#ifdef GLYPHGL_STATS
+    if (!renderer || !renderer->initialized) return 0;
+    if (enable && !renderer->queries[0]) {
+        if (!glyph_gl_supports_timer_query()) {
+            GLYPH_LOG("GPU timer queries unavailable\n");
+            return 0;
+        }
+        glyph__glGenQueries(GLYPHGL_STATS_QUERIES, renderer->queries);
+    }
+    renderer->gpu_timing = enable && renderer->queries[0];
+    return renderer->gpu_timing;
+#else
+    (void)renderer;
+    (void)enable;
+    return 0;
+#endif
 }
 
 /*
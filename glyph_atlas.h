@@ -31,6 +31,7 @@
  * - Packs glyphs efficiently into a texture atlas
  * - Provides SDF (Signed Distance Field) rendering support
  * - Manages character set encoding (ASCII/UTF-8)
+ * - Builds atlases on background threads (no GL calls, see glyph_atlas_build_t)
  *
  * The atlas system is crucial for performance, allowing multiple characters
  * to be rendered from a single texture with minimal texture state changes.
@@ -42,6 +43,8 @@
 #include "glyph_image.h"
 #include "glyph_util.h"
 #include "glyph_truetype.h"
+#include "glyph_msdf.h"
+#include "glyph_thread.h"
 
 /* Character encoding type flags */
 typedef enum {
@@ -50,9 +53,16 @@ typedef enum {
     GLYPH_ENCODING_ASCII = 0x020,    /* Simple ASCII single-byte encoding */
 } glyph_encoding_type_t;
 
-/* Default atlas texture dimensions - can be overridden at compile time */
-#define GLYPHGL_ATLAS_WIDTH 2048   /* Default atlas width in pixels */
-#define GLYPHGL_ATLAS_HEIGHT 2048  /* Default atlas height in pixels */
+/* Minimum atlas texture dimensions - can be overridden at compile time */
+#ifndef GLYPHGL_ATLAS_WIDTH
+#define GLYPHGL_ATLAS_WIDTH 256    /* Minimum atlas width in pixels */
+#endif
+#ifndef GLYPHGL_ATLAS_HEIGHT
+#define GLYPHGL_ATLAS_HEIGHT 256   /* Minimum atlas height in pixels */
+#endif
+#ifndef GLYPHGL_ATLAS_MAX_SIZE
+#define GLYPHGL_ATLAS_MAX_SIZE 16384 /* Largest width/height the packer may grow to */
+#endif
 
 #if defined(_WIN32) || defined(_WIN64)
     #include <windows.h>
@@ -124,6 +134,11 @@ static int glyph_atlas_utf8_decode(const char* str, size_t* index) {
     return 0xFFFD; /* Unicode replacement character */
 }
 
+/* Glyph formats accepted by the use_sdf parameter of glyph_atlas_create(_ex) */
+#define GLYPH_ATLAS_COVERAGE 0  /* Anti-aliased coverage (8-bit) */
+#define GLYPH_ATLAS_SDF      1  /* Single-channel signed distance field from the coverage (8-bit) */
+#define GLYPH_ATLAS_MSDF     2  /* Multi-channel signed distance field from the outlines (RGB) */
+
 /*
  * Individual character data stored in the atlas
  *
@@ -138,6 +153,94 @@ typedef struct {
     int advance;       /* Horizontal advance width for cursor positioning */
 } glyph_atlas_char_t;
 
+/*
+ * Codepoint lookup index built alongside the atlas
+ *
+ * Maps Unicode codepoints to positions in the atlas 'chars' array in constant
+ * time. Basic Multilingual Plane codepoints go through a two-level direct map
+ * (256 pages of 256 slots, pages allocated on demand), while astral codepoints
+ * (above U+FFFF) live in a small open-addressed hash table. Removed astral
+ * entries leave a tombstone (key -2) so probe chains stay intact.
+ */
+typedef struct {
+    int* pages[256];        /* BMP pages selected by codepoint >> 8, slots hold char index or -1 */
+    int* astral_keys;       /* Hash table keys for astral codepoints (-1 empty, -2 removed) */
+    int* astral_values;     /* Char indices matching astral_keys */
+    int astral_capacity;    /* Hash table capacity (power of 2, 0 when unused) */
+    int astral_count;       /* Number of astral entries stored */
+    int astral_tombstones;  /* Number of removed astral slots awaiting a rehash */
+    int count;              /* Total number of indexed codepoints */
+} glyph_atlas_index_t;
+
+/*
+ * Kerning pair table built with the atlas
+ *
+ * Open-addressed hash from a codepoint pair to its advance adjustment in
+ * atlas pixels, so layout pays one probe per character. Static atlases
+ * hold every non-zero pair of their charset (a miss means "not kerned");
+ * dynamic atlases also memoize pairs they resolve through the retained
+ * font, zeros included.
+ */
+typedef struct {
+    uint64_t* keys;    /* Packed pair + 1 per slot, 0 for empty slots */
+    float* values;     /* Kerning in atlas pixels matching keys */
+    int capacity;      /* Slot count (power of 2, 0 when unused) */
+    int count;         /* Stored pairs */
+    int enabled;       /* Zero when kerning was turned off at build time */
+} glyph_atlas_kerning_t;
+
+/*
+ * On-demand glyph cache for dynamic atlases
+ *
+ * A dynamic atlas keeps its font loaded and splits a fixed-size texture into
+ * uniform slots sized for the font's largest glyph. Codepoints missing from
+ * the atlas are rasterized on first use, and when every slot is taken the
+ * least recently used glyph is evicted. Modified texels are accumulated in a
+ * dirty rectangle so renderers only re-upload what changed.
+ */
+typedef struct {
+    glyph_font_t font;             /* Font retained for lazy rasterization */
+    float scale;                   /* Font units to pixel conversion factor */
+    int use_sdf;                   /* Rasterize new glyphs as SDF */
+    int sdf_spread;                /* SDF distance range and border in pixels */
+    glyph_raster_scratch_t raster_scratch; /* Accumulation buffer reused by every glyph */
+    glyph_sdf_scratch_t sdf_scratch; /* Working memory reused by every SDF glyph */
+    int padding;                   /* Empty pixels around every slot */
+    int cell_width, cell_height;   /* Slot size in pixels (padding included) */
+    int columns, rows;             /* Slot grid dimensions */
+    int* slot_owner;               /* chars[] index stored in each slot, -1 when free */
+    int* free_slots;               /* Stack of unused slot indices */
+    int num_free_slots;            /* Number of entries in free_slots */
+    int* char_slot;                /* Slot of each chars[] entry, -1 for glyphs without a bitmap */
+    unsigned int* last_used;       /* Tick at which each chars[] entry was last requested */
+    int capacity;                  /* Allocated length of chars, char_slot and last_used */
+    unsigned int tick;             /* Current use tick (see glyph_atlas_cache_tick) */
+    unsigned int generation;       /* Incremented on every eviction */
+    int dirty_x0, dirty_y0;        /* Pending upload rectangle, top-left */
+    int dirty_x1, dirty_y1;        /* Pending upload rectangle, bottom-right (exclusive, empty when x1 <= x0) */
+} glyph_atlas_cache_t;
+
+/*
+ * Time spent in each phase of an atlas build (GLYPHGL_STATS builds)
+ *
+ * All values are wall-clock milliseconds. Rasterization is measured around
+ * the whole job batch, so with several threads it is shorter than the sum
+ * of per-glyph work; sdf_ms is that per-glyph sum for the distance
+ * transform alone. Dynamic atlases keep adding to rasterize_ms, sdf_ms and
+ * glyphs for every glyph loaded on demand after creation.
+ */
+typedef struct {
+    double load_ms;      /* Font parse, or reading the whole atlas from a cache file */
+    double rasterize_ms; /* Phase 1: outline rasterization (SDF/MSDF generation included) */
+    double sdf_ms;       /* Distance transform summed over glyphs (SDF atlases) */
+    double pack_ms;      /* Phase 2: rectangle packing, atlas growth retries included */
+    double copy_ms;      /* Phase 3: atlas image allocation and glyph blits */
+    double kerning_ms;   /* Kerning pair table */
+    double index_ms;     /* Codepoint lookup index */
+    double total_ms;     /* Whole build, from the first file access to the finished atlas */
+    int glyphs;          /* Glyphs rasterized */
+} glyph_atlas_bake_stats_t;
+
 /*
  * Font atlas containing pre-rasterized glyphs packed into a texture
  *
@@ -146,436 +249,2299 @@ typedef struct {
  * enables efficient text rendering by storing all glyphs in a single texture.
  */
 typedef struct {
-    glyph_image_t image;        /* RGB texture image containing packed glyphs */
+    glyph_image_t image;        /* Texture image containing packed glyphs (grayscale, RGB for MSDF) */
     glyph_atlas_char_t* chars;  /* Array of character data (one per glyph) */
     int num_chars;              /* Number of characters in the atlas */
     float pixel_height;         /* Font size used for rasterization */
+    float occupancy;            /* Fraction of atlas pixels covered by glyphs (0..1) */
+    glyph_atlas_index_t index;  /* Codepoint -> chars[] lookup table */
+    glyph_atlas_cache_t* cache; /* On-demand glyph cache (NULL for static atlases) */
+    int msdf;                   /* Non-zero when glyphs are multi-channel SDFs (3 channels) */
+    glyph_atlas_kerning_t kerning; /* Codepoint pair -> kerning table */
+    int borrowed_chars;         /* Non-zero when chars points into a merged atlas (glyph_atlas_merge) and is not freed here */
+#ifdef GLYPHGL_STATS
+    glyph_atlas_bake_stats_t bake_stats; /* Build phase timings */
+#endif
 } glyph_atlas_t;
 
 /*
- * Calculates the next power-of-2 value greater than or equal to input
- *
- * Used for determining optimal atlas texture dimensions, as OpenGL
- * historically preferred power-of-2 textures for better performance.
- * Uses bit manipulation for efficient calculation.
+ * Looks up a codepoint in the atlas index
  *
  * Parameters:
- *   v: Input value
+ *   index: Pointer to the lookup index
+ *   codepoint: Unicode codepoint to resolve
  *
- * Returns: Smallest power-of-2 >= v
+ * Returns: Index into the atlas chars array, or -1 if not present
  */
-static int glyph_atlas__next_pow2(int v) {
-    v--;                    /* Decrement to handle exact powers of 2 */
-    v |= v >> 1;           /* Fill in bits to the right */
-    v |= v >> 2;
-    v |= v >> 4;
-    v |= v >> 8;
-    v |= v >> 16;
-    v++;                   /* Increment to get next power of 2 */
-    return v;
-}
+static inline int glyph_atlas__index_lookup(const glyph_atlas_index_t* index, int codepoint) {
+    if (codepoint < 0) return -1;
+
+    /* BMP: two array loads, no hashing */
+    if (codepoint <= 0xFFFF) {
+        const int* page = index->pages[codepoint >> 8];
+        return page ? page[codepoint & 0xFF] : -1;
+    }
 
+    /* Astral planes: linear probing in a power-of-2 table */
+    if (!index->astral_capacity) return -1;
+    unsigned int mask = (unsigned int)index->astral_capacity - 1;
+    unsigned int slot = ((unsigned int)codepoint * 2654435761u) & mask;
+    while (index->astral_keys[slot] != -1) {
+        if (index->astral_keys[slot] == codepoint) return index->astral_values[slot];
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
 
 /*
- * Creates a font atlas by rasterizing and packing glyphs into a texture
+ * Grows the astral hash table and rehashes existing entries
  *
- * This is the core atlas generation function that:
- * 1. Loads the font file (TTF)
- * 2. Rasterizes each character in the charset
- * 3. Optionally converts to SDF for scalable rendering
- * 4. Packs glyphs efficiently into a 2D texture atlas
- * 5. Returns complete atlas with positioning data
+ * Parameters:
+ *   index: Pointer to the lookup index
+ *   new_capacity: New table capacity (must be a power of 2, may equal the
+ *                 current capacity to purge tombstones)
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static int glyph_atlas__index_grow_astral(glyph_atlas_index_t* index, int new_capacity) {
+    int* keys = (int*)GLYPH_MALLOC(new_capacity * sizeof(int));
+    int* values = (int*)GLYPH_MALLOC(new_capacity * sizeof(int));
+    if (!keys || !values) {
+        GLYPH_FREE(keys);
+        GLYPH_FREE(values);
+        return 0;
+    }
+    memset(keys, 0xFF, new_capacity * sizeof(int)); /* All slots empty (-1) */
+
+    /* Reinsert live entries into the new table, dropping tombstones */
+    unsigned int mask = (unsigned int)new_capacity - 1;
+    int live = 0;
+    for (int i = 0; i < index->astral_capacity; i++) {
+        if (index->astral_keys[i] < 0) continue;
+        unsigned int slot = ((unsigned int)index->astral_keys[i] * 2654435761u) & mask;
+        while (keys[slot] != -1) slot = (slot + 1) & mask;
+        keys[slot] = index->astral_keys[i];
+        values[slot] = index->astral_values[i];
+        live++;
+    }
+
+    GLYPH_FREE(index->astral_keys);
+    GLYPH_FREE(index->astral_values);
+    index->astral_keys = keys;
+    index->astral_values = values;
+    index->astral_capacity = new_capacity;
+    index->astral_count = live;
+    index->astral_tombstones = 0;
+    return 1;
+}
+
+/*
+ * Adds a codepoint to the atlas index
  *
- * The packing algorithm sorts glyphs by height and uses a row-based approach
- * to minimize wasted texture space while maintaining efficient access patterns.
+ * If the codepoint is already present the existing entry is kept, matching
+ * the first-match behavior of a linear search over a charset with duplicates.
  *
  * Parameters:
- *   font_path: Path to .ttf font file
- *   pixel_height: Font size for rasterization (affects quality/detail)
- *   charset: String containing all characters to include
- *   char_type: GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII encoding type
- *   use_sdf: Enable Signed Distance Field rendering (smoother scaling)
+ *   index: Pointer to the lookup index
+ *   codepoint: Unicode codepoint to add
+ *   char_index: Position of the character in the atlas chars array
  *
- * Returns: Complete glyph_atlas_t or zero-initialized struct on failure
+ * Returns: 1 on success, 0 on allocation failure or invalid codepoint
  */
-static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type, int use_sdf) {
-    /* Initialize atlas structure */
-    glyph_atlas_t atlas = {0};
+static int glyph_atlas__index_insert(glyph_atlas_index_t* index, int codepoint, int char_index) {
+    if (codepoint < 0) return 0;
+
+    if (codepoint <= 0xFFFF) {
+        int** page = &index->pages[codepoint >> 8];
+        if (!*page) {
+            /* Allocate page on first use, all slots empty (-1) */
+            *page = (int*)GLYPH_MALLOC(256 * sizeof(int));
+            if (!*page) return 0;
+            memset(*page, 0xFF, 256 * sizeof(int));
+        }
+        if ((*page)[codepoint & 0xFF] == -1) {
+            (*page)[codepoint & 0xFF] = char_index;
+            index->count++;
+        }
+        return 1;
+    }
 
-    /* Font structure */
-    glyph_font_t ttf_font;
-    float scale; /* Font units to pixel conversion factor */
+    /* Keep astral load factor below 50% so probe sequences stay short */
+    if ((index->astral_count + index->astral_tombstones + 1) * 2 > index->astral_capacity) {
+        /* Mostly tombstones: rehash in place instead of doubling */
+        int new_capacity = !index->astral_capacity ? 16 :
+                           (index->astral_count + 1) * 4 <= index->astral_capacity ? index->astral_capacity : index->astral_capacity * 2;
+        if (!glyph_atlas__index_grow_astral(index, new_capacity)) return 0;
+    }
 
-    /* Load TrueType font */
-    if (!glyph_ttf_load_font_from_file(&ttf_font, font_path)) {
-        GLYPH_LOG("Failed to load TTF font: %s\n", font_path);
-        return atlas;
+    unsigned int mask = (unsigned int)index->astral_capacity - 1;
+    unsigned int slot = ((unsigned int)codepoint * 2654435761u) & mask;
+    while (index->astral_keys[slot] != -1) {
+        if (index->astral_keys[slot] == codepoint) return 1; /* Keep first entry */
+        slot = (slot + 1) & mask;
     }
-    scale = glyph_ttf_scale_for_pixel_height(&ttf_font, pixel_height);
-    
-    /* Store the pixel height for reference */
-    atlas.pixel_height = pixel_height;
+    index->astral_keys[slot] = codepoint;
+    index->astral_values[slot] = char_index;
+    index->astral_count++;
+    index->count++;
+    return 1;
+}
 
-    /* Use default ASCII charset if none provided */
-    if (!charset) {
-        if (char_type == GLYPH_ENCODING_UTF8) {
-            charset = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
-        } else {
-            charset = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+/*
+ * Removes a codepoint from the atlas index
+ *
+ * Parameters:
+ *   index: Pointer to the lookup index
+ *   codepoint: Unicode codepoint to remove (no-op if not present)
+ */
+static void glyph_atlas__index_remove(glyph_atlas_index_t* index, int codepoint) {
+    if (codepoint < 0) return;
+
+    if (codepoint <= 0xFFFF) {
+        int* page = index->pages[codepoint >> 8];
+        if (page && page[codepoint & 0xFF] != -1) {
+            page[codepoint & 0xFF] = -1;
+            index->count--;
         }
+        return;
     }
 
-    /* Calculate number of characters in charset (handles UTF-8 multi-byte) */
-    int charset_len;
-    if (char_type == GLYPH_ENCODING_UTF8) {
-        charset_len = 0;
-        size_t idx = 0;
-        /* Count UTF-8 codepoints by decoding each sequence */
-        while (idx < strlen(charset)) {
-            glyph_atlas_utf8_decode(charset, &idx);
-            charset_len++;
+    if (!index->astral_capacity) return;
+    unsigned int mask = (unsigned int)index->astral_capacity - 1;
+    unsigned int slot = ((unsigned int)codepoint * 2654435761u) & mask;
+    while (index->astral_keys[slot] != -1) {
+        if (index->astral_keys[slot] == codepoint) {
+            index->astral_keys[slot] = -2; /* Tombstone keeps later probes reachable */
+            index->astral_count--;
+            index->astral_tombstones++;
+            index->count--;
+            return;
         }
-    } else {
-        /* Simple byte count for ASCII */
-        charset_len = strlen(charset);
+        slot = (slot + 1) & mask;
     }
+}
 
-    /* Allocate character data array */
-    atlas.num_chars = charset_len;
-    atlas.chars = (glyph_atlas_char_t*)GLYPH_MALLOC(charset_len * sizeof(glyph_atlas_char_t));
-    if (!atlas.chars) {
-        /* Cleanup on allocation failure */
-        glyph_ttf_free_font(&ttf_font);
-        return atlas;
+/*
+ * Releases all memory held by an atlas index
+ *
+ * Parameters:
+ *   index: Pointer to the lookup index to free
+ */
+static void glyph_atlas__index_free(glyph_atlas_index_t* index) {
+    for (int p = 0; p < 256; p++) {
+        GLYPH_FREE(index->pages[p]);
+        index->pages[p] = NULL;
     }
+    GLYPH_FREE(index->astral_keys);
+    GLYPH_FREE(index->astral_values);
+    index->astral_keys = NULL;
+    index->astral_values = NULL;
+    index->astral_capacity = 0;
+    index->astral_count = 0;
+    index->astral_tombstones = 0;
+    index->count = 0;
+}
 
-    /* Temporary structure to hold glyph bitmaps during processing */
-    typedef struct {
-        unsigned char* bitmap;  /* Rasterized glyph bitmap data */
-        int width, height;      /* Bitmap dimensions */
-        int xoff, yoff;         /* Baseline offsets */
-        int advance;            /* Cursor advance width */
-        int is_default;         /* Flag for SDF-generated bitmaps */
-    } temp_glyph_t;
-
-    /* Allocate temporary glyph storage */
-    temp_glyph_t* temp_glyphs = (temp_glyph_t*)GLYPH_MALLOC(charset_len * sizeof(temp_glyph_t));
-    if (!temp_glyphs) {
-        /* Cleanup on allocation failure */
-        GLYPH_FREE(atlas.chars);
-        atlas.chars = NULL;
-        glyph_ttf_free_font(&ttf_font);
-        return atlas;
+/*
+ * Builds the codepoint lookup index for every character in the atlas
+ *
+ * Parameters:
+ *   atlas: Pointer to an atlas with a populated chars array
+ *
+ * Returns: 1 on success, 0 on allocation failure (index is left empty)
+ */
+static int glyph_atlas__index_build(glyph_atlas_t* atlas) {
+    glyph_atlas__index_free(&atlas->index);
+    for (int i = 0; i < atlas->num_chars; i++) {
+        if (!glyph_atlas__index_insert(&atlas->index, atlas->chars[i].codepoint, i)) {
+            glyph_atlas__index_free(&atlas->index);
+            return 0;
+        }
     }
+    return 1;
+}
 
-    /* Phase 1: Rasterize all glyphs and calculate atlas requirements */
-    int total_width = 0;  /* Estimate total width needed for all glyphs */
-    int max_height = 0;   /* Track maximum glyph height */
+/* Largest number of pairs a dynamic atlas memoizes, beyond it pairs are resolved from the font each time */
+#ifndef GLYPHGL_KERNING_MEMO_LIMIT
+#define GLYPHGL_KERNING_MEMO_LIMIT 65536
+#endif
 
-    size_t charset_idx = 0; /* Index for UTF-8 charset traversal */
-    for (int i = 0; i < charset_len; i++) {
-        /* Decode next character from charset */
-        int codepoint;
-        if (char_type == GLYPH_ENCODING_UTF8) {
-            codepoint = glyph_atlas_utf8_decode(charset, &charset_idx);
-        } else {
-            codepoint = (unsigned char)charset[i];
-        }
-
-        /* Find glyph index in font (maps codepoint to glyph) */
-        int glyph_idx = glyph_ttf_find_glyph_index(&ttf_font, codepoint);
-
-        /* Handle missing glyphs (glyph_idx == 0 means .notdef glyph) */
-        if (glyph_idx == 0 && codepoint != ' ') {
-            /* Create fallback data for missing characters */
-            temp_glyphs[i].bitmap = NULL;
-            temp_glyphs[i].width = 0;
-            temp_glyphs[i].height = 0;
-            temp_glyphs[i].xoff = 0;
-            temp_glyphs[i].yoff = 0;
-            temp_glyphs[i].advance = (int)(pixel_height * 0.5f); /* Half-width fallback */
-            temp_glyphs[i].is_default = 0;
-            atlas.chars[i].codepoint = codepoint;
-            continue;
-        }
+/* Packs a codepoint pair into a non-zero hash key (codepoints fit in 21 bits) */
+static inline uint64_t glyph_atlas__kerning_key(int left, int right) {
+    return (((uint64_t)(left & 0x1FFFFF) << 21) | (uint64_t)(right & 0x1FFFFF)) + 1;
+}
 
-        /* Rasterize the glyph into a bitmap */
-        int width, height, xoff, yoff;
-        unsigned char* bitmap;
+/* Finds a pair; returns its slot, or the empty slot where it belongs */
+static inline int glyph_atlas__kerning_slot(const glyph_atlas_kerning_t* kerning, uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    int mask = kerning->capacity - 1;
+    int slot = (int)(h >> 40) & mask;
+    while (kerning->keys[slot] && kerning->keys[slot] != key) slot = (slot + 1) & mask;
+    return slot;
+}
 
-        /* Get glyph bitmap from TrueType font */
-        bitmap = glyph_ttf_get_glyph_bitmap(&ttf_font, glyph_idx, scale, scale,
-                                             &width, &height, &xoff, &yoff);
+/* Frees the pair table */
+static void glyph_atlas__kerning_free(glyph_atlas_kerning_t* kerning) {
+    GLYPH_FREE(kerning->keys);
+    GLYPH_FREE(kerning->values);
+    kerning->keys = NULL;
+    kerning->values = NULL;
+    kerning->capacity = 0;
+    kerning->count = 0;
+}
 
-        /* Convert to Signed Distance Field if requested */
-        if (use_sdf && bitmap) {
-            /* Generate SDF bitmap for smooth scaling */
-            unsigned char* sdf = glyph_ttf_get_glyph_sdf_bitmap(bitmap, width, height, 4);
-            /* Free original bitmap */
-            glyph_ttf_free_bitmap(bitmap);
-            bitmap = sdf; /* Use SDF bitmap instead */
-            temp_glyphs[i].is_default = 1; /* Mark as SDF-generated */
+/*
+ * Stores a pair's kerning, growing the table to keep it at most half full
+ *
+ * Returns: 1 on success, 0 on allocation failure (table left unchanged)
+ */
+static int glyph_atlas__kerning_insert(glyph_atlas_kerning_t* kerning, int left, int right, float value) {
+    if ((kerning->count + 1) * 2 > kerning->capacity) {
+        int capacity = kerning->capacity ? kerning->capacity * 2 : 256;
+        glyph_atlas_kerning_t grown = *kerning;
+        grown.keys = (uint64_t*)GLYPH_MALLOC((size_t)capacity * sizeof(uint64_t));
+        grown.values = (float*)GLYPH_MALLOC((size_t)capacity * sizeof(float));
+        if (!grown.keys || !grown.values) {
+            GLYPH_FREE(grown.keys);
+            GLYPH_FREE(grown.values);
+            return 0;
         }
+        memset(grown.keys, 0, (size_t)capacity * sizeof(uint64_t));
+        grown.capacity = capacity;
+        for (int i = 0; i < kerning->capacity; i++) {
+            if (!kerning->keys[i]) continue;
+            int slot = glyph_atlas__kerning_slot(&grown, kerning->keys[i]);
+            grown.keys[slot] = kerning->keys[i];
+            grown.values[slot] = kerning->values[i];
+        }
+        GLYPH_FREE(kerning->keys);
+        GLYPH_FREE(kerning->values);
+        *kerning = grown;
+    }
+    uint64_t key = glyph_atlas__kerning_key(left, right);
+    int slot = glyph_atlas__kerning_slot(kerning, key);
+    if (!kerning->keys[slot]) {
+        kerning->keys[slot] = key;
+        kerning->count++;
+    }
+    kerning->values[slot] = value;
+    return 1;
+}
 
-        /* Store glyph data in temporary structure */
-        temp_glyphs[i].bitmap = bitmap;
-        temp_glyphs[i].width = width;
-        temp_glyphs[i].height = height;
-        temp_glyphs[i].xoff = xoff;
-        temp_glyphs[i].yoff = yoff;
+/* Glyph index of an atlas character, sorted by glyph to map table pairs back to characters */
+typedef struct {
+    int glyph;
+    int index;
+} glyph_atlas__glyph_char_t;
 
-        /* Get horizontal advance width */
-        temp_glyphs[i].advance = (int)(glyph_ttf_get_glyph_advance(&ttf_font, glyph_idx) * scale);
-        temp_glyphs[i].is_default = use_sdf ? 1 : 0;
+typedef struct {
+    glyph_atlas_t* atlas;
+    const glyph_atlas__glyph_char_t* chars;
+    int count;
+    float scale;
+} glyph_atlas__kerning_build_t;
+
+/* qsort comparator: by glyph index, then atlas order */
+static int glyph_atlas__glyph_char_compare(const void* a, const void* b) {
+    const glyph_atlas__glyph_char_t* ca = (const glyph_atlas__glyph_char_t*)a;
+    const glyph_atlas__glyph_char_t* cb = (const glyph_atlas__glyph_char_t*)b;
+    if (ca->glyph != cb->glyph) return ca->glyph < cb->glyph ? -1 : 1;
+    return ca->index - cb->index;
+}
 
-        /* Store basic character info */
-        atlas.chars[i].codepoint = codepoint;
-        atlas.chars[i].advance = temp_glyphs[i].advance;
+/* First entry for a glyph in the sorted map (count if absent) */
+static int glyph_atlas__glyph_char_find(const glyph_atlas__glyph_char_t* chars, int count, int glyph) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (chars[mid].glyph < glyph) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
 
-        /* Accumulate atlas size requirements */
-        total_width += width + 4; /* Add padding between glyphs */
-        if (height > max_height) {
-            max_height = height;
+/* Stores a glyph pair for every pair of atlas characters sharing those glyphs */
+static int glyph_atlas__kerning_pair(void* user_data, int left, int right, int advance) {
+    glyph_atlas__kerning_build_t* build = (glyph_atlas__kerning_build_t*)user_data;
+    const glyph_atlas__glyph_char_t* chars = build->chars;
+    const glyph_atlas_char_t* atlas_chars = build->atlas->chars;
+    int first = glyph_atlas__glyph_char_find(chars, build->count, right);
+    for (int i = glyph_atlas__glyph_char_find(chars, build->count, left); i < build->count && chars[i].glyph == left; i++) {
+        for (int j = first; j < build->count && chars[j].glyph == right; j++) {
+            if (!glyph_atlas__kerning_insert(&build->atlas->kerning, atlas_chars[chars[i].index].codepoint, atlas_chars[chars[j].index].codepoint, advance * build->scale)) return 0;
         }
     }
+    return 1;
+}
 
-    /* Phase 2: Sort glyphs by height for optimal packing */
-    /* Sort glyphs tallest-first to minimize wasted vertical space */
-    int* glyph_order = (int*)GLYPH_MALLOC(charset_len * sizeof(int));
-    if (!glyph_order) {
-        /* Cleanup on allocation failure */
-        GLYPH_FREE(atlas.chars);
-        atlas.chars = NULL;
-        GLYPH_FREE(temp_glyphs);
-        glyph_ttf_free_font(&ttf_font);
-        return atlas;
+/*
+ * Precomputes the kerning of every pair of atlas characters
+ *
+ * Only non-zero pairs are stored. The charset's glyph indices are sorted once
+ * and the font's kerning tables are walked against them, so the cost follows
+ * the number of pairs the font defines rather than the square of the charset.
+ *
+ * Parameters:
+ *   atlas: Atlas with its chars array filled in
+ *   font: Font the atlas was rasterized from
+ *   scale: Font units to atlas pixels
+ */
+static void glyph_atlas__kerning_build(glyph_atlas_t* atlas, const glyph_font_t* font, float scale) {
+    int n = atlas->num_chars;
+    if (n == 0 || (!font->num_kern_subtables && !font->kern)) return;
+    glyph_atlas__glyph_char_t* chars = (glyph_atlas__glyph_char_t*)GLYPH_MALLOC((size_t)n * sizeof(glyph_atlas__glyph_char_t));
+    int* glyphs = (int*)GLYPH_MALLOC((size_t)n * sizeof(int));
+    if (!chars || !glyphs) {
+        GLYPH_FREE(chars);
+        GLYPH_FREE(glyphs);
+        return;
     }
 
-    /* Initialize sort indices */
-    for (int i = 0; i < charset_len; i++) {
-        glyph_order[i] = i;
+    /* Sort the mapped characters by glyph; the distinct glyphs form the set to match */
+    int count = 0, num_glyphs = 0;
+    for (int i = 0; i < n; i++) {
+        int glyph = glyph_ttf_find_glyph_index(font, atlas->chars[i].codepoint);
+        if (!glyph) continue;
+        chars[count].glyph = glyph;
+        chars[count].index = i;
+        count++;
+    }
+    qsort(chars, (size_t)count, sizeof(glyph_atlas__glyph_char_t), glyph_atlas__glyph_char_compare);
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || chars[i].glyph != chars[i - 1].glyph) glyphs[num_glyphs++] = chars[i].glyph;
     }
 
-    /* Bubble sort by height (descending) - simple but effective for glyph counts */
-    for (int i = 0; i < charset_len - 1; i++) {
-        for (int j = 0; j < charset_len - i - 1; j++) {
-            if (temp_glyphs[glyph_order[j]].height < temp_glyphs[glyph_order[j + 1]].height) {
-                /* Swap indices to sort by decreasing height */
-                int temp = glyph_order[j];
-                glyph_order[j] = glyph_order[j + 1];
-                glyph_order[j + 1] = temp;
-            }
-        }
+    glyph_atlas__kerning_build_t build;
+    build.atlas = atlas;
+    build.chars = chars;
+    build.count = count;
+    build.scale = scale;
+    if (!glyph_ttf_get_kerning_pairs(font, glyphs, num_glyphs, glyph_atlas__kerning_pair, &build)) {
+        GLYPH_LOG("Warning: Failed to allocate kerning pairs\n");
     }
-    
-    /* Phase 3: Create atlas texture and pack glyphs */
-    int padding = 4; /* Pixels between glyphs to prevent bleeding */
+    GLYPH_FREE(chars);
+    GLYPH_FREE(glyphs);
+}
 
-    /* Estimate atlas size using square root of total area, round up to power-of-2 */
-    int atlas_width = glyph_atlas__next_pow2((int)sqrtf(total_width * max_height) + 256);
-    int atlas_height = atlas_width;
+/*
+ * Calculates the next power-of-2 value greater than or equal to input
+ *
+ * Used for determining optimal atlas texture dimensions, as OpenGL
+ * historically preferred power-of-2 textures for better performance.
+ * Uses bit manipulation for efficient calculation.
+ *
+ * Parameters:
+ *   v: Input value
+ *
+ * Returns: Smallest power-of-2 >= v
+ */
+static int glyph_atlas__next_pow2(int v) {
+    v--;                    /* Decrement to handle exact powers of 2 */
+    v |= v >> 1;           /* Fill in bits to the right */
+    v |= v >> 2;
+    v |= v >> 4;
+    v |= v >> 8;
+    v |= v >> 16;
+    v++;                   /* Increment to get next power of 2 */
+    return v;
+}
+
+/*
+ * Rectangle packing algorithms available to the atlas builder
+ *
+ * All packers receive the rectangles sorted by decreasing height (O(n log n))
+ * and place them without overlap inside a fixed-size bin:
+ * - SHELF:    Row-based packing, fastest but leaves gaps above short glyphs
+ * - SKYLINE:  Bottom-left skyline, near-MaxRects density at shelf speed (default)
+ * - MAXRECTS: Best-short-side-fit MaxRects, densest result but slowest for
+ *             very large charsets
+ */
+typedef enum {
+    GLYPH_ATLAS_PACKER_SHELF = 0,
+    GLYPH_ATLAS_PACKER_SKYLINE,
+    GLYPH_ATLAS_PACKER_MAXRECTS
+} glyph_atlas_packer_t;
 
-    /* Ensure minimum atlas size */
-    if (atlas_width < GLYPHGL_ATLAS_WIDTH) atlas_width = GLYPHGL_ATLAS_WIDTH;
-    if (atlas_height < GLYPHGL_ATLAS_HEIGHT) atlas_height = GLYPHGL_ATLAS_HEIGHT;
+/* Rectangle handed to a packer: size is the input, position the output */
+typedef struct {
+    int w, h;         /* Requested size in pixels (padding included) */
+    int x, y;         /* Assigned top-left position inside the bin */
+    int was_packed;   /* Non-zero once the rectangle has been placed */
+} glyph_atlas_rect_t;
 
-    /* Create RGB image for atlas texture */
-    atlas.image = glyph_image_create(atlas_width, atlas_height);
-    memset(atlas.image.data, 0, atlas_width * atlas_height * 3); /* Clear to black */
-    
-    /* Initialize packing cursor and row tracking */
-    int pen_x = padding;     /* Current X position in atlas */
-    int pen_y = padding;     /* Current Y position in atlas */
-    int row_height = 0;      /* Height of current row */
+/*
+ * Custom packer callback
+ *
+ * Must place every rectangle inside a width x height bin without overlap,
+ * filling x, y and was_packed.
+ *
+ * Returns: 1 if all rectangles were placed, 0 if the bin is too small
+ */
+typedef int (*glyph_atlas_pack_fn)(void* user_data, glyph_atlas_rect_t* rects, int count, int width, int height);
+
+/* qsort comparator: tallest first, then widest, then input order (deterministic) */
+static int glyph_atlas__rect_compare(const void* a, const void* b) {
+    const glyph_atlas_rect_t* ra = *(const glyph_atlas_rect_t* const*)a;
+    const glyph_atlas_rect_t* rb = *(const glyph_atlas_rect_t* const*)b;
+    if (ra->h != rb->h) return rb->h - ra->h;
+    if (ra->w != rb->w) return rb->w - ra->w;
+    return (ra < rb) ? -1 : (ra > rb);
+}
 
-    /* Structure to track glyphs in current packing row */
-    typedef struct {
-        int index;  /* Index into temp_glyphs array */
-        int yoff;   /* Y offset of this glyph */
-    } row_glyph_t;
+/* Shelf packer: fills rows left to right, opening a new row when full */
+static int glyph_atlas__pack_shelf(glyph_atlas_rect_t** order, int count, int width, int height) {
+    int x = 0, y = 0, row_height = 0;
+    for (int i = 0; i < count; i++) {
+        glyph_atlas_rect_t* r = order[i];
+        if (r->w > width) return 0;
+        /* Start a new row when the current one is full */
+        if (x + r->w > width) {
+            y += row_height;
+            x = 0;
+            row_height = 0;
+        }
+        if (y + r->h > height) return 0;
+        r->x = x;
+        r->y = y;
+        r->was_packed = 1;
+        x += r->w;
+        if (r->h > row_height) row_height = r->h;
+    }
+    return 1;
+}
 
-    /* Allocate space for tracking current row */
-    row_glyph_t* current_row = (row_glyph_t*)GLYPH_MALLOC(charset_len * sizeof(row_glyph_t));
-    int row_count = 0; /* Number of glyphs in current row */
+/* Skyline segment: horizontal span [x, x + w) whose top edge is at y */
+typedef struct {
+    int x, y, w;
+} glyph_atlas__skyline_node_t;
 
-    /* Pack glyphs into atlas using sorted order */
-    for (int order_idx = 0; order_idx < charset_len; order_idx++) {
-        int i = glyph_order[order_idx];
+/*
+ * Returns the lowest y at which a rectangle of width w can rest when its left
+ * edge starts at skyline node 'index' (the highest segment under its span)
+ */
+static int glyph_atlas__skyline_fit(const glyph_atlas__skyline_node_t* nodes, int num_nodes, int index, int w) {
+    int y = 0;
+    int width_left = w;
+    while (width_left > 0 && index < num_nodes) {
+        if (nodes[index].y > y) y = nodes[index].y;
+        width_left -= nodes[index].w;
+        index++;
+    }
+    return y;
+}
 
-        /* Skip glyphs with no bitmap data */
-        if (!temp_glyphs[i].bitmap || temp_glyphs[i].width == 0) {
-            /* Set zero data for empty glyphs */
-            atlas.chars[i].x = 0;
-            atlas.chars[i].y = 0;
-            atlas.chars[i].width = 0;
-            atlas.chars[i].height = 0;
-            atlas.chars[i].xoff = 0;
-            atlas.chars[i].yoff = 0;
-            continue;
+/* Skyline bottom-left packer: places each rectangle where its top edge ends lowest */
+static int glyph_atlas__pack_skyline(glyph_atlas_rect_t** order, int count, int width, int height) {
+    /* Every placement adds at most one segment, so count + 1 nodes always suffice */
+    glyph_atlas__skyline_node_t* nodes = (glyph_atlas__skyline_node_t*)GLYPH_MALLOC((count + 1) * sizeof(glyph_atlas__skyline_node_t));
+    if (!nodes) return 0;
+    int num_nodes = 1;
+    nodes[0].x = 0;
+    nodes[0].y = 0;
+    nodes[0].w = width;
+
+    for (int k = 0; k < count; k++) {
+        glyph_atlas_rect_t* r = order[k];
+        int best_index = -1, best_top = height + 1, best_width = width + 1, best_y = 0;
+
+        /* Pick the segment giving the lowest top edge, ties go to the narrowest segment */
+        for (int i = 0; i < num_nodes; i++) {
+            if (nodes[i].x + r->w > width) break; /* Segments are sorted by x */
+            int y = glyph_atlas__skyline_fit(nodes, num_nodes, i, r->w);
+            int top = y + r->h;
+            if (top > height) continue;
+            if (top < best_top || (top == best_top && nodes[i].w < best_width)) {
+                best_index = i;
+                best_top = top;
+                best_width = nodes[i].w;
+                best_y = y;
+            }
+        }
+        if (best_index < 0) {
+            GLYPH_FREE(nodes);
+            return 0;
         }
 
-        /* Check if glyph fits in current row, if not, finalize current row */
-        if (pen_x + temp_glyphs[i].width + padding > atlas_width) {
-            /* Calculate baseline alignment for current row */
-            int max_yoff = 0;
-            for (int r = 0; r < row_count; r++) {
-                if (temp_glyphs[current_row[r].index].yoff > max_yoff) {
-                    max_yoff = temp_glyphs[current_row[r].index].yoff;
-                }
+        r->x = nodes[best_index].x;
+        r->y = best_y;
+        r->was_packed = 1;
+
+        /* Insert the new segment on top of the placed rectangle */
+        memmove(&nodes[best_index + 1], &nodes[best_index], (num_nodes - best_index) * sizeof(glyph_atlas__skyline_node_t));
+        nodes[best_index].x = r->x;
+        nodes[best_index].y = best_top;
+        nodes[best_index].w = r->w;
+        num_nodes++;
+
+        /* Trim or drop the segments now hidden underneath it */
+        int right = r->x + r->w;
+        int i = best_index + 1;
+        while (i < num_nodes && nodes[i].x < right) {
+            int shrink = right - nodes[i].x;
+            if (nodes[i].w <= shrink) {
+                memmove(&nodes[i], &nodes[i + 1], (num_nodes - i - 1) * sizeof(glyph_atlas__skyline_node_t));
+                num_nodes--;
+                continue;
             }
+            nodes[i].x += shrink;
+            nodes[i].w -= shrink;
+            break;
+        }
 
-            /* Blit all glyphs in current row to atlas */
-            for (int r = 0; r < row_count; r++) {
-                int idx = current_row[r].index;
-                /* Align glyph to baseline */
-                int glyph_top = max_yoff - temp_glyphs[idx].yoff;
-
-                /* Copy glyph bitmap to atlas texture */
-                for (int y = 0; y < temp_glyphs[idx].height; y++) {
-                    for (int x = 0; x < temp_glyphs[idx].width; x++) {
-                        int atlas_x = atlas.chars[idx].x + x;
-                        int atlas_y = atlas.chars[idx].y + glyph_top + y;
-                        unsigned char alpha = temp_glyphs[idx].bitmap[y * temp_glyphs[idx].width + x];
-
-                        /* Write grayscale alpha to RGB channels */
-                        int pixel_idx = (atlas_y * atlas_width + atlas_x) * 3;
-                        atlas.image.data[pixel_idx + 0] = alpha;
-                        atlas.image.data[pixel_idx + 1] = alpha;
-                        atlas.image.data[pixel_idx + 2] = alpha;
-                    }
-                }
-
-                /* Update final Y position after baseline alignment */
-                atlas.chars[idx].y = atlas.chars[idx].y + glyph_top;
+        /* Merge neighbouring segments at the same height */
+        for (i = 0; i < num_nodes - 1;) {
+            if (nodes[i].y == nodes[i + 1].y) {
+                nodes[i].w += nodes[i + 1].w;
+                memmove(&nodes[i + 1], &nodes[i + 2], (num_nodes - i - 2) * sizeof(glyph_atlas__skyline_node_t));
+                num_nodes--;
+            } else {
+                i++;
             }
-
-            /* Start new row */
-            pen_x = padding;
-            pen_y += row_height + padding;
-            row_height = 0;
-            row_count = 0;
-        }
-        
-        /* Check if glyph fits vertically in atlas, resize if needed */
-        if (pen_y + temp_glyphs[i].height + padding > atlas_height) {
-            GLYPH_LOG("Warning: Atlas too small, increasing size for glyph %d\n", i);
-            /* Double atlas size and restart packing */
-            atlas_width *= 2;
-            atlas_height *= 2;
-            glyph_image_free(&atlas.image);
-            atlas.image = glyph_image_create(atlas_width, atlas_height);
-            memset(atlas.image.data, 0, atlas_width * atlas_height * 3);
-            /* Reset packing state */
-            pen_x = padding;
-            pen_y = padding;
-            row_height = 0;
-            row_count = 0;
-            order_idx = -1; /* Restart the packing loop */
-            continue;
         }
+    }
 
-        /* Add glyph to current row */
-        current_row[row_count].index = i;
-        current_row[row_count].yoff = temp_glyphs[i].yoff;
-        row_count++;
+    GLYPH_FREE(nodes);
+    return 1;
+}
 
-        /* Record glyph position in atlas */
-        atlas.chars[i].x = pen_x;
-        atlas.chars[i].y = pen_y;
-        atlas.chars[i].width = temp_glyphs[i].width;
-        atlas.chars[i].height = temp_glyphs[i].height;
-        atlas.chars[i].xoff = temp_glyphs[i].xoff;
-        atlas.chars[i].yoff = temp_glyphs[i].yoff;
+/* MaxRects free rectangle */
+typedef struct {
+    int x, y, w, h;
+} glyph_atlas__free_rect_t;
+
+/* Appends a free rectangle, growing the list as needed (returns 0 on allocation failure) */
+static int glyph_atlas__free_rect_push(glyph_atlas__free_rect_t** list, int* count, int* capacity, int x, int y, int w, int h) {
+    if (*count == *capacity) {
+        int new_capacity = *capacity * 2;
+        glyph_atlas__free_rect_t* grown = (glyph_atlas__free_rect_t*)GLYPH_REALLOC(*list, new_capacity * sizeof(glyph_atlas__free_rect_t));
+        if (!grown) return 0;
+        *list = grown;
+        *capacity = new_capacity;
+    }
+    (*list)[*count].x = x;
+    (*list)[*count].y = y;
+    (*list)[*count].w = w;
+    (*list)[*count].h = h;
+    (*count)++;
+    return 1;
+}
 
-        /* Update row height to accommodate tallest glyph */
-        int bottom = temp_glyphs[i].height;
-        row_height = (bottom > row_height) ? bottom : row_height;
-
-        /* Advance cursor for next glyph */
-        pen_x += temp_glyphs[i].width + padding * 2;
-    }
-    
-    /* Finalize last row if it contains glyphs */
-    if (row_count > 0) {
-        /* Calculate baseline alignment for final row */
-        int max_yoff = 0;
-        for (int r = 0; r < row_count; r++) {
-            if (temp_glyphs[current_row[r].index].yoff > max_yoff) {
-                max_yoff = temp_glyphs[current_row[r].index].yoff;
+/* MaxRects packer with the best-short-side-fit heuristic */
+static int glyph_atlas__pack_maxrects(glyph_atlas_rect_t** order, int count, int width, int height) {
+    int capacity = 64, num_free = 0;
+    glyph_atlas__free_rect_t* free_rects = (glyph_atlas__free_rect_t*)GLYPH_MALLOC(capacity * sizeof(glyph_atlas__free_rect_t));
+    if (!free_rects) return 0;
+    glyph_atlas__free_rect_push(&free_rects, &num_free, &capacity, 0, 0, width, height);
+
+    for (int k = 0; k < count; k++) {
+        glyph_atlas_rect_t* r = order[k];
+        int best = -1, best_short = 0x7FFFFFFF, best_long = 0x7FFFFFFF;
+
+        /* Choose the free rectangle leaving the smallest leftover on its short side */
+        for (int i = 0; i < num_free; i++) {
+            const glyph_atlas__free_rect_t* f = &free_rects[i];
+            if (f->w < r->w || f->h < r->h) continue;
+            int dw = f->w - r->w, dh = f->h - r->h;
+            int short_side = dw < dh ? dw : dh;
+            int long_side = dw < dh ? dh : dw;
+            if (short_side < best_short || (short_side == best_short && long_side < best_long)) {
+                best = i;
+                best_short = short_side;
+                best_long = long_side;
             }
         }
+        if (best < 0) {
+            GLYPH_FREE(free_rects);
+            return 0;
+        }
 
-        /* Blit final row glyphs to atlas */
-        for (int r = 0; r < row_count; r++) {
-            int idx = current_row[r].index;
-            int glyph_top = max_yoff - temp_glyphs[idx].yoff;
-
-            /* Copy glyph bitmap to final position */
-            for (int y = 0; y < temp_glyphs[idx].height; y++) {
-                for (int x = 0; x < temp_glyphs[idx].width; x++) {
-                    int atlas_x = atlas.chars[idx].x + x;
-                    int atlas_y = atlas.chars[idx].y + glyph_top + y;
-                    unsigned char alpha = temp_glyphs[idx].bitmap[y * temp_glyphs[idx].width + x];
+        r->x = free_rects[best].x;
+        r->y = free_rects[best].y;
+        r->was_packed = 1;
+
+        /* Split every free rectangle overlapping the placement into up to four maximal pieces */
+        int rx2 = r->x + r->w, ry2 = r->y + r->h;
+        int first_new = num_free;
+        for (int i = 0; i < first_new; i++) {
+            glyph_atlas__free_rect_t f = free_rects[i];
+            int fx2 = f.x + f.w, fy2 = f.y + f.h;
+            if (r->x >= fx2 || rx2 <= f.x || r->y >= fy2 || ry2 <= f.y) continue;
+            int ok = 1;
+            if (r->x > f.x)  ok &= glyph_atlas__free_rect_push(&free_rects, &num_free, &capacity, f.x, f.y, r->x - f.x, f.h);
+            if (rx2 < fx2)   ok &= glyph_atlas__free_rect_push(&free_rects, &num_free, &capacity, rx2, f.y, fx2 - rx2, f.h);
+            if (r->y > f.y)  ok &= glyph_atlas__free_rect_push(&free_rects, &num_free, &capacity, f.x, f.y, f.w, r->y - f.y);
+            if (ry2 < fy2)   ok &= glyph_atlas__free_rect_push(&free_rects, &num_free, &capacity, f.x, ry2, f.w, fy2 - ry2);
+            if (!ok) {
+                GLYPH_FREE(free_rects);
+                return 0;
+            }
+            free_rects[i].w = 0; /* Mark the split rectangle for removal */
+        }
 
-                    /* Write to RGB atlas */
-                    int pixel_idx = (atlas_y * atlas_width + atlas_x) * 3;
-                    atlas.image.data[pixel_idx + 0] = alpha;
-                    atlas.image.data[pixel_idx + 1] = alpha;
-                    atlas.image.data[pixel_idx + 2] = alpha;
+        /* Prune: only the new pieces can be redundant, drop those enclosed by another free rectangle */
+        for (int i = first_new; i < num_free; i++) {
+            const glyph_atlas__free_rect_t* a = &free_rects[i];
+            for (int j = 0; j < num_free; j++) {
+                const glyph_atlas__free_rect_t* b = &free_rects[j];
+                if (j == i || b->w == 0) continue;
+                if (a->x >= b->x && a->y >= b->y && a->x + a->w <= b->x + b->w && a->y + a->h <= b->y + b->h) {
+                    free_rects[i].w = 0;
+                    break;
                 }
             }
-
-            /* Update final Y position */
-            atlas.chars[idx].y = atlas.chars[idx].y + glyph_top;
         }
-    }
-    
-    /* Cleanup temporary resources */
-    GLYPH_FREE(current_row);
-    GLYPH_FREE(glyph_order);
 
-    /* Free all glyph bitmaps */
-    for (int i = 0; i < charset_len; i++) {
-        if (temp_glyphs[i].bitmap) {
-            if (temp_glyphs[i].is_default) {
-                /* SDF bitmaps allocated with GLYPH_MALLOC */
-                GLYPH_FREE(temp_glyphs[i].bitmap);
-            } else {
-                /* Regular bitmaps from font parsers */
-                glyph_ttf_free_bitmap(temp_glyphs[i].bitmap);
-            }
+        /* Compact the list */
+        int alive = 0;
+        for (int i = 0; i < num_free; i++) {
+            if (free_rects[i].w > 0) free_rects[alive++] = free_rects[i];
         }
+        num_free = alive;
     }
-    GLYPH_FREE(temp_glyphs);
-
-    /* Free font resources */
-    glyph_ttf_free_font(&ttf_font);
 
-    /* Return completed atlas */
-    return atlas;
+    GLYPH_FREE(free_rects);
+    return 1;
 }
 
 /*
- * Frees all resources associated with a glyph atlas
+ * Packs rectangles into a fixed-size bin with the selected algorithm
  *
- * Deallocates the character array and atlas image. Safe to call
- * on partially initialized or empty atlases.
+ * Rectangles keep their array order; positions are written into x/y. Zero-sized
+ * rectangles are placed at the origin without consuming space.
  *
  * Parameters:
- *   atlas: Pointer to glyph_atlas_t to free
+ *   packer: Packing algorithm to use
+ *   rects: Rectangles to place (w/h in, x/y/was_packed out)
+ *   count: Number of rectangles
+ *   width, height: Bin dimensions
+ *
+ * Returns: 1 if every rectangle was placed, 0 if the bin is too small or allocation failed
  */
-static inline void glyph_atlas_free(glyph_atlas_t* atlas) {
-    if (!atlas) return;
-    /* Free character data array */
-    if (atlas->chars) {
-        GLYPH_FREE(atlas->chars);
-        atlas->chars = NULL;
-    }
+static inline int glyph_atlas_pack_rects(glyph_atlas_packer_t packer, glyph_atlas_rect_t* rects, int count, int width, int height) {
+    if (count <= 0) return 1;
+
+    /* Sort pointers so the caller's array order is preserved */
+    glyph_atlas_rect_t** order = (glyph_atlas_rect_t**)GLYPH_MALLOC(count * sizeof(glyph_atlas_rect_t*));
+    if (!order) return 0;
+    int num_sized = 0;
+    for (int i = 0; i < count; i++) {
+        rects[i].was_packed = 0;
+        if (rects[i].w <= 0 || rects[i].h <= 0) {
+            rects[i].x = 0;
+            rects[i].y = 0;
+            rects[i].was_packed = 1;
+            continue;
+        }
+        order[num_sized++] = &rects[i];
+    }
+    qsort(order, num_sized, sizeof(glyph_atlas_rect_t*), glyph_atlas__rect_compare);
+
+    int result;
+    switch (packer) {
+        case GLYPH_ATLAS_PACKER_SHELF:    result = glyph_atlas__pack_shelf(order, num_sized, width, height); break;
+        case GLYPH_ATLAS_PACKER_MAXRECTS: result = glyph_atlas__pack_maxrects(order, num_sized, width, height); break;
+        case GLYPH_ATLAS_PACKER_SKYLINE:
+        default:                          result = glyph_atlas__pack_skyline(order, num_sized, width, height); break;
+    }
+
+    GLYPH_FREE(order);
+    return result;
+}
+
+
+/*
+ * Atlas build configuration
+ *
+ * Optional settings for glyph_atlas_create_ex. Start from
+ * glyph_atlas_default_config() and override only the fields you need, so
+ * new fields added in later versions keep sensible defaults.
+ */
+typedef struct {
+    int num_threads;                    /* Rasterization workers: 1 = serial, 0 = one per core */
+    glyph_job_dispatch_fn dispatch;     /* Optional job system hook (NULL = built-in thread pool) */
+    void* dispatch_user_data;           /* User pointer forwarded to dispatch */
+    glyph_atlas_packer_t packer;        /* Built-in packing algorithm */
+    glyph_atlas_pack_fn pack;           /* Optional custom packer (overrides 'packer') */
+    void* pack_user_data;               /* User pointer forwarded to pack */
+    int padding;                        /* Empty pixels kept around every glyph (at least 1) */
+    int min_width, min_height;          /* Smallest atlas size to start packing from */
+    int dynamic;                        /* Non-zero: fixed-size atlas filled on demand with LRU eviction */
+    int dynamic_width, dynamic_height;  /* Atlas size in dynamic mode */
+    int sdf_spread;                     /* SDF distance range in pixels, also added as a border around each glyph */
+    const unsigned char* font_data;     /* Optional in-memory font file used instead of font_path (not copied; */
+    size_t font_data_size;              /* must outlive dynamic atlases, which keep reading it) */
+    const char* cache_path;             /* Optional binary atlas cache: loaded when its key matches, else rebuilt and written (static atlases only) */
+    int kerning;                        /* Non-zero: precompute the charset's kerning pairs and apply them in layout */
+    const glyph_allocator_t* allocator; /* Source of memory used only while building (NULL = GLYPH_MALLOC); the */
+                                        /* finished atlas still uses GLYPH_MALLOC so glyph_atlas_free is unchanged */
+} glyph_atlas_config_t;
+
+/*
+ * Returns the default atlas build configuration
+ *
+ * Defaults reproduce the behavior of glyph_atlas_create: serial rasterization
+ * on the calling thread and skyline packing into the smallest power-of-2 atlas
+ * (at least GLYPHGL_ATLAS_WIDTH x GLYPHGL_ATLAS_HEIGHT) that fits.
+ *
+ * Returns: glyph_atlas_config_t with default values
+ */
+static inline glyph_atlas_config_t glyph_atlas_default_config(void) {
+    glyph_atlas_config_t config;
+    config.num_threads = 1;
+    config.dispatch = NULL;
+    config.dispatch_user_data = NULL;
+    config.packer = GLYPH_ATLAS_PACKER_SKYLINE;
+    config.pack = NULL;
+    config.pack_user_data = NULL;
+    config.padding = 2;
+    config.min_width = GLYPHGL_ATLAS_WIDTH;
+    config.min_height = GLYPHGL_ATLAS_HEIGHT;
+    config.dynamic = 0;
+    config.dynamic_width = 1024;
+    config.dynamic_height = 1024;
+    config.sdf_spread = 4;
+    config.font_data = NULL;
+    config.font_data_size = 0;
+    config.cache_path = NULL;
+    config.kerning = 1;
+    config.allocator = NULL;
+    return config;
+}
+
+/* Temporary structure to hold glyph bitmaps during atlas processing */
+typedef struct {
+    unsigned char* bitmap;  /* Rasterized glyph bitmap data */
+    int width, height;      /* Bitmap dimensions */
+    int xoff, yoff;         /* Baseline offsets */
+    int advance;            /* Cursor advance width */
+    const glyph_allocator_t* allocator; /* Owner of bitmap (NULL = GLYPH_MALLOC) */
+#ifdef GLYPHGL_STATS
+    double sdf_ms;          /* Time spent in the distance transform */
+#endif
+} glyph_atlas__temp_glyph_t;
+
+/* Frees the bitmap of a temporary glyph (a no-op for bitmaps in a worker arena) */
+static void glyph_atlas__free_temp_bitmap(glyph_atlas__temp_glyph_t* glyph) {
+    glyph__free(glyph->allocator, glyph->bitmap);
+    glyph->bitmap = NULL;
+}
+
+/* Bitmap memory of one build worker, released in one piece once the atlas is assembled */
+typedef struct {
+    glyph_arena_t bitmaps;          /* Rasterized glyphs of every job the worker ran */
+    glyph_allocator_t allocator;    /* Allocator interface over bitmaps */
+} glyph_atlas__worker_arena_t;
+
+/*
+ * Frees all glyph bitmaps, the worker arenas and the temporary glyph array
+ *
+ * Parameters:
+ *   temp_glyphs, count: Rasterized glyphs
+ *   arenas, num_arenas: Per-worker bitmap arenas (may be NULL)
+ *   allocator: Allocator the arrays were allocated with
+ */
+static void glyph_atlas__free_temp_glyphs(glyph_atlas__temp_glyph_t* temp_glyphs, int count, glyph_atlas__worker_arena_t* arenas, int num_arenas,
+                                          const glyph_allocator_t* allocator) {
+    for (int i = 0; i < count; i++) {
+        glyph_atlas__free_temp_bitmap(&temp_glyphs[i]);
+    }
+    for (int t = 0; arenas && t < num_arenas; t++) {
+        glyph_arena_release(&arenas[t].bitmaps);
+    }
+    glyph__free(allocator, arenas);
+    glyph__free(allocator, temp_glyphs);
+}
+
+/* Read-only inputs and per-glyph outputs shared by rasterization jobs */
+typedef struct {
+    const glyph_font_t* font;               /* Parsed font (read-only during the build) */
+    float scale;                            /* Font units to pixel conversion factor */
+    float pixel_height;                     /* Requested font size */
+    int use_sdf;                            /* Generate SDF bitmaps */
+    int sdf_spread;                         /* SDF distance range and border in pixels */
+    glyph_raster_scratch_t* raster_scratch; /* One rasterizer scratch per worker index */
+    glyph_sdf_scratch_t* sdf_scratch;       /* One SDF scratch per worker index */
+    const int* codepoints;                  /* Decoded charset */
+    glyph_atlas__temp_glyph_t* temp_glyphs; /* One output slot per codepoint */
+} glyph_atlas__raster_job_t;
+
+/*
+ * Rasterizes a single charset entry (job callback for phase 1)
+ *
+ * Each job only reads the shared font and writes its own temp_glyphs slot,
+ * so any number of jobs can run concurrently.
+ */
+static void glyph_atlas__raster_glyph_job(void* context, int i, int worker_index) {
+    glyph_atlas__raster_job_t* job = (glyph_atlas__raster_job_t*)context;
+    glyph_atlas__temp_glyph_t* out = &job->temp_glyphs[i];
+    int codepoint = job->codepoints[i];
+    GLYPH_STAT(out->sdf_ms = 0.0);
+
+    /* Find glyph index in font (maps codepoint to glyph) */
+    int glyph_idx = glyph_ttf_find_glyph_index(job->font, codepoint);
+
+    /* Handle missing glyphs (glyph_idx == 0 means .notdef glyph) */
+    if (glyph_idx == 0 && codepoint != ' ') {
+        /* Create fallback data for missing characters */
+        out->bitmap = NULL;
+        out->width = 0;
+        out->height = 0;
+        out->xoff = 0;
+        out->yoff = 0;
+        out->advance = (int)(job->pixel_height * 0.5f); /* Half-width fallback */
+        out->allocator = NULL;
+        return;
+    }
+
+    /* Get glyph bitmap from TrueType font (MSDFs come straight from the outline) */
+    int width, height, xoff, yoff;
+    unsigned char* bitmap;
+    glyph_raster_scratch_t* scratch = job->raster_scratch ? &job->raster_scratch[worker_index] : NULL;
+    const glyph_allocator_t* allocator = scratch ? scratch->allocator : NULL; /* Owner of the final bitmap */
+    if (job->use_sdf == GLYPH_ATLAS_MSDF) {
+        bitmap = glyph_msdf_get_glyph_bitmap_ex(job->font, glyph_idx, job->scale, job->scale, job->sdf_spread,
+                                                &width, &height, &xoff, &yoff, scratch);
+    } else {
+        /* Coverage that only feeds the SDF stays in the scratch's temp arena */
+        bitmap = glyph_ttf__get_glyph_bitmap(job->font, glyph_idx, job->scale, job->scale,
+                                             &width, &height, &xoff, &yoff, scratch, job->use_sdf == GLYPH_ATLAS_SDF);
+    }
+
+    /* Convert to Signed Distance Field if requested */
+    if (job->use_sdf == GLYPH_ATLAS_SDF && bitmap) {
+        /* Generate SDF bitmap for smooth scaling, with a spread-wide border for the falloff */
+        glyph_sdf_scratch_t* sdf_scratch = job->sdf_scratch ? &job->sdf_scratch[worker_index] : NULL;
+        GLYPH_STAT(double sdf_start = glyph__stats_now_ms());
+        unsigned char* sdf = glyph_ttf_get_glyph_sdf_bitmap_ex(bitmap, width, height, job->sdf_spread, job->sdf_spread, sdf_scratch);
+        GLYPH_STAT(out->sdf_ms = glyph__stats_now_ms() - sdf_start);
+        /* Free original bitmap (only heap coverage; the temp arena is rewound by the next glyph) */
+        if (!scratch) glyph_ttf_free_bitmap(bitmap);
+        allocator = sdf_scratch ? sdf_scratch->allocator : NULL;
+        bitmap = sdf; /* Use SDF bitmap instead */
+        if (sdf) {
+            width += 2 * job->sdf_spread;
+            height += 2 * job->sdf_spread;
+            xoff -= job->sdf_spread;
+            yoff += job->sdf_spread;
+        } else {
+            width = height = 0;
+        }
+    }
+
+    /* Store glyph data in temporary structure */
+    out->bitmap = bitmap;
+    out->width = width;
+    out->height = height;
+    out->xoff = xoff;
+    out->yoff = yoff;
+
+    /* Get horizontal advance width */
+    out->advance = (int)(glyph_ttf_get_glyph_advance(job->font, glyph_idx) * job->scale);
+    out->allocator = allocator;
+}
+
+/* Grows the dirty rectangle to include the given area */
+static void glyph_atlas__cache_mark_dirty(glyph_atlas_cache_t* cache, int x, int y, int w, int h) {
+    if (cache->dirty_x1 <= cache->dirty_x0) {
+        cache->dirty_x0 = x;
+        cache->dirty_y0 = y;
+        cache->dirty_x1 = x + w;
+        cache->dirty_y1 = y + h;
+        return;
+    }
+    if (x < cache->dirty_x0) cache->dirty_x0 = x;
+    if (y < cache->dirty_y0) cache->dirty_y0 = y;
+    if (x + w > cache->dirty_x1) cache->dirty_x1 = x + w;
+    if (y + h > cache->dirty_y1) cache->dirty_y1 = y + h;
+}
+
+/* Releases the glyph cache, including the retained font */
+static void glyph_atlas__cache_free(glyph_atlas_cache_t* cache) {
+    if (!cache) return;
+    GLYPH_FREE(cache->slot_owner);
+    GLYPH_FREE(cache->free_slots);
+    GLYPH_FREE(cache->char_slot);
+    GLYPH_FREE(cache->last_used);
+    glyph_raster_scratch_free(&cache->raster_scratch);
+    glyph_sdf_scratch_free(&cache->sdf_scratch);
+    glyph_ttf_free_font(&cache->font);
+    GLYPH_FREE(cache);
+}
+
+/*
+ * Grows the per-character arrays of a dynamic atlas
+ *
+ * Returns: 1 on success, 0 on allocation failure (arrays are left untouched)
+ */
+static int glyph_atlas__cache_reserve(glyph_atlas_t* atlas, int capacity) {
+    glyph_atlas_cache_t* cache = atlas->cache;
+    if (capacity <= cache->capacity) return 1;
+
+    glyph_atlas_char_t* chars = (glyph_atlas_char_t*)GLYPH_REALLOC(atlas->chars, capacity * sizeof(glyph_atlas_char_t));
+    if (!chars) return 0;
+    atlas->chars = chars;
+    int* char_slot = (int*)GLYPH_REALLOC(cache->char_slot, capacity * sizeof(int));
+    if (!char_slot) return 0;
+    cache->char_slot = char_slot;
+    unsigned int* last_used = (unsigned int*)GLYPH_REALLOC(cache->last_used, capacity * sizeof(unsigned int));
+    if (!last_used) return 0;
+    cache->last_used = last_used;
+
+    cache->capacity = capacity;
+    return 1;
+}
+
+/* Padding kept by every packing path: synthetic bold samples the texel beside each glyph, so never below 1 */
+static int glyph_atlas__padding(int padding) {
+    return padding > 1 ? padding : 1;
+}
+
+/*
+ * Sets up the glyph cache and its blank texture for a dynamic atlas
+ *
+ * Takes ownership of the font on success. Slots are sized from the font's
+ * global bounding box (head table) so any glyph of the font fits.
+ *
+ * Returns: 1 on success, 0 on failure (atlas->cache stays NULL)
+ */
+static int glyph_atlas__cache_init(glyph_atlas_t* atlas, const glyph_font_t* font, float scale, int use_sdf, int sdf_spread,
+                                   int padding, int width, int height, int initial_capacity) {
+    glyph_atlas_cache_t* cache = (glyph_atlas_cache_t*)GLYPH_MALLOC(sizeof(glyph_atlas_cache_t));
+    if (!cache) return 0;
+    memset(cache, 0, sizeof(glyph_atlas_cache_t));
+
+    /* Slot size matches the bitmap size the rasterizer produces for the font bbox */
+    int xMin = glyph_ttf__get16(font->data, font->head + 36);
+    int yMin = glyph_ttf__get16(font->data, font->head + 38);
+    int xMax = glyph_ttf__get16(font->data, font->head + 40);
+    int yMax = glyph_ttf__get16(font->data, font->head + 42);
+    int border = use_sdf ? 2 * sdf_spread : 0; /* SDF bitmaps carry a spread-wide border */
+    cache->cell_width = (int)ceilf((xMax - xMin) * scale) + 1 + border + padding;
+    cache->cell_height = (int)ceilf((yMax - yMin) * scale) + 1 + border + padding;
+    cache->columns = (width - padding) / cache->cell_width;
+    cache->rows = (height - padding) / cache->cell_height;
+    if (cache->columns <= 0 || cache->rows <= 0) {
+        GLYPH_LOG("Dynamic atlas %dx%d is too small for %dx%d glyph slots\n", width, height, cache->cell_width, cache->cell_height);
+        GLYPH_FREE(cache);
+        return 0;
+    }
+
+    int num_slots = cache->columns * cache->rows;
+    cache->slot_owner = (int*)GLYPH_MALLOC(num_slots * sizeof(int));
+    cache->free_slots = (int*)GLYPH_MALLOC(num_slots * sizeof(int));
+    atlas->image = use_sdf == GLYPH_ATLAS_MSDF ? glyph_image_create(width, height) : glyph_image_create_gray(width, height);
+    if (!cache->slot_owner || !cache->free_slots || !atlas->image.data) {
+        GLYPH_FREE(cache->slot_owner);
+        GLYPH_FREE(cache->free_slots);
+        GLYPH_FREE(cache);
+        glyph_image_free(&atlas->image);
+        atlas->image.width = 0;
+        atlas->image.height = 0;
+        return 0;
+    }
+    memset(atlas->image.data, 0, (size_t)width * height * atlas->image.channels); /* Clear to black */
+
+    /* Hand out slots in row-major order */
+    for (int i = 0; i < num_slots; i++) {
+        cache->slot_owner[i] = -1;
+        cache->free_slots[i] = num_slots - 1 - i;
+    }
+    cache->num_free_slots = num_slots;
+
+    cache->font = *font;
+    cache->scale = scale;
+    cache->use_sdf = use_sdf;
+    cache->sdf_spread = sdf_spread;
+    cache->padding = padding;
+    cache->tick = 1;
+    atlas->cache = cache;
+    atlas->msdf = use_sdf == GLYPH_ATLAS_MSDF;
+
+    if (!glyph_atlas__cache_reserve(atlas, initial_capacity > 64 ? initial_capacity : 64)) {
+        atlas->cache = NULL;
+        cache->font.data = NULL; /* Font ownership stays with the caller */
+        glyph_atlas__cache_free(cache);
+        glyph_image_free(&atlas->image);
+        atlas->image.width = 0;
+        atlas->image.height = 0;
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Copies a rasterized glyph into a cache slot and fills its chars[] entry
+ *
+ * The whole slot is cleared first so leftovers from an evicted glyph never
+ * bleed into the new one. The touched area is added to the dirty rectangle.
+ */
+static void glyph_atlas__cache_place(glyph_atlas_t* atlas, int char_index, const glyph_atlas__temp_glyph_t* glyph, int slot) {
+    glyph_atlas_cache_t* cache = atlas->cache;
+    size_t bpp = atlas->image.channels;
+    size_t stride = atlas->image.width * bpp;
+    int x0 = cache->padding + (slot % cache->columns) * cache->cell_width;
+    int y0 = cache->padding + (slot / cache->columns) * cache->cell_height;
+    int cw = cache->cell_width - cache->padding;
+    int ch = cache->cell_height - cache->padding;
+
+    for (int y = 0; y < ch; y++) {
+        memset(atlas->image.data + (size_t)(y0 + y) * stride + x0 * bpp, 0, (size_t)cw * bpp);
+    }
+    for (int y = 0; y < glyph->height; y++) {
+        memcpy(atlas->image.data + (size_t)(y0 + y) * stride + x0 * bpp, glyph->bitmap + (size_t)y * glyph->width * bpp,
+               (size_t)glyph->width * bpp);
+    }
+    glyph_atlas__cache_mark_dirty(cache, x0, y0, cw, ch);
+
+    glyph_atlas_char_t* c = &atlas->chars[char_index];
+    c->x = x0;
+    c->y = y0;
+    c->width = glyph->width;
+    c->height = glyph->height;
+    c->xoff = glyph->xoff;
+    c->yoff = glyph->yoff;
+    cache->slot_owner[slot] = char_index;
+    cache->char_slot[char_index] = slot;
+}
+
+/* Returns non-zero when a rasterized glyph fits into a cache slot */
+static int glyph_atlas__cache_fits(const glyph_atlas_cache_t* cache, const glyph_atlas__temp_glyph_t* glyph) {
+    return glyph->width <= cache->cell_width - cache->padding && glyph->height <= cache->cell_height - cache->padding;
+}
+
+/* Charset used when glyph_atlas_create receives NULL (printable ASCII) */
+#define GLYPH_ATLAS__DEFAULT_CHARSET " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~"
+
+/*
+ * Binary atlas cache file
+ *
+ * Stores a finished static atlas so later runs skip font parsing and
+ * rasterization entirely. All fields are little-endian:
+ *
+ *   offset  size  field
+ *   0       8     magic "GLYPHATL"
+ *   8       4     format version (GLYPH_ATLAS_FILE_VERSION)
+ *   12      8     cache key (see glyph_atlas_cache_key)
+ *   20      4     pixel height (IEEE float)
+ *   24      4     occupancy (IEEE float)
+ *   28      4     texture width
+ *   32      4     texture height
+ *   36      4     channels (1, or 3 for MSDF)
+ *   40      4     num_chars
+ *   44      4     num_kerning (pairs stored in the kerning table)
+ *   48      32*n  glyph_atlas_char_t table (8 signed 32-bit fields each)
+ *   ...     12*k  kerning pairs (left codepoint, right codepoint, IEEE float pixels)
+ *   ...     w*h*c raw texels, row-major, top row first
+ *
+ * The version is bumped whenever the layout or the rasterized output
+ * changes, so caches written by older builds are rebuilt instead of reused.
+ */
+#define GLYPH_ATLAS_FILE_VERSION 2
+#define GLYPH_ATLAS__FILE_HEADER_SIZE 48
+#define GLYPH_ATLAS__FILE_CHAR_SIZE 32
+#define GLYPH_ATLAS__FILE_KERN_SIZE 12
+
+/* FNV-1a 64-bit hash step over a byte range */
+static uint64_t glyph_atlas__hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/* Little-endian field helpers for the cache file */
+static void glyph_atlas__put_u32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t glyph_atlas__get_u32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Opens a whole file for reading, memory-mapped when possible
+ *
+ * Returns: File contents (release with glyph_atlas__close_file) or NULL on failure
+ */
+static unsigned char* glyph_atlas__open_file(const char* path, size_t* size, int* mapped) {
+    unsigned char* data = NULL;
+    *mapped = 0;
+#ifndef GLYPHGL_NO_MMAP
+    if (glyph_ttf__map_file(path, &data, size)) {
+        *mapped = 1;
+        return data;
+    }
+#endif
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (length > 0) data = (unsigned char*)GLYPH_MALLOC((size_t)length);
+    if (data && fread(data, 1, (size_t)length, f) != (size_t)length) {
+        GLYPH_FREE(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+/* Releases contents returned by glyph_atlas__open_file */
+static void glyph_atlas__close_file(unsigned char* data, size_t size, int mapped) {
+    if (!data) return;
+#ifndef GLYPHGL_NO_MMAP
+    if (mapped) {
+        glyph_ttf__unmap_file(data, size);
+        return;
+    }
+#endif
+    (void)size;
+    (void)mapped;
+    GLYPH_FREE(data);
+}
+
+/*
+ * Computes the cache key identifying one atlas build
+ *
+ * Hashes everything that determines the atlas contents: the font file
+ * bytes, pixel height, charset (and how it is decoded), the rendering
+ * mode with its SDF spread, and whether kerning pairs are included. A cache file is only reused when its key
+ * matches exactly.
+ *
+ * Parameters:
+ *   font_data: Font file contents
+ *   font_size: Size of font_data in bytes
+ *   pixel_height: Font size for rasterization
+ *   charset: Characters in the atlas (NULL for the default ASCII set)
+ *   char_type: GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII encoding type
+ *   use_sdf: GLYPH_ATLAS_COVERAGE, GLYPH_ATLAS_SDF or GLYPH_ATLAS_MSDF
+ *   sdf_spread: SDF distance range in pixels (ignored for coverage atlases)
+ *   kerning: Whether kerning pairs are precomputed (glyph_atlas_config_t.kerning)
+ *
+ * Returns: Non-zero 64-bit key
+ */
+static inline uint64_t glyph_atlas_cache_key(const unsigned char* font_data, size_t font_size, float pixel_height,
+                                             const char* charset, glyph_encoding_type_t char_type, int use_sdf, int sdf_spread, int kerning) {
+    int32_t params[5];
+    params[0] = (int32_t)char_type;
+    params[1] = (int32_t)use_sdf;
+    params[2] = use_sdf ? (int32_t)(sdf_spread > 0 ? sdf_spread : 4) : 0;
+    params[3] = GLYPH_ATLAS_FILE_VERSION;
+    params[4] = kerning != 0;
+    if (!charset) charset = GLYPH_ATLAS__DEFAULT_CHARSET;
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = glyph_atlas__hash_bytes(hash, &font_size, sizeof(font_size));
+    hash = glyph_atlas__hash_bytes(hash, font_data, font_size);
+    hash = glyph_atlas__hash_bytes(hash, &pixel_height, sizeof(pixel_height));
+    hash = glyph_atlas__hash_bytes(hash, params, sizeof(params));
+    hash = glyph_atlas__hash_bytes(hash, charset, strlen(charset) + 1);
+    return hash ? hash : 1; /* 0 means "any key" to glyph_atlas_load_cache */
+}
+
+/*
+ * Writes a static atlas to a binary cache file
+ *
+ * Dynamic atlases cannot be saved: their contents change at runtime and
+ * depend on the retained font.
+ *
+ * Parameters:
+ *   atlas: Pointer to a static glyph atlas
+ *   output_path: Path where the cache file will be written
+ *   key: Cache key from glyph_atlas_cache_key (0 if unused)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_atlas_save_cache(const glyph_atlas_t* atlas, const char* output_path, uint64_t key) {
+    if (!atlas || !atlas->chars || !atlas->image.data || atlas->cache) return -1;
+
+    size_t chars_end = GLYPH_ATLAS__FILE_HEADER_SIZE + (size_t)atlas->num_chars * GLYPH_ATLAS__FILE_CHAR_SIZE;
+    size_t table_size = chars_end + (size_t)atlas->kerning.count * GLYPH_ATLAS__FILE_KERN_SIZE;
+    unsigned char* table = (unsigned char*)GLYPH_MALLOC(table_size);
+    if (!table) return -1;
+
+    /* Header */
+    uint32_t bits;
+    memcpy(table, "GLYPHATL", 8);
+    glyph_atlas__put_u32(table + 8, GLYPH_ATLAS_FILE_VERSION);
+    glyph_atlas__put_u32(table + 12, (uint32_t)key);
+    glyph_atlas__put_u32(table + 16, (uint32_t)(key >> 32));
+    memcpy(&bits, &atlas->pixel_height, 4);
+    glyph_atlas__put_u32(table + 20, bits);
+    memcpy(&bits, &atlas->occupancy, 4);
+    glyph_atlas__put_u32(table + 24, bits);
+    glyph_atlas__put_u32(table + 28, atlas->image.width);
+    glyph_atlas__put_u32(table + 32, atlas->image.height);
+    glyph_atlas__put_u32(table + 36, atlas->image.channels);
+    glyph_atlas__put_u32(table + 40, (uint32_t)atlas->num_chars);
+    glyph_atlas__put_u32(table + 44, (uint32_t)atlas->kerning.count);
+
+    /* Character table */
+    for (int i = 0; i < atlas->num_chars; i++) {
+        const glyph_atlas_char_t* c = &atlas->chars[i];
+        unsigned char* p = table + GLYPH_ATLAS__FILE_HEADER_SIZE + (size_t)i * GLYPH_ATLAS__FILE_CHAR_SIZE;
+        glyph_atlas__put_u32(p, (uint32_t)c->codepoint);
+        glyph_atlas__put_u32(p + 4, (uint32_t)c->x);
+        glyph_atlas__put_u32(p + 8, (uint32_t)c->y);
+        glyph_atlas__put_u32(p + 12, (uint32_t)c->width);
+        glyph_atlas__put_u32(p + 16, (uint32_t)c->height);
+        glyph_atlas__put_u32(p + 20, (uint32_t)c->xoff);
+        glyph_atlas__put_u32(p + 24, (uint32_t)c->yoff);
+        glyph_atlas__put_u32(p + 28, (uint32_t)c->advance);
+    }
+
+    /* Kerning pairs */
+    unsigned char* kp = table + chars_end;
+    for (int i = 0; i < atlas->kerning.capacity; i++) {
+        uint64_t packed = atlas->kerning.keys[i];
+        if (!packed) continue;
+        packed--;
+        glyph_atlas__put_u32(kp, (uint32_t)(packed >> 21));
+        glyph_atlas__put_u32(kp + 4, (uint32_t)(packed & 0x1FFFFF));
+        memcpy(&bits, &atlas->kerning.values[i], 4);
+        glyph_atlas__put_u32(kp + 8, bits);
+        kp += GLYPH_ATLAS__FILE_KERN_SIZE;
+    }
+
+    FILE* f = fopen(output_path, "wb");
+    if (!f) {
+        GLYPH_FREE(table);
+        return -1;
+    }
+    size_t texel_size = (size_t)atlas->image.width * atlas->image.height * atlas->image.channels;
+    int ok = fwrite(table, 1, table_size, f) == table_size &&
+             fwrite(atlas->image.data, 1, texel_size, f) == texel_size;
+    ok = fclose(f) == 0 && ok;
+    GLYPH_FREE(table);
+    if (!ok) remove(output_path); /* Never leave a truncated cache behind */
+    return ok ? 0 : -1;
+}
+
+/*
+ * Loads a static atlas from a binary cache file
+ *
+ * The file is memory-mapped and validated (magic, version, key, sizes and
+ * glyph rectangles) before the table and texels are copied out, so a stale
+ * or foreign file is rejected after reading its header only.
+ *
+ * Parameters:
+ *   path: Cache file written by glyph_atlas_save_cache
+ *   key: Expected cache key, or 0 to accept any key
+ *
+ * Returns: Complete glyph_atlas_t or zero-initialized struct if the file is
+ *          missing, stale or invalid
+ */
+static inline glyph_atlas_t glyph_atlas_load_cache(const char* path, uint64_t key) {
+    glyph_atlas_t atlas = {0};
+    GLYPH_STAT(double load_start = glyph__stats_now_ms());
+    size_t size;
+    int mapped;
+    unsigned char* data = glyph_atlas__open_file(path, &size, &mapped);
+    if (!data) return atlas;
+
+    /* Validate the header before touching the payload */
+    if (size < GLYPH_ATLAS__FILE_HEADER_SIZE || memcmp(data, "GLYPHATL", 8) != 0 ||
+        glyph_atlas__get_u32(data + 8) != GLYPH_ATLAS_FILE_VERSION) {
+        glyph_atlas__close_file(data, size, mapped);
+        return atlas;
+    }
+    uint64_t file_key = (uint64_t)glyph_atlas__get_u32(data + 12) | ((uint64_t)glyph_atlas__get_u32(data + 16) << 32);
+    uint32_t width = glyph_atlas__get_u32(data + 28);
+    uint32_t height = glyph_atlas__get_u32(data + 32);
+    uint32_t channels = glyph_atlas__get_u32(data + 36);
+    uint32_t num_chars = glyph_atlas__get_u32(data + 40);
+    uint32_t num_kerning = glyph_atlas__get_u32(data + 44);
+    size_t chars_end = GLYPH_ATLAS__FILE_HEADER_SIZE + (size_t)num_chars * GLYPH_ATLAS__FILE_CHAR_SIZE;
+    size_t kerning_end = chars_end + (size_t)num_kerning * GLYPH_ATLAS__FILE_KERN_SIZE;
+    if ((key && file_key != key) || width == 0 || height == 0 || width > GLYPHGL_ATLAS_MAX_SIZE || height > GLYPHGL_ATLAS_MAX_SIZE ||
+        (channels != 1 && channels != 3) || num_chars > (size - GLYPH_ATLAS__FILE_HEADER_SIZE) / GLYPH_ATLAS__FILE_CHAR_SIZE ||
+        num_kerning > (size - GLYPH_ATLAS__FILE_HEADER_SIZE) / GLYPH_ATLAS__FILE_KERN_SIZE ||
+        size != kerning_end + (size_t)width * height * channels) {
+        glyph_atlas__close_file(data, size, mapped);
+        return atlas;
+    }
+
+    atlas.chars = (glyph_atlas_char_t*)GLYPH_MALLOC((num_chars + 1) * sizeof(glyph_atlas_char_t));
+    atlas.image = channels == 3 ? glyph_image_create(width, height) : glyph_image_create_gray(width, height);
+    if (!atlas.chars || !atlas.image.data) {
+        GLYPH_FREE(atlas.chars);
+        glyph_image_free(&atlas.image);
+        glyph_atlas__close_file(data, size, mapped);
+        memset(&atlas, 0, sizeof(atlas));
+        return atlas;
+    }
+
+    /* Character table, rejecting rectangles outside the texture */
+    int valid = 1;
+    for (uint32_t i = 0; i < num_chars && valid; i++) {
+        const unsigned char* p = data + GLYPH_ATLAS__FILE_HEADER_SIZE + (size_t)i * GLYPH_ATLAS__FILE_CHAR_SIZE;
+        glyph_atlas_char_t* c = &atlas.chars[i];
+        c->codepoint = (int32_t)glyph_atlas__get_u32(p);
+        c->x = (int32_t)glyph_atlas__get_u32(p + 4);
+        c->y = (int32_t)glyph_atlas__get_u32(p + 8);
+        c->width = (int32_t)glyph_atlas__get_u32(p + 12);
+        c->height = (int32_t)glyph_atlas__get_u32(p + 16);
+        c->xoff = (int32_t)glyph_atlas__get_u32(p + 20);
+        c->yoff = (int32_t)glyph_atlas__get_u32(p + 24);
+        c->advance = (int32_t)glyph_atlas__get_u32(p + 28);
+        valid = c->x >= 0 && c->y >= 0 && c->width >= 0 && c->height >= 0 &&
+                c->x <= (int)width - c->width && c->y <= (int)height - c->height;
+    }
+    if (!valid) {
+        GLYPH_LOG("Corrupt atlas cache: %s\n", path);
+        GLYPH_FREE(atlas.chars);
+        glyph_image_free(&atlas.image);
+        glyph_atlas__close_file(data, size, mapped);
+        memset(&atlas, 0, sizeof(atlas));
+        return atlas;
+    }
+
+    uint32_t bits = glyph_atlas__get_u32(data + 20);
+    memcpy(&atlas.pixel_height, &bits, 4);
+    bits = glyph_atlas__get_u32(data + 24);
+    memcpy(&atlas.occupancy, &bits, 4);
+    atlas.num_chars = (int)num_chars;
+    atlas.msdf = channels == 3;
+    memcpy(atlas.image.data, data + kerning_end, (size_t)width * height * channels);
+
+    /* Kerning pairs (a failed allocation only loses kerning) */
+    atlas.kerning.enabled = 1;
+    for (uint32_t i = 0; i < num_kerning; i++) {
+        const unsigned char* p = data + chars_end + (size_t)i * GLYPH_ATLAS__FILE_KERN_SIZE;
+        float value;
+        bits = glyph_atlas__get_u32(p + 8);
+        memcpy(&value, &bits, 4);
+        if (!glyph_atlas__kerning_insert(&atlas.kerning, (int)glyph_atlas__get_u32(p), (int)glyph_atlas__get_u32(p + 4), value)) {
+            GLYPH_LOG("Warning: Failed to allocate kerning pairs\n");
+            glyph_atlas__kerning_free(&atlas.kerning);
+            break;
+        }
+    }
+    glyph_atlas__close_file(data, size, mapped);
+    GLYPH_STAT(double index_start = glyph__stats_now_ms());
+
+    if (!glyph_atlas__index_build(&atlas)) {
+        GLYPH_LOG("Warning: Failed to build atlas lookup index\n");
+    }
+    GLYPH_STAT(atlas.bake_stats.index_ms = glyph__stats_now_ms() - index_start);
+    GLYPH_STAT(atlas.bake_stats.load_ms = index_start - load_start);
+    GLYPH_STAT(atlas.bake_stats.total_ms = glyph__stats_now_ms() - load_start);
+    return atlas;
+}
+
+/*
+ * Builds an atlas from a loaded font (everything after glyph_atlas_create_ex's font load)
+ *
+ * Parameters:
+ *   font: Loaded font; the charset's composite components are added to its outline cache
+ *   owns_font: 1 to free the font afterwards (a dynamic atlas keeps it instead), 0 to
+ *              leave it to the caller, which allows several builds from one parse
+ *              (static atlases only)
+ *   pixel_height, charset, char_type, use_sdf: As for glyph_atlas_create_ex
+ *   config: Build configuration (not NULL; cache_path is ignored)
+ *
+ * Returns: Complete glyph_atlas_t or zero-initialized struct on failure
+ */
+static glyph_atlas_t glyph_atlas__create_from_font(glyph_font_t* font, int owns_font, float pixel_height, const char* charset,
+                                                   glyph_encoding_type_t char_type, int use_sdf, const glyph_atlas_config_t* config) {
+    glyph_atlas_t atlas = {0};
+    int sdf_spread = config->sdf_spread > 0 ? config->sdf_spread : 4;
+    float scale = glyph_ttf_scale_for_pixel_height(font, pixel_height); /* Font units to pixel conversion factor */
+    GLYPH_STAT(double build_start = glyph__stats_now_ms());
+    GLYPH_STAT(double phase_start = build_start);
+
+    /* Store the pixel height for reference */
+    atlas.pixel_height = pixel_height;
+
+    /* Use default ASCII charset if none provided */
+    if (!charset) charset = GLYPH_ATLAS__DEFAULT_CHARSET;
+
+    /* Calculate number of characters in charset (handles UTF-8 multi-byte) */
+    int charset_len;
+    size_t charset_bytes = strlen(charset);
+    if (char_type == GLYPH_ENCODING_UTF8) {
+        charset_len = 0;
+        size_t idx = 0;
+        /* Count UTF-8 codepoints by decoding each sequence */
+        while (idx < charset_bytes) {
+            glyph_atlas_utf8_decode(charset, &idx);
+            charset_len++;
+        }
+    } else {
+        /* Simple byte count for ASCII */
+        charset_len = (int)charset_bytes;
+    }
+
+    /* Allocate character data array (one spare entry keeps empty charsets valid) */
+    atlas.num_chars = charset_len;
+    atlas.chars = (glyph_atlas_char_t*)GLYPH_MALLOC((charset_len + 1) * sizeof(glyph_atlas_char_t));
+    if (!atlas.chars) {
+        /* Cleanup on allocation failure */
+        if (owns_font) glyph_ttf_free_font(font);
+        return atlas;
+    }
+
+    /* Allocate temporary glyph storage and decoded codepoints */
+    const glyph_allocator_t* allocator = config->allocator;
+    glyph_atlas__temp_glyph_t* temp_glyphs = (glyph_atlas__temp_glyph_t*)glyph__alloc(allocator, (charset_len + 1) * sizeof(glyph_atlas__temp_glyph_t));
+    int* codepoints = (int*)glyph__alloc(allocator, (charset_len + 1) * sizeof(int));
+    if (!temp_glyphs || !codepoints) {
+        /* Cleanup on allocation failure */
+        glyph__free(allocator, temp_glyphs);
+        glyph__free(allocator, codepoints);
+        GLYPH_FREE(atlas.chars);
+        atlas.chars = NULL;
+        if (owns_font) glyph_ttf_free_font(font);
+        return atlas;
+    }
+
+    /* Decode the charset up front so rasterization jobs can run in any order */
+    size_t charset_idx = 0; /* Index for UTF-8 charset traversal */
+    for (int i = 0; i < charset_len; i++) {
+        if (char_type == GLYPH_ENCODING_UTF8) {
+            codepoints[i] = glyph_atlas_utf8_decode(charset, &charset_idx);
+        } else {
+            codepoints[i] = (unsigned char)charset[i];
+        }
+    }
+
+    /* Phase 1: Rasterize all glyphs (serially, on the thread pool or on the user's job system) */
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    /* Decode composite components once up front; the workers then only read the cache */
+    for (int i = 0; i < charset_len; i++) {
+        glyph_ttf_cache_components(font, glyph_ttf_find_glyph_index(font, codepoints[i]));
+    }
+
+    glyph_atlas__raster_job_t raster_job;
+    raster_job.font = font;
+    raster_job.scale = scale;
+    raster_job.pixel_height = pixel_height;
+    raster_job.use_sdf = use_sdf;
+    raster_job.sdf_spread = sdf_spread;
+    raster_job.raster_scratch = NULL;
+    raster_job.sdf_scratch = NULL;
+    raster_job.codepoints = codepoints;
+    raster_job.temp_glyphs = temp_glyphs;
+
+    int num_threads = config->num_threads > 0 ? config->num_threads : glyph_thread_hardware_concurrency();
+    /* One scratch and bitmap arena per worker, reused by every glyph that worker handles (NULL falls back to the heap) */
+    glyph_atlas__worker_arena_t* arenas = (glyph_atlas__worker_arena_t*)glyph__alloc(allocator, num_threads * sizeof(glyph_atlas__worker_arena_t));
+    raster_job.raster_scratch = (glyph_raster_scratch_t*)glyph__alloc(allocator, num_threads * sizeof(glyph_raster_scratch_t));
+    if (raster_job.raster_scratch) memset(raster_job.raster_scratch, 0, num_threads * sizeof(glyph_raster_scratch_t));
+    if (use_sdf == GLYPH_ATLAS_SDF) {
+        raster_job.sdf_scratch = (glyph_sdf_scratch_t*)glyph__alloc(allocator, num_threads * sizeof(glyph_sdf_scratch_t));
+        if (raster_job.sdf_scratch) memset(raster_job.sdf_scratch, 0, num_threads * sizeof(glyph_sdf_scratch_t));
+    }
+    for (int t = 0; arenas && t < num_threads; t++) {
+        memset(&arenas[t].bitmaps, 0, sizeof(glyph_arena_t));
+        arenas[t].bitmaps.backing = allocator;
+        arenas[t].allocator = glyph_arena_allocator(&arenas[t].bitmaps);
+        if (raster_job.raster_scratch) raster_job.raster_scratch[t].allocator = &arenas[t].allocator;
+        if (raster_job.sdf_scratch) raster_job.sdf_scratch[t].allocator = &arenas[t].allocator;
+    }
+    /* Without arenas the scratches still draw their working memory from the build allocator */
+    for (int t = 0; !arenas && raster_job.raster_scratch && t < num_threads; t++) raster_job.raster_scratch[t].allocator = allocator;
+    for (int t = 0; !arenas && raster_job.sdf_scratch && t < num_threads; t++) raster_job.sdf_scratch[t].allocator = allocator;
+    if (config->dispatch) {
+        config->dispatch(config->dispatch_user_data, glyph_atlas__raster_glyph_job, &raster_job, charset_len, num_threads);
+    } else {
+        glyph_thread_run_jobs(num_threads, glyph_atlas__raster_glyph_job, &raster_job, charset_len);
+    }
+    if (raster_job.raster_scratch) {
+        for (int t = 0; t < num_threads; t++) glyph_raster_scratch_free(&raster_job.raster_scratch[t]);
+        glyph__free(allocator, raster_job.raster_scratch);
+    }
+    if (raster_job.sdf_scratch) {
+        for (int t = 0; t < num_threads; t++) glyph_sdf_scratch_free(&raster_job.sdf_scratch[t]);
+        glyph__free(allocator, raster_job.sdf_scratch);
+    }
+
+    /* Gather results */
+    for (int i = 0; i < charset_len; i++) {
+        /* Store basic character info */
+        atlas.chars[i].codepoint = codepoints[i];
+        atlas.chars[i].advance = temp_glyphs[i].advance;
+        GLYPH_STAT(atlas.bake_stats.sdf_ms += temp_glyphs[i].sdf_ms);
+    }
+    GLYPH_STAT(atlas.bake_stats.rasterize_ms = glyph__stats_now_ms() - phase_start);
+    GLYPH_STAT(atlas.bake_stats.glyphs = charset_len);
+    glyph__free(allocator, codepoints);
+
+    /* Dynamic mode: preload the charset into cache slots, the font stays alive for later glyphs */
+    if (config->dynamic) {
+        if (!glyph_atlas__cache_init(&atlas, font, scale, use_sdf, sdf_spread, glyph_atlas__padding(config->padding),
+                                     config->dynamic_width, config->dynamic_height, charset_len)) {
+            glyph_atlas__free_temp_glyphs(temp_glyphs, charset_len, arenas, num_threads, allocator);
+            GLYPH_FREE(atlas.chars);
+            atlas.chars = NULL;
+            if (owns_font) glyph_ttf_free_font(font);
+            return atlas;
+        }
+
+        glyph_atlas_cache_t* cache = atlas.cache;
+        double glyph_area = 0.0;
+        int count = 0;
+        for (int i = 0; i < charset_len; i++) {
+            glyph_atlas__temp_glyph_t* glyph = &temp_glyphs[i];
+            int codepoint = atlas.chars[i].codepoint;
+            int has_bitmap = glyph->bitmap && glyph->width > 0 && glyph->height > 0;
+
+            /* Skip duplicates, oversized glyphs and whatever no longer fits (loaded on demand later) */
+            if (glyph_atlas__index_lookup(&atlas.index, codepoint) >= 0) continue;
+            if (has_bitmap && (!glyph_atlas__cache_fits(cache, glyph) || cache->num_free_slots == 0)) continue;
+            if (!glyph_atlas__index_insert(&atlas.index, codepoint, count)) continue;
+
+            atlas.chars[count] = atlas.chars[i];
+            cache->char_slot[count] = -1;
+            cache->last_used[count] = 0;
+            if (has_bitmap) {
+                glyph_atlas__cache_place(&atlas, count, glyph, cache->free_slots[--cache->num_free_slots]);
+                glyph_area += (double)glyph->width * glyph->height;
+            } else {
+                atlas.chars[count].x = 0;
+                atlas.chars[count].y = 0;
+                atlas.chars[count].width = 0;
+                atlas.chars[count].height = 0;
+                atlas.chars[count].xoff = 0;
+                atlas.chars[count].yoff = 0;
+            }
+            count++;
+        }
+        atlas.num_chars = count;
+        atlas.occupancy = (float)(glyph_area / ((double)atlas.image.width * atlas.image.height));
+        GLYPH_STAT(phase_start = glyph__stats_now_ms());
+        atlas.kerning.enabled = config->kerning;
+        if (config->kerning) glyph_atlas__kerning_build(&atlas, &cache->font, scale);
+        GLYPH_STAT(atlas.bake_stats.kerning_ms = glyph__stats_now_ms() - phase_start);
+
+        /* The initial texture upload covers everything placed so far */
+        cache->dirty_x0 = cache->dirty_y0 = cache->dirty_x1 = cache->dirty_y1 = 0;
+        glyph_atlas__free_temp_glyphs(temp_glyphs, charset_len, arenas, num_threads, allocator);
+        GLYPH_STAT(atlas.bake_stats.total_ms = glyph__stats_now_ms() - build_start);
+        return atlas;
+    }
+
+    /* Phase 2: Pack glyph rectangles (padded on the right/bottom, bin inset by the padding) */
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    int padding = glyph_atlas__padding(config->padding); /* Pixels between glyphs to prevent bleeding */
+    glyph_atlas_rect_t* rects = (glyph_atlas_rect_t*)glyph__alloc(allocator, (charset_len + 1) * sizeof(glyph_atlas_rect_t));
+    if (!rects) {
+        /* Cleanup on allocation failure */
+        glyph_atlas__free_temp_glyphs(temp_glyphs, charset_len, arenas, num_threads, allocator);
+        GLYPH_FREE(atlas.chars);
+        atlas.chars = NULL;
+        if (owns_font) glyph_ttf_free_font(font);
+        return atlas;
+    }
+
+    double glyph_area = 0.0; /* Unpadded glyph pixels, for occupancy */
+    double packed_area = 0.0; /* Padded area, lower bound for the atlas size */
+    int max_w = 0, max_h = 0;
+    for (int i = 0; i < charset_len; i++) {
+        int has_bitmap = temp_glyphs[i].bitmap && temp_glyphs[i].width > 0 && temp_glyphs[i].height > 0;
+        rects[i].w = has_bitmap ? temp_glyphs[i].width + padding : 0;
+        rects[i].h = has_bitmap ? temp_glyphs[i].height + padding : 0;
+        if (!has_bitmap) continue;
+        glyph_area += (double)temp_glyphs[i].width * temp_glyphs[i].height;
+        packed_area += (double)rects[i].w * rects[i].h;
+        if (rects[i].w > max_w) max_w = rects[i].w;
+        if (rects[i].h > max_h) max_h = rects[i].h;
+    }
+
+    /* Smallest power-of-2 atlas holding the largest glyph and the total area */
+    int atlas_width = glyph_atlas__next_pow2((max_w + padding > config->min_width) ? max_w + padding : config->min_width);
+    int atlas_height = glyph_atlas__next_pow2((max_h + padding > config->min_height) ? max_h + padding : config->min_height);
+    if (atlas_width < 1) atlas_width = 1;
+    if (atlas_height < 1) atlas_height = 1;
+    while ((double)atlas_width * atlas_height < packed_area) {
+        if (atlas_width <= atlas_height) atlas_width *= 2;
+        else atlas_height *= 2;
+    }
+
+    /* Try to pack, growing the smaller dimension whenever the glyphs do not fit */
+    for (;;) {
+        int packed;
+        if (config->pack) {
+            packed = config->pack(config->pack_user_data, rects, charset_len, atlas_width - padding, atlas_height - padding);
+        } else {
+            packed = glyph_atlas_pack_rects(config->packer, rects, charset_len, atlas_width - padding, atlas_height - padding);
+        }
+        if (packed) break;
+
+        if (atlas_width <= atlas_height) atlas_width *= 2;
+        else atlas_height *= 2;
+        if (atlas_width > GLYPHGL_ATLAS_MAX_SIZE || atlas_height > GLYPHGL_ATLAS_MAX_SIZE) {
+            GLYPH_LOG("Failed to pack %d glyphs into a %dx%d atlas\n", charset_len, GLYPHGL_ATLAS_MAX_SIZE, GLYPHGL_ATLAS_MAX_SIZE);
+            glyph__free(allocator, rects);
+            glyph_atlas__free_temp_glyphs(temp_glyphs, charset_len, arenas, num_threads, allocator);
+            GLYPH_FREE(atlas.chars);
+            atlas.chars = NULL;
+            if (owns_font) glyph_ttf_free_font(font);
+            return atlas;
+        }
+    }
+
+    GLYPH_STAT(atlas.bake_stats.pack_ms = glyph__stats_now_ms() - phase_start);
+
+    /* Phase 3: Create atlas texture and blit glyphs at their packed positions */
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    atlas.image = use_sdf == GLYPH_ATLAS_MSDF ? glyph_image_create(atlas_width, atlas_height)
+                                              : glyph_image_create_gray(atlas_width, atlas_height);
+    if (!atlas.image.data) {
+        GLYPH_LOG("Failed to allocate %dx%d atlas image\n", atlas_width, atlas_height);
+        atlas.image.width = 0;
+        atlas.image.height = 0;
+        glyph__free(allocator, rects);
+        glyph_atlas__free_temp_glyphs(temp_glyphs, charset_len, arenas, num_threads, allocator);
+        GLYPH_FREE(atlas.chars);
+        atlas.chars = NULL;
+        if (owns_font) glyph_ttf_free_font(font);
+        return atlas;
+    }
+    size_t bpp = atlas.image.channels;
+    memset(atlas.image.data, 0, (size_t)atlas_width * atlas_height * bpp); /* Clear to black */
+    atlas.msdf = use_sdf == GLYPH_ATLAS_MSDF;
+    atlas.occupancy = (float)(glyph_area / ((double)atlas_width * atlas_height));
+
+    for (int i = 0; i < charset_len; i++) {
+        /* Skip glyphs with no bitmap data */
+        if (rects[i].w == 0) {
+            /* Set zero data for empty glyphs */
+            atlas.chars[i].x = 0;
+            atlas.chars[i].y = 0;
+            atlas.chars[i].width = 0;
+            atlas.chars[i].height = 0;
+            atlas.chars[i].xoff = 0;
+            atlas.chars[i].yoff = 0;
+            continue;
+        }
+
+        /* Record glyph position in atlas */
+        atlas.chars[i].x = rects[i].x + padding;
+        atlas.chars[i].y = rects[i].y + padding;
+        atlas.chars[i].width = temp_glyphs[i].width;
+        atlas.chars[i].height = temp_glyphs[i].height;
+        atlas.chars[i].xoff = temp_glyphs[i].xoff;
+        atlas.chars[i].yoff = temp_glyphs[i].yoff;
+
+        /* Copy glyph rows into the atlas (bpp is 1 for coverage/SDF, 3 for MSDF) */
+        for (int y = 0; y < temp_glyphs[i].height; y++) {
+            memcpy(atlas.image.data + ((size_t)(atlas.chars[i].y + y) * atlas_width + atlas.chars[i].x) * bpp,
+                   temp_glyphs[i].bitmap + (size_t)y * temp_glyphs[i].width * bpp, (size_t)temp_glyphs[i].width * bpp);
+        }
+    }
+
+    /* Cleanup temporary resources */
+    glyph__free(allocator, rects);
+    glyph_atlas__free_temp_glyphs(temp_glyphs, charset_len, arenas, num_threads, allocator);
+    GLYPH_STAT(atlas.bake_stats.copy_ms = glyph__stats_now_ms() - phase_start);
+
+    /* Precompute kerning pairs while the font is still loaded */
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    atlas.kerning.enabled = config->kerning;
+    if (config->kerning) glyph_atlas__kerning_build(&atlas, font, scale);
+    GLYPH_STAT(atlas.bake_stats.kerning_ms = glyph__stats_now_ms() - phase_start);
+
+    /* Free font resources */
+    if (owns_font) glyph_ttf_free_font(font);
+
+    /* Build O(1) codepoint lookup table (falls back to linear search if this fails) */
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    if (!glyph_atlas__index_build(&atlas)) {
+        GLYPH_LOG("Warning: Failed to build atlas lookup index\n");
+    }
+    GLYPH_STAT(atlas.bake_stats.index_ms = glyph__stats_now_ms() - phase_start);
+    GLYPH_STAT(atlas.bake_stats.total_ms = glyph__stats_now_ms() - build_start);
+
+    /* Return completed atlas */
+    return atlas;
+}
+
+/*
+ * Creates a font atlas by rasterizing and packing glyphs into a texture
+ *
+ * This is the core atlas generation function that:
+ * 1. Loads the font file (TTF)
+ * 2. Rasterizes each character in the charset
+ * 3. Optionally converts to SDF for scalable rendering
+ * 4. Packs glyphs efficiently into a 2D texture atlas
+ * 5. Returns complete atlas with positioning data
+ *
+ * Glyphs are sorted by height and packed with the configured rectangle packer
+ * (skyline by default). The atlas starts at the smallest power-of-2 size that
+ * could hold the total glyph area and grows one dimension at a time until the
+ * packer succeeds; the achieved fill ratio is reported in atlas.occupancy.
+ *
+ * Rasterization can be spread across a built-in thread pool or an external
+ * job system through the config (see glyph_atlas_config_t). Custom
+ * GLYPH_MALLOC/GLYPH_FREE implementations and config->allocator must be
+ * thread-safe in that case.
+ *
+ * Build-time memory (decoded outlines, scratch buffers, glyph bitmaps,
+ * packing input) comes from config->allocator; every worker keeps its
+ * bitmaps in an arena that is released in one piece once the atlas image
+ * is assembled.
+ *
+ * Parameters:
+ *   font_path: Path to .ttf font file (ignored when config->font_data is set)
+ *   pixel_height: Font size for rasterization (affects quality/detail)
+ *   charset: String containing all characters to include
+ *   char_type: GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII encoding type
+ *   use_sdf: GLYPH_ATLAS_COVERAGE (0), GLYPH_ATLAS_SDF (1) or GLYPH_ATLAS_MSDF (2, keeps sharp corners)
+ *   config: Build configuration (NULL for defaults)
+ *
+ * Returns: Complete glyph_atlas_t or zero-initialized struct on failure
+ */
+static inline glyph_atlas_t glyph_atlas_create_ex(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type, int use_sdf, const glyph_atlas_config_t* config) {
+    /* Initialize atlas structure */
+    glyph_atlas_t atlas = {0};
+
+    /* Fall back to default configuration */
+    glyph_atlas_config_t default_config = glyph_atlas_default_config();
+    if (!config) config = &default_config;
+    int sdf_spread = config->sdf_spread > 0 ? config->sdf_spread : 4;
+    GLYPH_STAT(double phase_start = glyph__stats_now_ms());
+
+    /* Binary cache: reuse a matching file, otherwise build normally and write it */
+    if (config->cache_path && !config->dynamic) {
+        uint64_t key = 0;
+        if (config->font_data) {
+            key = glyph_atlas_cache_key(config->font_data, config->font_data_size, pixel_height, charset, char_type, use_sdf, sdf_spread, config->kerning);
+        } else {
+            size_t font_size;
+            int mapped;
+            unsigned char* font_data = glyph_atlas__open_file(font_path, &font_size, &mapped);
+            if (!font_data) {
+                GLYPH_LOG("Failed to load TTF font: %s\n", font_path);
+                return atlas;
+            }
+            key = glyph_atlas_cache_key(font_data, font_size, pixel_height, charset, char_type, use_sdf, sdf_spread, config->kerning);
+            glyph_atlas__close_file(font_data, font_size, mapped);
+        }
+        atlas = glyph_atlas_load_cache(config->cache_path, key);
+        if (atlas.chars) return atlas;
+
+        glyph_atlas_config_t build_config = *config;
+        build_config.cache_path = NULL;
+        atlas = glyph_atlas_create_ex(font_path, pixel_height, charset, char_type, use_sdf, &build_config);
+        if (atlas.chars && atlas.image.data && glyph_atlas_save_cache(&atlas, config->cache_path, key) != 0) {
+            GLYPH_LOG("Warning: Failed to write atlas cache: %s\n", config->cache_path);
+        }
+        return atlas;
+    }
+
+    /* Font structure */
+    glyph_font_t ttf_font;
+
+    /* Load TrueType font: caller-owned blob, else the file is memory-mapped */
+    if (config->font_data) {
+        if (!glyph_ttf_load_font_from_memory(&ttf_font, config->font_data, config->font_data_size)) {
+            GLYPH_LOG("Failed to load TTF font from memory\n");
+            return atlas;
+        }
+    } else if (!glyph_ttf_load_font_from_file(&ttf_font, font_path)) {
+        GLYPH_LOG("Failed to load TTF font: %s\n", font_path);
+        return atlas;
+    }
+    GLYPH_STAT(double load_ms = glyph__stats_now_ms() - phase_start);
+
+    atlas = glyph_atlas__create_from_font(&ttf_font, 1, pixel_height, charset, char_type, use_sdf, config);
+    GLYPH_STAT(atlas.bake_stats.load_ms = load_ms);
+    GLYPH_STAT(atlas.bake_stats.total_ms += load_ms);
+    return atlas;
+}
+
+/*
+ * Creates a font atlas with the default build configuration
+ *
+ * Equivalent to glyph_atlas_create_ex with config == NULL (serial
+ * rasterization). See glyph_atlas_create_ex for details.
+ *
+ * Parameters:
+ *   font_path: Path to .ttf font file
+ *   pixel_height: Font size for rasterization (affects quality/detail)
+ *   charset: String containing all characters to include
+ *   char_type: GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII encoding type
+ *   use_sdf: GLYPH_ATLAS_COVERAGE (0), GLYPH_ATLAS_SDF (1) or GLYPH_ATLAS_MSDF (2, keeps sharp corners)
+ *
+ * Returns: Complete glyph_atlas_t or zero-initialized struct on failure
+ */
+static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type, int use_sdf) {
+    return glyph_atlas_create_ex(font_path, pixel_height, charset, char_type, use_sdf, NULL);
+}
+
+/* One entry of a glyph_atlas_create_sizes request */
+typedef struct {
+    float pixel_height;                 /* Font size for rasterization */
+    int use_sdf;                        /* GLYPH_ATLAS_COVERAGE, GLYPH_ATLAS_SDF or GLYPH_ATLAS_MSDF */
+} glyph_atlas_bake_size_t;
+
+/*
+ * Creates several atlases of one charset from a single font parse
+ *
+ * The font is loaded once and every glyph outline of the charset is decoded
+ * once into the font's outline cache (see glyph_ttf_cache_outline); each
+ * size/mode then only scales the cached contours. The atlases are identical
+ * to separate glyph_atlas_create_ex calls with the same arguments. The
+ * shared load and decode time is reported in atlases[0].bake_stats.
+ *
+ * Dynamic atlases and config->cache_path keep their own font and cache file
+ * per atlas, so those configs fall back to one glyph_atlas_create_ex call
+ * per entry.
+ *
+ * Parameters:
+ *   font_path: Path to .ttf font file (ignored when config->font_data is set)
+ *   sizes: Pixel height and rendering mode of every atlas to build
+ *   count: Number of entries in sizes
+ *   charset: Characters to include (NULL for the default charset)
+ *   char_type: GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII encoding type
+ *   config: Build configuration shared by all atlases (NULL for defaults)
+ *   atlases: Output array of count atlases (entries that fail are zeroed)
+ *
+ * Returns: Number of atlases created successfully
+ */
+static inline int glyph_atlas_create_sizes(const char* font_path, const glyph_atlas_bake_size_t* sizes, int count, const char* charset,
+                                           glyph_encoding_type_t char_type, const glyph_atlas_config_t* config, glyph_atlas_t* atlases) {
+    int created = 0;
+    if (!sizes || !atlases || count <= 0) return 0;
+    memset(atlases, 0, count * sizeof(glyph_atlas_t));
+
+    glyph_atlas_config_t default_config = glyph_atlas_default_config();
+    if (!config) config = &default_config;
+    if (config->dynamic || config->cache_path) {
+        for (int i = 0; i < count; i++) {
+            atlases[i] = glyph_atlas_create_ex(font_path, sizes[i].pixel_height, charset, char_type, sizes[i].use_sdf, config);
+            if (atlases[i].chars) created++;
+        }
+        return created;
+    }
+
+    GLYPH_STAT(double phase_start = glyph__stats_now_ms());
+    glyph_font_t font;
+    if (config->font_data) {
+        if (!glyph_ttf_load_font_from_memory(&font, config->font_data, config->font_data_size)) {
+            GLYPH_LOG("Failed to load TTF font from memory\n");
+            return 0;
+        }
+    } else if (!glyph_ttf_load_font_from_file(&font, font_path)) {
+        GLYPH_LOG("Failed to load TTF font: %s\n", font_path);
+        return 0;
+    }
+
+    /* Decode every outline once; a failed cache entry is simply decoded again per size */
+    if (!charset) charset = GLYPH_ATLAS__DEFAULT_CHARSET;
+    size_t charset_bytes = strlen(charset);
+    size_t idx = 0;
+    while (idx < charset_bytes) {
+        int codepoint = char_type == GLYPH_ENCODING_UTF8 ? glyph_atlas_utf8_decode(charset, &idx) : (unsigned char)charset[idx++];
+        glyph_ttf_cache_outline(&font, glyph_ttf_find_glyph_index(&font, codepoint));
+    }
+    GLYPH_STAT(double load_ms = glyph__stats_now_ms() - phase_start);
+
+    for (int i = 0; i < count; i++) {
+        atlases[i] = glyph_atlas__create_from_font(&font, 0, sizes[i].pixel_height, charset, char_type, sizes[i].use_sdf, config);
+        if (atlases[i].chars) created++;
+    }
+    GLYPH_STAT(atlases[0].bake_stats.load_ms = load_ms);
+    GLYPH_STAT(atlases[0].bake_stats.total_ms += load_ms);
+    glyph_ttf_free_font(&font);
+    return created;
+}
+
+/*
+ * Frees all resources associated with a glyph atlas
+ *
+ * Deallocates the character array and atlas image. Safe to call
+ * on partially initialized or empty atlases.
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph_atlas_t to free
+ */
+static inline void glyph_atlas_free(glyph_atlas_t* atlas) {
+    if (!atlas) return;
+    /* Free character data array (merged faces only borrow it) */
+    if (atlas->chars) {
+        if (!atlas->borrowed_chars) GLYPH_FREE(atlas->chars);
+        atlas->chars = NULL;
+        atlas->borrowed_chars = 0;
+    }
+    /* Free codepoint lookup index */
+    glyph_atlas__index_free(&atlas->index);
+    /* Free kerning pairs */
+    glyph_atlas__kerning_free(&atlas->kerning);
+    /* Free on-demand glyph cache and its retained font */
+    glyph_atlas__cache_free(atlas->cache);
+    atlas->cache = NULL;
     /* Free atlas texture image */
     glyph_image_free(&atlas->image);
     atlas->num_chars = 0;
 }
 
+/* States reported by glyph_atlas_build_poll */
+typedef enum {
+    GLYPH_ATLAS_BUILD_PENDING = 0,  /* Created, not picked up by a thread yet */
+    GLYPH_ATLAS_BUILD_RUNNING = 1,  /* Font loading and rasterization in progress */
+    GLYPH_ATLAS_BUILD_READY   = 2,  /* Atlas built, ready for glyph_atlas_build_take */
+    GLYPH_ATLAS_BUILD_FAILED  = 3   /* Build finished without an atlas */
+} glyph_atlas_build_state_t;
+
+typedef struct glyph_atlas_build_t glyph_atlas_build_t;
+
+/*
+ * Completion callback of a background atlas build
+ *
+ * Runs on the thread that built the atlas, right before glyph_atlas_build_poll
+ * starts reporting READY or FAILED. It must not make GL calls or free the
+ * build; signal the render thread instead.
+ */
+typedef void (*glyph_atlas_build_callback_fn)(void* user_data, glyph_atlas_build_t* build, int success);
+
+/*
+ * Atlas build running off the render thread
+ *
+ * Holds private copies of the build inputs, so the caller's strings may go
+ * away once the build is created (config->font_data, config->allocator and
+ * config->dispatch are still used by pointer and must stay valid until the
+ * build finishes). Nothing here touches GL.
+ */
+struct glyph_atlas_build_t {
+    char* font_path;                        /* Copied font path (NULL with config.font_data) */
+    char* charset;                          /* Copied charset (NULL = default charset) */
+    char* cache_path;                       /* Copied config.cache_path */
+    float pixel_height;                     /* Font size for rasterization */
+    glyph_encoding_type_t char_type;        /* Charset encoding */
+    int use_sdf;                            /* Atlas mode (GLYPH_ATLAS_*) */
+    glyph_atlas_config_t config;            /* Build configuration, cache_path pointing at the copy */
+    glyph_atlas_build_callback_fn callback; /* Optional completion callback */
+    void* user_data;                        /* Forwarded to callback */
+    glyph_atlas_t atlas;                    /* Result once READY, until taken */
+    volatile long state;                    /* glyph_atlas_build_state_t, updated atomically */
+    glyph_thread_t thread;                  /* Background thread of glyph_atlas_build_start */
+};
+
+/* Copies a string with GLYPH_MALLOC (NULL stays NULL) */
+static char* glyph_atlas__strdup(const char* text, int* ok) {
+    if (!text) return NULL;
+    size_t length = strlen(text) + 1;
+    char* copy = (char*)GLYPH_MALLOC(length);
+    if (copy) memcpy(copy, text, length);
+    else *ok = 0;
+    return copy;
+}
+
+/*
+ * Prepares an atlas build without running it
+ *
+ * Run the returned build on any thread with glyph_atlas_build_run (for
+ * example from a job system), or use glyph_atlas_build_start to get a
+ * dedicated thread. Parameters match glyph_atlas_create_ex.
+ *
+ * Parameters:
+ *   font_path: Path to .ttf font file (ignored when config->font_data is set)
+ *   pixel_height: Font size for rasterization
+ *   charset: Characters to include (NULL for the default charset)
+ *   char_type: GLYPH_ENCODING_UTF8 or GLYPH_ENCODING_ASCII encoding type
+ *   use_sdf: GLYPH_ATLAS_COVERAGE, GLYPH_ATLAS_SDF or GLYPH_ATLAS_MSDF
+ *   config: Build configuration (NULL for defaults), copied
+ *   callback: Optional completion callback, called on the building thread
+ *   user_data: Forwarded to callback
+ *
+ * Returns: New build (release with glyph_atlas_build_free), or NULL on allocation failure
+ */
+static inline glyph_atlas_build_t* glyph_atlas_build_create(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type,
+                                                          int use_sdf, const glyph_atlas_config_t* config,
+                                                          glyph_atlas_build_callback_fn callback, void* user_data) {
+    glyph_atlas_build_t* build = (glyph_atlas_build_t*)GLYPH_MALLOC(sizeof(glyph_atlas_build_t));
+    if (!build) return NULL;
+    memset(build, 0, sizeof(glyph_atlas_build_t));
+
+    build->config = config ? *config : glyph_atlas_default_config();
+    int ok = 1;
+    build->font_path = build->config.font_data ? NULL : glyph_atlas__strdup(font_path, &ok);
+    build->charset = glyph_atlas__strdup(charset, &ok);
+    build->cache_path = glyph_atlas__strdup(build->config.cache_path, &ok);
+    if (!ok) {
+        GLYPH_FREE(build->font_path);
+        GLYPH_FREE(build->charset);
+        GLYPH_FREE(build->cache_path);
+        GLYPH_FREE(build);
+        return NULL;
+    }
+    build->config.cache_path = build->cache_path;
+    build->pixel_height = pixel_height;
+    build->char_type = char_type;
+    build->use_sdf = use_sdf;
+    build->callback = callback;
+    build->user_data = user_data;
+    build->state = GLYPH_ATLAS_BUILD_PENDING;
+    return build;
+}
+
+/*
+ * Builds the atlas on the calling thread
+ *
+ * Entry point for job systems. Only the first call (from any thread, including
+ * an implicit one from glyph_atlas_build_wait) does the work; later calls
+ * return immediately.
+ *
+ * Parameters:
+ *   build: Build from glyph_atlas_build_create
+ */
+static inline void glyph_atlas_build_run(glyph_atlas_build_t* build) {
+    if (!build || !glyph_thread_atomic_cas(&build->state, GLYPH_ATLAS_BUILD_PENDING, GLYPH_ATLAS_BUILD_RUNNING)) return;
+
+    build->atlas = glyph_atlas_create_ex(build->font_path, build->pixel_height, build->charset, build->char_type, build->use_sdf, &build->config);
+    int success = build->atlas.chars != NULL && build->atlas.image.data != NULL;
+    if (!success) glyph_atlas_free(&build->atlas);
+    if (build->callback) build->callback(build->user_data, build, success);
+    glyph_thread_atomic_store(&build->state, success ? GLYPH_ATLAS_BUILD_READY : GLYPH_ATLAS_BUILD_FAILED);
+}
+
+/* Thread entry of glyph_atlas_build_start */
+static void glyph_atlas__build_thread(void* arg) {
+    glyph_atlas_build_run((glyph_atlas_build_t*)arg);
+}
+
+/*
+ * Starts an atlas build on a background thread
+ *
+ * Same parameters as glyph_atlas_build_create. Poll with
+ * glyph_atlas_build_poll (or wait for the callback), then hand the build to
+ * glyph_renderer_create_from_build or glyph_atlas_build_take on the render
+ * thread. If no thread can be started (or with GLYPHGL_NO_THREADS) the atlas
+ * is built before this function returns.
+ *
+ * Returns: New build (release with glyph_atlas_build_free), or NULL on allocation failure
+ */
+static inline glyph_atlas_build_t* glyph_atlas_build_start(const char* font_path, float pixel_height, const char* charset, glyph_encoding_type_t char_type,
+                                                         int use_sdf, const glyph_atlas_config_t* config,
+                                                         glyph_atlas_build_callback_fn callback, void* user_data) {
+    glyph_atlas_build_t* build = glyph_atlas_build_create(font_path, pixel_height, charset, char_type, use_sdf, config, callback, user_data);
+    if (build && !glyph_thread_start(&build->thread, glyph_atlas__build_thread, build)) {
+        GLYPH_LOG("Could not start atlas build thread, building synchronously\n");
+        glyph_atlas_build_run(build);
+    }
+    return build;
+}
+
+/*
+ * Reports the progress of a build without blocking
+ *
+ * Returns: glyph_atlas_build_state_t (FAILED for a NULL build)
+ */
+static inline int glyph_atlas_build_poll(glyph_atlas_build_t* build) {
+    if (!build) return GLYPH_ATLAS_BUILD_FAILED;
+    return (int)glyph_thread_atomic_load(&build->state);
+}
+
+/*
+ * Blocks until a build has finished
+ *
+ * A build nobody has picked up yet is run on the calling thread.
+ *
+ * Returns: 1 if an atlas was built, 0 on failure
+ */
+static inline int glyph_atlas_build_wait(glyph_atlas_build_t* build) {
+    if (!build) return 0;
+    glyph_atlas_build_run(build);
+    glyph_thread_join(&build->thread);
+    while (glyph_atlas_build_poll(build) == GLYPH_ATLAS_BUILD_RUNNING) glyph_thread_yield();
+    return glyph_atlas_build_poll(build) == GLYPH_ATLAS_BUILD_READY;
+}
+
+/*
+ * Moves the finished atlas out of a build
+ *
+ * Waits for the build first. The caller owns the returned atlas; later
+ * calls return a zero-initialized atlas.
+ *
+ * Returns: Built atlas, or zero-initialized struct on failure
+ */
+static inline glyph_atlas_t glyph_atlas_build_take(glyph_atlas_build_t* build) {
+    glyph_atlas_t atlas = {0};
+    if (!glyph_atlas_build_wait(build)) return atlas;
+    atlas = build->atlas;
+    memset(&build->atlas, 0, sizeof(glyph_atlas_t));
+    return atlas;
+}
+
+/*
+ * Releases a build, waiting for it if it is still running
+ *
+ * An atlas that was not taken is freed with it.
+ *
+ * Parameters:
+ *   build: Build to release (NULL is ignored)
+ */
+static inline void glyph_atlas_build_free(glyph_atlas_build_t* build) {
+    if (!build) return;
+    /* Claim builds nobody started so waiting cannot spin forever */
+    glyph_thread_atomic_cas(&build->state, GLYPH_ATLAS_BUILD_PENDING, GLYPH_ATLAS_BUILD_FAILED);
+    glyph_thread_join(&build->thread);
+    while (glyph_atlas_build_poll(build) == GLYPH_ATLAS_BUILD_RUNNING) glyph_thread_yield();
+    glyph_atlas_free(&build->atlas);
+    GLYPH_FREE(build->font_path);
+    GLYPH_FREE(build->charset);
+    GLYPH_FREE(build->cache_path);
+    GLYPH_FREE(build);
+}
+
+/*
+ * Packs several static atlases into one shared atlas
+ *
+ * Every glyph of every source atlas is repacked with the skyline packer
+ * into the smallest power-of-2 texture that holds them all, and the glyph
+ * records are concatenated into the merged chars array with positions
+ * rewritten. Each source then becomes a lookup view: it keeps its index,
+ * kerning and pixel height, but its chars point into the merged array and
+ * its image is released. Free the views before or after the merged atlas,
+ * but do not use them once it is gone.
+ *
+ * Parameters:
+ *   faces: Static atlases to merge, all coverage/SDF or all MSDF (modified in place)
+ *   count: Number of atlases
+ *   padding: Empty pixels kept around every glyph (at least 1)
+ *
+ * Returns: Merged atlas (codepoints resolve to the first face that has them),
+ *          or zero-initialized struct on failure (sources left untouched)
+ */
+static inline glyph_atlas_t glyph_atlas_merge(glyph_atlas_t* faces, int count, int padding) {
+    glyph_atlas_t atlas = {0};
+    if (!faces || count <= 0) return atlas;
+    padding = glyph_atlas__padding(padding);
+    GLYPH_STAT(double phase_start = glyph__stats_now_ms());
+
+    int total_chars = 0;
+    for (int f = 0; f < count; f++) {
+        if (faces[f].cache || faces[f].borrowed_chars || !faces[f].image.data || faces[f].msdf != faces[0].msdf) {
+            GLYPH_LOG("Can only merge static atlases of the same kind\n");
+            return atlas;
+        }
+        total_chars += faces[f].num_chars;
+    }
+
+    /* One rectangle per glyph of every face, padded like the glyph packer does */
+    glyph_atlas_rect_t* rects = (glyph_atlas_rect_t*)GLYPH_MALLOC((total_chars > 0 ? total_chars : 1) * sizeof(glyph_atlas_rect_t));
+    atlas.chars = (glyph_atlas_char_t*)GLYPH_MALLOC((total_chars > 0 ? total_chars : 1) * sizeof(glyph_atlas_char_t));
+    if (!rects || !atlas.chars) {
+        GLYPH_FREE(rects);
+        GLYPH_FREE(atlas.chars);
+        atlas.chars = NULL;
+        return atlas;
+    }
+    double glyph_area = 0.0, packed_area = 0.0;
+    int max_w = 0, max_h = 0;
+    for (int f = 0, n = 0; f < count; f++) {
+        for (int i = 0; i < faces[f].num_chars; i++, n++) {
+            const glyph_atlas_char_t* ch = &faces[f].chars[i];
+            int has_bitmap = ch->width > 0 && ch->height > 0;
+            rects[n].w = has_bitmap ? ch->width + padding : 0;
+            rects[n].h = has_bitmap ? ch->height + padding : 0;
+            if (!has_bitmap) continue;
+            glyph_area += (double)ch->width * ch->height;
+            packed_area += (double)rects[n].w * rects[n].h;
+            if (rects[n].w > max_w) max_w = rects[n].w;
+            if (rects[n].h > max_h) max_h = rects[n].h;
+        }
+    }
+
+    /* Same sizing rule as glyph_atlas_create_ex: grow the smaller side until everything fits */
+    int width = glyph_atlas__next_pow2(max_w + padding > 1 ? max_w + padding : 1);
+    int height = glyph_atlas__next_pow2(max_h + padding > 1 ? max_h + padding : 1);
+    while ((double)width * height < packed_area) {
+        if (width <= height) width *= 2;
+        else height *= 2;
+    }
+    while (!glyph_atlas_pack_rects(GLYPH_ATLAS_PACKER_SKYLINE, rects, total_chars, width - padding, height - padding)) {
+        if (width <= height) width *= 2;
+        else height *= 2;
+        if (width > GLYPHGL_ATLAS_MAX_SIZE || height > GLYPHGL_ATLAS_MAX_SIZE) {
+            GLYPH_LOG("Failed to merge %d glyphs into a %dx%d atlas\n", total_chars, GLYPHGL_ATLAS_MAX_SIZE, GLYPHGL_ATLAS_MAX_SIZE);
+            GLYPH_FREE(rects);
+            GLYPH_FREE(atlas.chars);
+            atlas.chars = NULL;
+            return atlas;
+        }
+    }
+
+    GLYPH_STAT(atlas.bake_stats.pack_ms = glyph__stats_now_ms() - phase_start);
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    atlas.image = faces[0].msdf ? glyph_image_create(width, height) : glyph_image_create_gray(width, height);
+    if (!atlas.image.data) {
+        GLYPH_LOG("Failed to allocate %dx%d merged atlas image\n", width, height);
+        atlas.image.width = 0;
+        atlas.image.height = 0;
+        GLYPH_FREE(rects);
+        GLYPH_FREE(atlas.chars);
+        atlas.chars = NULL;
+        return atlas;
+    }
+    size_t bpp = atlas.image.channels;
+    memset(atlas.image.data, 0, (size_t)width * height * bpp);
+
+    /* Copy every glyph from its source texture to its new position */
+    for (int f = 0, n = 0; f < count; f++) {
+        const glyph_image_t* src = &faces[f].image;
+        for (int i = 0; i < faces[f].num_chars; i++, n++) {
+            glyph_atlas_char_t ch = faces[f].chars[i];
+            if (rects[n].w > 0) {
+                for (int y = 0; y < ch.height; y++) {
+                    memcpy(atlas.image.data + ((size_t)(rects[n].y + padding + y) * width + rects[n].x + padding) * bpp,
+                           src->data + ((size_t)(ch.y + y) * src->width + ch.x) * bpp, (size_t)ch.width * bpp);
+                }
+                ch.x = rects[n].x + padding;
+                ch.y = rects[n].y + padding;
+            }
+            atlas.chars[n] = ch;
+        }
+    }
+    GLYPH_FREE(rects);
+    GLYPH_STAT(atlas.bake_stats.copy_ms = glyph__stats_now_ms() - phase_start);
+
+    atlas.num_chars = total_chars;
+    atlas.pixel_height = faces[0].pixel_height;
+    atlas.occupancy = (float)(glyph_area / ((double)width * height));
+    atlas.msdf = faces[0].msdf;
+    GLYPH_STAT(phase_start = glyph__stats_now_ms());
+    if (!glyph_atlas__index_build(&atlas)) {
+        GLYPH_LOG("Warning: Failed to build merged atlas lookup index\n");
+    }
+    GLYPH_STAT(atlas.bake_stats.index_ms = glyph__stats_now_ms() - phase_start);
+    GLYPH_STAT(atlas.bake_stats.total_ms = atlas.bake_stats.pack_ms + atlas.bake_stats.copy_ms + atlas.bake_stats.index_ms);
+
+    /* The merged build also accounts for the work that produced every face */
+    #ifdef GLYPHGL_STATS
+    for (int f = 0; f < count; f++) {
+        const glyph_atlas_bake_stats_t* face = &faces[f].bake_stats;
+        atlas.bake_stats.load_ms += face->load_ms;
+        atlas.bake_stats.rasterize_ms += face->rasterize_ms;
+        atlas.bake_stats.sdf_ms += face->sdf_ms;
+        atlas.bake_stats.pack_ms += face->pack_ms;
+        atlas.bake_stats.copy_ms += face->copy_ms;
+        atlas.bake_stats.kerning_ms += face->kerning_ms;
+        atlas.bake_stats.index_ms += face->index_ms;
+        atlas.bake_stats.total_ms += face->total_ms;
+        atlas.bake_stats.glyphs += face->glyphs;
+    }
+    #endif
+
+    /* Turn the sources into views over the merged glyph records */
+    for (int f = 0, base = 0; f < count; f++) {
+        GLYPH_FREE(faces[f].chars);
+        faces[f].chars = atlas.chars + base;
+        faces[f].borrowed_chars = 1;
+        glyph_image_free(&faces[f].image);
+        base += faces[f].num_chars;
+    }
+    return atlas;
+}
+
 /*
  * Saves the atlas texture as a PNG image file
  *
@@ -654,6 +2620,8 @@ static inline int glyph_atlas_save_metadata(glyph_atlas_t* atlas, const char* ou
  *
  * Searches the atlas for glyph information corresponding to a
  * specific Unicode character. Returns NULL if character not found.
+ * Uses the lookup index built by glyph_atlas_create, so the cost is
+ * constant regardless of charset size.
  *
  * Parameters:
  *   atlas: Pointer to glyph atlas
@@ -664,7 +2632,13 @@ static inline int glyph_atlas_save_metadata(glyph_atlas_t* atlas, const char* ou
 static inline glyph_atlas_char_t* glyph_atlas_find_char(glyph_atlas_t* atlas, int codepoint) {
     if (!atlas || !atlas->chars) return NULL;
 
-    /* Linear search through character array */
+    /* Constant-time path through the codepoint index */
+    if (atlas->index.count > 0) {
+        int i = glyph_atlas__index_lookup(&atlas->index, codepoint);
+        return i >= 0 ? &atlas->chars[i] : NULL;
+    }
+
+    /* Linear search for atlases assembled without an index */
     for (int i = 0; i < atlas->num_chars; i++) {
         if (atlas->chars[i].codepoint == codepoint) {
             return &atlas->chars[i];
@@ -673,6 +2647,191 @@ static inline glyph_atlas_char_t* glyph_atlas_find_char(glyph_atlas_t* atlas, in
     return NULL;
 }
 
+/*
+ * Marks the start of a new use period for a dynamic atlas
+ *
+ * Glyphs requested through glyph_atlas_get_char during the current tick are
+ * never evicted, so every glyph referenced by one draw call stays resident.
+ * Renderers call this once per draw/flush. No-op for static atlases.
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ */
+static inline void glyph_atlas_cache_tick(glyph_atlas_t* atlas) {
+    if (!atlas || !atlas->cache) return;
+    if (++atlas->cache->tick == 0) atlas->cache->tick = 1; /* 0 is reserved for "never used" */
+}
+
+/*
+ * Looks up a character, rasterizing it on demand in dynamic atlases
+ *
+ * Static atlases behave like glyph_atlas_find_char. Dynamic atlases load
+ * missing codepoints from the retained font into a free slot, evicting the
+ * least recently used glyph when the atlas is full.
+ *
+ * Note: Adding a glyph may reallocate the chars array, invalidating pointers
+ *       returned by earlier calls.
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ *   codepoint: Unicode codepoint to look up
+ *
+ * Returns: Pointer to glyph_atlas_char_t, or NULL if the font has no such glyph
+ *          or every slot is in use during the current tick
+ */
+static inline glyph_atlas_char_t* glyph_atlas_get_char(glyph_atlas_t* atlas, int codepoint) {
+    glyph_atlas_char_t* found = glyph_atlas_find_char(atlas, codepoint);
+    if (!atlas || !atlas->cache) return found;
+
+    glyph_atlas_cache_t* cache = atlas->cache;
+    if (found) {
+        cache->last_used[found - atlas->chars] = cache->tick;
+        return found;
+    }
+
+    /* Codepoints the font cannot map keep falling back to the caller */
+    int glyph_index = codepoint < 0 ? 0 : glyph_ttf_find_glyph_index(&cache->font, codepoint);
+    if (glyph_index == 0 && codepoint != ' ') return NULL;
+    glyph_ttf_cache_components(&cache->font, glyph_index);
+
+    /* Rasterize with the same job used at creation time */
+    glyph_atlas__temp_glyph_t glyph;
+    glyph_atlas__raster_job_t job;
+    job.font = &cache->font;
+    job.scale = cache->scale;
+    job.pixel_height = atlas->pixel_height;
+    job.use_sdf = cache->use_sdf;
+    job.sdf_spread = cache->sdf_spread;
+    job.raster_scratch = &cache->raster_scratch;
+    job.sdf_scratch = &cache->sdf_scratch;
+    job.codepoints = &codepoint;
+    job.temp_glyphs = &glyph;
+    GLYPH_STAT(double raster_start = glyph__stats_now_ms());
+    glyph_atlas__raster_glyph_job(&job, 0, 0);
+    GLYPH_STAT(atlas->bake_stats.rasterize_ms += glyph__stats_now_ms() - raster_start);
+    GLYPH_STAT(atlas->bake_stats.sdf_ms += glyph.sdf_ms);
+    GLYPH_STAT(atlas->bake_stats.glyphs++);
+
+    int has_bitmap = glyph.bitmap && glyph.width > 0 && glyph.height > 0;
+    int char_index = -1;
+    int slot = -1;
+    if (has_bitmap) {
+        if (!glyph_atlas__cache_fits(cache, &glyph)) {
+            #ifdef GLYPHGL_DEBUG
+            GLYPH_LOG("Glyph U+%04X (%dx%d) exceeds the dynamic atlas slot size\n", codepoint, glyph.width, glyph.height);
+            #endif
+            glyph_atlas__free_temp_bitmap(&glyph);
+            return NULL;
+        }
+
+        if (cache->num_free_slots > 0) {
+            slot = cache->free_slots[--cache->num_free_slots];
+        } else {
+            /* Evict the least recently used glyph that is not needed in this tick */
+            unsigned int oldest = 0;
+            int num_slots = cache->columns * cache->rows;
+            for (int s = 0; s < num_slots; s++) {
+                unsigned int used = cache->last_used[cache->slot_owner[s]];
+                if (used == cache->tick) continue;
+                if (slot < 0 || used < oldest) {
+                    slot = s;
+                    oldest = used;
+                }
+            }
+            if (slot < 0) {
+                glyph_atlas__free_temp_bitmap(&glyph);
+                return NULL;
+            }
+            /* Reuse the victim's chars[] entry for the new codepoint */
+            char_index = cache->slot_owner[slot];
+            glyph_atlas__index_remove(&atlas->index, atlas->chars[char_index].codepoint);
+            cache->slot_owner[slot] = -1;
+            cache->generation++;
+        }
+    }
+
+    /* Append a new entry when no evicted one is being reused */
+    if (char_index < 0) {
+        if (atlas->num_chars == cache->capacity && !glyph_atlas__cache_reserve(atlas, cache->capacity * 2)) {
+            if (slot >= 0) cache->free_slots[cache->num_free_slots++] = slot;
+            glyph_atlas__free_temp_bitmap(&glyph);
+            return NULL;
+        }
+        char_index = atlas->num_chars++;
+    }
+
+    glyph_atlas_char_t* c = &atlas->chars[char_index];
+    c->codepoint = codepoint;
+    c->advance = glyph.advance;
+    cache->char_slot[char_index] = -1;
+    cache->last_used[char_index] = cache->tick;
+    if (has_bitmap) {
+        glyph_atlas__cache_place(atlas, char_index, &glyph, slot);
+    } else {
+        c->x = c->y = c->width = c->height = c->xoff = c->yoff = 0;
+    }
+    glyph_atlas__free_temp_bitmap(&glyph);
+
+    if (!glyph_atlas__index_insert(&atlas->index, codepoint, char_index)) {
+        GLYPH_LOG("Warning: Failed to index cached glyph U+%04X\n", codepoint);
+    }
+    return c;
+}
+
+/*
+ * Returns the kerning between two characters
+ *
+ * Static atlases answer from the pair table built at creation time.
+ * Dynamic atlases fall back to the retained font for pairs not in the
+ * table and memoize the result (up to GLYPHGL_KERNING_MEMO_LIMIT pairs).
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ *   left: Codepoint of the first character
+ *   right: Codepoint of the character that follows it
+ *
+ * Returns: Advance adjustment in atlas pixels (multiply by the text scale)
+ */
+static inline float glyph_atlas_get_kerning(glyph_atlas_t* atlas, int left, int right) {
+    glyph_atlas_kerning_t* kerning = &atlas->kerning;
+    if (kerning->capacity) {
+        int slot = glyph_atlas__kerning_slot(kerning, glyph_atlas__kerning_key(left, right));
+        if (kerning->keys[slot]) return kerning->values[slot];
+    }
+    if (!atlas->cache || !kerning->enabled) return 0.0f;
+
+    const glyph_font_t* font = &atlas->cache->font;
+    int left_glyph = glyph_ttf_find_glyph_index(font, left);
+    int right_glyph = glyph_ttf_find_glyph_index(font, right);
+    float value = 0.0f;
+    if (left_glyph && right_glyph && glyph_ttf_glyph_has_kerning(font, left_glyph)) {
+        value = glyph_ttf_get_glyph_kerning(font, left_glyph, right_glyph) * atlas->cache->scale;
+    }
+    if (kerning->count < GLYPHGL_KERNING_MEMO_LIMIT) glyph_atlas__kerning_insert(kerning, left, right, value);
+    return value;
+}
+
+/*
+ * Retrieves and clears the region of a dynamic atlas modified since the last call
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ *   x, y, width, height: Receive the dirty rectangle in texels
+ *
+ * Returns: 1 if part of the atlas needs re-uploading, 0 otherwise
+ */
+static inline int glyph_atlas_cache_take_dirty(glyph_atlas_t* atlas, int* x, int* y, int* width, int* height) {
+    if (!atlas || !atlas->cache) return 0;
+    glyph_atlas_cache_t* cache = atlas->cache;
+    if (cache->dirty_x1 <= cache->dirty_x0 || cache->dirty_y1 <= cache->dirty_y0) return 0;
+    *x = cache->dirty_x0;
+    *y = cache->dirty_y0;
+    *width = cache->dirty_x1 - cache->dirty_x0;
+    *height = cache->dirty_y1 - cache->dirty_y0;
+    cache->dirty_x0 = cache->dirty_y0 = cache->dirty_x1 = cache->dirty_y1 = 0;
+    return 1;
+}
+
 /*
  * Prints detailed information about the atlas to the log
  *
@@ -689,7 +2848,13 @@ static inline void glyph_atlas_print_info(glyph_atlas_t* atlas) {
     GLYPH_LOG("Font Atlas Info:\n");
     GLYPH_LOG("  Atlas Size: %ux%u\n", atlas->image.width, atlas->image.height);
     GLYPH_LOG("  Pixel Height: %.2f\n", atlas->pixel_height);
+    GLYPH_LOG("  Occupancy: %.1f%%\n", atlas->occupancy * 100.0f);
     GLYPH_LOG("  Characters: %d\n", atlas->num_chars);
+    #ifdef GLYPHGL_STATS
+    GLYPH_LOG("  Bake: %.2f ms (load %.2f, rasterize %.2f, sdf %.2f, pack %.2f, copy %.2f, kerning %.2f, index %.2f)\n",
+              atlas->bake_stats.total_ms, atlas->bake_stats.load_ms, atlas->bake_stats.rasterize_ms, atlas->bake_stats.sdf_ms,
+              atlas->bake_stats.pack_ms, atlas->bake_stats.copy_ms, atlas->bake_stats.kerning_ms, atlas->bake_stats.index_ms);
+    #endif
     GLYPH_LOG("\nCharacter Details:\n");
 
     /* Print per-character details */
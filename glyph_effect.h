@@ -12,6 +12,8 @@
  * - GLSL-based implementation with automatic version handling
  * - Effect stacking through uniform parameters
  * - Performance-optimized shader generation and caching
+ * - Programs shared through the glyph_gl.h program cache; glyph_effect_precompile
+ *   builds every effect up front and glyph_renderer_set_effect switches per draw
  */
 
 #ifndef __GLYPH_EFFECT_H
@@ -96,24 +98,22 @@ typedef struct {
  * =================================================================
  */
 
-static const char* glyph__glow_vertex_shader = NULL;
+/* Built-in effects reuse the default vertex stage (rebuilt if the GLSL version changes) */
 static const char* glyph__get_glow_vertex_shader() {
-    if (!glyph__glow_vertex_shader) {
-        glyph__glow_vertex_shader = glyph__get_vertex_shader_source_cached();
-    }
-    return glyph__glow_vertex_shader;
+    return glyph__get_vertex_shader_source_cached();
 }
 
 static char glyph__glow_fragment_shader_buffer[2048];
 static const char* glyph__glow_fragment_shader = NULL;
+static unsigned int glyph__glow_fragment_shader_serial = 0;
 static const char* glyph__get_glow_fragment_shader() {
-    if (!glyph__glow_fragment_shader) {
-        sprintf(glyph__glow_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__glow_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__glow_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__glow_fragment_shader_buffer, sizeof(glyph__glow_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform float glowIntensity = 1.0;\n"
             "void main() {\n"
             "    float alpha = texture(textTexture, TexCoord).r;\n"
@@ -131,7 +131,7 @@ static const char* glyph__get_glow_fragment_shader() {
             "    }\n"
             "    glow /= totalWeight;\n"
             "    float finalAlpha = alpha + glow * glowIntensity;\n"
-            "    FragColor = vec4(textColor, min(finalAlpha, 1.0));\n"
+            "    FragColor = vec4(TextColor, min(finalAlpha, 1.0));\n"
             "}\n");
         glyph__glow_fragment_shader = glyph__glow_fragment_shader_buffer;
     }
@@ -143,7 +143,10 @@ static const char* glyph__get_glow_fragment_shader() {
  *
  * Allows advanced users to implement their own text effects by providing
  * custom vertex and fragment shader source code. The shaders must be
- * compatible with the GlyphGL pipeline and use the expected uniform names.
+ * compatible with the GlyphGL pipeline: the default vertex shader passes
+ * 'TexCoord', 'TextColor' and 'flat int Effects' to the fragment stage.
+ * Shaders that declare the 'textColor'/'effects' uniforms instead keep
+ * working, at the cost of one draw call per style when batching.
  *
  * Parameters:
  *   vertex_shader: Complete GLSL vertex shader source
@@ -158,14 +161,15 @@ static inline glyph_effect_t glyph_effect_create_custom(const char* vertex_shade
 
 static char glyph__rainbow_fragment_shader_buffer[2048];
 static const char* glyph__rainbow_fragment_shader = NULL;
+static unsigned int glyph__rainbow_fragment_shader_serial = 0;
 static const char* glyph__get_rainbow_fragment_shader() {
-    if (!glyph__rainbow_fragment_shader) {
-        sprintf(glyph__rainbow_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__rainbow_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__rainbow_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__rainbow_fragment_shader_buffer, sizeof(glyph__rainbow_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform float time;\n"
             "void main() {\n"
             "    float alpha = texture(textTexture, TexCoord).r;\n"
@@ -204,14 +208,15 @@ static inline glyph_effect_t glyph_effect_create_glow() {
 
 static char glyph__outline_fragment_shader_buffer[2048];
 static const char* glyph__outline_fragment_shader = NULL;
+static unsigned int glyph__outline_fragment_shader_serial = 0;
 static const char* glyph__get_outline_fragment_shader() {
-    if (!glyph__outline_fragment_shader) {
-        sprintf(glyph__outline_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__outline_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__outline_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__outline_fragment_shader_buffer, sizeof(glyph__outline_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform vec3 outlineColor = vec3(0.0, 0.0, 0.0);\n"
             "void main() {\n"
             "    float alpha = texture(textTexture, TexCoord).r;\n"
@@ -224,7 +229,7 @@ static const char* glyph__get_outline_fragment_shader() {
             "    }\n"
             "    outline = min(outline, 1.0);\n"
             "    float finalAlpha = max(alpha, outline * 0.3);\n"
-            "    vec3 finalColor = mix(outlineColor, textColor, alpha / max(finalAlpha, 0.001));\n"
+            "    vec3 finalColor = mix(outlineColor, TextColor, alpha / max(finalAlpha, 0.001));\n"
             "    FragColor = vec4(finalColor, finalAlpha);\n"
             "}\n");
         glyph__outline_fragment_shader = glyph__outline_fragment_shader_buffer;
@@ -234,20 +239,21 @@ static const char* glyph__get_outline_fragment_shader() {
 
 static char glyph__shadow_fragment_shader_buffer[2048];
 static const char* glyph__shadow_fragment_shader = NULL;
+static unsigned int glyph__shadow_fragment_shader_serial = 0;
 static const char* glyph__get_shadow_fragment_shader() {
-    if (!glyph__shadow_fragment_shader) {
-        sprintf(glyph__shadow_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__shadow_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__shadow_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__shadow_fragment_shader_buffer, sizeof(glyph__shadow_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform vec2 shadowOffset = vec2(0.005, -0.005);\n"
             "uniform vec3 shadowColor = vec3(0.0, 0.0, 0.0);\n"
             "void main() {\n"
             "    float shadowAlpha = texture(textTexture, TexCoord + shadowOffset).r * 0.5;\n"
             "    float textAlpha = texture(textTexture, TexCoord).r;\n"
-            "    vec3 finalColor = mix(shadowColor, textColor, textAlpha);\n"
+            "    vec3 finalColor = mix(shadowColor, TextColor, textAlpha);\n"
             "    float finalAlpha = max(textAlpha, shadowAlpha);\n"
             "    FragColor = vec4(finalColor, finalAlpha);\n"
             "}\n");
@@ -258,21 +264,22 @@ static const char* glyph__get_shadow_fragment_shader() {
 
 static char glyph__wave_fragment_shader_buffer[2048];
 static const char* glyph__wave_fragment_shader = NULL;
+static unsigned int glyph__wave_fragment_shader_serial = 0;
 static const char* glyph__get_wave_fragment_shader() {
-    if (!glyph__wave_fragment_shader) {
-        sprintf(glyph__wave_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__wave_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__wave_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__wave_fragment_shader_buffer, sizeof(glyph__wave_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform float time;\n"
             "uniform float waveAmplitude = 0.001;\n"
             "void main() {\n"
             "    vec2 waveCoord = TexCoord;\n"
             "    waveCoord.y += sin(TexCoord.x * 10.0 + time * 3.0) * waveAmplitude;\n"
             "    float alpha = texture(textTexture, waveCoord).r;\n"
-            "    FragColor = vec4(textColor, alpha);\n"
+            "    FragColor = vec4(TextColor, alpha);\n"
             "}\n");
         glyph__wave_fragment_shader = glyph__wave_fragment_shader_buffer;
     }
@@ -281,14 +288,15 @@ static const char* glyph__get_wave_fragment_shader() {
 
 static char glyph__gradient_fragment_shader_buffer[2048];
 static const char* glyph__gradient_fragment_shader = NULL;
+static unsigned int glyph__gradient_fragment_shader_serial = 0;
 static const char* glyph__get_gradient_fragment_shader() {
-    if (!glyph__gradient_fragment_shader) {
-        sprintf(glyph__gradient_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__gradient_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__gradient_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__gradient_fragment_shader_buffer, sizeof(glyph__gradient_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform vec3 gradientStart = vec3(1.0, 0.0, 0.0);\n"
             "uniform vec3 gradientEnd = vec3(0.0, 0.0, 1.0);\n"
             "void main() {\n"
@@ -303,19 +311,20 @@ static const char* glyph__get_gradient_fragment_shader() {
 
 static char glyph__neon_fragment_shader_buffer[2048];
 static const char* glyph__neon_fragment_shader = NULL;
+static unsigned int glyph__neon_fragment_shader_serial = 0;
 static const char* glyph__get_neon_fragment_shader() {
-    if (!glyph__neon_fragment_shader) {
-        sprintf(glyph__neon_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__neon_fragment_shader_serial != glyph__glsl_version_serial) {
+        glyph__neon_fragment_shader_serial = glyph__glsl_version_serial;
+        snprintf(glyph__neon_fragment_shader_buffer, sizeof(glyph__neon_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
-            "uniform vec3 textColor;\n"
-            "uniform int effects;\n"
+            "in vec3 TextColor;\n"
             "uniform float time;\n"
             "void main() {\n"
             "    float alpha = texture(textTexture, TexCoord).r;\n"
             "    float glow = sin(time * 5.0) * 0.5 + 0.5;\n"
-            "    vec3 neonColor = textColor * (1.0 + glow * 0.5);\n"
+            "    vec3 neonColor = TextColor * (1.0 + glow * 0.5);\n"
             "    FragColor = vec4(neonColor, alpha);\n"
             "}\n");
         glyph__neon_fragment_shader = glyph__neon_fragment_shader_buffer;
@@ -401,4 +410,41 @@ static inline glyph_effect_t glyph_effect_create_neon() {
     return effect;
 }
 
+/*
+ * Builds the programs of the default shaders and every built-in effect
+ *
+ * Fills the shared program cache (see glyph_gl.h), so creating renderers
+ * and switching effects with glyph_renderer_set_effect never compile at
+ * draw time. With glyph_gl_set_program_binary_dir set, later runs load the
+ * stored binaries instead of compiling. Requires a current GL context; the
+ * programs stay until glyph_gl_clear_program_cache.
+ *
+ * Parameters:
+ *   instanced: Nonzero to also build the variants of the instanced path
+ *              (skipped when the context cannot instance)
+ *
+ * Returns: Number of programs ready
+ */
+static inline int glyph_effect_precompile(int instanced) {
+    if (!glyph_gl_load_functions()) return 0;
+
+    const char* fragment_sources[8];
+    fragment_sources[0] = glyph__get_fragment_shader_source_cached();
+    fragment_sources[1] = glyph__get_glow_fragment_shader();
+    fragment_sources[2] = glyph__get_rainbow_fragment_shader();
+    fragment_sources[3] = glyph__get_outline_fragment_shader();
+    fragment_sources[4] = glyph__get_shadow_fragment_shader();
+    fragment_sources[5] = glyph__get_wave_fragment_shader();
+    fragment_sources[6] = glyph__get_gradient_fragment_shader();
+    fragment_sources[7] = glyph__get_neon_fragment_shader();
+
+    if (instanced && !glyph_gl_supports_instancing()) instanced = 0;
+    int ready = 0;
+    for (int i = 0; i < 8; i++) {
+        ready += glyph_gl_precompile_program(glyph__get_vertex_shader_source_cached(), fragment_sources[i]);
+        if (instanced) ready += glyph_gl_precompile_program(glyph__get_instanced_vertex_shader_source_cached(), fragment_sources[i]);
+    }
+    return ready;
+}
+
 #endif
\ No newline at end of file
@@ -69,6 +69,10 @@
 typedef char GLchar;           /* Character type for shader source */
 typedef ptrdiff_t GLsizeiptr;  /* Size type for buffer operations */
 typedef ptrdiff_t GLintptr;    /* Pointer offset type */
+#ifndef GL_VERSION_3_2
+typedef struct __GLsync *GLsync;       /* Fence sync object handle */
+typedef unsigned long long GLuint64;   /* 64-bit timeout type */
+#endif
 
 /* OpenGL constants - defined here if not available in system headers */
 #ifndef GL_ARRAY_BUFFER
@@ -107,9 +111,96 @@ typedef ptrdiff_t GLintptr;    /* Pointer offset type */
 #ifndef GL_RED
 #define GL_RED 0x1903  /* Red color channel */
 #endif
+#ifndef GL_R8
+#define GL_R8 0x8229  /* 8-bit single-channel internal format */
+#endif
+#ifndef GL_RGB8
+#define GL_RGB8 0x8051  /* 8-bit three-channel internal format (MSDF atlases) */
+#endif
 #ifndef GL_FUNC_ADD
 #define GL_FUNC_ADD 0x8006  /* Blend equation: add */
 #endif
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2  /* Source row stride for sub-rectangle uploads */
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0  /* Buffer usage: written once per use */
+#endif
+#ifndef GL_VERSION
+#define GL_VERSION 0x1F02  /* Version string query */
+#endif
+#ifndef GL_EXTENSIONS
+#define GL_EXTENSIONS 0x1F03  /* Extension string query */
+#endif
+#ifndef GL_NUM_EXTENSIONS
+#define GL_NUM_EXTENSIONS 0x821D  /* Extension count query (GL 3.0+) */
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002  /* Mapping will be written */
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004  /* Previous contents of the mapped range may be discarded */
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008  /* Previous contents of the whole buffer may be discarded */
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC  /* Buffer binding read by texture uploads */
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020  /* Do not wait for pending GPU reads of the buffer */
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040  /* Mapping stays valid while the buffer is used for drawing */
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080  /* Persistent writes become visible without explicit flushes */
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117  /* Fence condition: preceding commands finished */
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001  /* Flush the command stream before waiting */
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A  /* Wait result: fence was signaled before the call */
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C  /* Wait result: fence signaled during the call */
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D  /* Wait result: error */
+#endif
+#ifndef GL_TEXTURE1
+#define GL_TEXTURE1 0x84C1  /* Second texture unit (glyph metrics) */
+#endif
+#ifndef GL_RGBA32F
+#define GL_RGBA32F 0x8814  /* 32-bit float RGBA internal format */
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11  /* Uniform block buffer target (GL 3.1) */
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257  /* Program binaries (GL 4.1 / ES 3.0) */
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX 0xFFFFFFFFu  /* Uniform block not found */
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF  /* GPU timer query target (GL 3.3 / ARB_timer_query) */
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866  /* Query result value */
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867  /* Non-zero once the result can be read without stalling */
+#endif
 
 /* Function pointer typedefs for OpenGL extension functions */
 /* Buffer management functions */
@@ -119,6 +210,41 @@ typedef void (*PFNGLBINDBUFFERPROC)(GLenum target, GLuint buffer);
 typedef void (*PFNGLBUFFERDATAPROC)(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
 typedef void (*PFNGLBUFFERSUBDATAPROC)(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
 
+/* Buffer streaming functions (optional: GL 3.0 mapping, GL 3.2 sync, GL 4.4 storage) */
+typedef void *(*PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef GLboolean (*PFNGLUNMAPBUFFERPROC)(GLenum target);
+typedef void (*PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+typedef GLsync (*PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+typedef GLenum (*PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (*PFNGLDELETESYNCPROC)(GLsync sync);
+
+/* Instancing functions (optional: GL 3.1 draw, GL 3.3 divisor) */
+typedef void (*PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+typedef void (*PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index, GLuint divisor);
+
+/* Uniform blocks (optional: GL 3.1) */
+typedef GLuint (*PFNGLGETUNIFORMBLOCKINDEXPROC)(GLuint program, const GLchar *uniformBlockName);
+typedef void (*PFNGLUNIFORMBLOCKBINDINGPROC)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+typedef void (*PFNGLBINDBUFFERBASEPROC)(GLenum target, GLuint index, GLuint buffer);
+
+/* Program binaries (optional: GL 4.1 / ES 3.0) */
+typedef void (*PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (*PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (*PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+/* Timer queries (optional: GL 1.5 query objects, GL 3.3 64-bit results) */
+typedef void (*PFNGLGENQUERIESPROC)(GLsizei n, GLuint *ids);
+typedef void (*PFNGLDELETEQUERIESPROC)(GLsizei n, const GLuint *ids);
+typedef void (*PFNGLBEGINQUERYPROC)(GLenum target, GLuint id);
+typedef void (*PFNGLENDQUERYPROC)(GLenum target);
+typedef void (*PFNGLGETQUERYOBJECTIVPROC)(GLuint id, GLenum pname, GLint *params);
+typedef void (*PFNGLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, GLuint64 *params);
+
+/* Context queries */
+typedef const GLubyte *(*PFNGLGETSTRINGPROC)(GLenum name);
+typedef const GLubyte *(*PFNGLGETSTRINGIPROC)(GLenum name, GLuint index);
+typedef void (*PFNGLGETINTEGERVPROC)(GLenum pname, GLint *data);
+
 /* Shader management functions */
 typedef GLuint (*PFNGLCREATESHADERPROC)(GLenum type);
 typedef void (*PFNGLDELETESHADERPROC)(GLuint shader);
@@ -158,6 +284,7 @@ typedef void (*PFNGLDELETETEXTURESPROC)(GLsizei n, const GLuint *textures);
 typedef void (*PFNGLBINDTEXTUREPROC)(GLenum target, GLuint texture);
 typedef void (*PFNGLPIXELSTOREIPROC)(GLenum pname, GLint param);
 typedef void (*PFNGLTEXIMAGE2DPROC)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels);
+typedef void (*PFNGLTEXSUBIMAGE2DPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
 typedef void (*PFNGLTEXPARAMETERIPROC)(GLenum target, GLenum pname, GLint param);
 
 /* Drawing functions */
@@ -167,6 +294,7 @@ typedef void (*PFNGLENABLEPROC)(GLenum cap);
 typedef void (*PFNGLBLENDFUNCPROC)(GLenum sfactor, GLenum dfactor);
 typedef void (*PFNGLCLEARCOLORPROC)(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
 typedef void (*PFNGLCLEARPROC)(GLbitfield mask);
+typedef void (*PFNGLFINISHPROC)(void);
 
 /* VAO functions */
 typedef void (*PFNGLGENVERTEXARRAYSPROC)(GLsizei n, GLuint *arrays);
@@ -181,6 +309,41 @@ static PFNGLBINDBUFFERPROC glyph__glBindBuffer;
 static PFNGLBUFFERDATAPROC glyph__glBufferData;
 static PFNGLBUFFERSUBDATAPROC glyph__glBufferSubData;
 
+/* Buffer streaming (optional, may be NULL) */
+static PFNGLMAPBUFFERRANGEPROC glyph__glMapBufferRange;
+static PFNGLUNMAPBUFFERPROC glyph__glUnmapBuffer;
+static PFNGLBUFFERSTORAGEPROC glyph__glBufferStorage;
+static PFNGLFENCESYNCPROC glyph__glFenceSync;
+static PFNGLCLIENTWAITSYNCPROC glyph__glClientWaitSync;
+static PFNGLDELETESYNCPROC glyph__glDeleteSync;
+
+/* Instancing (optional, may be NULL) */
+static PFNGLDRAWARRAYSINSTANCEDPROC glyph__glDrawArraysInstanced;
+static PFNGLVERTEXATTRIBDIVISORPROC glyph__glVertexAttribDivisor;
+
+/* Uniform blocks (optional, may be NULL) */
+static PFNGLGETUNIFORMBLOCKINDEXPROC glyph__glGetUniformBlockIndex;
+static PFNGLUNIFORMBLOCKBINDINGPROC glyph__glUniformBlockBinding;
+static PFNGLBINDBUFFERBASEPROC glyph__glBindBufferBase;
+
+/* Program binaries (optional, may be NULL) */
+static PFNGLGETPROGRAMBINARYPROC glyph__glGetProgramBinary;
+static PFNGLPROGRAMBINARYPROC glyph__glProgramBinary;
+static PFNGLPROGRAMPARAMETERIPROC glyph__glProgramParameteri;
+
+/* Timer queries (optional, may be NULL) */
+static PFNGLGENQUERIESPROC glyph__glGenQueries;
+static PFNGLDELETEQUERIESPROC glyph__glDeleteQueries;
+static PFNGLBEGINQUERYPROC glyph__glBeginQuery;
+static PFNGLENDQUERYPROC glyph__glEndQuery;
+static PFNGLGETQUERYOBJECTIVPROC glyph__glGetQueryObjectiv;
+static PFNGLGETQUERYOBJECTUI64VPROC glyph__glGetQueryObjectui64v;
+
+/* Context queries (optional, may be NULL) */
+static PFNGLGETSTRINGPROC glyph__glGetString;
+static PFNGLGETSTRINGIPROC glyph__glGetStringi;
+static PFNGLGETINTEGERVPROC glyph__glGetIntegerv;
+
 /* Shader management */
 static PFNGLCREATESHADERPROC glyph__glCreateShader;
 static PFNGLDELETESHADERPROC glyph__glDeleteShader;
@@ -220,6 +383,7 @@ static PFNGLDELETETEXTURESPROC glyph__glDeleteTextures;
 static PFNGLBINDTEXTUREPROC glyph__glBindTexture;
 static PFNGLPIXELSTOREIPROC glyph__glPixelStorei;
 static PFNGLTEXIMAGE2DPROC glyph__glTexImage2D;
+static PFNGLTEXSUBIMAGE2DPROC glyph__glTexSubImage2D;
 static PFNGLTEXPARAMETERIPROC glyph__glTexParameteri;
 
 /* Drawing */
@@ -229,6 +393,7 @@ static PFNGLENABLEPROC glyph__glEnable;
 static PFNGLBLENDFUNCPROC glyph__glBlendFunc;
 static PFNGLCLEARCOLORPROC glyph__glClearColor;
 static PFNGLCLEARPROC glyph__glClear;
+static PFNGLFINISHPROC glyph__glFinish;
 
 /* VAOs */
 static PFNGLGENVERTEXARRAYSPROC glyph__glGenVertexArrays;
@@ -237,7 +402,7 @@ static PFNGLBINDVERTEXARRAYPROC glyph__glBindVertexArray;
 
 #if defined(_WIN32) || defined(_WIN64)
     static HMODULE glyph__opengl_dll = NULL;
-    #define GLYPH_GL_LOAD_PROC(type, name) \
+    #define GLYPH_GL_TRY_LOAD_PROC(type, name) \
         glyph__##name = (type)wglGetProcAddress(#name); \
         if (!glyph__##name) { \
             if (!glyph__opengl_dll) { \
@@ -246,29 +411,21 @@ static PFNGLBINDVERTEXARRAYPROC glyph__glBindVertexArray;
             if (glyph__opengl_dll) { \
                 glyph__##name = (type)GetProcAddress(glyph__opengl_dll, #name); \
             } \
-        } \
-        if (!glyph__##name) { \
-            GLYPH_LOG("Failed to load OpenGL function: %s\n", #name); \
-            return 0; \
         }
 #elif defined(__APPLE__)
     #include <dlfcn.h>
     static void* glyph__opengl_handle = NULL;
-    #define GLYPH_GL_LOAD_PROC(type, name) \
+    #define GLYPH_GL_TRY_LOAD_PROC(type, name) \
         if (!glyph__opengl_handle) { \
             glyph__opengl_handle = dlopen("/System/Library/Frameworks/OpenGL.framework/OpenGL", RTLD_LAZY | RTLD_GLOBAL); \
         } \
         if (glyph__opengl_handle) { \
             glyph__##name = (type)dlsym(glyph__opengl_handle, #name); \
-        } \
-        if (!glyph__##name) { \
-            GLYPH_LOG("Failed to load OpenGL function: %s\n", #name); \
-            return 0; \
         }
 #elif defined(__linux__) || defined(__unix__)
     #include <dlfcn.h>
     static void* glyph__libgl_handle = NULL;
-    #define GLYPH_GL_LOAD_PROC(type, name) \
+    #define GLYPH_GL_TRY_LOAD_PROC(type, name) \
         if (!glyph__libgl_handle) { \
             glyph__libgl_handle = dlopen("libGL.so.1", RTLD_LAZY | RTLD_GLOBAL); \
             if (!glyph__libgl_handle) glyph__libgl_handle = dlopen("libGL.so", RTLD_LAZY | RTLD_GLOBAL); \
@@ -280,13 +437,21 @@ static PFNGLBINDVERTEXARRAYPROC glyph__glBindVertexArray;
                 glyph__##name = (type)glXGetProcAddressARB((const GLubyte*)#name); \
             } \
             if (!glyph__##name) glyph__##name = (type)dlsym(glyph__libgl_handle, #name); \
-        } \
-        if (!glyph__##name) { \
-            GLYPH_LOG("Failed to load OpenGL function: %s\n", #name); \
-            return 0; \
         }
 #endif
 
+/* Loads a required entry point; a missing one fails glyph_gl_load_functions */
+#define GLYPH_GL_LOAD_PROC(type, name) \
+    GLYPH_GL_TRY_LOAD_PROC(type, name) \
+    if (!glyph__##name) { \
+        GLYPH_LOG("Failed to load OpenGL function: %s\n", #name); \
+        return 0; \
+    }
+
+/* Loads an optional entry point; callers must check the pointer (or the GL version) before use */
+#define GLYPH_GL_LOAD_PROC_OPTIONAL(type, name) \
+    GLYPH_GL_TRY_LOAD_PROC(type, name)
+
 /*
  * Loads all required OpenGL extension functions for the current platform
  *
@@ -345,6 +510,7 @@ static int glyph_gl_load_functions(void) {
     GLYPH_GL_LOAD_PROC(PFNGLBINDTEXTUREPROC, glBindTexture);
     GLYPH_GL_LOAD_PROC(PFNGLPIXELSTOREIPROC, glPixelStorei);
     GLYPH_GL_LOAD_PROC(PFNGLTEXIMAGE2DPROC, glTexImage2D);
+    GLYPH_GL_LOAD_PROC(PFNGLTEXSUBIMAGE2DPROC, glTexSubImage2D);
     GLYPH_GL_LOAD_PROC(PFNGLTEXPARAMETERIPROC, glTexParameteri);
 
     /* Load drawing functions */
@@ -354,12 +520,54 @@ static int glyph_gl_load_functions(void) {
     GLYPH_GL_LOAD_PROC(PFNGLBLENDFUNCPROC, glBlendFunc);
     GLYPH_GL_LOAD_PROC(PFNGLCLEARCOLORPROC, glClearColor);
     GLYPH_GL_LOAD_PROC(PFNGLCLEARPROC, glClear);
+    GLYPH_GL_LOAD_PROC(PFNGLFINISHPROC, glFinish);
 
     /* Load VAO functions */
     GLYPH_GL_LOAD_PROC(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays);
     GLYPH_GL_LOAD_PROC(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays);
     GLYPH_GL_LOAD_PROC(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray);
 
+    /* Load optional buffer streaming functions */
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLMAPBUFFERRANGEPROC, glMapBufferRange);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLUNMAPBUFFERPROC, glUnmapBuffer);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLBUFFERSTORAGEPROC, glBufferStorage);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLFENCESYNCPROC, glFenceSync);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLDELETESYNCPROC, glDeleteSync);
+
+    /* Load optional instancing functions */
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLDRAWARRAYSINSTANCEDPROC, glDrawArraysInstanced);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor);
+
+    /* Load uniform block functions (required by GLYPHGL_UNIFORM_BUFFER builds) */
+#ifdef GLYPHGL_UNIFORM_BUFFER
+    GLYPH_GL_LOAD_PROC(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex);
+    GLYPH_GL_LOAD_PROC(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding);
+    GLYPH_GL_LOAD_PROC(PFNGLBINDBUFFERBASEPROC, glBindBufferBase);
+#else
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLBINDBUFFERBASEPROC, glBindBufferBase);
+#endif
+
+    /* Load optional program binary functions */
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLPROGRAMBINARYPROC, glProgramBinary);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri);
+
+    /* Load optional timer query functions */
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGENQUERIESPROC, glGenQueries);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLDELETEQUERIESPROC, glDeleteQueries);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLBEGINQUERYPROC, glBeginQuery);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLENDQUERYPROC, glEndQuery);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v);
+
+    /* Load optional context queries */
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETSTRINGPROC, glGetString);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETSTRINGIPROC, glGetStringi);
+    GLYPH_GL_LOAD_PROC_OPTIONAL(PFNGLGETINTEGERVPROC, glGetIntegerv);
+
     return 1; /* Success - all functions loaded */
 }
 
@@ -399,6 +607,7 @@ static int glyph_gl_load_functions(void) {
 #define glBindTexture glyph__glBindTexture
 #define glPixelStorei glyph__glPixelStorei
 #define glTexImage2D glyph__glTexImage2D
+#define glTexSubImage2D glyph__glTexSubImage2D
 #define glTexParameteri glyph__glTexParameteri
 #define glGenVertexArrays glyph__glGenVertexArrays
 #define glDeleteVertexArrays glyph__glDeleteVertexArrays
@@ -409,6 +618,41 @@ static int glyph_gl_load_functions(void) {
 #define glBlendFunc glyph__glBlendFunc
 #define glClearColor glyph__glClearColor
 #define glClear glyph__glClear
+#define glFinish glyph__glFinish
+#define glMapBufferRange glyph__glMapBufferRange
+#define glUnmapBuffer glyph__glUnmapBuffer
+#define glBufferStorage glyph__glBufferStorage
+#define glFenceSync glyph__glFenceSync
+#define glClientWaitSync glyph__glClientWaitSync
+#define glDeleteSync glyph__glDeleteSync
+#define glDrawArraysInstanced glyph__glDrawArraysInstanced
+#define glVertexAttribDivisor glyph__glVertexAttribDivisor
+#define glGetUniformBlockIndex glyph__glGetUniformBlockIndex
+#define glUniformBlockBinding glyph__glUniformBlockBinding
+#define glBindBufferBase glyph__glBindBufferBase
+#define glGetProgramBinary glyph__glGetProgramBinary
+#define glProgramBinary glyph__glProgramBinary
+#define glProgramParameteri glyph__glProgramParameteri
+#define glGenQueries glyph__glGenQueries
+#define glDeleteQueries glyph__glDeleteQueries
+#define glBeginQuery glyph__glBeginQuery
+#define glEndQuery glyph__glEndQuery
+#define glGetQueryObjectiv glyph__glGetQueryObjectiv
+#define glGetQueryObjectui64v glyph__glGetQueryObjectui64v
+#define glGetString glyph__glGetString
+#define glGetStringi glyph__glGetStringi
+#define glGetIntegerv glyph__glGetIntegerv
+
+/* Streaming entry points resolved by the loader */
+#define GLYPH_GL__HAS_MAP_BUFFER_RANGE() (glyph__glMapBufferRange && glyph__glUnmapBuffer && glyph__glFenceSync && glyph__glClientWaitSync && glyph__glDeleteSync)
+#define GLYPH_GL__HAS_BUFFER_STORAGE() (glyph__glBufferStorage != NULL)
+#define GLYPH_GL__HAS_PIXEL_BUFFER() (glyph__glMapBufferRange && glyph__glUnmapBuffer)
+#define GLYPH_GL__HAS_QUERIES() (glyph__glGetString && glyph__glGetStringi && glyph__glGetIntegerv)
+#define GLYPH_GL__HAS_INSTANCING() (glyph__glDrawArraysInstanced && glyph__glVertexAttribDivisor)
+#define GLYPH_GL__HAS_PROGRAM_BINARY() (glyph__glGetProgramBinary && glyph__glProgramBinary && glyph__glProgramParameteri)
+typedef GLuint64 glyph__gl_uint64_t; /* Query result type in both loader modes */
+#define GLYPH_GL__HAS_TIMER_QUERY() (glyph__glGenQueries && glyph__glDeleteQueries && glyph__glBeginQuery && glyph__glEndQuery && \
+                                     glyph__glGetQueryObjectiv && glyph__glGetQueryObjectui64v)
 
 #else
 
@@ -445,15 +689,360 @@ static int glyph_gl_load_functions(void) {
 #define glyph__glGenVertexArrays glGenVertexArrays
 #define glyph__glDeleteVertexArrays glDeleteVertexArrays
 #define glyph__glBindVertexArray glBindVertexArray
+#define glyph__glMapBufferRange glMapBufferRange
+#define glyph__glUnmapBuffer glUnmapBuffer
+#define glyph__glFenceSync glFenceSync
+#define glyph__glClientWaitSync glClientWaitSync
+#define glyph__glDeleteSync glDeleteSync
+#define glyph__glDrawArraysInstanced glDrawArraysInstanced
+#define glyph__glVertexAttribDivisor glVertexAttribDivisor
+#define glyph__glGetUniformBlockIndex glGetUniformBlockIndex
+#define glyph__glUniformBlockBinding glUniformBlockBinding
+#define glyph__glBindBufferBase glBindBufferBase
+#define glyph__glGetString glGetString
+#define glyph__glGetStringi glGetStringi
+#define glyph__glGetIntegerv glGetIntegerv
+
+/* Buffer storage is GL 4.4; only use it when the application's headers declare it */
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+#define glyph__glBufferStorage glBufferStorage
+#define GLYPH_GL__HAS_BUFFER_STORAGE() 1
+#else
+static inline void glyph__glBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+    (void)target; (void)size; (void)data; (void)flags;
+}
+#define GLYPH_GL__HAS_BUFFER_STORAGE() 0
+#endif
+/* Program binaries are GL 4.1 / ES 3.0; same rule as buffer storage */
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary) || defined(GL_ES_VERSION_3_0)
+#define glyph__glGetProgramBinary glGetProgramBinary
+#define glyph__glProgramBinary glProgramBinary
+#define glyph__glProgramParameteri glProgramParameteri
+#define GLYPH_GL__HAS_PROGRAM_BINARY() 1
+#else
+static inline void glyph__glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) {
+    (void)program; (void)bufSize; (void)binaryFormat; (void)binary;
+    if (length) *length = 0;
+}
+static inline void glyph__glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+    (void)program; (void)binaryFormat; (void)binary; (void)length;
+}
+static inline void glyph__glProgramParameteri(GLuint program, GLenum pname, GLint value) {
+    (void)program; (void)pname; (void)value;
+}
+#define GLYPH_GL__HAS_PROGRAM_BINARY() 0
+#endif
+/* Timer queries need 64-bit results (GL 3.3 / ARB_timer_query); same rule again */
+#if defined(GL_VERSION_3_3) || defined(GL_ARB_timer_query)
+#define glyph__glGenQueries glGenQueries
+#define glyph__glDeleteQueries glDeleteQueries
+#define glyph__glBeginQuery glBeginQuery
+#define glyph__glEndQuery glEndQuery
+#define glyph__glGetQueryObjectiv glGetQueryObjectiv
+#define glyph__glGetQueryObjectui64v glGetQueryObjectui64v
+typedef GLuint64 glyph__gl_uint64_t;
+#define GLYPH_GL__HAS_TIMER_QUERY() 1
+#else
+static inline void glyph__glGenQueries(GLsizei n, GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) ids[i] = 0;
+}
+static inline void glyph__glDeleteQueries(GLsizei n, const GLuint* ids) {
+    (void)n; (void)ids;
+}
+static inline void glyph__glBeginQuery(GLenum target, GLuint id) {
+    (void)target; (void)id;
+}
+static inline void glyph__glEndQuery(GLenum target) {
+    (void)target;
+}
+static inline void glyph__glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params) {
+    (void)id; (void)pname;
+    *params = 0;
+}
+typedef unsigned long long glyph__gl_uint64_t;
+static inline void glyph__glGetQueryObjectui64v(GLuint id, GLenum pname, glyph__gl_uint64_t* params) {
+    (void)id; (void)pname;
+    *params = 0;
+}
+#define GLYPH_GL__HAS_TIMER_QUERY() 0
+#endif
+#define GLYPH_GL__HAS_MAP_BUFFER_RANGE() 1
+#define GLYPH_GL__HAS_PIXEL_BUFFER() 1
+#define GLYPH_GL__HAS_QUERIES() 1
+#define GLYPH_GL__HAS_INSTANCING() 1
 
 static int glyph_gl_load_functions(void) {
     return 1;
 }
 
 #endif
+
+/*
+ * Reads the version of the current OpenGL context
+ *
+ * Parses the GL_VERSION string, which starts with "major.minor" on desktop GL
+ * and with "OpenGL ES major.minor" on embedded contexts.
+ *
+ * Parameters:
+ *   major, minor: Receive the context version (0.0 if it cannot be queried)
+ *
+ * Returns: 1 for an OpenGL ES context, 0 for desktop OpenGL
+ */
+static inline int glyph_gl_get_version(int* major, int* minor) {
+    *major = 0;
+    *minor = 0;
+    if (!GLYPH_GL__HAS_QUERIES()) return 0;
+
+    const char* version = (const char*)glyph__glGetString(GL_VERSION);
+    if (!version) return 0;
+    int is_es = strncmp(version, "OpenGL ES", 9) == 0;
+    while (*version && (*version < '0' || *version > '9')) version++;
+    if (sscanf(version, "%d.%d", major, minor) != 2) {
+        *major = 0;
+        *minor = 0;
+    }
+    return is_es;
+}
+
+/*
+ * Checks whether the current context advertises an extension
+ *
+ * Uses the indexed GL 3.0 query, since the single GL_EXTENSIONS string is
+ * unavailable in core profiles.
+ *
+ * Parameters:
+ *   name: Full extension name (e.g. "GL_ARB_buffer_storage")
+ *
+ * Returns: 1 if the extension is supported, 0 otherwise
+ */
+static inline int glyph_gl_has_extension(const char* name) {
+    if (!GLYPH_GL__HAS_QUERIES()) return 0;
+
+    GLint count = 0;
+    glyph__glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char* ext = (const char*)glyph__glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (ext && strcmp(ext, name) == 0) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Checks for unsynchronized buffer mapping guarded by fences
+ *
+ * Requires glMapBufferRange (GL 3.0 / ES 3.0) and sync objects (GL 3.2 / ES 3.0).
+ * Loaders may hand out non-NULL stubs for anything, so the context version is
+ * checked as well.
+ *
+ * Returns: 1 if glMapBufferRange and fence syncs can be used, 0 otherwise
+ */
+static inline int glyph_gl_supports_map_buffer_range(void) {
+    if (!GLYPH_GL__HAS_MAP_BUFFER_RANGE()) return 0;
+
+    int major, minor;
+    int is_es = glyph_gl_get_version(&major, &minor);
+    if (is_es) return major >= 3;
+    return major > 3 || (major == 3 && minor >= 2) || glyph_gl_has_extension("GL_ARB_sync");
+}
+
+/*
+ * Checks for persistent, coherent buffer mappings (glBufferStorage)
+ *
+ * Returns: 1 on GL 4.4+ or with GL_ARB_buffer_storage, 0 otherwise
+ */
+static inline int glyph_gl_supports_buffer_storage(void) {
+    if (!GLYPH_GL__HAS_BUFFER_STORAGE() || !glyph_gl_supports_map_buffer_range()) return 0;
+
+    int major, minor;
+    if (glyph_gl_get_version(&major, &minor)) return 0; /* ES only has the EXT variant under another name */
+    return major > 4 || (major == 4 && minor >= 4) || glyph_gl_has_extension("GL_ARB_buffer_storage");
+}
+
+/*
+ * Checks whether texture uploads can be sourced from a mapped pixel buffer
+ *
+ * Pixel unpack buffers are core since GL 2.1 / ES 3.0; filling them through
+ * glMapBufferRange needs GL 3.0 or GL_ARB_map_buffer_range.
+ *
+ * Returns: 1 if GL_PIXEL_UNPACK_BUFFER uploads are available, 0 otherwise
+ */
+static inline int glyph_gl_supports_pixel_buffer(void) {
+    if (!GLYPH_GL__HAS_PIXEL_BUFFER()) return 0;
+
+    int major, minor;
+    int is_es = glyph_gl_get_version(&major, &minor);
+    if (is_es) return major >= 3;
+    return major >= 3 || glyph_gl_has_extension("GL_ARB_map_buffer_range");
+}
+
+/*
+ * Checks for instanced drawing with per-instance attributes
+ *
+ * Returns: 1 on GL 3.3+ / ES 3.0+ (glDrawArraysInstanced + glVertexAttribDivisor), 0 otherwise
+ */
+static inline int glyph_gl_supports_instancing(void) {
+    if (!GLYPH_GL__HAS_INSTANCING()) return 0;
+
+    int major, minor;
+    int is_es = glyph_gl_get_version(&major, &minor);
+    if (is_es) return major >= 3;
+    return major > 3 || (major == 3 && minor >= 3) || glyph_gl_has_extension("GL_ARB_instanced_arrays");
+}
+
+/*
+ * Checks whether linked programs can be saved and reloaded as driver binaries
+ *
+ * Requires glGetProgramBinary/glProgramBinary (GL 4.1, ARB_get_program_binary
+ * or ES 3.0) and at least one binary format advertised by the driver.
+ *
+ * Returns: 1 when program binaries are available, 0 otherwise
+ */
+static inline int glyph_gl_supports_program_binary(void) {
+    if (!GLYPH_GL__HAS_PROGRAM_BINARY() || !GLYPH_GL__HAS_QUERIES()) return 0;
+    GLint formats = 0;
+    glyph__glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+/*
+ * Checks for GPU timer queries (GL_TIME_ELAPSED)
+ *
+ * Returns: 1 on desktop GL 3.3+ or with GL_ARB_timer_query, 0 otherwise
+ *          (ES only exposes timers through EXT_disjoint_timer_query)
+ */
+static inline int glyph_gl_supports_timer_query(void) {
+    if (!GLYPH_GL__HAS_TIMER_QUERY()) return 0;
+
+    int major, minor;
+    if (glyph_gl_get_version(&major, &minor)) return 0;
+    return major > 3 || (major == 3 && minor >= 3) || glyph_gl_has_extension("GL_ARB_timer_query");
+}
+
+/* Uniform buffer binding point of the GlyphFrame block (GLYPHGL_UNIFORM_BUFFER builds) */
+#ifndef GLYPHGL_FRAME_BINDING
+#define GLYPHGL_FRAME_BINDING 12
+#endif
+
+/* Marks a tracked binding as unknown, so the next bind is always issued */
+#define GLYPH__GL_UNKNOWN 0xFFFFFFFFu
+
+/*
+ * Bindings last made by GlyphGL
+ *
+ * Every program, vertex array, buffer and texture bind of the draw path
+ * goes through the glyph__gl_* helpers below. With tracking enabled
+ * (glyph_gl_set_state_tracking) binds matching this record are skipped and
+ * draws leave their bindings in place instead of resetting them to 0. The
+ * record is per translation unit and per context.
+ */
+typedef struct {
+    int tracking;               /* Skip redundant binds and leave state bound after draws */
+    GLuint program;             /* Program in use */
+    GLuint vertex_array;        /* Bound vertex array */
+    GLuint array_buffer;        /* Buffer bound to GL_ARRAY_BUFFER */
+    GLuint uniform_buffer;      /* Buffer bound at GLYPHGL_FRAME_BINDING */
+    GLuint active_texture;      /* Active texture unit index */
+    GLuint textures[2];         /* GL_TEXTURE_2D bound on units 0 and 1 */
+} glyph__gl_state_t;
+
+static glyph__gl_state_t glyph__gl_state = {
+    0, GLYPH__GL_UNKNOWN, GLYPH__GL_UNKNOWN, GLYPH__GL_UNKNOWN, GLYPH__GL_UNKNOWN, GLYPH__GL_UNKNOWN, {GLYPH__GL_UNKNOWN, GLYPH__GL_UNKNOWN}
+};
+
+/*
+ * Forgets the recorded GL bindings
+ *
+ * Call after code outside GlyphGL changed the program, vertex array, array
+ * or uniform buffer, active texture unit or texture bindings, when state
+ * tracking is enabled. The next GlyphGL draw re-binds everything it needs.
+ */
+static inline void glyph_gl_invalidate_state(void) {
+    glyph__gl_state.program = GLYPH__GL_UNKNOWN;
+    glyph__gl_state.vertex_array = GLYPH__GL_UNKNOWN;
+    glyph__gl_state.array_buffer = GLYPH__GL_UNKNOWN;
+    glyph__gl_state.uniform_buffer = GLYPH__GL_UNKNOWN;
+    glyph__gl_state.active_texture = GLYPH__GL_UNKNOWN;
+    glyph__gl_state.textures[0] = GLYPH__GL_UNKNOWN;
+    glyph__gl_state.textures[1] = GLYPH__GL_UNKNOWN;
+}
+
+/*
+ * Enables or disables GL binding tracking
+ *
+ * Off (default): every draw binds what it uses and unbinds its program and
+ * vertex array afterwards. On: consecutive text draws skip binds that are
+ * already in place and nothing is unbound; the application must call
+ * glyph_gl_invalidate_state after touching those bindings itself.
+ *
+ * Parameters:
+ *   enable: Non-zero to track bindings
+ */
+static inline void glyph_gl_set_state_tracking(int enable) {
+    glyph__gl_state.tracking = enable != 0;
+    glyph_gl_invalidate_state();
+}
+
+/* glUseProgram, skipped when tracking says the program is already in use */
+static inline void glyph__gl_use_program(GLuint program) {
+    if (glyph__gl_state.tracking && glyph__gl_state.program == program) return;
+    glyph__glUseProgram(program);
+    glyph__gl_state.program = program;
+}
+
+/* glBindVertexArray, skipped when already bound */
+static inline void glyph__gl_bind_vertex_array(GLuint vertex_array) {
+    if (glyph__gl_state.tracking && glyph__gl_state.vertex_array == vertex_array) return;
+    glyph__glBindVertexArray(vertex_array);
+    glyph__gl_state.vertex_array = vertex_array;
+}
+
+/* glBindBuffer(GL_ARRAY_BUFFER), skipped when already bound */
+static inline void glyph__gl_bind_array_buffer(GLuint buffer) {
+    if (glyph__gl_state.tracking && glyph__gl_state.array_buffer == buffer) return;
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glyph__gl_state.array_buffer = buffer;
+}
+
+/* glActiveTexture for unit 0 or 1, skipped when already active */
+static inline void glyph__gl_active_texture(GLuint unit) {
+    if (glyph__gl_state.tracking && glyph__gl_state.active_texture == unit) return;
+    glyph__glActiveTexture(GL_TEXTURE0 + unit);
+    glyph__gl_state.active_texture = unit;
+}
+
+/* Binds a 2D texture on unit 0 or 1 and leaves that unit active */
+static inline void glyph__gl_bind_texture(GLuint unit, GLuint texture) {
+    glyph__gl_active_texture(unit);
+    if (glyph__gl_state.tracking && glyph__gl_state.textures[unit] == texture) return;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glyph__gl_state.textures[unit] = texture;
+}
+
+/* Binds a buffer at GLYPHGL_FRAME_BINDING (and to GL_UNIFORM_BUFFER), skipped when already bound */
+static inline void glyph__gl_bind_uniform_buffer(GLuint buffer) {
+    if (glyph__gl_state.tracking && glyph__gl_state.uniform_buffer == buffer) return;
+    glyph__glBindBufferBase(GL_UNIFORM_BUFFER, GLYPHGL_FRAME_BINDING, buffer);
+    glyph__gl_state.uniform_buffer = buffer;
+}
+
+/* Resets GL_ARRAY_BUFFER after an upload unless tracking keeps it bound */
+static inline void glyph__gl_unbind_array_buffer(void) {
+    if (!glyph__gl_state.tracking) glyph__gl_bind_array_buffer(0);
+}
+
+/* Ends a draw: resets the program and vertex array unless tracking keeps them bound */
+static inline void glyph__gl_release(void) {
+    if (glyph__gl_state.tracking) return;
+    glyph__gl_bind_vertex_array(0);
+    glyph__gl_use_program(0);
+}
+
 /* GLSL version string for shader compilation - defaults to OpenGL 3.3 core */
 static char glyph_glsl_version_str[32] = "#version 330 core\n";
 
+/* Bumped whenever glyph_glsl_version_str changes; cached shader sources are rebuilt when it moves */
+static unsigned int glyph__glsl_version_serial = 1;
+
 /*
  * Sets the GLSL version string for shader compilation
  *
@@ -467,52 +1056,165 @@ static char glyph_glsl_version_str[32] = "#version 330 core\n";
  * Example: glyph_gl_set_opengl_version(4, 1) sets "#version 410 core\n"
  */
 static inline void glyph_gl_set_opengl_version(int major, int minor) {
-    sprintf(glyph_glsl_version_str, "#version %d%d0 core\n", major, minor);
+    snprintf(glyph_glsl_version_str, sizeof(glyph_glsl_version_str), "#version %d%d0 core\n", major, minor);
+    glyph__glsl_version_serial++;
 }
 /* Built-in vertex shader source for text rendering */
-/* Transforms vertex positions and passes texture coordinates to fragment shader */
+/* Transforms vertex positions and passes texture coordinates, color and effect flags to fragment shader */
 static const char* glyph__vertex_shader_body =
 "layout (location = 0) in vec2 aPos;\n"           /* Vertex position input */
 "layout (location = 1) in vec2 aTexCoord;\n"       /* Texture coordinate input */
+"layout (location = 2) in vec3 aColor;\n"          /* Per-vertex text color (normalized bytes) */
+"layout (location = 3) in float aEffects;\n"       /* Per-vertex effects bitmask (unnormalized byte) */
 "out vec2 TexCoord;\n"                             /* Output to fragment shader */
+"out vec3 TextColor;\n"                            /* Text color for fragment shader */
+"flat out int Effects;\n"                          /* Effects bitmask for fragment shader */
+"#ifdef GLYPH_FRAME_BLOCK\n"
+"layout (std140) uniform GlyphFrame {\n"           /* Projection shared by every program (GLYPHGL_UNIFORM_BUFFER) */
+"    mat4 projection;\n"
+"};\n"
+"#else\n"
 "uniform mat4 projection;\n"                       /* Projection matrix uniform */
+"#endif\n"
+"uniform vec2 textOffset;\n"                       /* Retained text position (0 for immediate text) */
+"uniform float textScale;\n"                       /* Retained text scale (1 for immediate text) */
+"uniform vec3 textTint;\n"                         /* Retained text color (1 for immediate text) */
 "void main() {\n"
-"    gl_Position = projection * vec4(aPos, 0.0, 1.0);\n"  /* Apply projection */
+"    gl_Position = projection * vec4(aPos * textScale + textOffset, 0.0, 1.0);\n"  /* Apply transform and projection */
 "    TexCoord = aTexCoord;\n"                     /* Pass texture coords */
+"    TextColor = aColor * textTint;\n"            /* Pass color */
+"    Effects = int(aEffects + 0.5);\n"            /* Pass effects */
+"}\n";
+
+/* Built-in vertex shader for instanced rendering */
+/* Expands one glyph instance into a quad using the per-glyph metrics texture */
+static const char* glyph__instanced_vertex_shader_body =
+"layout (location = 0) in vec2 aCorner;\n"        /* Unit quad corner (0..1) */
+"layout (location = 1) in vec2 aPen;\n"           /* Pen position on the baseline */
+"layout (location = 2) in vec2 aGlyph;\n"         /* Glyph index, scale * 256 */
+"layout (location = 3) in vec3 aColor;\n"         /* Text color (normalized bytes) */
+"layout (location = 4) in float aEffects;\n"      /* Effects bitmask; bit 7 marks a run underline */
+"out vec2 TexCoord;\n"
+"out vec3 TextColor;\n"
+"flat out int Effects;\n"
+"#ifdef GLYPH_FRAME_BLOCK\n"
+"layout (std140) uniform GlyphFrame {\n"
+"    mat4 projection;\n"
+"};\n"
+"#else\n"
+"uniform mat4 projection;\n"
+"#endif\n"
+"uniform sampler2D textTexture;\n"                /* Atlas, only queried for its size */
+"uniform sampler2D glyphMetrics;\n"               /* Two RGBA32F texels per glyph, 256 glyphs per row */
+"void main() {\n"
+"    int flags = int(aEffects + 0.5);\n"
+"    vec2 pos;\n"
+"    if ((flags & 128) != 0) {\n"                                        /* Run underline: pen is its corner, width in quarter pixels */
+"        pos = aPen + vec2(aCorner.x * aGlyph.x * 0.25, aCorner.y * 2.0);\n"
+"        TexCoord = vec2(-1.0, -1.0);\n"
+"    } else {\n"
+"        int index = int(aGlyph.x + 0.5);\n"
+"        float scale = aGlyph.y / 256.0;\n"
+"        ivec2 base = ivec2((index % 256) * 2, index / 256);\n"
+"        vec4 rect = texelFetch(glyphMetrics, base, 0);\n"                /* Atlas x, y, width, height */
+"        vec4 metrics = texelFetch(glyphMetrics, base + ivec2(1, 0), 0);\n" /* xoff, yoff, advance */
+"        if ((flags & 1) != 0) rect.z += 1.0;\n"                          /* Bold: room for the fragment stage's offset copy */
+"        vec2 size = rect.zw * scale;\n"
+"        pos = vec2(aPen.x + metrics.x * scale, aPen.y - metrics.y * scale) + aCorner * size;\n"
+"        if ((flags & 2) != 0) pos.x -= aCorner.y * 0.2 * size.y;\n"      /* Italic shear of the top edge */
+"        TexCoord = (rect.xy + aCorner * rect.zw) / vec2(textureSize(textTexture, 0));\n"
+"    }\n"
+"    gl_Position = projection * vec4(pos, 0.0, 1.0);\n"
+"    TextColor = aColor;\n"
+"    Effects = flags & 127;\n"
+"}\n";
+
+/* Built-in vertex shader for text grids */
+/* Places each cell from its instance number and expands its glyph (6 vertices) and underline (6 more) */
+static const char* glyph__grid_vertex_shader_body =
+"layout (location = 0) in float aGlyph;\n"        /* Glyph index (65535 = empty cell) */
+"layout (location = 1) in vec3 aColor;\n"         /* Text color (normalized bytes) */
+"layout (location = 2) in float aEffects;\n"      /* Effects bitmask */
+"out vec2 TexCoord;\n"
+"out vec3 TextColor;\n"
+"flat out int Effects;\n"
+"#ifdef GLYPH_FRAME_BLOCK\n"
+"layout (std140) uniform GlyphFrame {\n"
+"    mat4 projection;\n"
+"};\n"
+"#else\n"
+"uniform mat4 projection;\n"
+"#endif\n"
+"uniform sampler2D textTexture;\n"                /* Atlas, only queried for its size */
+"uniform sampler2D glyphMetrics;\n"               /* Two RGBA32F texels per glyph, 256 glyphs per row */
+"uniform vec2 gridOrigin;\n"                      /* Baseline start of the first row */
+"uniform vec2 gridStep;\n"                        /* Scaled cell width and line height */
+"uniform float gridScale;\n"                      /* Text scale */
+"uniform float gridUnderline;\n"                  /* Scaled distance from the baseline to the underline */
+"uniform int gridColumns;\n"                      /* Cells per row */
+"const vec2 corners[6] = vec2[6](vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(1.0, 0.0));\n"
+"void main() {\n"
+"    int flags = int(aEffects + 0.5);\n"
+"    vec2 corner = corners[gl_VertexID % 6];\n"
+"    vec2 pen = gridOrigin + vec2(float(gl_InstanceID % gridColumns), float(gl_InstanceID / gridColumns)) * gridStep;\n"
+"    vec2 pos = pen;\n"                                                  /* Collapsed quad unless something is drawn */
+"    TexCoord = vec2(-1.0, -1.0);\n"
+"    if (gl_VertexID >= 6) {\n"                                          /* Second quad: the cell's share of an underline */
+"        if ((flags & 4) != 0) pos = vec2(pen.x, pen.y + gridUnderline) + corner * vec2(gridStep.x, 2.0);\n"
+"    } else if (aGlyph < 65534.5) {\n"
+"        int index = int(aGlyph + 0.5);\n"
+"        ivec2 base = ivec2((index % 256) * 2, index / 256);\n"
+"        vec4 rect = texelFetch(glyphMetrics, base, 0);\n"                /* Atlas x, y, width, height */
+"        vec4 metrics = texelFetch(glyphMetrics, base + ivec2(1, 0), 0);\n" /* xoff, yoff, advance */
+"        if ((flags & 1) != 0) rect.z += 1.0;\n"                          /* Bold: room for the fragment stage's offset copy */
+"        vec2 size = rect.zw * gridScale;\n"
+"        pos = vec2(pen.x + metrics.x * gridScale, pen.y - metrics.y * gridScale) + corner * size;\n"
+"        if ((flags & 2) != 0) pos.x -= corner.y * 0.2 * size.y;\n"       /* Italic shear of the top edge */
+"        TexCoord = (rect.xy + corner * rect.zw) / vec2(textureSize(textTexture, 0));\n"
+"    }\n"
+"    gl_Position = projection * vec4(pos, 0.0, 1.0);\n"
+"    TextColor = aColor;\n"
+"    Effects = flags;\n"
 "}\n";
 
 /* Built-in fragment shader source for text rendering */
 /* Samples texture and applies effects based on compile-time flags */
 static const char* glyph__fragment_shader_body =
 "in vec2 TexCoord;\n"                               /* Input from vertex shader */
+"in vec3 TextColor;\n"                             /* Per-vertex text color */
+"flat in int Effects;\n"                           /* Per-vertex effects bitmask */
 "out vec4 FragColor;\n"                            /* Final fragment color output */
 "uniform sampler2D textTexture;\n"                 /* Glyph atlas texture */
-"uniform vec3 textColor;\n"                        /* Text color uniform */
-"#ifndef GLYPHGL_MINIMAL\n"                        /* Conditional compilation for effects */
-"uniform int effects;\n"                           /* Effects bitmask */
-"#endif\n"
 "void main() {\n"
-"    float sample;\n"                              /* Texture sample value */
+"    vec3 msd = texture(textTexture, TexCoord).rgb;\n"     /* Coverage/SDF in red, MSDF in all three */
+"    float sample = (Effects & 16) != 0 ? max(min(msd.r, msd.g), min(max(msd.r, msd.g), msd.b)) : msd.r;\n" /* MSDF median */
+"    float w = max(fwidth(sample) * 0.7, 1e-4);\n" /* About one screen pixel in SDF units (uniform control flow) */
 "#ifndef GLYPHGL_MINIMAL\n"                        /* Full mode with effects support */
-"    if (TexCoord.x == -1.0 && TexCoord.y == -1.0 && (effects & 4) != 0) {\n"
-"        sample = 1.0;\n"                          /* Special case for underline rendering */
-"    } else {\n"
-"        sample = texture(textTexture, TexCoord).r;\n"  /* Sample red channel */
-"    }\n"
 "    float alpha;\n"                               /* Final alpha value */
-"    if ((effects & 8) != 0) {\n"                  /* SDF rendering mode */
-"        float dist = sample * 2.0 - 1.0;\n"      /* Convert to signed distance */
-"        alpha = dist < 0.0 ? 1.0 : 0.0;\n"       /* Threshold for glyph interior */
+"    if (TexCoord.x == -1.0 && TexCoord.y == -1.0 && (Effects & 4) != 0) {\n"
+"        alpha = 1.0;\n"                           /* Special case for underline rendering */
+"    } else if ((Effects & 24) != 0) {\n"          /* SDF or MSDF rendering mode */
+"        float edge = (Effects & 1) != 0 ? 0.45 : 0.5;\n" /* Bold dilates the outline, ~0.4 texel per side at spread 4 */
+"        alpha = smoothstep(edge - w, edge + w, sample);\n"  /* Inside is above 0.5 */
 "    } else {\n"
 "        alpha = sample;\n"                        /* Direct alpha from texture */
+"        if ((Effects & 1) != 0) {\n"              /* Bold: composite a copy one texel to the right */
+"            float shifted = texture(textTexture, TexCoord - vec2(1.0 / float(textureSize(textTexture, 0).x), 0.0)).r;\n"
+"            alpha = alpha + shifted - alpha * shifted;\n" /* Same result as blending the two copies */
+"        }\n"
 "    }\n"
 "#else\n"                                          /* Minimal mode - SDF only */
-"    sample = texture(textTexture, TexCoord).r;\n"
-"    float dist = sample * 2.0 - 1.0;\n"          /* Always use SDF in minimal mode */
-"    float alpha = dist < 0.0 ? 1.0 : 0.0;\n"
+"    float alpha = smoothstep(0.5 - w, 0.5 + w, sample);\n"  /* Always use SDF in minimal mode */
 "#endif\n"
-"    FragColor = vec4(textColor, alpha);\n"       /* Combine color and alpha */
+"    FragColor = vec4(TextColor, alpha);\n"       /* Combine color and alpha */
 "}\n";
+/* Defines inserted after the version directive of the built-in vertex stages */
+#ifdef GLYPHGL_UNIFORM_BUFFER
+#define GLYPH__VERTEX_SHADER_DEFINES "#define GLYPH_FRAME_BLOCK\n"
+#else
+#define GLYPH__VERTEX_SHADER_DEFINES ""
+#endif
+
 /* Shader source buffers for dynamic GLSL version insertion */
 static char glyph__vertex_shader_buffer[2048];
 static char glyph__fragment_shader_buffer[2048];
@@ -526,7 +1228,7 @@ static char glyph__fragment_shader_buffer[2048];
  * Returns: Pointer to buffer containing complete vertex shader source
  */
 static const char* glyph__get_vertex_shader_source() {
-    sprintf(glyph__vertex_shader_buffer, "%s%s", glyph_glsl_version_str, glyph__vertex_shader_body);
+    sprintf(glyph__vertex_shader_buffer, "%s%s%s", glyph_glsl_version_str, GLYPH__VERTEX_SHADER_DEFINES, glyph__vertex_shader_body);
     return glyph__vertex_shader_buffer;
 }
 
@@ -548,18 +1250,48 @@ static char glyph__vertex_shader_source_buffer[2048];
 static char glyph__fragment_shader_source_buffer[2048];
 static const char* glyph__vertex_shader_source = NULL;
 static const char* glyph__fragment_shader_source = NULL;
+static unsigned int glyph__vertex_shader_source_serial = 0;   /* glyph__glsl_version_serial the buffer was built for */
+static unsigned int glyph__fragment_shader_source_serial = 0;
 
 static const char* glyph__get_vertex_shader_source_cached() {
-    if (!glyph__vertex_shader_source) {
-        sprintf(glyph__vertex_shader_source_buffer, "%s%s", glyph_glsl_version_str, glyph__vertex_shader_body);
+    if (glyph__vertex_shader_source_serial != glyph__glsl_version_serial) {
+        snprintf(glyph__vertex_shader_source_buffer, sizeof(glyph__vertex_shader_source_buffer), "%s%s%s", glyph_glsl_version_str, GLYPH__VERTEX_SHADER_DEFINES, glyph__vertex_shader_body);
+        glyph__vertex_shader_source_serial = glyph__glsl_version_serial;
         glyph__vertex_shader_source = glyph__vertex_shader_source_buffer;
     }
     return glyph__vertex_shader_source;
 }
 
+static char glyph__instanced_vertex_shader_source_buffer[4096];
+static const char* glyph__instanced_vertex_shader_source = NULL;
+static unsigned int glyph__instanced_vertex_shader_source_serial = 0;
+
+static const char* glyph__get_instanced_vertex_shader_source_cached() {
+    if (glyph__instanced_vertex_shader_source_serial != glyph__glsl_version_serial) {
+        snprintf(glyph__instanced_vertex_shader_source_buffer, sizeof(glyph__instanced_vertex_shader_source_buffer), "%s%s%s", glyph_glsl_version_str, GLYPH__VERTEX_SHADER_DEFINES, glyph__instanced_vertex_shader_body);
+        glyph__instanced_vertex_shader_source_serial = glyph__glsl_version_serial;
+        glyph__instanced_vertex_shader_source = glyph__instanced_vertex_shader_source_buffer;
+    }
+    return glyph__instanced_vertex_shader_source;
+}
+
+static char glyph__grid_vertex_shader_source_buffer[4096];
+static const char* glyph__grid_vertex_shader_source = NULL;
+static unsigned int glyph__grid_vertex_shader_source_serial = 0;
+
+static const char* glyph__get_grid_vertex_shader_source_cached() {
+    if (glyph__grid_vertex_shader_source_serial != glyph__glsl_version_serial) {
+        snprintf(glyph__grid_vertex_shader_source_buffer, sizeof(glyph__grid_vertex_shader_source_buffer), "%s%s%s", glyph_glsl_version_str, GLYPH__VERTEX_SHADER_DEFINES, glyph__grid_vertex_shader_body);
+        glyph__grid_vertex_shader_source_serial = glyph__glsl_version_serial;
+        glyph__grid_vertex_shader_source = glyph__grid_vertex_shader_source_buffer;
+    }
+    return glyph__grid_vertex_shader_source;
+}
+
 static const char* glyph__get_fragment_shader_source_cached() {
-    if (!glyph__fragment_shader_source) {
-        sprintf(glyph__fragment_shader_source_buffer, "%s%s", glyph_glsl_version_str, glyph__fragment_shader_body);
+    if (glyph__fragment_shader_source_serial != glyph__glsl_version_serial) {
+        snprintf(glyph__fragment_shader_source_buffer, sizeof(glyph__fragment_shader_source_buffer), "%s%s", glyph_glsl_version_str, glyph__fragment_shader_body);
+        glyph__fragment_shader_source_serial = glyph__glsl_version_serial;
         glyph__fragment_shader_source = glyph__fragment_shader_source_buffer;
     }
     return glyph__fragment_shader_source;
@@ -611,10 +1343,11 @@ static GLuint glyph__compile_shader(GLenum type, const char* source) {
  * Parameters:
  *   vertex_source: Complete vertex shader source code
  *   fragment_source: Complete fragment shader source code
+ *   retrievable: Ask the driver to keep the binary for glGetProgramBinary
  *
  * Returns: Linked program object handle, or 0 on failure
  */
-static GLuint glyph__create_program(const char* vertex_source, const char* fragment_source) {
+static GLuint glyph__create_program_ex(const char* vertex_source, const char* fragment_source, int retrievable) {
     /* Compile vertex shader */
     GLuint vertex_shader = glyph__compile_shader(GL_VERTEX_SHADER, vertex_source);
     if (!vertex_shader) return 0;
@@ -630,6 +1363,7 @@ static GLuint glyph__create_program(const char* vertex_source, const char* fragm
     GLuint program = glyph__glCreateProgram();
     glyph__glAttachShader(program, vertex_shader);
     glyph__glAttachShader(program, fragment_shader);
+    if (retrievable && GLYPH_GL__HAS_PROGRAM_BINARY()) glyph__glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     /* Link the program */
     glyph__glLinkProgram(program);
 
@@ -655,4 +1389,307 @@ static GLuint glyph__create_program(const char* vertex_source, const char* fragm
     return program; /* Success */
 }
 
+/*
+ * ================== PROGRAM CACHE ==================
+ *
+ * Renderers obtain their programs through glyph__program_acquire, which
+ * shares one linked program between every renderer using the same vertex
+ * and fragment source (as seen after the #version line was prepended, so
+ * the key covers effect and GLSL version). Programs are reference counted
+ * and deleted with their last user. With a binary directory set
+ * (glyph_gl_set_program_binary_dir), linked programs are also written to
+ * disk and later runs load them with glProgramBinary instead of compiling.
+ *
+ * The cache is per translation unit and assumes one GL context (or one
+ * share group). Uniforms are program state: values an application sets
+ * with glUniform* on a shared program apply to every renderer using it.
+ */
+
+#ifndef GLYPHGL_PROGRAM_CACHE_SIZE
+#define GLYPHGL_PROGRAM_CACHE_SIZE 32  /* Distinct programs shared at once; further programs are not shared */
+#endif
+
+/* Version of the program binary file layout */
+#define GLYPH__PROGRAM_BINARY_VERSION 1
+
+/* Upper bound accepted for a stored program binary */
+#define GLYPH__PROGRAM_BINARY_MAX (16u * 1024u * 1024u)
+
+typedef struct {
+    unsigned long long key;     /* glyph__program_key of both stage sources */
+    GLuint program;             /* Linked program */
+    int refs;                   /* Acquisitions not yet released (a pin counts as one) */
+    int pinned;                 /* Held by glyph_gl_precompile_program until glyph_gl_clear_program_cache */
+    const void* owner;          /* Renderer that last set uniforms on the program (glyph__program_claim) */
+} glyph__program_entry_t;
+
+/* Header of a program binary file, followed by 'length' bytes of driver binary */
+typedef struct {
+    char magic[8];              /* "GLYPHPRG" */
+    unsigned int version;       /* GLYPH__PROGRAM_BINARY_VERSION */
+    unsigned int format;        /* Driver binary format from glGetProgramBinary */
+    unsigned long long key;     /* Source key the binary was linked from */
+    unsigned long long driver;  /* glyph__program_driver_key of the context that produced it */
+    unsigned int length;        /* Binary size in bytes */
+    unsigned int reserved;      /* Zero */
+} glyph__program_binary_header_t;
+
+static glyph__program_entry_t glyph__program_cache[GLYPHGL_PROGRAM_CACHE_SIZE];
+static int glyph__program_cache_count = 0;
+static char glyph__program_binary_dir[512] = "";
+
+/* FNV-1a step over a NUL-terminated string */
+static inline unsigned long long glyph__program_hash(unsigned long long hash, const char* str) {
+    for (const unsigned char* p = (const unsigned char*)str; p && *p; p++) {
+        hash = (hash ^ *p) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/*
+ * Computes the cache key of a vertex/fragment source pair
+ *
+ * Returns: 64-bit FNV-1a hash of both sources, separated by a byte GLSL never contains
+ */
+static inline unsigned long long glyph__program_key(const char* vertex_source, const char* fragment_source) {
+    unsigned long long hash = glyph__program_hash(1469598103934665603ull, vertex_source);
+    hash = (hash ^ 0xFFu) * 1099511628211ull;
+    return glyph__program_hash(hash, fragment_source);
+}
+
+/*
+ * Identifies the driver that produced a program binary
+ *
+ * Returns: Hash of GL_VENDOR, GL_RENDERER and GL_VERSION (0 if they cannot be queried)
+ */
+static inline unsigned long long glyph__program_driver_key(void) {
+    if (!GLYPH_GL__HAS_QUERIES()) return 0;
+    unsigned long long hash = 1469598103934665603ull;
+    hash = glyph__program_hash(hash, (const char*)glyph__glGetString(GL_VENDOR));
+    hash = glyph__program_hash(hash, (const char*)glyph__glGetString(GL_RENDERER));
+    return glyph__program_hash(hash, (const char*)glyph__glGetString(GL_VERSION));
+}
+
+/*
+ * Sets the directory where linked programs are stored as driver binaries
+ *
+ * Each program is kept in "<dir>/glyph_<key>.glp". Files written by another
+ * driver, GPU or driver version are ignored and replaced on the next link.
+ * The directory must exist; it is not created.
+ *
+ * Parameters:
+ *   dir: Directory path, or NULL / "" to disable binary persistence (default)
+ */
+static inline void glyph_gl_set_program_binary_dir(const char* dir) {
+    if (!dir || strlen(dir) >= sizeof(glyph__program_binary_dir) - 32) {
+        glyph__program_binary_dir[0] = '\0';
+        return;
+    }
+    strcpy(glyph__program_binary_dir, dir);
+}
+
+/* Builds the binary file path of a program key */
+static inline void glyph__program_binary_path(char* path, size_t size, unsigned long long key) {
+    snprintf(path, size, "%s/glyph_%08x%08x.glp", glyph__program_binary_dir, (unsigned int)(key >> 32), (unsigned int)key);
+}
+
+/*
+ * Loads a program from its stored binary
+ *
+ * Returns: Linked program, or 0 when no usable binary exists (missing file,
+ *          other driver, or the driver rejected it)
+ */
+static inline GLuint glyph__program_load_binary(unsigned long long key) {
+    if (!glyph__program_binary_dir[0] || !glyph_gl_supports_program_binary()) return 0;
+
+    char path[sizeof(glyph__program_binary_dir) + 32];
+    glyph__program_binary_path(path, sizeof(path), key);
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+
+    glyph__program_binary_header_t header;
+    void* binary = NULL;
+    GLuint program = 0;
+    if (fread(&header, sizeof(header), 1, f) == 1 && memcmp(header.magic, "GLYPHPRG", 8) == 0 &&
+        header.version == GLYPH__PROGRAM_BINARY_VERSION && header.key == key &&
+        header.driver == glyph__program_driver_key() && header.length > 0 && header.length <= GLYPH__PROGRAM_BINARY_MAX) {
+        binary = GLYPH_MALLOC(header.length);
+        if (binary && fread(binary, 1, header.length, f) == header.length) {
+            program = glyph__glCreateProgram();
+            glyph__glProgramBinary(program, (GLenum)header.format, binary, (GLsizei)header.length);
+            GLint success = 0;
+            glyph__glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (!success) {
+                /* Driver update or different GPU - fall back to compiling */
+                glyph__glDeleteProgram(program);
+                program = 0;
+            }
+        }
+    }
+    GLYPH_FREE(binary);
+    fclose(f);
+    return program;
+}
+
+/*
+ * Writes a linked program to the binary directory
+ *
+ * Failures only cost the next run a compile, so they are not reported.
+ */
+static inline void glyph__program_save_binary(GLuint program, unsigned long long key) {
+    if (!glyph__program_binary_dir[0] || !glyph_gl_supports_program_binary()) return;
+
+    GLint length = 0;
+    glyph__glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || (unsigned int)length > GLYPH__PROGRAM_BINARY_MAX) return;
+    void* binary = GLYPH_MALLOC((size_t)length);
+    if (!binary) return;
+
+    GLsizei written = 0;
+    GLenum format = 0;
+    glyph__glGetProgramBinary(program, length, &written, &format, binary);
+    if (written > 0) {
+        glyph__program_binary_header_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "GLYPHPRG", 8);
+        header.version = GLYPH__PROGRAM_BINARY_VERSION;
+        header.format = (unsigned int)format;
+        header.key = key;
+        header.driver = glyph__program_driver_key();
+        header.length = (unsigned int)written;
+
+        char path[sizeof(glyph__program_binary_dir) + 32];
+        glyph__program_binary_path(path, sizeof(path), key);
+        FILE* f = fopen(path, "wb");
+        if (f) {
+            int ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(binary, 1, (size_t)written, f) == (size_t)written;
+            if (fclose(f) != 0 || !ok) remove(path); /* Never leave a truncated binary behind */
+        }
+    }
+    GLYPH_FREE(binary);
+}
+
+/*
+ * Returns a linked program for a source pair, sharing it when already cached
+ *
+ * A cache miss loads the stored binary if there is one and otherwise
+ * compiles and links (saving the binary when a directory is set). Every
+ * successful call must be paired with glyph__program_release.
+ *
+ * Parameters:
+ *   vertex_source, fragment_source: Complete GLSL sources
+ *
+ * Returns: Program object, or 0 if it failed to compile or link
+ */
+static inline GLuint glyph__program_acquire(const char* vertex_source, const char* fragment_source) {
+    if (!vertex_source || !fragment_source) return 0;
+
+    unsigned long long key = glyph__program_key(vertex_source, fragment_source);
+    for (int i = 0; i < glyph__program_cache_count; i++) {
+        if (glyph__program_cache[i].key == key) {
+            glyph__program_cache[i].refs++;
+            return glyph__program_cache[i].program;
+        }
+    }
+
+    GLuint program = glyph__program_load_binary(key);
+    if (!program) {
+        program = glyph__create_program_ex(vertex_source, fragment_source, glyph__program_binary_dir[0] != '\0');
+        if (!program) return 0;
+        glyph__program_save_binary(program, key);
+    }
+
+    if (glyph__program_cache_count < GLYPHGL_PROGRAM_CACHE_SIZE) {
+        glyph__program_entry_t* entry = &glyph__program_cache[glyph__program_cache_count++];
+        entry->key = key;
+        entry->program = program;
+        entry->refs = 1;
+        entry->pinned = 0;
+        entry->owner = NULL;
+    }
+    return program;
+}
+
+/*
+ * Drops one reference to a program from glyph__program_acquire
+ *
+ * The program is deleted once nothing references it; programs that did not
+ * fit into the cache are deleted immediately.
+ *
+ * Parameters:
+ *   program: Program to release (0 is ignored)
+ */
+static inline void glyph__program_release(GLuint program) {
+    if (!program) return;
+    for (int i = 0; i < glyph__program_cache_count; i++) {
+        if (glyph__program_cache[i].program != program) continue;
+        if (--glyph__program_cache[i].refs > 0) return;
+        glyph__program_cache[i] = glyph__program_cache[--glyph__program_cache_count];
+        break;
+    }
+    glyph__glDeleteProgram(program);
+}
+
+/*
+ * Records which renderer last set uniforms on a shared program
+ *
+ * Parameters:
+ *   program: Program about to receive uniform updates
+ *   owner: Renderer issuing them
+ *
+ * Returns: 1 if someone else set uniforms on the program since 'owner' last
+ *          claimed it (the owner's uniform caches are stale), 0 otherwise
+ */
+static inline int glyph__program_claim(GLuint program, const void* owner) {
+    for (int i = 0; i < glyph__program_cache_count; i++) {
+        if (glyph__program_cache[i].program != program) continue;
+        if (glyph__program_cache[i].owner == owner) return 0;
+        glyph__program_cache[i].owner = owner;
+        return 1;
+    }
+    return 0; /* Uncached programs are not shared */
+}
+
+/*
+ * Compiles (or loads) a program ahead of time and keeps it cached
+ *
+ * Renderers and effect switches that later ask for the same sources get
+ * the program without a compile. Pinned programs stay alive until
+ * glyph_gl_clear_program_cache, even when no renderer uses them.
+ *
+ * Parameters:
+ *   vertex_source, fragment_source: Complete GLSL sources
+ *
+ * Returns: 1 if the program is ready, 0 if it failed to build
+ */
+static inline int glyph_gl_precompile_program(const char* vertex_source, const char* fragment_source) {
+    GLuint program = glyph__program_acquire(vertex_source, fragment_source);
+    if (!program) return 0;
+    for (int i = 0; i < glyph__program_cache_count; i++) {
+        if (glyph__program_cache[i].program != program) continue;
+        if (glyph__program_cache[i].pinned) {
+            glyph__program_cache[i].refs--; /* Already pinned: keep a single pin reference */
+        } else {
+            glyph__program_cache[i].pinned = 1;
+        }
+        return 1;
+    }
+    glyph__glDeleteProgram(program); /* Cache full: nothing to keep it in */
+    return 0;
+}
+
+/*
+ * Releases the programs pinned by glyph_gl_precompile_program
+ *
+ * Programs still used by renderers stay until those renderers are freed.
+ * Call before destroying the GL context the programs belong to.
+ */
+static inline void glyph_gl_clear_program_cache(void) {
+    for (int i = glyph__program_cache_count - 1; i >= 0; i--) {
+        if (!glyph__program_cache[i].pinned) continue;
+        glyph__program_cache[i].pinned = 0;
+        glyph__program_release(glyph__program_cache[i].program);
+    }
+}
+
 #endif
\ No newline at end of file
@@ -31,8 +31,8 @@
  * verification used in PNG compression.
  *
  * Key features:
- * - Simple RGB image structure and memory management
- * - PNG export with DEFLATE compression
+ * - Simple RGB and 8-bit grayscale image structure and memory management
+ * - PNG export with LZ77 + Huffman DEFLATE compression, grayscale or RGB
  * - BMP export for uncompressed bitmaps
  * - CRC32 and Adler32 checksum calculations
  * - Cross-platform compatibility
@@ -69,15 +69,17 @@
 #endif
 
 /*
- * Basic RGB image structure
+ * Basic image structure
  *
- * Represents an image in memory with RGB color data stored as 3 bytes per pixel
- * in row-major order (top to bottom). Used for glyph atlas textures and export.
+ * Represents an image in memory stored in row-major order (top to bottom),
+ * either as RGB (3 bytes per pixel) or as 8-bit grayscale (1 byte per pixel).
+ * Glyph atlases use grayscale coverage; RGB is used for colored renders.
  */
 typedef struct {
     unsigned int width;      /* Image width in pixels */
     unsigned int height;     /* Image height in pixels */
-    unsigned char* data;     /* RGB pixel data: width * height * 3 bytes */
+    unsigned char* data;     /* Pixel data: width * height * channels bytes */
+    unsigned int channels;   /* Bytes per pixel: 3 (RGB) or 1 (grayscale) */
 } glyph_image_t;
 
 /*
@@ -100,6 +102,30 @@ static glyph_image_t glyph_image_create(unsigned int width, unsigned int height)
     img.height = height;
     /* Allocate RGB pixel buffer: 3 bytes per pixel */
     img.data = (unsigned char*)GLYPH_MALLOC((size_t)width * height * 3);
+    img.channels = 3;
+    return img;
+}
+
+/*
+ * Creates a new 8-bit grayscale image with the specified dimensions
+ *
+ * Same layout as glyph_image_create but with a single byte per pixel,
+ * which is all a glyph coverage or distance field needs. Export helpers
+ * expand it to RGB on the fly.
+ *
+ * Parameters:
+ *   width: Image width in pixels
+ *   height: Image height in pixels
+ *
+ * Returns: glyph_image_t structure with allocated pixel buffer
+ */
+static glyph_image_t glyph_image_create_gray(unsigned int width, unsigned int height) {
+    glyph_image_t img;
+    img.width = width;
+    img.height = height;
+    /* Allocate grayscale pixel buffer: 1 byte per pixel */
+    img.data = (unsigned char*)GLYPH_MALLOC((size_t)width * height);
+    img.channels = 1;
     return img;
 }
 
@@ -144,6 +170,28 @@ static void crc32_init_table(void) {
     crc32_table_inited = 1;
 }
 
+/*
+ * Continues a CRC32 over another block of data
+ *
+ * Lets a checksum cover data that is produced piece by piece (such as a
+ * PNG chunk type followed by its streamed payload). Start from 0.
+ *
+ * Parameters:
+ *   crc: Checksum of the data so far (0 for none)
+ *   data: Next input block
+ *   len: Length of data in bytes
+ *
+ * Returns: 32-bit CRC32 checksum of all data so far
+ */
+static uint32_t crc32_update(uint32_t crc, const unsigned char* data, size_t len) {
+    crc32_init_table();
+    crc ^= 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i) {
+        crc = (crc >> 8) ^ crc32_table[(uint8_t)(crc ^ data[i])];
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
 /*
  * Computes CRC32 checksum of data using the precomputed lookup table
  *
@@ -158,35 +206,37 @@ static void crc32_init_table(void) {
  * Returns: 32-bit CRC32 checksum
  */
 static uint32_t crc32(const unsigned char* data, size_t len) {
-    crc32_init_table();           /* Ensure table is ready */
-    uint32_t crc = 0xFFFFFFFFu;   /* Standard initial value */
-    for (size_t i = 0; i < len; ++i) {
-        uint8_t idx = (uint8_t)(crc ^ data[i]);
-        crc = (crc >> 8) ^ crc32_table[idx];
-    }
-    return crc ^ 0xFFFFFFFFu;     /* Final XOR with all 1s */
+    return crc32_update(0, data, len);
 }
 
 /*
- * Computes Adler32 checksum - a fast alternative to CRC32
+ * Continues an Adler32 checksum over another block of data
  *
- * Adler32 is a simple, fast checksum algorithm that maintains two 16-bit
- * sums. It's not as robust as CRC32 for error detection but is faster
- * and used in zlib compression for the DEFLATE compressed data checksum.
+ * Adler32 maintains two 16-bit sums; zlib streams use it as the checksum
+ * of the uncompressed data. The modulo is deferred for 5552 bytes at a
+ * time (the most that cannot overflow 32 bits), which keeps the loop to
+ * two additions per byte. Start from 1.
  *
  * Parameters:
- *   data: Input data buffer
+ *   adler: Checksum of the data so far (1 for none)
+ *   data: Next input block
  *   len: Length of data in bytes
  *
- * Returns: 32-bit Adler32 checksum (b << 16 | a)
+ * Returns: 32-bit Adler32 checksum of all data so far
  */
-static uint32_t adler32(const unsigned char* data, size_t len) {
+static uint32_t adler32_update(uint32_t adler, const unsigned char* data, size_t len) {
     const uint32_t MOD_ADLER = 65521u; /* Adler32 modulus */
-    uint32_t a = 1;  /* Primary sum */
-    uint32_t b = 0;  /* Secondary sum */
-    for (size_t i = 0; i < len; ++i) {
-        a = (a + data[i]) % MOD_ADLER;
-        b = (b + a) % MOD_ADLER;
+    uint32_t a = adler & 0xFFFF;  /* Primary sum */
+    uint32_t b = adler >> 16;     /* Secondary sum */
+    while (len > 0) {
+        size_t n = len < 5552 ? len : 5552;
+        len -= n;
+        while (n--) {
+            a += *data++;
+            b += a;
+        }
+        a %= MOD_ADLER;
+        b %= MOD_ADLER;
     }
     return (b << 16) | a; /* Combine sums into 32-bit value */
 }
@@ -291,10 +341,15 @@ static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
     /* Write pixel data bottom-to-top (BMP convention) with BGR color order */
     for (int y = height - 1; y >= 0; y--) {
         for (int x = 0; x < width; x++) {
-            /* Extract RGB components from image data */
-            unsigned char r = img->data[(y * width + x) * 3 + 0];
-            unsigned char g = img->data[(y * width + x) * 3 + 1];
-            unsigned char b = img->data[(y * width + x) * 3 + 2];
+            /* Extract RGB components from image data (grayscale is replicated) */
+            unsigned char r, g, b;
+            if (img->channels == 1) {
+                r = g = b = img->data[y * width + x];
+            } else {
+                r = img->data[(y * width + x) * 3 + 0];
+                g = img->data[(y * width + x) * 3 + 1];
+                b = img->data[(y * width + x) * 3 + 2];
+            }
             /* Write in BGR order (BMP format) */
             fputc(b, f);
             fputc(g, f);
@@ -307,6 +362,462 @@ static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
     fclose(f);
     return 0;
 }
+/*
+ * DEFLATE encoder (RFC 1951) used by the PNG writer
+ *
+ * LZ77 with hash chains over a 32 KB sliding window produces literal and
+ * length/distance tokens. Every GLYPH_DEFLATE__BLOCK_TOKENS tokens a block
+ * is emitted with whichever Huffman coding is smaller: the fixed codes or
+ * length-limited dynamic codes built from that block's symbol counts.
+ * Input can be fed in pieces of any size, and output goes straight to the
+ * stream's IDAT buffer, so memory use is constant whatever the image size.
+ */
+#define GLYPH_DEFLATE__WSIZE 32768                      /* LZ77 window size */
+#define GLYPH_DEFLATE__HASH_BITS 15
+#define GLYPH_DEFLATE__HASH_SIZE (1 << GLYPH_DEFLATE__HASH_BITS)
+#define GLYPH_DEFLATE__MIN_MATCH 3
+#define GLYPH_DEFLATE__MAX_MATCH 258
+#define GLYPH_DEFLATE__MAX_CHAIN 128                    /* Hash chain steps per match search */
+#define GLYPH_DEFLATE__BLOCK_TOKENS 16384               /* Tokens per Huffman block */
+#define GLYPH_PNG__IDAT_SIZE 65536                      /* Compressed bytes per IDAT chunk */
+
+/* Base values and extra bit counts of the length (257..285) and distance (0..29) symbols */
+static const unsigned short glyph_deflate__len_base[29] = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+static const unsigned char glyph_deflate__len_extra[29] = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+static const unsigned short glyph_deflate__dist_base[30] = {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+static const unsigned char glyph_deflate__dist_extra[30] = {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+/* Transmission order of the code length code lengths */
+static const unsigned char glyph_deflate__clen_order[19] = {16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15};
+
+/* Compressor state plus the PNG chunk sink it writes into */
+typedef struct {
+    unsigned char window[2 * GLYPH_DEFLATE__WSIZE]; /* History (first half) and lookahead */
+    size_t fill;                                    /* Bytes buffered in window */
+    size_t pos;                                     /* Next window byte to encode */
+    int head[GLYPH_DEFLATE__HASH_SIZE];             /* Latest window position per 3-byte hash, -1 if none */
+    int prev[GLYPH_DEFLATE__WSIZE];                 /* Previous position with the same hash */
+    uint32_t tokens[GLYPH_DEFLATE__BLOCK_TOKENS];   /* Literal (dist 0) or length | dist << 16 */
+    int num_tokens;
+    uint32_t lit_freq[286];                         /* Literal/length symbol counts of the block */
+    uint32_t dist_freq[30];                         /* Distance symbol counts of the block */
+    uint32_t bit_buf;                               /* Pending output bits (LSB first) */
+    int bit_count;
+    uint32_t adler;                                 /* Adler32 of the uncompressed stream */
+    FILE* f;                                        /* PNG file receiving IDAT chunks */
+    unsigned char out[GLYPH_PNG__IDAT_SIZE];        /* Compressed bytes of the current IDAT chunk */
+    size_t out_len;
+} glyph_png__stream_t;
+
+/* Writes the buffered compressed bytes as one IDAT chunk */
+static void glyph_png__flush_idat(glyph_png__stream_t* s) {
+    if (s->out_len == 0) return;
+    write_u32_be(s->f, (uint32_t)s->out_len);
+    fwrite("IDAT", 1, 4, s->f);
+    fwrite(s->out, 1, s->out_len, s->f);
+    write_u32_be(s->f, crc32_update(crc32((const unsigned char*)"IDAT", 4), s->out, s->out_len));
+    s->out_len = 0;
+}
+
+static void glyph_png__put_byte(glyph_png__stream_t* s, unsigned char b) {
+    s->out[s->out_len++] = b;
+    if (s->out_len == GLYPH_PNG__IDAT_SIZE) glyph_png__flush_idat(s);
+}
+
+/* Appends 'count' bits of 'value' (at most 16) least significant first */
+static void glyph_deflate__put_bits(glyph_png__stream_t* s, uint32_t value, int count) {
+    s->bit_buf |= value << s->bit_count;
+    s->bit_count += count;
+    while (s->bit_count >= 8) {
+        glyph_png__put_byte(s, (unsigned char)s->bit_buf);
+        s->bit_buf >>= 8;
+        s->bit_count -= 8;
+    }
+}
+
+/*
+ * Computes Huffman code lengths limited to max_bits
+ *
+ * Uses the in-place minimum-redundancy algorithm of Moffat and Katajainen
+ * on the symbols sorted by count, then rebalances any code longer than
+ * max_bits while keeping the Kraft sum exact. A lone used symbol gets a
+ * partner so every tree is complete.
+ */
+static void glyph_deflate__build_lengths(const uint32_t* freq, int n, int max_bits, unsigned char* lengths) {
+    int syms[286];
+    int a[286];
+    int used = 0;
+    for (int i = 0; i < n; i++) {
+        lengths[i] = 0;
+        if (freq[i]) syms[used++] = i;
+    }
+    if (used == 0) return;
+    if (used == 1) {
+        lengths[syms[0]] = 1;
+        lengths[syms[0] == 0 ? 1 : 0] = 1;
+        return;
+    }
+
+    /* Sort used symbols by ascending count (small alphabets: insertion sort) */
+    for (int i = 1; i < used; i++) {
+        int sym = syms[i];
+        int j = i - 1;
+        while (j >= 0 && freq[syms[j]] > freq[sym]) {
+            syms[j + 1] = syms[j];
+            j--;
+        }
+        syms[j + 1] = sym;
+    }
+    for (int i = 0; i < used; i++) a[i] = (int)freq[syms[i]];
+
+    /* Moffat-Katajainen: a[] becomes code lengths, longest first */
+    int root = 0, leaf = 2, next;
+    a[0] += a[1];
+    for (next = 1; next < used - 1; next++) {
+        if (leaf >= used || a[root] < a[leaf]) { a[next] = a[root]; a[root++] = next; }
+        else a[next] = a[leaf++];
+        if (leaf >= used || (root < next && a[root] < a[leaf])) { a[next] += a[root]; a[root++] = next; }
+        else a[next] += a[leaf++];
+    }
+    a[used - 2] = 0;
+    for (next = used - 3; next >= 0; next--) a[next] = a[a[next]] + 1;
+    int avail = 1, taken = 0, depth = 0;
+    root = used - 2;
+    next = used - 1;
+    while (avail > 0) {
+        while (root >= 0 && a[root] == depth) { taken++; root--; }
+        while (avail > taken) { a[next--] = depth; avail--; }
+        avail = 2 * taken;
+        depth++;
+        taken = 0;
+    }
+
+    /* Clamp to max_bits and restore a complete code */
+    int count[32] = {0};
+    for (int i = 0; i < used; i++) count[a[i] < max_bits ? a[i] : max_bits]++;
+    uint32_t total = 0;
+    for (int i = 1; i <= max_bits; i++) total += (uint32_t)count[i] << (max_bits - i);
+    while (total > (1u << max_bits)) {
+        count[max_bits]--;
+        for (int i = max_bits - 1; i > 0; i--) {
+            if (count[i]) {
+                count[i]--;
+                count[i + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    /* Least frequent symbols take the longest codes */
+    int k = 0;
+    for (int len = max_bits; len >= 1; len--) {
+        for (int c = 0; c < count[len]; c++) lengths[syms[k++]] = (unsigned char)len;
+    }
+}
+
+/* Assigns canonical codes (bit-reversed for LSB-first output) from code lengths */
+static void glyph_deflate__build_codes(const unsigned char* lengths, int n, unsigned short* codes) {
+    int count[16] = {0};
+    int next_code[16];
+    for (int i = 0; i < n; i++) count[lengths[i]]++;
+    count[0] = 0;
+    int code = 0;
+    for (int len = 1; len < 16; len++) {
+        code = (code + count[len - 1]) << 1;
+        next_code[len] = code;
+    }
+    for (int i = 0; i < n; i++) {
+        int len = lengths[i];
+        if (!len) continue;
+        int c = next_code[len]++;
+        int reversed = 0;
+        for (int b = 0; b < len; b++) reversed |= ((c >> b) & 1) << (len - 1 - b);
+        codes[i] = (unsigned short)reversed;
+    }
+}
+
+static int glyph_deflate__len_symbol(int len) {
+    int i = 28;
+    while (glyph_deflate__len_base[i] > len) i--;
+    return i;
+}
+
+static int glyph_deflate__dist_symbol(int dist) {
+    int i = 29;
+    while (glyph_deflate__dist_base[i] > dist) i--;
+    return i;
+}
+
+/*
+ * Run-length encodes the literal/length and distance code lengths with the
+ * code length alphabet (16 = repeat previous, 17/18 = runs of zeros)
+ *
+ * Returns: Number of entries written to out (symbol | extra value << 8)
+ */
+static int glyph_deflate__rle_lengths(const unsigned char* lengths, int n, unsigned short* out, uint32_t* clen_freq) {
+    int count = 0;
+    for (int i = 0; i < n;) {
+        int len = lengths[i];
+        int run = 1;
+        while (i + run < n && lengths[i + run] == len) run++;
+        i += run;
+        if (len == 0) {
+            while (run >= 11) {
+                int r = run > 138 ? 138 : run;
+                out[count++] = (unsigned short)(18 | (r - 11) << 8);
+                clen_freq[18]++;
+                run -= r;
+            }
+            if (run >= 3) {
+                out[count++] = (unsigned short)(17 | (run - 3) << 8);
+                clen_freq[17]++;
+                run = 0;
+            }
+        } else {
+            out[count++] = (unsigned short)len;
+            clen_freq[len]++;
+            run--;
+            while (run >= 3) {
+                int r = run > 6 ? 6 : run;
+                out[count++] = (unsigned short)(16 | (r - 3) << 8);
+                clen_freq[16]++;
+                run -= r;
+            }
+        }
+        while (run-- > 0) {
+            out[count++] = (unsigned short)len;
+            clen_freq[len]++;
+        }
+    }
+    return count;
+}
+
+/* Writes the buffered tokens as one Huffman block (fixed or dynamic, whichever is smaller) */
+static void glyph_deflate__flush_block(glyph_png__stream_t* s, int final) {
+    unsigned char lit_len[288], dist_len[30], clen_len[19]; /* 288: the fixed code also spans symbols 286..287 */
+    unsigned short lit_code[288], dist_code[30], clen_code[19];
+    unsigned char all_len[286 + 30];
+    unsigned short rle[286 + 30];
+    uint32_t clen_freq[19] = {0};
+
+    s->lit_freq[256]++; /* End of block */
+    glyph_deflate__build_lengths(s->lit_freq, 286, 15, lit_len);
+    lit_len[286] = lit_len[287] = 0;
+    glyph_deflate__build_lengths(s->dist_freq, 30, 15, dist_len);
+    int hlit = 286, hdist = 30;
+    while (hlit > 257 && lit_len[hlit - 1] == 0) hlit--;
+    while (hdist > 1 && dist_len[hdist - 1] == 0) hdist--;
+    memcpy(all_len, lit_len, hlit);
+    memcpy(all_len + hlit, dist_len, hdist);
+    int rle_count = glyph_deflate__rle_lengths(all_len, hlit + hdist, rle, clen_freq);
+    glyph_deflate__build_lengths(clen_freq, 19, 7, clen_len);
+    int hclen = 19;
+    while (hclen > 4 && clen_len[glyph_deflate__clen_order[hclen - 1]] == 0) hclen--;
+
+    /* Compare encoded sizes; extra bits cost the same either way */
+    uint64_t dynamic_bits = 14 + 3 * (uint64_t)hclen, fixed_bits = 0;
+    for (int i = 0; i < rle_count; i++) {
+        int sym = rle[i] & 0xFF;
+        dynamic_bits += clen_len[sym] + (sym == 16 ? 2 : sym == 17 ? 3 : sym == 18 ? 7 : 0);
+    }
+    for (int i = 0; i < 286; i++) {
+        int fixed = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+        dynamic_bits += (uint64_t)s->lit_freq[i] * lit_len[i];
+        fixed_bits += (uint64_t)s->lit_freq[i] * fixed;
+    }
+    for (int i = 0; i < 30; i++) {
+        dynamic_bits += (uint64_t)s->dist_freq[i] * dist_len[i];
+        fixed_bits += (uint64_t)s->dist_freq[i] * 5;
+    }
+
+    if (fixed_bits <= dynamic_bits) {
+        for (int i = 0; i < 288; i++) lit_len[i] = (unsigned char)(i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8);
+        for (int i = 0; i < 30; i++) dist_len[i] = 5;
+        glyph_deflate__put_bits(s, final | (1 << 1), 3); /* BTYPE 01: fixed Huffman */
+    } else {
+        glyph_deflate__build_codes(clen_len, 19, clen_code);
+        glyph_deflate__put_bits(s, final | (2 << 1), 3); /* BTYPE 10: dynamic Huffman */
+        glyph_deflate__put_bits(s, hlit - 257, 5);
+        glyph_deflate__put_bits(s, hdist - 1, 5);
+        glyph_deflate__put_bits(s, hclen - 4, 4);
+        for (int i = 0; i < hclen; i++) glyph_deflate__put_bits(s, clen_len[glyph_deflate__clen_order[i]], 3);
+        for (int i = 0; i < rle_count; i++) {
+            int sym = rle[i] & 0xFF;
+            glyph_deflate__put_bits(s, clen_code[sym], clen_len[sym]);
+            if (sym == 16) glyph_deflate__put_bits(s, rle[i] >> 8, 2);
+            else if (sym == 17) glyph_deflate__put_bits(s, rle[i] >> 8, 3);
+            else if (sym == 18) glyph_deflate__put_bits(s, rle[i] >> 8, 7);
+        }
+    }
+    glyph_deflate__build_codes(lit_len, 288, lit_code);
+    glyph_deflate__build_codes(dist_len, 30, dist_code);
+
+    /* Token stream */
+    for (int i = 0; i < s->num_tokens; i++) {
+        uint32_t t = s->tokens[i];
+        int dist = (int)(t >> 16);
+        if (dist == 0) {
+            glyph_deflate__put_bits(s, lit_code[t], lit_len[t]);
+            continue;
+        }
+        int len = (int)(t & 0xFFFF);
+        int ls = glyph_deflate__len_symbol(len);
+        glyph_deflate__put_bits(s, lit_code[257 + ls], lit_len[257 + ls]);
+        if (glyph_deflate__len_extra[ls]) glyph_deflate__put_bits(s, len - glyph_deflate__len_base[ls], glyph_deflate__len_extra[ls]);
+        int ds = glyph_deflate__dist_symbol(dist);
+        glyph_deflate__put_bits(s, dist_code[ds], dist_len[ds]);
+        if (glyph_deflate__dist_extra[ds]) glyph_deflate__put_bits(s, dist - glyph_deflate__dist_base[ds], glyph_deflate__dist_extra[ds]);
+    }
+    glyph_deflate__put_bits(s, lit_code[256], lit_len[256]);
+
+    s->num_tokens = 0;
+    memset(s->lit_freq, 0, sizeof(s->lit_freq));
+    memset(s->dist_freq, 0, sizeof(s->dist_freq));
+}
+
+static void glyph_deflate__add_token(glyph_png__stream_t* s, int len, int dist) {
+    if (dist == 0) {
+        s->tokens[s->num_tokens++] = (uint32_t)len;
+        s->lit_freq[len]++;
+    } else {
+        s->tokens[s->num_tokens++] = (uint32_t)len | ((uint32_t)dist << 16);
+        s->lit_freq[257 + glyph_deflate__len_symbol(len)]++;
+        s->dist_freq[glyph_deflate__dist_symbol(dist)]++;
+    }
+    if (s->num_tokens == GLYPH_DEFLATE__BLOCK_TOKENS) glyph_deflate__flush_block(s, 0);
+}
+
+static int glyph_deflate__hash(const unsigned char* p) {
+    return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (GLYPH_DEFLATE__HASH_SIZE - 1);
+}
+
+/* Records window position 'pos' in its hash chain (needs 3 bytes of lookahead) */
+static void glyph_deflate__insert(glyph_png__stream_t* s, size_t pos) {
+    int h = glyph_deflate__hash(s->window + pos);
+    s->prev[pos & (GLYPH_DEFLATE__WSIZE - 1)] = s->head[h];
+    s->head[h] = (int)pos;
+}
+
+/*
+ * Tokenizes buffered input
+ *
+ * Unless 'final' is set, MAX_MATCH bytes of lookahead are kept back so a
+ * match is never cut short by the end of the buffer.
+ */
+static void glyph_deflate__compress(glyph_png__stream_t* s, int final) {
+    size_t limit = final ? s->fill : (s->fill > GLYPH_DEFLATE__MAX_MATCH ? s->fill - GLYPH_DEFLATE__MAX_MATCH : 0);
+    while (s->pos < limit) {
+        size_t pos = s->pos;
+        size_t avail = s->fill - pos;
+        int best_len = 0, best_dist = 0;
+        if (avail >= GLYPH_DEFLATE__MIN_MATCH) {
+            int max_len = avail < GLYPH_DEFLATE__MAX_MATCH ? (int)avail : GLYPH_DEFLATE__MAX_MATCH;
+            int cand = s->head[glyph_deflate__hash(s->window + pos)];
+            const unsigned char* cur = s->window + pos;
+            for (int chain = 0; cand >= 0 && chain < GLYPH_DEFLATE__MAX_CHAIN; chain++) {
+                int dist = (int)pos - cand;
+                if (dist > GLYPH_DEFLATE__WSIZE) break;
+                const unsigned char* m = s->window + cand;
+                if (m[best_len] == cur[best_len] && m[0] == cur[0]) {
+                    int len = 0;
+                    while (len < max_len && m[len] == cur[len]) len++;
+                    if (len > best_len) {
+                        best_len = len;
+                        best_dist = dist;
+                        if (len == max_len) break;
+                    }
+                }
+                int next = s->prev[cand & (GLYPH_DEFLATE__WSIZE - 1)];
+                if (next >= cand) break; /* Slot reused by a newer position: chain ends */
+                cand = next;
+            }
+        }
+        if (best_len >= GLYPH_DEFLATE__MIN_MATCH) {
+            glyph_deflate__add_token(s, best_len, best_dist);
+            for (int i = 0; i < best_len; i++, pos++) {
+                if (pos + GLYPH_DEFLATE__MIN_MATCH <= s->fill) glyph_deflate__insert(s, pos);
+            }
+            s->pos = pos;
+        } else {
+            glyph_deflate__add_token(s, s->window[pos], 0);
+            if (avail >= GLYPH_DEFLATE__MIN_MATCH) glyph_deflate__insert(s, pos);
+            s->pos = pos + 1;
+        }
+    }
+}
+
+/* Feeds bytes of the zlib stream payload to the compressor */
+static void glyph_deflate__write(glyph_png__stream_t* s, const unsigned char* data, size_t len) {
+    s->adler = adler32_update(s->adler, data, len);
+    while (len > 0) {
+        size_t space = sizeof(s->window) - s->fill;
+        size_t n = len < space ? len : space;
+        memcpy(s->window + s->fill, data, n);
+        s->fill += n;
+        data += n;
+        len -= n;
+        if (s->fill < sizeof(s->window)) break;
+
+        /* Window full: encode what has lookahead, then slide the history down by WSIZE */
+        glyph_deflate__compress(s, 0);
+        memmove(s->window, s->window + GLYPH_DEFLATE__WSIZE, s->fill - GLYPH_DEFLATE__WSIZE);
+        s->fill -= GLYPH_DEFLATE__WSIZE;
+        s->pos -= GLYPH_DEFLATE__WSIZE;
+        for (int i = 0; i < GLYPH_DEFLATE__HASH_SIZE; i++) {
+            s->head[i] = s->head[i] >= GLYPH_DEFLATE__WSIZE ? s->head[i] - GLYPH_DEFLATE__WSIZE : -1;
+        }
+        for (int i = 0; i < GLYPH_DEFLATE__WSIZE; i++) {
+            s->prev[i] = s->prev[i] >= GLYPH_DEFLATE__WSIZE ? s->prev[i] - GLYPH_DEFLATE__WSIZE : -1;
+        }
+    }
+}
+
+/*
+ * Chooses a PNG filter for one scanline and applies it
+ *
+ * Tries None, Sub, Up, Average and Paeth and keeps the one with the
+ * smallest sum of absolute (signed) residuals, the usual heuristic from
+ * the PNG specification.
+ *
+ * Parameters:
+ *   row: Current scanline
+ *   prev: Previous scanline (all zeros for the first row)
+ *   len: Scanline length in bytes
+ *   bpp: Bytes per pixel
+ *   out: Receives the filter type byte followed by len filtered bytes
+ *   tmp: Scratch buffer of len + 1 bytes
+ */
+static void glyph_png__filter_row(const unsigned char* row, const unsigned char* prev, size_t len, int bpp,
+                                  unsigned char* out, unsigned char* tmp) {
+    uint64_t best_cost = 0;
+    for (int type = 0; type < 5; type++) {
+        unsigned char* dst = type == 0 ? out : tmp;
+        uint64_t cost = 0;
+        dst[0] = (unsigned char)type;
+        for (size_t i = 0; i < len; i++) {
+            int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+            int b = prev[i];
+            int c = i >= (size_t)bpp ? prev[i - bpp] : 0;
+            int pred = 0;
+            if (type == 1) pred = a;
+            else if (type == 2) pred = b;
+            else if (type == 3) pred = (a + b) >> 1;
+            else if (type == 4) {
+                int p = a + b - c;
+                int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+                pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+            }
+            unsigned char v = (unsigned char)(row[i] - pred);
+            dst[i + 1] = v;
+            cost += v < 128 ? v : 256 - v;
+        }
+        if (type == 0 || cost < best_cost) {
+            best_cost = cost;
+            if (type != 0) memcpy(out, tmp, len + 1);
+        }
+    }
+}
+
 /*
  * Exports a glyph image to PNG (Portable Network Graphics) file format
  *
@@ -314,6 +825,11 @@ static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
  * in applications. This implementation creates a valid PNG with IHDR, IDAT,
  * and IEND chunks, using DEFLATE compression for the image data.
  *
+ * Single-channel images are written as 8-bit grayscale (color type 0) and
+ * RGB images as truecolor (color type 2). Scanlines are filtered and
+ * compressed one at a time and written in 64 KB IDAT chunks, so only a few
+ * rows of the image are ever copied.
+ *
  * Parameters:
  *   filename: Output PNG file path
  *   img: Pointer to glyph_image_t to export
@@ -322,134 +838,92 @@ static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
  */
 static int glyph_write_png(const char* filename, glyph_image_t* img) {
     /* Validate input parameters */
-    if (!img || !img->data) return -1;
+    if (!img || !img->data || (img->channels != 1 && img->channels != 3)) return -1;
+
+    /* Compressor state and three scanline buffers (previous row, filtered row, filter scratch) */
+    size_t row_bytes = (size_t)img->width * img->channels;
+    glyph_png__stream_t* s = (glyph_png__stream_t*)GLYPH_MALLOC(sizeof(glyph_png__stream_t));
+    unsigned char* rows = (unsigned char*)GLYPH_MALLOC(row_bytes * 3 + 2);
+    if (!s || !rows) {
+        GLYPH_FREE(s);
+        GLYPH_FREE(rows);
+        return -1;
+    }
 
     /* Open file for binary writing */
     FILE* f = fopen(filename, "wb");
-    if (!f) return -1;
+    if (!f) {
+        GLYPH_FREE(s);
+        GLYPH_FREE(rows);
+        return -1;
+    }
 
     /* Write PNG signature (required first 8 bytes of all PNG files) */
     const unsigned char png_sig[8] = {137,80,78,71,13,10,26,10};
     fwrite(png_sig, 1, 8, f);
 
-    /* Create IHDR chunk data (Image Header) */
-    unsigned char ihdr_data[13];
+    /* Create IHDR chunk (Image Header): type followed by 13 data bytes */
+    unsigned char ihdr[17];
+    memcpy(ihdr, "IHDR", 4);
     /* Image width in big-endian */
-    ihdr_data[0] = (img->width >> 24) & 0xFF;
-    ihdr_data[1] = (img->width >> 16) & 0xFF;
-    ihdr_data[2] = (img->width >> 8) & 0xFF;
-    ihdr_data[3] = img->width & 0xFF;
+    ihdr[4] = (img->width >> 24) & 0xFF;
+    ihdr[5] = (img->width >> 16) & 0xFF;
+    ihdr[6] = (img->width >> 8) & 0xFF;
+    ihdr[7] = img->width & 0xFF;
     /* Image height in big-endian */
-    ihdr_data[4] = (img->height >> 24) & 0xFF;
-    ihdr_data[5] = (img->height >> 16) & 0xFF;
-    ihdr_data[6] = (img->height >> 8) & 0xFF;
-    ihdr_data[7] = img->height & 0xFF;
-    ihdr_data[8] = 8;  /* Bit depth: 8 bits per channel */
-    ihdr_data[9] = 2;  /* Color type: RGB (2) */
-    ihdr_data[10] = 0; /* Compression method: DEFLATE (0) */
-    ihdr_data[11] = 0; /* Filter method: Adaptive (0) */
-    ihdr_data[12] = 0; /* Interlace method: None (0) */
-
-    /* Write IHDR chunk */
-    write_u32_be(f, 13);              /* Chunk length */
-    fwrite("IHDR", 1, 4, f);         /* Chunk type */
-    fwrite(ihdr_data, 1, 13, f);     /* Chunk data */
-    /* Calculate and write CRC32 checksum */
-    {
-        unsigned char* tmp = (unsigned char*)GLYPH_MALLOC(4 + 13);
-        memcpy(tmp, "IHDR", 4);
-        memcpy(tmp + 4, ihdr_data, 13);
-        uint32_t crc = crc32(tmp, 4 + 13);
-        write_u32_be(f, crc);
-        GLYPH_FREE(tmp);
-    }
-
-    /* Prepare image data for DEFLATE compression */
-    /* PNG uses "filter bytes" and requires big-endian storage */
-    size_t raw_row_bytes = (size_t)img->width * 3 + 1; /* +1 for filter byte */
-    size_t raw_size = raw_row_bytes * img->height;
-    unsigned char* raw = (unsigned char*)GLYPH_MALLOC(raw_size);
-    if (!raw) { fclose(f); return -1; }
-
-    int bpp = 3; /* Bytes per pixel (RGB) */
-    /* Apply PNG filtering (Sub filter for simplicity) */
-    unsigned char* row_data = (unsigned char*)GLYPH_MALLOC((size_t)img->width * bpp);
+    ihdr[8] = (img->height >> 24) & 0xFF;
+    ihdr[9] = (img->height >> 16) & 0xFF;
+    ihdr[10] = (img->height >> 8) & 0xFF;
+    ihdr[11] = img->height & 0xFF;
+    ihdr[12] = 8;                           /* Bit depth: 8 bits per channel */
+    ihdr[13] = img->channels == 1 ? 0 : 2;  /* Color type: grayscale (0) or RGB (2) */
+    ihdr[14] = 0;                           /* Compression method: DEFLATE (0) */
+    ihdr[15] = 0;                           /* Filter method: Adaptive (0) */
+    ihdr[16] = 0;                           /* Interlace method: None (0) */
+
+    /* Write IHDR chunk with its CRC32 checksum */
+    write_u32_be(f, 13);
+    fwrite(ihdr, 1, 17, f);
+    write_u32_be(f, crc32(ihdr, 17));
+
+    /* Stream filtered scanlines through the compressor into IDAT chunks */
+    s->fill = 0;
+    s->pos = 0;
+    memset(s->head, 0xFF, sizeof(s->head)); /* -1: empty hash chains */
+    memset(s->prev, 0xFF, sizeof(s->prev));
+    s->num_tokens = 0;
+    memset(s->lit_freq, 0, sizeof(s->lit_freq));
+    memset(s->dist_freq, 0, sizeof(s->dist_freq));
+    s->bit_buf = 0;
+    s->bit_count = 0;
+    s->adler = 1;
+    s->f = f;
+    s->out_len = 0;
+
+    glyph_png__put_byte(s, 0x78); /* Zlib header: DEFLATE, 32 KB window */
+    glyph_png__put_byte(s, 0x9C); /* Default compression level, header checksum */
+
+    unsigned char* prev = rows;
+    unsigned char* filtered = rows + row_bytes;
+    unsigned char* scratch = rows + row_bytes * 2 + 1;
+    memset(prev, 0, row_bytes);
     for (unsigned int y = 0; y < img->height; ++y) {
-        unsigned char* row_ptr = raw + y * raw_row_bytes;
-        /* Copy current row */
-        memcpy(row_data, &img->data[(y * img->width) * bpp], (size_t)img->width * bpp);
-        row_ptr[0] = 1; /* Filter type: Sub (1) */
-        /* Apply Sub filter: each pixel = current - left neighbor */
-        for (size_t i = 0; i < (size_t)img->width * bpp; ++i) {
-            if (i < bpp) {
-                row_ptr[i + 1] = row_data[i]; /* First pixel unchanged */
-            } else {
-                row_ptr[i + 1] = row_data[i] - row_data[i - bpp]; /* Subtract left pixel */
-            }
-        }
-    }
-    GLYPH_FREE(row_data);
-
-    /* Compress using DEFLATE algorithm (stored/uncompressed for simplicity) */
-    /* Zlib header for DEFLATE compression */
-    unsigned char zlib_header[2] = {0x78, 0x01}; /* Fastest compression, stored blocks */
-
-    /* Calculate maximum compressed size (worst case) */
-    size_t max_blocks = (raw_size + 65534) / 65535; /* Number of 64KB blocks needed */
-    size_t comp_cap = 2 + raw_size + max_blocks * 5 + 4; /* Header + data + block overhead + checksum */
-    unsigned char* comp = (unsigned char*)GLYPH_MALLOC(comp_cap);
-    if (!comp) { GLYPH_FREE(raw); fclose(f); return -1; }
-
-    /* Build compressed data stream */
-    size_t comp_pos = 0;
-    comp[comp_pos++] = zlib_header[0]; /* Zlib compression method/flags */
-    comp[comp_pos++] = zlib_header[1];
-
-    /* Process data in 64KB blocks (DEFLATE stored blocks) */
-    size_t remaining = raw_size;
-    size_t raw_pos = 0;
-    while (remaining > 0) {
-        uint16_t block_len = (uint16_t)((remaining > 65535) ? 65535 : remaining);
-        uint8_t bfinal = (remaining <= 65535) ? 1 : 0; /* Final block flag */
-        uint8_t block_hdr = (uint8_t)((bfinal & 1) | (0 << 1)); /* Stored block type */
-        comp[comp_pos++] = block_hdr;
-        /* Block length and one's complement */
-        comp[comp_pos++] = (uint8_t)(block_len & 0xFF);
-        comp[comp_pos++] = (uint8_t)((block_len >> 8) & 0xFF);
-        uint16_t nlen = (uint16_t)(~block_len);
-        comp[comp_pos++] = (uint8_t)(nlen & 0xFF);
-        comp[comp_pos++] = (uint8_t)((nlen >> 8) & 0xFF);
-        /* Copy uncompressed data */
-        memcpy(comp + comp_pos, raw + raw_pos, block_len);
-        comp_pos += block_len;
-        raw_pos += block_len;
-        remaining -= block_len;
+        const unsigned char* row = img->data + (size_t)y * row_bytes;
+        glyph_png__filter_row(row, y ? row - row_bytes : prev, row_bytes, (int)img->channels, filtered, scratch);
+        glyph_deflate__write(s, filtered, row_bytes + 1);
     }
+    glyph_deflate__compress(s, 1);
+    glyph_deflate__flush_block(s, 1);
+    if (s->bit_count > 0) glyph_deflate__put_bits(s, 0, 8 - s->bit_count); /* Pad to a byte boundary */
 
     /* Append Adler32 checksum (required by zlib) */
-    uint32_t a32 = adler32(raw, raw_size);
-    comp[comp_pos++] = (unsigned char)((a32 >> 24) & 0xFF);
-    comp[comp_pos++] = (unsigned char)((a32 >> 16) & 0xFF);
-    comp[comp_pos++] = (unsigned char)((a32 >> 8) & 0xFF);
-    comp[comp_pos++] = (unsigned char)(a32 & 0xFF);
-
-    GLYPH_FREE(raw); /* Free uncompressed data */
-
-    /* Write IDAT chunk (Image Data) */
-    uint32_t comp_len = (uint32_t)comp_pos;
-    write_u32_be(f, comp_len);        /* Chunk length */
-    fwrite("IDAT", 1, 4, f);         /* Chunk type */
-    fwrite(comp, 1, comp_len, f);    /* Compressed data */
-    /* Calculate and write CRC32 */
-    {
-        unsigned char* tmp = (unsigned char*)GLYPH_MALLOC(4 + comp_len);
-        memcpy(tmp, "IDAT", 4);
-        memcpy(tmp + 4, comp, comp_len);
-        uint32_t crc = crc32(tmp, 4 + comp_len);
-        write_u32_be(f, crc);
-        GLYPH_FREE(tmp);
-    }
-    GLYPH_FREE(comp); /* Free compressed data */
+    glyph_png__put_byte(s, (unsigned char)((s->adler >> 24) & 0xFF));
+    glyph_png__put_byte(s, (unsigned char)((s->adler >> 16) & 0xFF));
+    glyph_png__put_byte(s, (unsigned char)((s->adler >> 8) & 0xFF));
+    glyph_png__put_byte(s, (unsigned char)(s->adler & 0xFF));
+    glyph_png__flush_idat(s);
+    GLYPH_FREE(s);
+    GLYPH_FREE(rows);
 
     /* Write IEND chunk (Image End) - marks end of PNG file */
     write_u32_be(f, 0);                          /* Empty chunk */
@@ -457,8 +931,8 @@ static int glyph_write_png(const char* filename, glyph_image_t* img) {
     uint32_t iend_crc = crc32((const unsigned char*)"IEND", 4);
     write_u32_be(f, iend_crc);                   /* CRC32 checksum */
 
-    fclose(f);
-    return 0;
+    int ok = !ferror(f);
+    return fclose(f) == 0 && ok ? 0 : -1;
 }
 
 #endif
\ No newline at end of file
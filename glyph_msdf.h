@@ -0,0 +1,630 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 Darek
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Multi-channel Signed Distance Field (MSDF) Module for GlyphGL
+ *
+ * Computes distance fields straight from TrueType outlines instead of a
+ * rasterized bitmap. Edges are split at corners and colored so that every
+ * corner sits between edges sharing only one of the R, G and B channels;
+ * each channel stores the signed pseudo-distance to its nearest edge. The
+ * median of the three channels reconstructs sharp corners at any
+ * magnification, so a small atlas (e.g. 32 px) replaces several sizes.
+ *
+ * The approach follows Chlumsky's msdfgen: simple edge coloring, exact
+ * nearest-point queries on lines and quadratic Beziers, then sign and
+ * channel-clash correction passes.
+ */
+
+#ifndef __GLYPH_MSDF_H
+#define __GLYPH_MSDF_H
+
+#include "glyph_truetype.h"
+
+/* Edge colors: a bitmask of the channels an edge contributes to */
+#define GLYPH_MSDF__RED     1
+#define GLYPH_MSDF__GREEN   2
+#define GLYPH_MSDF__BLUE    4
+#define GLYPH_MSDF__YELLOW  (GLYPH_MSDF__RED | GLYPH_MSDF__GREEN)
+#define GLYPH_MSDF__MAGENTA (GLYPH_MSDF__RED | GLYPH_MSDF__BLUE)
+#define GLYPH_MSDF__CYAN    (GLYPH_MSDF__GREEN | GLYPH_MSDF__BLUE)
+#define GLYPH_MSDF__WHITE   (GLYPH_MSDF__RED | GLYPH_MSDF__GREEN | GLYPH_MSDF__BLUE)
+
+/* One outline edge in pixel space (Y down) */
+typedef struct {
+    int quadratic;              /* 0 = line p0-p2, 1 = quadratic Bezier p0-p1-p2 */
+    float x0, y0;               /* Start point */
+    float x1, y1;               /* Control point (midpoint for lines) */
+    float x2, y2;               /* End point */
+    int color;                  /* Channel mask (GLYPH_MSDF__*) */
+} glyph_msdf__edge_t;
+
+/* Growable edge list with per-contour ranges */
+typedef struct {
+    glyph_msdf__edge_t* edges;  /* All edges, contour after contour */
+    int count;                  /* Edges in use */
+    int capacity;               /* Allocated edges */
+    const glyph_allocator_t* allocator; /* Source of edges (NULL = GLYPH_MALLOC) */
+} glyph_msdf__shape_t;
+
+/* Nearest-edge query result, compared by |distance| then by orthogonality */
+typedef struct {
+    float distance;             /* Signed distance (positive outside) */
+    float dot;                  /* |cos| between edge direction and the query vector, 0 = perpendicular */
+    float param;                /* Curve parameter of the nearest point (may lie outside [0, 1]) */
+    int edge;                   /* Edge index, -1 when no edge has been seen */
+} glyph_msdf__hit_t;
+
+/* Appends an edge, skipping degenerate ones */
+static int glyph_msdf__push(glyph_msdf__shape_t* shape, int quadratic, float x0, float y0, float x1, float y1, float x2, float y2) {
+    if (fabsf(x2 - x0) + fabsf(y2 - y0) + (quadratic ? fabsf(x1 - x0) + fabsf(y1 - y0) : 0.0f) < 1e-6f) return 1;
+    if (shape->count == shape->capacity) {
+        int new_capacity = shape->capacity ? shape->capacity * 2 : 64;
+        glyph_msdf__edge_t* edges = (glyph_msdf__edge_t*)glyph__realloc(shape->allocator, shape->edges, new_capacity * sizeof(glyph_msdf__edge_t));
+        if (!edges) return 0;
+        shape->edges = edges;
+        shape->capacity = new_capacity;
+    }
+    glyph_msdf__edge_t* e = &shape->edges[shape->count++];
+    e->quadratic = quadratic;
+    e->x0 = x0;
+    e->y0 = y0;
+    e->x1 = quadratic ? x1 : (x0 + x2) * 0.5f;
+    e->y1 = quadratic ? y1 : (y0 + y2) * 0.5f;
+    e->x2 = x2;
+    e->y2 = y2;
+    e->color = GLYPH_MSDF__WHITE;
+    return 1;
+}
+
+/* Evaluates an edge at parameter t */
+static void glyph_msdf__point(const glyph_msdf__edge_t* e, float t, float* x, float* y) {
+    float u = 1.0f - t;
+    *x = u * u * e->x0 + 2.0f * u * t * e->x1 + t * t * e->x2;
+    *y = u * u * e->y0 + 2.0f * u * t * e->y1 + t * t * e->y2;
+}
+
+/* Returns the (unnormalized) tangent of an edge at its start (t = 0) or end (t = 1) */
+static void glyph_msdf__direction(const glyph_msdf__edge_t* e, int at_end, float* dx, float* dy) {
+    if (!e->quadratic) {
+        *dx = e->x2 - e->x0;
+        *dy = e->y2 - e->y0;
+        return;
+    }
+    *dx = at_end ? e->x2 - e->x1 : e->x1 - e->x0;
+    *dy = at_end ? e->y2 - e->y1 : e->y1 - e->y0;
+    if (*dx == 0.0f && *dy == 0.0f) {
+        /* Control point on an end point: fall back to the chord */
+        *dx = e->x2 - e->x0;
+        *dy = e->y2 - e->y0;
+    }
+}
+
+/* Splits an edge into its thirds (used to color contours with too few edges) */
+static void glyph_msdf__split_thirds(const glyph_msdf__edge_t* e, glyph_msdf__edge_t* parts) {
+    for (int i = 0; i < 3; i++) {
+        float t0 = i / 3.0f;
+        float t1 = (i + 1) / 3.0f;
+        parts[i] = *e;
+        glyph_msdf__point(e, t0, &parts[i].x0, &parts[i].y0);
+        glyph_msdf__point(e, t1, &parts[i].x2, &parts[i].y2);
+        /* Blossom b(t0, t1) is the control point of the sub-curve */
+        float a = (1.0f - t0) * (1.0f - t1);
+        float b = (1.0f - t0) * t1 + t0 * (1.0f - t1);
+        float c = t0 * t1;
+        parts[i].x1 = a * e->x0 + b * e->x1 + c * e->x2;
+        parts[i].y1 = a * e->y0 + b * e->y1 + c * e->y2;
+    }
+}
+
+/*
+ * Builds the edge list of one contour from decoded outline points
+ *
+ * Off-curve points always sit between on-curve points (see
+ * glyph_ttf__load_outline), so each one closes a quadratic segment.
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static int glyph_msdf__add_contour(glyph_msdf__shape_t* shape, const glyph_point_t* points, int n) {
+    int start = -1;
+    for (int i = 0; i < n; i++) {
+        if (points[i].on_curve) {
+            start = i;
+            break;
+        }
+    }
+    if (start < 0 || n < 2) return 1;
+
+    int i = 0;
+    while (i < n) {
+        const glyph_point_t* p0 = &points[(start + i) % n];
+        const glyph_point_t* p1 = &points[(start + i + 1) % n];
+        if (p1->on_curve) {
+            if (!glyph_msdf__push(shape, 0, p0->x, p0->y, 0.0f, 0.0f, p1->x, p1->y)) return 0;
+            i += 1;
+        } else {
+            const glyph_point_t* p2 = &points[(start + i + 2) % n];
+            if (!glyph_msdf__push(shape, 1, p0->x, p0->y, p1->x, p1->y, p2->x, p2->y)) return 0;
+            i += 2;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Colors the edges of one contour (msdfgen's "simple" strategy)
+ *
+ * Corners are joins that turn by more than about 8 degrees (or reverse).
+ * Smooth contours stay white; a single corner splits the contour
+ * into three color bands; otherwise the color switches at every corner
+ * so adjacent splines share exactly one channel.
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static int glyph_msdf__color_contour(glyph_msdf__shape_t* shape, int first, int count) {
+    const float sin_threshold = 0.1411200081f; /* sin(3 rad), msdfgen's default angle threshold */
+    if (count <= 0) return 1;
+
+    /* Find corners: corner k sits at the start of edge corners[k] */
+    int corner_count = 0;
+    int first_corner = -1;
+    for (int i = 0; i < count; i++) {
+        float ax, ay, bx, by;
+        glyph_msdf__direction(&shape->edges[first + (i + count - 1) % count], 1, &ax, &ay);
+        glyph_msdf__direction(&shape->edges[first + i], 0, &bx, &by);
+        float la = sqrtf(ax * ax + ay * ay);
+        float lb = sqrtf(bx * bx + by * by);
+        if (la == 0.0f || lb == 0.0f) continue;
+        float dot = (ax * bx + ay * by) / (la * lb);
+        float cross = (ax * by - ay * bx) / (la * lb);
+        if (dot <= 0.0f || fabsf(cross) > sin_threshold) {
+            if (first_corner < 0) first_corner = i;
+            corner_count++;
+        }
+    }
+
+    glyph_msdf__edge_t* edges = shape->edges + first;
+    if (corner_count == 0) {
+        for (int i = 0; i < count; i++) edges[i].color = GLYPH_MSDF__WHITE;
+        return 1;
+    }
+
+    if (corner_count == 1) {
+        /* Teardrop: magenta, white and yellow bands starting at the corner */
+        static const int bands[3] = {GLYPH_MSDF__MAGENTA, GLYPH_MSDF__WHITE, GLYPH_MSDF__YELLOW};
+        if (count >= 3) {
+            for (int i = 0; i < count; i++) {
+                edges[(first_corner + i) % count].color = bands[i * 3 / count];
+            }
+            return 1;
+        }
+
+        /* One or two edges: split each into thirds so every band gets an edge */
+        glyph_msdf__edge_t parts[6];
+        for (int i = 0; i < count; i++) glyph_msdf__split_thirds(&edges[(first_corner + i) % count], parts + 3 * i);
+        int num_parts = 3 * count;
+        for (int i = 0; i < num_parts; i++) parts[i].color = bands[i * 3 / num_parts];
+
+        /* Replace the contour's edges (it is the last one pushed) */
+        shape->count = first;
+        for (int i = 0; i < num_parts; i++) {
+            if (!glyph_msdf__push(shape, parts[i].quadratic, parts[i].x0, parts[i].y0, parts[i].x1, parts[i].y1, parts[i].x2, parts[i].y2)) return 0;
+            shape->edges[shape->count - 1].color = parts[i].color;
+        }
+        return 1;
+    }
+
+    /* Several corners: alternate cyan/magenta per spline, yellow closes an odd cycle */
+    int spline = -1;
+    for (int i = 0; i < count; i++) {
+        int idx = (first_corner + i) % count;
+        float ax, ay, bx, by;
+        glyph_msdf__direction(&edges[(idx + count - 1) % count], 1, &ax, &ay);
+        glyph_msdf__direction(&edges[idx], 0, &bx, &by);
+        float la = sqrtf(ax * ax + ay * ay);
+        float lb = sqrtf(bx * bx + by * by);
+        if (la != 0.0f && lb != 0.0f) {
+            float dot = (ax * bx + ay * by) / (la * lb);
+            float cross = (ax * by - ay * bx) / (la * lb);
+            if (dot <= 0.0f || fabsf(cross) > sin_threshold) spline++;
+        }
+        int color = (spline % 2 == 0) ? GLYPH_MSDF__CYAN : GLYPH_MSDF__MAGENTA;
+        if ((corner_count & 1) && spline == corner_count - 1) color = GLYPH_MSDF__YELLOW;
+        edges[idx].color = color;
+    }
+    return 1;
+}
+
+/*
+ * Solves a*t^2 + b*t + c = 0
+ *
+ * Returns: Number of real roots written to t (0-2)
+ */
+static int glyph_msdf__solve_quadratic(float* t, float a, float b, float c) {
+    if (fabsf(a) < 1e-12f) {
+        if (fabsf(b) < 1e-12f) return 0;
+        t[0] = -c / b;
+        return 1;
+    }
+    float disc = b * b - 4.0f * a * c;
+    if (disc > 0.0f) {
+        disc = sqrtf(disc);
+        t[0] = (-b + disc) / (2.0f * a);
+        t[1] = (-b - disc) / (2.0f * a);
+        return 2;
+    }
+    if (disc == 0.0f) {
+        t[0] = -b / (2.0f * a);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Solves a*t^3 + b*t^2 + c*t + d = 0 (Cardano / trigonometric method)
+ *
+ * Returns: Number of real roots written to t (0-3)
+ */
+static int glyph_msdf__solve_cubic(float* t, float a, float b, float c, float d) {
+    if (fabsf(a) < 1e-6f * (fabsf(b) + fabsf(c) + fabsf(d)) || a == 0.0f) return glyph_msdf__solve_quadratic(t, b, c, d);
+
+    double A = b / (double)a, B = c / (double)a, C = d / (double)a;
+    double A2 = A * A;
+    double q = (A2 - 3.0 * B) / 9.0;
+    double r = (A * (2.0 * A2 - 9.0 * B) + 27.0 * C) / 54.0;
+    double r2 = r * r;
+    double q3 = q * q * q;
+    A /= 3.0;
+    if (r2 < q3) {
+        double ratio = r / sqrt(q3);
+        if (ratio < -1.0) ratio = -1.0;
+        if (ratio > 1.0) ratio = 1.0;
+        double theta = acos(ratio);
+        double m = -2.0 * sqrt(q);
+        t[0] = (float)(m * cos(theta / 3.0) - A);
+        t[1] = (float)(m * cos((theta + 2.0 * 3.14159265358979323846) / 3.0) - A);
+        t[2] = (float)(m * cos((theta - 2.0 * 3.14159265358979323846) / 3.0) - A);
+        return 3;
+    }
+    double u = (r < 0.0 ? 1.0 : -1.0) * pow(fabs(r) + sqrt(r2 - q3), 1.0 / 3.0);
+    double v = u == 0.0 ? 0.0 : q / u;
+    t[0] = (float)((u + v) - A);
+    if (u == v || fabs(u - v) < 1e-12 * fabs(u + v)) {
+        t[1] = (float)(-0.5 * (u + v) - A);
+        return 2;
+    }
+    return 1;
+}
+
+/* Cross product sign that never returns 0 (keeps ties consistent) */
+static float glyph_msdf__sign(float v) {
+    return v > 0.0f ? 1.0f : -1.0f;
+}
+
+/*
+ * Signed distance from (px, py) to an edge
+ *
+ * The sign is positive on the left of the edge direction (outside for
+ * TrueType's clockwise outer contours once Y points down).
+ */
+static void glyph_msdf__edge_distance(const glyph_msdf__edge_t* e, float px, float py, glyph_msdf__hit_t* hit) {
+    if (!e->quadratic) {
+        float abx = e->x2 - e->x0, aby = e->y2 - e->y0;
+        float aqx = px - e->x0, aqy = py - e->y0;
+        float len2 = abx * abx + aby * aby;
+        float param = (aqx * abx + aqy * aby) / len2;
+        /* Nearer end point, or the perpendicular foot when it lies on the segment */
+        float ex = param > 0.5f ? e->x2 : e->x0;
+        float ey = param > 0.5f ? e->y2 : e->y0;
+        float eqx = ex - px, eqy = ey - py;
+        float end_distance = sqrtf(eqx * eqx + eqy * eqy);
+        if (param > 0.0f && param < 1.0f) {
+            float ortho = (aqx * aby - aqy * abx) / sqrtf(len2);
+            if (fabsf(ortho) < end_distance) {
+                hit->distance = ortho;
+                hit->dot = 0.0f;
+                hit->param = param;
+                return;
+            }
+        }
+        float cross = aqx * aby - aqy * abx;
+        float len = sqrtf(len2);
+        hit->distance = glyph_msdf__sign(cross) * end_distance;
+        hit->dot = end_distance > 0.0f ? fabsf((abx * eqx + aby * eqy) / (len * end_distance)) : 0.0f;
+        hit->param = param;
+        return;
+    }
+
+    /* Quadratic: nearest point solves dot(B(t) - P, B'(t)) = 0, a cubic in t */
+    float qax = e->x0 - px, qay = e->y0 - py;
+    float abx = e->x1 - e->x0, aby = e->y1 - e->y0;
+    float brx = e->x2 - e->x1 - abx, bry = e->y2 - e->y1 - aby;
+    float a = brx * brx + bry * bry;
+    float b = 3.0f * (abx * brx + aby * bry);
+    float c = 2.0f * (abx * abx + aby * aby) + (qax * brx + qay * bry);
+    float d = qax * abx + qay * aby;
+    float roots[3];
+    int num_roots = glyph_msdf__solve_cubic(roots, a, b, c, d);
+
+    /* Start point */
+    float dx0, dy0;
+    glyph_msdf__direction(e, 0, &dx0, &dy0);
+    float best = sqrtf(qax * qax + qay * qay);
+    float distance = glyph_msdf__sign(dx0 * qay - dy0 * qax) * best;
+    float param = -(qax * dx0 + qay * dy0) / (dx0 * dx0 + dy0 * dy0);
+    /* End point */
+    float dx1, dy1;
+    glyph_msdf__direction(e, 1, &dx1, &dy1);
+    float qbx = e->x2 - px, qby = e->y2 - py;
+    float end_distance = sqrtf(qbx * qbx + qby * qby);
+    if (end_distance < best) {
+        best = end_distance;
+        distance = glyph_msdf__sign(dx1 * qby - dy1 * qbx) * end_distance;
+        param = 1.0f + (-(qbx * dx1 + qby * dy1)) / (dx1 * dx1 + dy1 * dy1);
+    }
+    /* Interior stationary points */
+    for (int i = 0; i < num_roots; i++) {
+        float t = roots[i];
+        if (t <= 0.0f || t >= 1.0f) continue;
+        float qex = qax + 2.0f * t * abx + t * t * brx;
+        float qey = qay + 2.0f * t * aby + t * t * bry;
+        float dist = sqrtf(qex * qex + qey * qey);
+        if (dist <= best) {
+            float tx = abx + t * brx, ty = aby + t * bry;
+            best = dist;
+            distance = glyph_msdf__sign(tx * qey - ty * qex) * dist;
+            param = t;
+        }
+    }
+
+    hit->distance = distance;
+    hit->param = param;
+    if (param >= 0.0f && param <= 1.0f) {
+        hit->dot = 0.0f;
+    } else {
+        float dx = param < 0.5f ? dx0 : dx1, dy = param < 0.5f ? dy0 : dy1;
+        float qx = param < 0.5f ? qax : qbx, qy = param < 0.5f ? qay : qby;
+        float l = sqrtf(dx * dx + dy * dy) * best;
+        hit->dot = l > 0.0f ? fabsf((dx * qx + dy * qy) / l) : 0.0f;
+    }
+}
+
+/*
+ * Converts a nearest-edge distance into a pseudo-distance
+ *
+ * Beyond an edge's end points the distance to the tangent line extension
+ * is used instead, which keeps corners sharp.
+ */
+static float glyph_msdf__pseudo_distance(const glyph_msdf__edge_t* e, const glyph_msdf__hit_t* hit, float px, float py) {
+    float distance = hit->distance;
+    if (hit->param < 0.0f) {
+        float dx, dy;
+        glyph_msdf__direction(e, 0, &dx, &dy);
+        float len = sqrtf(dx * dx + dy * dy);
+        float aqx = px - e->x0, aqy = py - e->y0;
+        if ((aqx * dx + aqy * dy) < 0.0f) {
+            float pseudo = (aqx * dy - aqy * dx) / len;
+            if (fabsf(pseudo) <= fabsf(distance)) distance = pseudo;
+        }
+    } else if (hit->param > 1.0f) {
+        float dx, dy;
+        glyph_msdf__direction(e, 1, &dx, &dy);
+        float len = sqrtf(dx * dx + dy * dy);
+        float bqx = px - e->x2, bqy = py - e->y2;
+        if ((bqx * dx + bqy * dy) > 0.0f) {
+            float pseudo = (bqx * dy - bqy * dx) / len;
+            if (fabsf(pseudo) <= fabsf(distance)) distance = pseudo;
+        }
+    }
+    return distance;
+}
+
+/* Orders hits by |distance|, breaking near-ties by the more perpendicular edge */
+static int glyph_msdf__closer(const glyph_msdf__hit_t* a, const glyph_msdf__hit_t* b) {
+    if (b->edge < 0) return 1;
+    float da = fabsf(a->distance), db = fabsf(b->distance);
+    if (fabsf(da - db) > 1e-5f) return da < db;
+    return a->dot < b->dot;
+}
+
+/* Median of three values */
+static float glyph_msdf__median(float a, float b, float c) {
+    return fmaxf(fminf(a, b), fminf(fmaxf(a, b), c));
+}
+
+/*
+ * Returns non-zero when two neighboring texels would interpolate to a
+ * false edge (msdfgen's clash test); only the texel farther from the
+ * shape edge is flagged
+ */
+static int glyph_msdf__clash(const float* a, const float* b, float threshold) {
+    float a0 = a[0], a1 = a[1], a2 = a[2];
+    float b0 = b[0], b1 = b[1], b2 = b[2];
+    float tmp;
+    /* Sort channel pairs by decreasing difference */
+    if (fabsf(b0 - a0) < fabsf(b1 - a1)) {
+        tmp = a0; a0 = a1; a1 = tmp;
+        tmp = b0; b0 = b1; b1 = tmp;
+    }
+    if (fabsf(b1 - a1) < fabsf(b2 - a2)) {
+        tmp = a1; a1 = a2; a2 = tmp;
+        tmp = b1; b1 = b2; b2 = tmp;
+        if (fabsf(b0 - a0) < fabsf(b1 - a1)) {
+            tmp = a0; a0 = a1; a1 = tmp;
+            tmp = b0; b0 = b1; b1 = tmp;
+        }
+    }
+    return fabsf(b1 - a1) >= threshold && !(b0 == b1 && b0 == b2) && fabsf(a2 - 0.5f) >= fabsf(b2 - 0.5f);
+}
+
+/*
+ * Generates a multi-channel SDF for a glyph directly from its outline
+ *
+ * Parameters:
+ *   font: Font structure
+ *   glyph_index: Glyph to convert
+ *   scale_x, scale_y: Font units to pixel scale factors
+ *   spread: Distance in pixels mapped to the ends of the 0-255 range; also
+ *           the border added on every side of the glyph box
+ *   width, height: Receive the bitmap size (glyph box plus 2 * spread)
+ *   xoff, yoff: Receive the bitmap's left and top edges relative to the pen (Y up)
+ *   scratch: Working memory reused across calls (the outline, edges, coverage
+ *            and float field go to its temp arena), or NULL for heap temporaries
+ *
+ * Returns: RGB bitmap (3 bytes per pixel) allocated from scratch->allocator
+ *          (GLYPH_MALLOC without one), or NULL for empty glyphs and on
+ *          failure. As in single-channel SDFs, the median of the channels is
+ *          above 127.5 inside the glyph
+ */
+static inline unsigned char* glyph_msdf_get_glyph_bitmap_ex(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int spread,
+                                                            int* width, int* height, int* xoff, int* yoff, glyph_raster_scratch_t* scratch) {
+    *width = 0;
+    *height = 0;
+    *xoff = 0;
+    *yoff = 0;
+    if (spread < 1) spread = 1;
+
+    glyph_allocator_t temp;
+    const glyph_allocator_t* temp_allocator = glyph_ttf__scratch_temp(scratch, &temp);
+    const glyph_allocator_t* output = scratch ? scratch->allocator : NULL;
+
+    glyph_ttf__outline_t outline;
+    if (!glyph_ttf__load_outline(font, glyph_index, scale_x, scale_y, &outline, temp_allocator)) return NULL;
+
+    /* Edge list with colors, contour by contour */
+    glyph_msdf__shape_t shape;
+    memset(&shape, 0, sizeof(shape));
+    shape.allocator = temp_allocator;
+    int ok = 1;
+    for (int c = 0; c < outline.num_contours && ok; c++) {
+        if (!outline.contours[c]) continue;
+        int first = shape.count;
+        ok = glyph_msdf__add_contour(&shape, outline.contours[c], outline.contour_sizes[c]) &&
+             glyph_msdf__color_contour(&shape, first, shape.count - first);
+    }
+
+    /* Coverage of the same outline, used to fix the sign where edge distances disagree with the fill */
+    int gw = outline.width, gh = outline.height;
+    unsigned char* coverage = ok ? (unsigned char*)glyph__alloc(temp_allocator, (size_t)gw * gh) : NULL;
+    if (coverage && !glyph_ttf__rasterize_shape(coverage, gw, gh, outline.contours, outline.contour_sizes, outline.num_contours, scratch)) {
+        glyph__free(temp_allocator, coverage);
+        coverage = NULL;
+    }
+
+    int w = gw + 2 * spread;
+    int h = gh + 2 * spread;
+    float* field = ok && coverage ? (float*)glyph__alloc(temp_allocator, (size_t)w * h * 3 * sizeof(float)) : NULL;
+    unsigned char* bitmap = field ? (unsigned char*)glyph__alloc(output, (size_t)w * h * 3) : NULL;
+    if (!bitmap || shape.count == 0) {
+        glyph__free(output, bitmap);
+        glyph__free(temp_allocator, field);
+        glyph__free(temp_allocator, coverage);
+        glyph__free(temp_allocator, shape.edges);
+        glyph_ttf__free_outline(&outline);
+        return NULL;
+    }
+
+    float range = 2.0f * spread;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            /* Sample at the pixel center, in outline space */
+            float px = x - spread + 0.5f;
+            float py = y - spread + 0.5f;
+
+            glyph_msdf__hit_t best[3];
+            for (int ch = 0; ch < 3; ch++) best[ch].edge = -1;
+            for (int i = 0; i < shape.count; i++) {
+                glyph_msdf__hit_t hit;
+                glyph_msdf__edge_distance(&shape.edges[i], px, py, &hit);
+                hit.edge = i;
+                for (int ch = 0; ch < 3; ch++) {
+                    if ((shape.edges[i].color & (1 << ch)) && glyph_msdf__closer(&hit, &best[ch])) best[ch] = hit;
+                }
+            }
+
+            float* texel = field + ((size_t)y * w + x) * 3;
+            for (int ch = 0; ch < 3; ch++) {
+                float distance = best[ch].edge >= 0 ? glyph_msdf__pseudo_distance(&shape.edges[best[ch].edge], &best[ch], px, py) : 1e6f;
+                /* Positive-outside distance to 0..1 with the inside above 0.5 */
+                texel[ch] = -distance / range + 0.5f;
+            }
+
+            /* The rasterized fill decides inside/outside where it is unambiguous: fully */
+            /* covered or empty pixels whose field is more than a pixel on the wrong side */
+            /* (closer disagreements are just the rasterizer's own edge antialiasing) */
+            int gx = x - spread, gy = y - spread;
+            int a = (gx >= 0 && gx < gw && gy >= 0 && gy < gh) ? coverage[gy * gw + gx] : 0;
+            float median = glyph_msdf__median(texel[0], texel[1], texel[2]);
+            if ((a == 255 && median < 0.5f - 1.0f / range) || (a == 0 && median > 0.5f + 1.0f / range)) {
+                for (int ch = 0; ch < 3; ch++) texel[ch] = 1.0f - texel[ch];
+            }
+        }
+    }
+
+    /* Equalize texels whose channel clashes would produce artifacts between neighbors */
+    float threshold = 1.001f / range;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            float* texel = field + ((size_t)y * w + x) * 3;
+            if ((x > 0 && glyph_msdf__clash(texel, texel - 3, threshold)) ||
+                (x < w - 1 && glyph_msdf__clash(texel, texel + 3, threshold)) ||
+                (y > 0 && glyph_msdf__clash(texel, texel - (size_t)w * 3, threshold)) ||
+                (y < h - 1 && glyph_msdf__clash(texel, texel + (size_t)w * 3, threshold))) {
+                bitmap[((size_t)y * w + x) * 3] = 1; /* Mark; resolved below so later tests see original values */
+            } else {
+                bitmap[((size_t)y * w + x) * 3] = 0;
+            }
+        }
+    }
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        float* texel = field + i * 3;
+        if (bitmap[i * 3]) {
+            float median = glyph_msdf__median(texel[0], texel[1], texel[2]);
+            texel[0] = texel[1] = texel[2] = median;
+        }
+        for (int ch = 0; ch < 3; ch++) {
+            float v = texel[ch] * 255.0f + 0.5f;
+            bitmap[i * 3 + ch] = (unsigned char)(v <= 0.0f ? 0.0f : (v >= 255.0f ? 255.0f : v));
+        }
+    }
+
+    glyph__free(temp_allocator, field);
+    glyph__free(temp_allocator, coverage);
+    glyph__free(temp_allocator, shape.edges);
+    glyph_ttf__free_outline(&outline);
+
+    *width = w;
+    *height = h;
+    *xoff = outline.xoff - spread;
+    *yoff = outline.yoff + spread;
+    return bitmap;
+}
+
+/* Generates a multi-channel SDF with heap temporaries (see glyph_msdf_get_glyph_bitmap_ex) */
+static inline unsigned char* glyph_msdf_get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int spread,
+                                                         int* width, int* height, int* xoff, int* yoff) {
+    return glyph_msdf_get_glyph_bitmap_ex(font, glyph_index, scale_x, scale_y, spread, width, height, xoff, yoff, NULL);
+}
+
+#endif
@@ -0,0 +1,369 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 Darek
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Threading Module for GlyphGL
+ *
+ * This module provides the small amount of threading GlyphGL needs to spread
+ * CPU-heavy work (glyph rasterization, SDF generation) across cores:
+ * - A job callback signature shared by the built-in pool and user job systems
+ * - A fork/join worker pool built on pthreads (POSIX) or Win32 threads
+ * - Joinable background threads and the few atomics needed to poll them
+ * - Hardware concurrency detection
+ *
+ * Define GLYPHGL_NO_THREADS to compile the built-in pool out. Jobs then run
+ * serially on the calling thread, background threads fail to start (so
+ * callers run the work inline), while user-supplied dispatch callbacks
+ * keep working.
+ */
+
+#ifndef __GLYPH_THREAD_H
+#define __GLYPH_THREAD_H
+
+#include "glyph_util.h"
+
+#ifndef GLYPHGL_NO_THREADS
+    #if defined(_WIN32) || defined(_WIN64)
+        #include <windows.h>
+    #else
+        #include <pthread.h>
+        #include <sched.h>
+        #include <unistd.h>
+    #endif
+#endif
+
+/*
+ * Job callback executed once per job index
+ *
+ * Parameters:
+ *   context: Opaque pointer shared by every job of a batch
+ *   job_index: Index of the job to run, in [0, job_count)
+ *   worker_index: Index of the worker running the job, in [0, worker_count);
+ *                 jobs sharing a worker_index never run concurrently, so it can
+ *                 select per-worker scratch memory
+ */
+typedef void (*glyph_job_fn)(void* context, int job_index, int worker_index);
+
+/*
+ * User-supplied dispatcher for integrating an external job system
+ *
+ * Must call job(context, i, worker) exactly once for every i in [0, job_count)
+ * with worker in [0, worker_count), and return only after all calls finished.
+ *
+ * Parameters:
+ *   user_data: Pointer registered alongside the dispatcher
+ *   job: Job callback to execute
+ *   context: Context pointer to forward to the job callback
+ *   job_count: Number of jobs in the batch
+ *   worker_count: Number of distinct worker indices the caller prepared for
+ */
+typedef void (*glyph_job_dispatch_fn)(void* user_data, glyph_job_fn job, void* context, int job_count, int worker_count);
+
+/*
+ * Returns the number of logical processors available to the process
+ *
+ * Returns: Processor count (at least 1; always 1 with GLYPHGL_NO_THREADS)
+ */
+static inline int glyph_thread_hardware_concurrency(void) {
+#if defined(GLYPHGL_NO_THREADS)
+    return 1;
+#elif defined(_WIN32) || defined(_WIN64)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/* Shared state for one fork/join batch */
+typedef struct {
+    glyph_job_fn job;           /* Job callback */
+    void* context;              /* Forwarded job context */
+    int job_count;              /* Total number of jobs */
+    volatile long next_job;     /* Next unclaimed job index (atomically incremented) */
+} glyph_thread__batch_t;
+
+/* Per-thread launch parameters */
+typedef struct {
+    glyph_thread__batch_t* batch;  /* Batch being processed */
+    int worker_index;              /* Worker index handed to the job callback */
+} glyph_thread__worker_t;
+
+/*
+ * Atomically claims the next job index of a batch
+ *
+ * Returns: Claimed job index (may be >= job_count when the batch is drained)
+ */
+static inline long glyph_thread__claim(glyph_thread__batch_t* batch) {
+#if defined(GLYPHGL_NO_THREADS)
+    return batch->next_job++;
+#elif defined(_MSC_VER)
+    return InterlockedIncrement(&batch->next_job) - 1;
+#else
+    return __sync_fetch_and_add(&batch->next_job, 1);
+#endif
+}
+
+/*
+ * Worker loop: claims and runs jobs until the batch is drained
+ */
+static inline void glyph_thread__work(glyph_thread__worker_t* worker) {
+    glyph_thread__batch_t* batch = worker->batch;
+    for (;;) {
+        long i = glyph_thread__claim(batch);
+        if (i >= batch->job_count) break;
+        batch->job(batch->context, (int)i, worker->worker_index);
+    }
+}
+
+#ifndef GLYPHGL_NO_THREADS
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI glyph_thread__entry(LPVOID param) {
+    glyph_thread__work((glyph_thread__worker_t*)param);
+    return 0;
+}
+#else
+static void* glyph_thread__entry(void* param) {
+    glyph_thread__work((glyph_thread__worker_t*)param);
+    return NULL;
+}
+#endif
+#endif
+
+/*
+ * Runs a batch of jobs across a temporary pool of worker threads
+ *
+ * The calling thread participates as worker 0 and the function returns once
+ * every job has completed. If a thread cannot be created, its share of the
+ * work is absorbed by the remaining workers, so the batch always finishes.
+ *
+ * Parameters:
+ *   num_threads: Total worker count including the caller (<= 1 runs serially)
+ *   job: Job callback
+ *   context: Context pointer forwarded to every job
+ *   job_count: Number of jobs to run
+ */
+static inline void glyph_thread_run_jobs(int num_threads, glyph_job_fn job, void* context, int job_count) {
+    glyph_thread__batch_t batch;
+    batch.job = job;
+    batch.context = context;
+    batch.job_count = job_count;
+    batch.next_job = 0;
+
+    if (num_threads > job_count) num_threads = job_count;
+
+#ifndef GLYPHGL_NO_THREADS
+    if (num_threads > 1) {
+        glyph_thread__worker_t* workers = (glyph_thread__worker_t*)GLYPH_MALLOC(num_threads * sizeof(glyph_thread__worker_t));
+#if defined(_WIN32) || defined(_WIN64)
+        HANDLE* threads = (HANDLE*)GLYPH_MALLOC(num_threads * sizeof(HANDLE));
+#else
+        pthread_t* threads = (pthread_t*)GLYPH_MALLOC(num_threads * sizeof(pthread_t));
+#endif
+        int* started = (int*)GLYPH_MALLOC(num_threads * sizeof(int));
+        if (workers && threads && started) {
+            /* Spawn helpers 1..n-1, the caller works as worker 0 */
+            for (int t = 0; t < num_threads; t++) {
+                workers[t].batch = &batch;
+                workers[t].worker_index = t;
+                started[t] = 0;
+            }
+            for (int t = 1; t < num_threads; t++) {
+#if defined(_WIN32) || defined(_WIN64)
+                threads[t] = CreateThread(NULL, 0, glyph_thread__entry, &workers[t], 0, NULL);
+                started[t] = threads[t] != NULL;
+#else
+                started[t] = pthread_create(&threads[t], NULL, glyph_thread__entry, &workers[t]) == 0;
+#endif
+            }
+            glyph_thread__work(&workers[0]);
+
+            /* Join all helpers before the batch goes out of scope */
+            for (int t = 1; t < num_threads; t++) {
+                if (!started[t]) continue;
+#if defined(_WIN32) || defined(_WIN64)
+                WaitForSingleObject(threads[t], INFINITE);
+                CloseHandle(threads[t]);
+#else
+                pthread_join(threads[t], NULL);
+#endif
+            }
+            GLYPH_FREE(started);
+            GLYPH_FREE(threads);
+            GLYPH_FREE(workers);
+            return;
+        }
+        GLYPH_FREE(started);
+        GLYPH_FREE(threads);
+        GLYPH_FREE(workers);
+    }
+#endif
+
+    /* Serial fallback on the calling thread */
+    glyph_thread__worker_t self;
+    self.batch = &batch;
+    self.worker_index = 0;
+    glyph_thread__work(&self);
+}
+
+/*
+ * Atomically reads a value shared between threads
+ *
+ * Returns: Current value, with acquire/release ordering against the writer
+ */
+static inline long glyph_thread_atomic_load(volatile long* value) {
+#if defined(GLYPHGL_NO_THREADS)
+    return *value;
+#elif defined(_MSC_VER)
+    return InterlockedCompareExchange(value, 0, 0);
+#else
+    return __sync_fetch_and_add(value, 0);
+#endif
+}
+
+/* Atomically writes a value shared between threads (full barrier) */
+static inline void glyph_thread_atomic_store(volatile long* value, long desired) {
+#if defined(GLYPHGL_NO_THREADS)
+    *value = desired;
+#elif defined(_MSC_VER)
+    InterlockedExchange(value, desired);
+#else
+    __sync_synchronize();
+    (void)__sync_lock_test_and_set(value, desired);
+#endif
+}
+
+/*
+ * Atomically replaces a value if it still holds the expected one
+ *
+ * Returns: 1 if the value was replaced, 0 if another thread changed it first
+ */
+static inline int glyph_thread_atomic_cas(volatile long* value, long expected, long desired) {
+#if defined(GLYPHGL_NO_THREADS)
+    if (*value != expected) return 0;
+    *value = desired;
+    return 1;
+#elif defined(_MSC_VER)
+    return InterlockedCompareExchange(value, desired, expected) == expected;
+#else
+    return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+}
+
+/* Gives the rest of the calling thread's time slice to other threads */
+static inline void glyph_thread_yield(void) {
+#if defined(GLYPHGL_NO_THREADS)
+#elif defined(_WIN32) || defined(_WIN64)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/* Entry point of a thread started with glyph_thread_start */
+typedef void (*glyph_thread_fn)(void* arg);
+
+/*
+ * Joinable thread handle
+ *
+ * Must stay at the same address from glyph_thread_start until
+ * glyph_thread_join returns.
+ */
+typedef struct {
+#ifndef GLYPHGL_NO_THREADS
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE handle;              /* Win32 thread */
+#else
+    pthread_t handle;           /* POSIX thread */
+#endif
+#endif
+    glyph_thread_fn fn;         /* Function run by the thread */
+    void* arg;                  /* Argument forwarded to fn */
+    int started;                /* 1 while the thread exists and has not been joined */
+} glyph_thread_t;
+
+#ifndef GLYPHGL_NO_THREADS
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI glyph_thread__start_entry(LPVOID param) {
+    glyph_thread_t* thread = (glyph_thread_t*)param;
+    thread->fn(thread->arg);
+    return 0;
+}
+#else
+static void* glyph_thread__start_entry(void* param) {
+    glyph_thread_t* thread = (glyph_thread_t*)param;
+    thread->fn(thread->arg);
+    return NULL;
+}
+#endif
+#endif
+
+/*
+ * Runs a function on a new thread
+ *
+ * Parameters:
+ *   thread: Handle to fill in (join it with glyph_thread_join)
+ *   fn: Function to run
+ *   arg: Argument forwarded to fn
+ *
+ * Returns: 1 if the thread started, 0 if it could not be created (always 0
+ *          with GLYPHGL_NO_THREADS); fn has not run in that case
+ */
+static inline int glyph_thread_start(glyph_thread_t* thread, glyph_thread_fn fn, void* arg) {
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->started = 0;
+#if defined(GLYPHGL_NO_THREADS)
+    return 0;
+#elif defined(_WIN32) || defined(_WIN64)
+    thread->handle = CreateThread(NULL, 0, glyph_thread__start_entry, thread, 0, NULL);
+    thread->started = thread->handle != NULL;
+    return thread->started;
+#else
+    thread->started = pthread_create(&thread->handle, NULL, glyph_thread__start_entry, thread) == 0;
+    return thread->started;
+#endif
+}
+
+/*
+ * Waits for a thread started with glyph_thread_start to finish
+ *
+ * Parameters:
+ *   thread: Thread to join (ignored if it never started or was joined already)
+ */
+static inline void glyph_thread_join(glyph_thread_t* thread) {
+    if (!thread->started) return;
+#if defined(GLYPHGL_NO_THREADS)
+#elif defined(_WIN32) || defined(_WIN64)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    thread->started = 0;
+}
+
+#endif
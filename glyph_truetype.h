@@ -33,6 +33,53 @@
 
 #include "glyph_util.h"
 
+/* Font files are memory-mapped unless GLYPHGL_NO_MMAP is defined (then read into the heap) */
+#ifndef GLYPHGL_NO_MMAP
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif
+
+/* SIMD coverage accumulation (define GLYPHGL_NO_SIMD to force the scalar path) */
+#ifndef GLYPHGL_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GLYPH_TTF__SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GLYPH_TTF__NEON 1
+#endif
+#endif
+
+/* Codepoints [0, GLYPHGL_GLYPH_INDEX_CACHE) get a dense codepoint -> glyph table built in glyph_ttf_init */
+/* (2 bytes each, 128 KB for the default BMP range; define as 0 to always search the cmap) */
+#ifndef GLYPHGL_GLYPH_INDEX_CACHE
+#ifdef GLYPHGL_MINIMAL
+#define GLYPHGL_GLYPH_INDEX_CACHE 0
+#else
+#define GLYPHGL_GLYPH_INDEX_CACHE 0x10000
+#endif
+#endif
+
+/* Ownership of glyph_font_t.data, decides what glyph_ttf_free_font does with it */
+#define GLYPH_TTF_DATA_BORROWED 0  /* Caller-owned (glyph_ttf_load_font_from_memory), never freed */
+#define GLYPH_TTF_DATA_HEAP     1  /* Allocated with GLYPH_MALLOC, freed with GLYPH_FREE */
+#define GLYPH_TTF_DATA_MAPPED   2  /* Read-only file mapping, unmapped on free */
+
+/* Cache of decoded glyph outlines (see glyph_ttf_cache_components, glyph_ttf_cache_outline) */
+typedef struct glyph_ttf_outline_cache_t glyph_ttf_outline_cache_t;
+
+/* GPOS pair adjustment subtable of the 'kern' feature */
+typedef struct {
+    unsigned int offset;  /* Absolute offset of the PairPos subtable in the font data */
+    int lookup;           /* Owning lookup index: only its first subtable defining a pair applies */
+} glyph_ttf_kern_subtable_t;
+
 /*
  * TrueType font structure containing all parsed font data and metadata
  *
@@ -41,13 +88,20 @@
  * It's initialized by glyph_ttf_init() and used throughout the rendering pipeline.
  */
 typedef struct {
-    unsigned char* data;           /* Raw font file data in memory */
+    unsigned char* data;           /* Raw font file data in memory (heap, mapped file or caller-owned) */
+    size_t data_size;              /* Bytes available at data (0 if unknown) */
+    int data_source;               /* GLYPH_TTF_DATA_* ownership of data */
     int fontstart;                 /* Offset to font data in file (for collections) */
     int numGlyphs;                 /* Total number of glyphs in the font */
     int loca, head, glyf, hhea, hmtx, kern, gpos, cmap;  /* Offsets to TrueType tables */
     int index_map;                 /* Offset to character-to-glyph mapping */
     int indexToLocFormat;          /* Format of loca table (short/long offsets) */
     float scale;                   /* Current font scale factor */
+    glyph_ttf_outline_cache_t* outline_cache; /* Decoded composite components (NULL until cached), owned by the font */
+    unsigned short* glyph_cache;   /* Dense codepoint -> glyph index table (NULL if disabled), owned by the font */
+    int glyph_cache_size;          /* Codepoints covered by glyph_cache */
+    glyph_ttf_kern_subtable_t* kern_subtables; /* GPOS kerning subtables (NULL if none), owned by the font */
+    int num_kern_subtables;        /* Entries in kern_subtables */
 } glyph_font_t;
 
 /*
@@ -73,6 +127,43 @@ typedef struct {
     int on_curve;                 /* 1 if on curve, 0 if control point */
 } glyph_point_t;
 
+/*
+ * Reusable working memory for glyph rasterization
+ *
+ * Zero-initialize before first use; the buffer grows to the largest glyph
+ * seen and is released with glyph_raster_scratch_free. Decoded outlines
+ * and other per-glyph temporaries live in the temp arena, which is rewound
+ * on every call instead of freeing them one by one. Set allocator before
+ * first use to take all of this memory, and the returned bitmaps, from it.
+ * One scratch must not be shared by threads rasterizing concurrently.
+ */
+typedef struct {
+    float* accum;                 /* Signed area deltas, (width + 1) per row */
+    size_t capacity;              /* Floats allocated in accum */
+    const glyph_allocator_t* allocator; /* Source of all memory (NULL = GLYPH_MALLOC) */
+    glyph_arena_t temp;           /* Per-call temporaries, rewound on every call */
+} glyph_raster_scratch_t;
+
+/*
+ * Reusable working memory for SDF generation
+ *
+ * Zero-initialize before first use; buffers grow to the largest glyph seen
+ * and are released with glyph_sdf_scratch_free. Set allocator before first
+ * use to take the buffers and the returned fields from it. One scratch
+ * must not be shared by threads generating SDFs concurrently.
+ */
+typedef struct {
+    const glyph_allocator_t* allocator; /* Source of all memory (NULL = GLYPH_MALLOC) */
+    float* outer;                 /* Squared distances to the glyph interior */
+    float* inner;                 /* Squared distances to the glyph exterior */
+    size_t grid_capacity;         /* Floats allocated in outer and inner */
+    float* f;                     /* 1D transform input line */
+    float* d;                     /* 1D transform output line */
+    float* z;                     /* Parabola boundaries (line length + 1) */
+    int* v;                       /* Parabola vertex positions */
+    int line_capacity;            /* Line length allocated in f, d, v (z holds one more) */
+} glyph_sdf_scratch_t;
+
 /*
  * Public API functions for TrueType font processing
  */
@@ -80,10 +171,17 @@ static inline int glyph_ttf_init(glyph_font_t* font, const unsigned char* data,
 static inline int glyph_ttf_find_glyph_index(const glyph_font_t* font, int codepoint);
 static inline void glyph_ttf_get_glyph_bbox(const glyph_font_t* font, int glyph_index, glyph_bbox_t* bbox);
 static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int* width, int* height, int* xoff, int* yoff);
+static inline unsigned char* glyph_ttf_get_glyph_bitmap_ex(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int* width, int* height, int* xoff, int* yoff, glyph_raster_scratch_t* scratch);
+static inline void glyph_raster_scratch_free(glyph_raster_scratch_t* scratch);
 static inline void glyph_ttf_free_bitmap(unsigned char* bitmap);
 static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitmap, int w, int h, int spread);
+static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap_ex(const unsigned char* bitmap, int w, int h, int spread, int padding, glyph_sdf_scratch_t* scratch);
+static inline void glyph_sdf_scratch_free(glyph_sdf_scratch_t* scratch);
 static inline float glyph_ttf_scale_for_pixel_height(const glyph_font_t* font, float pixels);
 static inline int glyph_ttf_get_glyph_advance(const glyph_font_t* font, int glyph_index);
+static inline int glyph_ttf_cache_components(glyph_font_t* font, int glyph_index);
+static inline int glyph_ttf_cache_outline(glyph_font_t* font, int glyph_index);
+static inline int glyph_ttf_get_glyph_kerning(const glyph_font_t* font, int left, int right);
 
 static int glyph_ttf__isfont(const unsigned char* font);
 static int glyph_ttf__find_table(const unsigned char* data, int fontstart, const char* tag);
@@ -91,9 +189,12 @@ static int glyph_ttf__get16(const unsigned char* data, int offset);
 static unsigned int glyph_ttf__get16u(const unsigned char* data, int offset);
 static int glyph_ttf__get32(const unsigned char* data, int offset);
 static int glyph_ttf__get_glyph_offset(const glyph_font_t* font, int glyph_index);
-static void glyph_ttf__rasterize_contour(unsigned char* bitmap, int w, int h, glyph_point_t* points, int n_points, float offset_x, float offset_y);
-static void glyph_ttf__draw_line_aa(float* accum, int w, int h, float x0, float y0, float x1, float y1);
-static void glyph_ttf__add_edge(float* accum, int w, int h, float x0, float y0, float x1, float y1);
+static int glyph_ttf__cache_components(glyph_font_t* font, int glyph_index, int depth);
+static void glyph_ttf__build_glyph_cache(glyph_font_t* font, int size);
+static void glyph_ttf__build_kern_subtables(glyph_font_t* font);
+static void glyph_ttf__add_line(float* accum, int w, int h, float x0, float y0, float x1, float y1);
+static void glyph_ttf__add_quad(float* accum, int w, int h, glyph_point_t p0, glyph_point_t p1, glyph_point_t p2);
+static void glyph_ttf__accumulate_row(const float* accum, unsigned char* out, int w);
 
 /*
  * Checks if the given data represents a valid TrueType/OpenType font
@@ -148,7 +249,14 @@ static int glyph_ttf__get32(const unsigned char* data, int offset) {
 
 static inline int glyph_ttf_init(glyph_font_t* font, const unsigned char* data, int offset) {
     font->data = (unsigned char*)data;
+    font->data_size = 0;
+    font->data_source = GLYPH_TTF_DATA_HEAP; /* Callers of glyph_ttf_init hand the buffer to the font */
     font->fontstart = offset;
+    font->outline_cache = NULL;
+    font->glyph_cache = NULL;
+    font->glyph_cache_size = 0;
+    font->kern_subtables = NULL;
+    font->num_kern_subtables = 0;
     if (!glyph_ttf__isfont(data + offset)) return 0;
 
     font->cmap = glyph_ttf__find_table(data, offset, "cmap");
@@ -183,13 +291,38 @@ static inline int glyph_ttf_init(glyph_font_t* font, const unsigned char* data,
     if (!index_map) return 0;
     font->index_map = index_map;
 
-    font->numGlyphs = glyph_ttf__get16u(data, font->hhea + 34);
+    /* maxp holds the glyph count; hhea only counts glyphs with their own advance */
+    int maxp = glyph_ttf__find_table(data, offset, "maxp");
+    font->numGlyphs = maxp ? (int)glyph_ttf__get16u(data, maxp + 4) : (int)glyph_ttf__get16u(data, font->hhea + 34);
+
+    glyph_ttf__build_glyph_cache(font, GLYPHGL_GLYPH_INDEX_CACHE);
+    glyph_ttf__build_kern_subtables(font);
     return 1;
 }
 
-static inline int glyph_ttf_find_glyph_index(const glyph_font_t* font, int codepoint) {
+/* Resolves a codepoint inside segment i of a format 4 subtable (start <= codepoint <= end) */
+static int glyph_ttf__format4_glyph(const unsigned char* data, int index_map, int segcount, int i, int start, int codepoint) {
+    int idDelta = index_map + 16 + segcount * 4;
+    int idRangeOffset = idDelta + segcount * 2;
+    int delta = glyph_ttf__get16(data, idDelta + i * 2);
+    int rangeOffset = glyph_ttf__get16u(data, idRangeOffset + i * 2);
+    if (rangeOffset == 0) return (codepoint + delta) & 0xFFFF;
+    int glyphIndex = glyph_ttf__get16u(data, idRangeOffset + i * 2 + rangeOffset + (codepoint - start) * 2);
+    return glyphIndex ? (glyphIndex + delta) & 0xFFFF : 0;
+}
+
+/*
+ * Maps a codepoint to a glyph index by searching the cmap subtable
+ *
+ * Format 4 segments and format 12/13 groups are sorted by codepoint, so
+ * both are binary-searched: O(log n) per lookup.
+ *
+ * Returns: Glyph index, or 0 (.notdef) if the font has no glyph for it
+ */
+static int glyph_ttf__search_glyph_index(const glyph_font_t* font, int codepoint) {
     const unsigned char* data = font->data;
     int index_map = font->index_map;
+    if (codepoint < 0) return 0;
     int format = glyph_ttf__get16u(data, index_map);
     if (format == 0) {
         int bytes = glyph_ttf__get16u(data, index_map + 2);
@@ -203,45 +336,518 @@ static inline int glyph_ttf_find_glyph_index(const glyph_font_t* font, int codep
             return glyph_ttf__get16u(data, index_map + 10 + (codepoint - first) * 2);
         return 0;
     } else if (format == 4) {
+        if (codepoint > 0xFFFF) return 0;
+        int segcount = glyph_ttf__get16u(data, index_map + 6) >> 1;
+        int endCount = index_map + 14;
+        int startCount = endCount + segcount * 2 + 2;
+        /* First segment whose end is at or past the codepoint */
+        int lo = 0, hi = segcount;
+        while (lo < hi) {
+            int mid = (lo + hi) >> 1;
+            if ((int)glyph_ttf__get16u(data, endCount + mid * 2) < codepoint) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == segcount) return 0;
+        int start = glyph_ttf__get16u(data, startCount + lo * 2);
+        if (codepoint < start) return 0;
+        return glyph_ttf__format4_glyph(data, index_map, segcount, lo, start, codepoint);
+    } else if (format == 12 || format == 13) {
+        int nGroups = glyph_ttf__get32(data, index_map + 12);
+        int groups = index_map + 16;
+        /* Last group starting at or before the codepoint */
+        int lo = 0, hi = nGroups;
+        while (lo < hi) {
+            int mid = (lo + hi) >> 1;
+            if (glyph_ttf__get32(data, groups + mid * 12) <= codepoint) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == 0) return 0;
+        int group = groups + (lo - 1) * 12;
+        int startCharCode = glyph_ttf__get32(data, group);
+        if (codepoint > glyph_ttf__get32(data, group + 4)) return 0;
+        if (format == 12)
+            return glyph_ttf__get32(data, group + 8) + (codepoint - startCharCode);
+        else
+            return glyph_ttf__get32(data, group + 8);
+    }
+    return 0;
+}
+
+/*
+ * Builds the dense codepoint -> glyph index table of a font
+ *
+ * Walks the cmap ranges once instead of searching for every codepoint, so
+ * the cost is the table clear plus the number of mapped codepoints. On
+ * allocation failure the font simply keeps searching the cmap.
+ *
+ * Parameters:
+ *   font: Initialized font structure
+ *   size: Number of leading codepoints to cover (0 disables the table)
+ */
+static void glyph_ttf__build_glyph_cache(glyph_font_t* font, int size) {
+    if (size <= 0) return;
+    unsigned short* cache = (unsigned short*)GLYPH_MALLOC((size_t)size * sizeof(unsigned short));
+    if (!cache) return;
+    memset(cache, 0, (size_t)size * sizeof(unsigned short));
+
+    const unsigned char* data = font->data;
+    int index_map = font->index_map;
+    int format = glyph_ttf__get16u(data, index_map);
+    if (format == 4) {
         int segcount = glyph_ttf__get16u(data, index_map + 6) >> 1;
         int endCount = index_map + 14;
         int startCount = endCount + segcount * 2 + 2;
-        int idDelta = startCount + segcount * 2;
-        int idRangeOffset = idDelta + segcount * 2;
         for (int i = 0; i < segcount; ++i) {
+            int start = glyph_ttf__get16u(data, startCount + i * 2);
             int end = glyph_ttf__get16u(data, endCount + i * 2);
-            if (codepoint <= end) {
-                int start = glyph_ttf__get16u(data, startCount + i * 2);
-                if (codepoint >= start) {
-                    int delta = glyph_ttf__get16(data, idDelta + i * 2);
-                    int rangeOffset = glyph_ttf__get16u(data, idRangeOffset + i * 2);
-                    if (rangeOffset == 0) {
-                        return (codepoint + delta) & 0xFFFF;
-                    } else {
-                        int glyphIndex = glyph_ttf__get16u(data, idRangeOffset + i * 2 + rangeOffset + (codepoint - start) * 2);
-                        return glyphIndex ? (glyphIndex + delta) & 0xFFFF : 0;
-                    }
-                }
+            if (end >= size) end = size - 1;
+            for (int codepoint = start; codepoint <= end; ++codepoint) {
+                cache[codepoint] = (unsigned short)glyph_ttf__format4_glyph(data, index_map, segcount, i, start, codepoint);
             }
         }
-        return 0;
     } else if (format == 12 || format == 13) {
         int nGroups = glyph_ttf__get32(data, index_map + 12);
         for (int i = 0; i < nGroups; ++i) {
-            int startCharCode = glyph_ttf__get32(data, index_map + 16 + i * 12);
-            int endCharCode = glyph_ttf__get32(data, index_map + 16 + i * 12 + 4);
-            if (codepoint >= startCharCode && codepoint <= endCharCode) {
-                if (format == 12)
-                    return glyph_ttf__get32(data, index_map + 16 + i * 12 + 8) + (codepoint - startCharCode);
-                else
-                    return glyph_ttf__get32(data, index_map + 16 + i * 12 + 8);
+            int group = index_map + 16 + i * 12;
+            int start = glyph_ttf__get32(data, group);
+            int end = glyph_ttf__get32(data, group + 4);
+            int glyph = glyph_ttf__get32(data, group + 8);
+            if (start < 0 || start >= size) continue;
+            if (end >= size) end = size - 1;
+            for (int codepoint = start; codepoint <= end; ++codepoint) {
+                cache[codepoint] = (unsigned short)(format == 12 ? glyph + (codepoint - start) : glyph);
+            }
+        }
+    } else {
+        for (int codepoint = 0; codepoint < size; ++codepoint) {
+            cache[codepoint] = (unsigned short)glyph_ttf__search_glyph_index(font, codepoint);
+        }
+    }
+
+    font->glyph_cache = cache;
+    font->glyph_cache_size = size;
+}
+
+/*
+ * Kerning
+ *
+ * Pair adjustments come from the GPOS 'kern' feature when present (PairPos
+ * lookups, formats 1 and 2, including extension lookups), otherwise from
+ * the legacy 'kern' table (format 0 subtables). The GPOS subtables are
+ * located once in glyph_ttf_init so a pair query is a few binary searches.
+ */
+
+/* Coverage index of a glyph in an OpenType coverage table, or -1 */
+static int glyph_ttf__coverage_index(const unsigned char* data, int coverage, int glyph) {
+    int format = glyph_ttf__get16u(data, coverage);
+    int count = glyph_ttf__get16u(data, coverage + 2);
+    int lo = 0, hi = count - 1;
+    if (format == 1) {
+        while (lo <= hi) {
+            int mid = (lo + hi) >> 1;
+            int g = glyph_ttf__get16u(data, coverage + 4 + mid * 2);
+            if (glyph < g) hi = mid - 1;
+            else if (glyph > g) lo = mid + 1;
+            else return mid;
+        }
+    } else if (format == 2) {
+        while (lo <= hi) {
+            int mid = (lo + hi) >> 1;
+            int range = coverage + 4 + mid * 6;
+            int start = glyph_ttf__get16u(data, range);
+            if (glyph < start) hi = mid - 1;
+            else if (glyph > (int)glyph_ttf__get16u(data, range + 2)) lo = mid + 1;
+            else return glyph_ttf__get16u(data, range + 4) + glyph - start;
+        }
+    }
+    return -1;
+}
+
+/* Class of a glyph in an OpenType class definition table (0 if unlisted) */
+static int glyph_ttf__glyph_class(const unsigned char* data, int class_def, int glyph) {
+    int format = glyph_ttf__get16u(data, class_def);
+    if (format == 1) {
+        int start = glyph_ttf__get16u(data, class_def + 2);
+        int count = glyph_ttf__get16u(data, class_def + 4);
+        if (glyph >= start && glyph < start + count) return glyph_ttf__get16u(data, class_def + 6 + (glyph - start) * 2);
+    } else if (format == 2) {
+        int lo = 0, hi = (int)glyph_ttf__get16u(data, class_def + 2) - 1;
+        while (lo <= hi) {
+            int mid = (lo + hi) >> 1;
+            int range = class_def + 4 + mid * 6;
+            if (glyph < (int)glyph_ttf__get16u(data, range)) hi = mid - 1;
+            else if (glyph > (int)glyph_ttf__get16u(data, range + 2)) lo = mid + 1;
+            else return glyph_ttf__get16u(data, range + 4);
+        }
+    }
+    return 0;
+}
+
+/* Size in bytes of a GPOS value record and offset of its XAdvance field (-1 if absent) */
+static int glyph_ttf__value_record_size(int format) {
+    int size = 0;
+    for (int bit = 0; bit < 8; bit++) size += (format >> bit) & 1;
+    return size * 2;
+}
+
+static int glyph_ttf__value_x_advance(int format) {
+    if (!(format & 0x0004)) return -1;
+    return ((format & 0x0001) ? 2 : 0) + ((format & 0x0002) ? 2 : 0);
+}
+
+/*
+ * Looks up a pair in one GPOS PairPos subtable
+ *
+ * Returns: 1 if the subtable defines the pair (value in *advance, font units), 0 otherwise
+ */
+static int glyph_ttf__pair_pos(const unsigned char* data, int subtable, int left, int right, int* advance) {
+    int format = glyph_ttf__get16u(data, subtable);
+    int coverage = glyph_ttf__coverage_index(data, subtable + glyph_ttf__get16u(data, subtable + 2), left);
+    if (coverage < 0) return 0;
+    int format1 = glyph_ttf__get16u(data, subtable + 4);
+    int format2 = glyph_ttf__get16u(data, subtable + 6);
+    int x_advance = glyph_ttf__value_x_advance(format1);
+    int record_size = glyph_ttf__value_record_size(format1) + glyph_ttf__value_record_size(format2);
+
+    if (format == 1) {
+        /* Explicit pair sets: binary search the second glyph */
+        if (coverage >= (int)glyph_ttf__get16u(data, subtable + 8)) return 0;
+        int pair_set = subtable + glyph_ttf__get16u(data, subtable + 10 + coverage * 2);
+        int lo = 0, hi = (int)glyph_ttf__get16u(data, pair_set) - 1;
+        int stride = 2 + record_size;
+        while (lo <= hi) {
+            int mid = (lo + hi) >> 1;
+            int record = pair_set + 2 + mid * stride;
+            int second = glyph_ttf__get16u(data, record);
+            if (right < second) hi = mid - 1;
+            else if (right > second) lo = mid + 1;
+            else {
+                *advance = x_advance >= 0 ? glyph_ttf__get16(data, record + 2 + x_advance) : 0;
+                return 1;
             }
         }
         return 0;
     }
+    if (format == 2) {
+        /* Class pairs: every covered first glyph is defined, possibly as 0 */
+        int class1 = glyph_ttf__glyph_class(data, subtable + glyph_ttf__get16u(data, subtable + 8), left);
+        int class2 = glyph_ttf__glyph_class(data, subtable + glyph_ttf__get16u(data, subtable + 10), right);
+        int class1_count = glyph_ttf__get16u(data, subtable + 12);
+        int class2_count = glyph_ttf__get16u(data, subtable + 14);
+        if (class1 >= class1_count || class2 >= class2_count) return 0;
+        int record = subtable + 16 + (class1 * class2_count + class2) * record_size;
+        *advance = x_advance >= 0 ? glyph_ttf__get16(data, record + x_advance) : 0;
+        return 1;
+    }
     return 0;
 }
 
+/*
+ * Collects the PairPos subtables of the GPOS 'kern' feature
+ *
+ * Lookups referenced by several scripts are kept once, in lookup order.
+ * Extension lookups (type 9) are resolved to the subtables they wrap.
+ */
+static void glyph_ttf__build_kern_subtables(glyph_font_t* font) {
+    const unsigned char* data = font->data;
+    int gpos = font->gpos;
+    font->kern_subtables = NULL;
+    font->num_kern_subtables = 0;
+    if (!gpos || glyph_ttf__get16u(data, gpos) != 1) return;
+
+    int feature_list = gpos + glyph_ttf__get16u(data, gpos + 6);
+    int lookup_list = gpos + glyph_ttf__get16u(data, gpos + 8);
+    int num_lookups = glyph_ttf__get16u(data, lookup_list);
+    if (num_lookups == 0) return;
+    unsigned char* used = (unsigned char*)GLYPH_MALLOC((size_t)num_lookups);
+    if (!used) return;
+    memset(used, 0, (size_t)num_lookups);
+
+    /* Mark lookups of every 'kern' feature record */
+    int num_features = glyph_ttf__get16u(data, feature_list);
+    for (int i = 0; i < num_features; i++) {
+        int record = feature_list + 2 + i * 6;
+        if (memcmp(data + record, "kern", 4) != 0) continue;
+        int feature = feature_list + glyph_ttf__get16u(data, record + 4);
+        int count = glyph_ttf__get16u(data, feature + 2);
+        for (int k = 0; k < count; k++) {
+            int lookup = glyph_ttf__get16u(data, feature + 4 + k * 2);
+            if (lookup < num_lookups) used[lookup] = 1;
+        }
+    }
+
+    /* Two passes: count the pair subtables, then record them */
+    for (int pass = 0; pass < 2; pass++) {
+        int count = 0;
+        for (int l = 0; l < num_lookups; l++) {
+            if (!used[l]) continue;
+            int lookup = lookup_list + glyph_ttf__get16u(data, lookup_list + 2 + l * 2);
+            int type = glyph_ttf__get16u(data, lookup);
+            int num_subtables = glyph_ttf__get16u(data, lookup + 4);
+            for (int s = 0; s < num_subtables; s++) {
+                int subtable = lookup + glyph_ttf__get16u(data, lookup + 6 + s * 2);
+                int subtable_type = type;
+                if (type == 9) {
+                    subtable_type = glyph_ttf__get16u(data, subtable + 2);
+                    subtable += glyph_ttf__get32(data, subtable + 4);
+                }
+                if (subtable_type != 2) continue;
+                if (pass == 1) {
+                    font->kern_subtables[count].offset = (unsigned int)subtable;
+                    font->kern_subtables[count].lookup = l;
+                }
+                count++;
+            }
+        }
+        if (pass == 0) {
+            if (count == 0) break;
+            font->kern_subtables = (glyph_ttf_kern_subtable_t*)GLYPH_MALLOC((size_t)count * sizeof(glyph_ttf_kern_subtable_t));
+            if (!font->kern_subtables) break;
+        } else {
+            font->num_kern_subtables = count;
+        }
+    }
+    GLYPH_FREE(used);
+}
+
+/* Sums the legacy 'kern' table (horizontal format 0 subtables) for a pair */
+static int glyph_ttf__kern_table_advance(const glyph_font_t* font, int left, int right) {
+    const unsigned char* data = font->data;
+    int kern = font->kern;
+    if (glyph_ttf__get16u(data, kern) != 0) return 0; /* Apple 'kern' (version 1) is not supported */
+    int num_tables = glyph_ttf__get16u(data, kern + 2);
+    uint32_t key = ((uint32_t)left << 16) | (uint32_t)right;
+    int total = 0;
+    int subtable = kern + 4;
+    for (int t = 0; t < num_tables; t++) {
+        int length = glyph_ttf__get16u(data, subtable + 2);
+        int coverage = glyph_ttf__get16u(data, subtable + 4);
+        /* Format 0, horizontal, not minimum values, not cross-stream */
+        if ((coverage >> 8) == 0 && (coverage & 0x0007) == 0x0001) {
+            int lo = 0, hi = (int)glyph_ttf__get16u(data, subtable + 6) - 1;
+            while (lo <= hi) {
+                int mid = (lo + hi) >> 1;
+                int pair = subtable + 14 + mid * 6;
+                uint32_t k = (uint32_t)glyph_ttf__get32(data, pair);
+                if (key < k) hi = mid - 1;
+                else if (key > k) lo = mid + 1;
+                else {
+                    total += glyph_ttf__get16(data, pair + 4);
+                    break;
+                }
+            }
+        }
+        subtable += length;
+    }
+    return total;
+}
+
+/*
+ * Returns the kerning adjustment between two glyphs
+ *
+ * Parameters:
+ *   font: Initialized font
+ *   left: Glyph index of the first glyph of the pair
+ *   right: Glyph index of the glyph that follows it
+ *
+ * Returns: Horizontal advance adjustment in font units (0 if the pair is not kerned)
+ */
+static inline int glyph_ttf_get_glyph_kerning(const glyph_font_t* font, int left, int right) {
+    if (font->num_kern_subtables > 0) {
+        int total = 0;
+        int done_lookup = -1; /* Within a lookup the first subtable defining the pair wins */
+        for (int i = 0; i < font->num_kern_subtables; i++) {
+            const glyph_ttf_kern_subtable_t* s = &font->kern_subtables[i];
+            int advance;
+            if (s->lookup == done_lookup) continue;
+            if (glyph_ttf__pair_pos(font->data, (int)s->offset, left, right, &advance)) {
+                total += advance;
+                done_lookup = s->lookup;
+            }
+        }
+        return total;
+    }
+    if (font->kern) return glyph_ttf__kern_table_advance(font, left, right);
+    return 0;
+}
+
+/*
+ * Tells whether any kerning pair starts with a glyph
+ *
+ * Lets callers building pair tables skip glyphs that can never be kerned
+ * instead of querying them against every other glyph.
+ *
+ * Returns: 1 if the glyph may start a kerned pair, 0 if it never does
+ */
+static inline int glyph_ttf_glyph_has_kerning(const glyph_font_t* font, int left) {
+    const unsigned char* data = font->data;
+    if (font->num_kern_subtables > 0) {
+        for (int i = 0; i < font->num_kern_subtables; i++) {
+            int subtable = (int)font->kern_subtables[i].offset;
+            if (glyph_ttf__coverage_index(data, subtable + glyph_ttf__get16u(data, subtable + 2), left) >= 0) return 1;
+        }
+        return 0;
+    }
+    return font->kern != 0; /* Format 0 pairs are not indexed by first glyph: assume possible */
+}
+
+/* Called by glyph_ttf_get_kerning_pairs for each kerned pair; returning 0 stops the walk */
+typedef int (*glyph_ttf_kern_pair_fn)(void* user_data, int left, int right, int advance);
+
+/* Tells whether a glyph is in a sorted glyph list */
+static int glyph_ttf__glyph_listed(const int* glyphs, int count, int glyph) {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        if (glyph < glyphs[mid]) hi = mid - 1;
+        else if (glyph > glyphs[mid]) lo = mid + 1;
+        else return 1;
+    }
+    return 0;
+}
+
+/* Reports a pair found in one subtable with its total kerning, unless that is 0 */
+static int glyph_ttf__report_pair(const glyph_font_t* font, int left, int right, glyph_ttf_kern_pair_fn fn, void* user_data) {
+    int advance = glyph_ttf_get_glyph_kerning(font, left, right);
+    return advance == 0 || fn(user_data, left, right, advance);
+}
+
+/* Walks one class-based PairPos subtable over a glyph set */
+static int glyph_ttf__class_pairs(const glyph_font_t* font, int subtable, const int* glyphs, int count, glyph_ttf_kern_pair_fn fn, void* user_data) {
+    const unsigned char* data = font->data;
+    int coverage = subtable + glyph_ttf__get16u(data, subtable + 2);
+    int x_advance = glyph_ttf__value_x_advance(glyph_ttf__get16u(data, subtable + 4));
+    int record_size = glyph_ttf__value_record_size(glyph_ttf__get16u(data, subtable + 4)) + glyph_ttf__value_record_size(glyph_ttf__get16u(data, subtable + 6));
+    int class_def1 = subtable + glyph_ttf__get16u(data, subtable + 8);
+    int class_def2 = subtable + glyph_ttf__get16u(data, subtable + 10);
+    int class1_count = glyph_ttf__get16u(data, subtable + 12);
+    int class2_count = glyph_ttf__get16u(data, subtable + 14);
+    if (x_advance < 0 || class2_count == 0) return 1; /* No XAdvance: every pair is 0 */
+
+    /* Bucket the set by second-glyph class once, so each first glyph only visits non-zero classes */
+    int* classes = (int*)GLYPH_MALLOC((size_t)count * sizeof(int));
+    int* order = (int*)GLYPH_MALLOC((size_t)count * sizeof(int));
+    int* starts = (int*)GLYPH_MALLOC((size_t)(class2_count + 1) * sizeof(int));
+    int ok = classes && order && starts;
+    if (ok) {
+        memset(starts, 0, (size_t)(class2_count + 1) * sizeof(int));
+        for (int j = 0; j < count; j++) {
+            classes[j] = glyph_ttf__glyph_class(data, class_def2, glyphs[j]);
+            if (classes[j] < class2_count) starts[classes[j] + 1]++;
+        }
+        for (int c = 0; c < class2_count; c++) starts[c + 1] += starts[c];
+        for (int j = 0; j < count; j++) {
+            if (classes[j] < class2_count) order[starts[classes[j]]++] = j;
+        }
+        for (int c = class2_count; c > 0; c--) starts[c] = starts[c - 1];
+        starts[0] = 0;
+
+        for (int i = 0; i < count && ok; i++) {
+            if (glyph_ttf__coverage_index(data, coverage, glyphs[i]) < 0) continue;
+            int class1 = glyph_ttf__glyph_class(data, class_def1, glyphs[i]);
+            if (class1 >= class1_count) continue;
+            int row = subtable + 16 + class1 * class2_count * record_size;
+            for (int c = 0; c < class2_count && ok; c++) {
+                if (glyph_ttf__get16(data, row + c * record_size + x_advance) == 0) continue;
+                for (int k = starts[c]; k < starts[c + 1] && ok; k++) {
+                    ok = glyph_ttf__report_pair(font, glyphs[i], glyphs[order[k]], fn, user_data);
+                }
+            }
+        }
+    }
+    GLYPH_FREE(classes);
+    GLYPH_FREE(order);
+    GLYPH_FREE(starts);
+    return ok;
+}
+
+/*
+ * Lists the kerned pairs within a set of glyphs
+ *
+ * Walks the kerning tables rather than querying every pair of the set:
+ * pair sets and legacy 'kern' pairs are matched against the set, and class
+ * subtables only visit the second-glyph classes that carry a value. The value
+ * passed to fn is the full glyph_ttf_get_glyph_kerning result; a pair listed
+ * by several subtables may be reported more than once, with the same value.
+ *
+ * Parameters:
+ *   font: Initialized font
+ *   glyphs: Glyph indices of the set, sorted ascending without duplicates
+ *   count: Number of glyphs in the set
+ *   fn: Called for each non-zero pair with its adjustment in font units
+ *   user_data: Passed through to fn
+ *
+ * Returns: 1 when every pair was reported, 0 if fn stopped the walk or an allocation failed
+ */
+static inline int glyph_ttf_get_kerning_pairs(const glyph_font_t* font, const int* glyphs, int count, glyph_ttf_kern_pair_fn fn, void* user_data) {
+    const unsigned char* data = font->data;
+    if (count <= 0) return 1;
+    if (font->num_kern_subtables > 0) {
+        for (int s = 0; s < font->num_kern_subtables; s++) {
+            int subtable = (int)font->kern_subtables[s].offset;
+            int format = glyph_ttf__get16u(data, subtable);
+            if (format == 2) {
+                if (!glyph_ttf__class_pairs(font, subtable, glyphs, count, fn, user_data)) return 0;
+                continue;
+            }
+            if (format != 1) continue;
+            int coverage = subtable + glyph_ttf__get16u(data, subtable + 2);
+            int x_advance = glyph_ttf__value_x_advance(glyph_ttf__get16u(data, subtable + 4));
+            int stride = 2 + glyph_ttf__value_record_size(glyph_ttf__get16u(data, subtable + 4)) + glyph_ttf__value_record_size(glyph_ttf__get16u(data, subtable + 6));
+            int num_sets = glyph_ttf__get16u(data, subtable + 8);
+            if (x_advance < 0) continue;
+            for (int i = 0; i < count; i++) {
+                int index = glyph_ttf__coverage_index(data, coverage, glyphs[i]);
+                if (index < 0 || index >= num_sets) continue;
+                int pair_set = subtable + glyph_ttf__get16u(data, subtable + 10 + index * 2);
+                int num_pairs = glyph_ttf__get16u(data, pair_set);
+                for (int k = 0; k < num_pairs; k++) {
+                    int record = pair_set + 2 + k * stride;
+                    int second = glyph_ttf__get16u(data, record);
+                    if (glyph_ttf__get16(data, record + 2 + x_advance) == 0 || !glyph_ttf__glyph_listed(glyphs, count, second)) continue;
+                    if (!glyph_ttf__report_pair(font, glyphs[i], second, fn, user_data)) return 0;
+                }
+            }
+        }
+        return 1;
+    }
+    if (!font->kern || glyph_ttf__get16u(data, font->kern) != 0) return 1;
+    int num_tables = glyph_ttf__get16u(data, font->kern + 2);
+    int subtable = font->kern + 4;
+    for (int t = 0; t < num_tables; t++) {
+        int coverage = glyph_ttf__get16u(data, subtable + 4);
+        if ((coverage >> 8) == 0 && (coverage & 0x0007) == 0x0001) {
+            int num_pairs = glyph_ttf__get16u(data, subtable + 6);
+            for (int k = 0; k < num_pairs; k++) {
+                int pair = subtable + 14 + k * 6;
+                int left = glyph_ttf__get16u(data, pair);
+                int right = glyph_ttf__get16u(data, pair + 2);
+                if (glyph_ttf__get16(data, pair + 4) == 0 || !glyph_ttf__glyph_listed(glyphs, count, left) || !glyph_ttf__glyph_listed(glyphs, count, right)) continue;
+                if (!glyph_ttf__report_pair(font, left, right, fn, user_data)) return 0;
+            }
+        }
+        subtable += glyph_ttf__get16u(data, subtable + 2);
+    }
+    return 1;
+}
+
+/*
+ * Maps a Unicode codepoint to a glyph index
+ *
+ * Served from the dense table for codepoints it covers, otherwise by a
+ * binary search of the cmap subtable.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   codepoint: Unicode codepoint
+ *
+ * Returns: Glyph index, or 0 (.notdef) if the font has no glyph for it
+ */
+static inline int glyph_ttf_find_glyph_index(const glyph_font_t* font, int codepoint) {
+    if (codepoint >= 0 && codepoint < font->glyph_cache_size) return font->glyph_cache[codepoint];
+    return glyph_ttf__search_glyph_index(font, codepoint);
+}
+
 static inline void glyph_ttf_get_glyph_bbox(const glyph_font_t* font, int glyph_index, glyph_bbox_t* bbox) {
     if (glyph_index >= font->numGlyphs) {
         bbox->x0 = bbox->y0 = bbox->x1 = bbox->y1 = 0;
@@ -298,279 +904,854 @@ static int glyph_ttf__get_glyph_offset(const glyph_font_t* font, int glyph_index
     return g1 == g2 ? -1 : g1;
 }
 
-static void glyph_ttf__add_edge(float* accum, int w, int h, float x0, float y0, float x1, float y1) {
-    if (fabs(y1 - y0) < 0.001f) return;
-    
-    int dir = 1;
+/*
+ * Adds the exact signed area of a line segment to the accumulation buffer
+ *
+ * For every scanline the segment crosses, the covered area right of the
+ * segment is split across the pixels it passes through, so that a running
+ * sum along the row yields the winding-weighted coverage of each pixel.
+ * Rows are w + 1 floats wide; the extra cell absorbs area right of the
+ * last pixel. Endpoints are clamped to the bitmap (x to w - 1, which the
+ * outline's bounding box never exceeds), keeping contours closed even when
+ * a font's bounding box is slightly off.
+ *
+ * Parameters:
+ *   accum: Accumulation buffer, (w + 1) * h floats
+ *   w, h: Bitmap dimensions
+ *   x0, y0, x1, y1: Segment endpoints in pixel space (Y down)
+ */
+static void glyph_ttf__add_line(float* accum, int w, int h, float x0, float y0, float x1, float y1) {
+    float x_max = (float)(w - 1);
+    x0 = x0 < 0.0f ? 0.0f : (x0 > x_max ? x_max : x0);
+    x1 = x1 < 0.0f ? 0.0f : (x1 > x_max ? x_max : x1);
+    y0 = y0 < 0.0f ? 0.0f : (y0 > (float)h ? (float)h : y0);
+    y1 = y1 < 0.0f ? 0.0f : (y1 > (float)h ? (float)h : y1);
+    if (y0 == y1) return;
+
+    float dir = 1.0f;
     if (y0 > y1) {
         float tmp;
         tmp = y0; y0 = y1; y1 = tmp;
         tmp = x0; x0 = x1; x1 = tmp;
-        dir = -1;
+        dir = -1.0f;
     }
-    
-    int y_start = (int)floorf(y0);
+
+    float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
     int y_end = (int)ceilf(y1);
-    
-    if (y_end <= 0 || y_start >= h) return;
-    if (y_start < 0) y_start = 0;
     if (y_end > h) y_end = h;
-    
-    float dx = x1 - x0;
-    float dy = y1 - y0;
-    
-    for (int y = y_start; y < y_end; ++y) {
-        float sy0 = (float)y;
-        float sy1 = (float)(y + 1);
-        
-        if (sy0 < y0) sy0 = y0;
-        if (sy1 > y1) sy1 = y1;
-        
-        float coverage = sy1 - sy0;
-        float y_mid = (sy0 + sy1) * 0.5f;
-        float x_mid = x0 + dx * (y_mid - y0) / dy;
-        
-        int x_int = (int)floorf(x_mid);
-        if (x_int >= 0 && x_int < w) {
-            accum[y * w + x_int] += coverage * dir;
-        }
-    }
-}
-
-static void glyph_ttf__rasterize_shape(unsigned char* bitmap, int w, int h, glyph_point_t** contours, int* contour_sizes, int num_contours) {
-    float* accum = (float*)calloc(w * h, sizeof(float));
-    if (!accum) return;
-    
+    size_t stride = (size_t)w + 1;
+
+    for (int y = (int)y0; y < y_end; ++y) {
+        float* row = accum + (size_t)y * stride;
+        float dy = ((float)(y + 1) < y1 ? (float)(y + 1) : y1) - ((float)y > y0 ? (float)y : y0);
+        float x_next = x + dxdy * dy;
+        float d = dy * dir;
+
+        float xa = x < x_next ? x : x_next;
+        float xb = x < x_next ? x_next : x;
+        float xa_floor = floorf(xa);
+        int xa_i = (int)xa_floor;
+        int xb_i = (int)ceilf(xb);
+
+        if (xb_i <= xa_i + 1) {
+            /* Within one pixel: split by the horizontal midpoint */
+            float xm = 0.5f * (x + x_next) - xa_floor;
+            row[xa_i] += d - d * xm;
+            row[xa_i + 1] += d * xm;
+        } else {
+            /* Across several pixels: triangle at each end, constant slope between */
+            float s = 1.0f / (xb - xa);
+            float xa_f = xa - xa_floor;
+            float a0 = 0.5f * s * (1.0f - xa_f) * (1.0f - xa_f);
+            float xb_f = xb - (float)xb_i + 1.0f;
+            float am = 0.5f * s * xb_f * xb_f;
+            row[xa_i] += d * a0;
+            if (xb_i == xa_i + 2) {
+                row[xa_i + 1] += d * (1.0f - a0 - am);
+            } else {
+                float a1 = s * (1.5f - xa_f);
+                row[xa_i + 1] += d * (a1 - a0);
+                for (int xi = xa_i + 2; xi < xb_i - 1; ++xi) {
+                    row[xi] += d * s;
+                }
+                float a2 = a1 + (float)(xb_i - xa_i - 3) * s;
+                row[xb_i - 1] += d * (1.0f - a2 - am);
+            }
+            row[xb_i] += d * am;
+        }
+        x = x_next;
+    }
+}
+
+/*
+ * Flattens a quadratic Bezier into line segments and adds their area
+ *
+ * n chords deviate from the curve by at most |p0 - 2 p1 + p2| / (4 n^2)
+ * pixels, so the segment count is chosen from that term to stay within
+ * 0.05 px at any scale: small glyphs get a few segments, large ones as
+ * many as needed.
+ */
+static void glyph_ttf__add_quad(float* accum, int w, int h, glyph_point_t p0, glyph_point_t p1, glyph_point_t p2) {
+    float ddx = p0.x - 2.0f * p1.x + p2.x;
+    float ddy = p0.y - 2.0f * p1.y + p2.y;
+    int steps = (int)ceilf(sqrtf(5.0f * sqrtf(ddx * ddx + ddy * ddy)));
+    if (steps <= 1) {
+        glyph_ttf__add_line(accum, w, h, p0.x, p0.y, p2.x, p2.y);
+        return;
+    }
+    if (steps > 64) steps = 64;
+    float prev_x = p0.x;
+    float prev_y = p0.y;
+    for (int t = 1; t <= steps; ++t) {
+        float u = (float)t / steps;
+        float b0 = (1 - u) * (1 - u);
+        float b1 = 2 * (1 - u) * u;
+        float b2 = u * u;
+        float x = b0 * p0.x + b1 * p1.x + b2 * p2.x;
+        float y = b0 * p0.y + b1 * p1.y + b2 * p2.y;
+        glyph_ttf__add_line(accum, w, h, prev_x, prev_y, x, y);
+        prev_x = x;
+        prev_y = y;
+    }
+}
+
+/*
+ * Converts one row of area deltas to 8-bit coverage (nonzero winding)
+ *
+ * A running sum turns the deltas into signed coverage, which is clamped to
+ * [0, 1] by magnitude and rounded. Four pixels per step on SSE2 and NEON.
+ */
+static void glyph_ttf__accumulate_row(const float* accum, unsigned char* out, int w) {
+    int x = 0;
+    float acc = 0.0f;
+#if defined(GLYPH_TTF__SSE2)
+    __m128 carry = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 full = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; x + 4 <= w; x += 4) {
+        /* In-register prefix sum: add the vector shifted by one lane, then by two */
+        __m128 v = _mm_loadu_ps(accum + x);
+        v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+        v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+        v = _mm_add_ps(v, carry);
+        carry = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+        __m128 a = _mm_min_ps(_mm_andnot_ps(sign, v), one);
+        __m128i q = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, full), half));
+        q = _mm_packs_epi32(q, q);
+        q = _mm_packus_epi16(q, q);
+        int packed = _mm_cvtsi128_si32(q);
+        memcpy(out + x, &packed, 4);
+    }
+    acc = _mm_cvtss_f32(carry);
+#elif defined(GLYPH_TTF__NEON)
+    float32x4_t carry = vdupq_n_f32(0.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t full = vdupq_n_f32(255.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; x + 4 <= w; x += 4) {
+        float32x4_t v = vld1q_f32(accum + x);
+        v = vaddq_f32(v, vextq_f32(zero, v, 3));
+        v = vaddq_f32(v, vextq_f32(zero, v, 2));
+        v = vaddq_f32(v, carry);
+        carry = vdupq_n_f32(vgetq_lane_f32(v, 3));
+        float32x4_t a = vminq_f32(vabsq_f32(v), one);
+        uint16x4_t q16 = vmovn_u32(vcvtq_u32_f32(vmlaq_f32(half, a, full)));
+        uint8x8_t q8 = vmovn_u16(vcombine_u16(q16, q16));
+        uint32_t packed = vget_lane_u32(vreinterpret_u32_u8(q8), 0);
+        memcpy(out + x, &packed, 4);
+    }
+    acc = vgetq_lane_f32(carry, 0);
+#endif
+    for (; x < w; ++x) {
+        acc += accum[x];
+        float alpha = fabsf(acc);
+        if (alpha > 1.0f) alpha = 1.0f;
+        out[x] = (unsigned char)(alpha * 255.0f + 0.5f);
+    }
+}
+
+/*
+ * Releases the buffers of a raster scratch and resets it for reuse (the allocator is kept)
+ *
+ * Parameters:
+ *   scratch: Scratch to release
+ */
+static inline void glyph_raster_scratch_free(glyph_raster_scratch_t* scratch) {
+    if (!scratch) return;
+    const glyph_allocator_t* allocator = scratch->allocator;
+    glyph__free(allocator, scratch->accum);
+    glyph_arena_release(&scratch->temp);
+    memset(scratch, 0, sizeof(glyph_raster_scratch_t));
+    scratch->allocator = allocator;
+}
+
+/*
+ * Rasterizes closed contours into an 8-bit coverage bitmap
+ *
+ * Parameters:
+ *   bitmap: Output, w * h bytes (fully overwritten)
+ *   w, h: Bitmap dimensions
+ *   contours, contour_sizes, num_contours: Outline in pixel space (Y down)
+ *   scratch: Reusable accumulation buffer, or NULL for a temporary one
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static int glyph_ttf__rasterize_shape(unsigned char* bitmap, int w, int h, glyph_point_t** contours, int* contour_sizes, int num_contours,
+                                      glyph_raster_scratch_t* scratch) {
+    glyph_raster_scratch_t local;
+    memset(&local, 0, sizeof(local));
+    glyph_raster_scratch_t* work = scratch ? scratch : &local;
+    size_t cells = ((size_t)w + 1) * h;
+    if (cells > work->capacity) {
+        float* accum = (float*)glyph__realloc(work->allocator, work->accum, cells * sizeof(float));
+        if (!accum) {
+            glyph_raster_scratch_free(&local);
+            return 0;
+        }
+        work->accum = accum;
+        work->capacity = cells;
+    }
+    float* accum = work->accum;
+    memset(accum, 0, cells * sizeof(float));
+
     for (int c = 0; c < num_contours; ++c) {
         glyph_point_t* points = contours[c];
         int n_points = contour_sizes[c];
-        
-        if (n_points < 2) continue;
-        
+
+        if (!points || n_points < 2) continue;
+
+        /* Decoded outlines have an on-curve point on each side of every control point */
         int i = 0;
         while (i < n_points) {
             glyph_point_t p0 = points[i];
-            int next = (i + 1) % n_points;
-            glyph_point_t p1 = points[next];
-            
+            glyph_point_t p1 = points[(i + 1) % n_points];
+
             if (p0.on_curve && p1.on_curve) {
-                glyph_ttf__add_edge(accum, w, h, p0.x, p0.y, p1.x, p1.y);
+                glyph_ttf__add_line(accum, w, h, p0.x, p0.y, p1.x, p1.y);
                 i++;
-            } else if (p0.on_curve && !p1.on_curve) {
-                int next2 = (i + 2) % n_points;
-                glyph_point_t p2 = points[next2];
-                
-                if (!p2.on_curve) {
-                    p2.x = (p1.x + p2.x) * 0.5f;
-                    p2.y = (p1.y + p2.y) * 0.5f;
-                }
-                
-                float prev_x = p0.x;
-                float prev_y = p0.y;
-                
-                int steps = 32;
-                for (int t = 1; t <= steps; ++t) {
-                    float u = (float)t / steps;
-                    float b0 = (1 - u) * (1 - u);
-                    float b1 = 2 * (1 - u) * u;
-                    float b2 = u * u;
-                    
-                    float x = b0 * p0.x + b1 * p1.x + b2 * p2.x;
-                    float y = b0 * p0.y + b1 * p1.y + b2 * p2.y;
-                    
-                    glyph_ttf__add_edge(accum, w, h, prev_x, prev_y, x, y);
-                    
-                    prev_x = x;
-                    prev_y = y;
-                }
-                
-                if (!points[next2].on_curve) {
-                    i += 1;
-                } else {
-                    i += 2;
-                }
+            } else if (p0.on_curve) {
+                glyph_ttf__add_quad(accum, w, h, p0, p1, points[(i + 2) % n_points]);
+                i += 2;
             } else {
                 i++;
             }
         }
     }
-    
+
     for (int y = 0; y < h; ++y) {
-        float winding = 0;
-        for (int x = 0; x < w; ++x) {
-            winding += accum[y * w + x];
-            float alpha = fabsf(winding);
-            if (alpha > 1.0f) alpha = 1.0f;
-            bitmap[y * w + x] = (unsigned char)(alpha * 255.0f);
-        }
+        glyph_ttf__accumulate_row(accum + (size_t)y * (w + 1), bitmap + (size_t)y * w, w);
     }
-    
-    GLYPH_FREE(accum);
+
+    glyph_raster_scratch_free(&local);
+    return 1;
 }
 
-static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int* width, int* height, int* xoff, int* yoff) {
-    const unsigned char* data = font->data;
-    int g = glyph_ttf__get_glyph_offset(font, glyph_index);
-    if (g < 0) {
-        *width = 0;
-        *height = 0;
-        *xoff = 0;
-        *yoff = 0;
-        return NULL;
+/*
+ * Glyph contours in font units (Y up)
+ *
+ * Between two consecutive off-curve points the implied on-curve midpoint
+ * is already inserted. Composite glyphs are flattened into the contours of
+ * their components, with the component transforms applied.
+ */
+typedef struct {
+    glyph_point_t* points;        /* All points, contour after contour */
+    int* contour_ends;            /* One past the last point of each contour */
+    int num_points, num_contours; /* Points and contours in use */
+    int point_capacity, contour_capacity; /* Allocated sizes */
+    const glyph_allocator_t* allocator; /* Source of points and contour_ends (NULL = GLYPH_MALLOC) */
+} glyph_ttf__shape_t;
+
+/* Decoded component outlines of a font, indexed by glyph */
+struct glyph_ttf_outline_cache_t {
+    int* entry_of;                /* entries[] index per glyph index, -1 if not decoded */
+    int num_glyphs;               /* Length of entry_of */
+    glyph_ttf__shape_t* entries;  /* Decoded outlines */
+    int count, capacity;          /* Entries in use and allocated */
+};
+
+/*
+ * Glyph outline decoded into pixel space
+ *
+ * Points are relative to the top-left of the glyph's scaled bounding box
+ * with Y pointing down. Between two consecutive off-curve points the
+ * implied on-curve midpoint is inserted, so every off-curve point sits
+ * between two on-curve points (wrapping around the contour).
+ */
+typedef struct {
+    glyph_point_t** contours;     /* Point arrays, one per contour (NULL if allocation failed) */
+    int* contour_sizes;           /* Points in each contour */
+    int num_contours;             /* Number of contours */
+    int width, height;            /* Bitmap size covering the scaled bounding box */
+    int xoff, yoff;               /* Bounding box left edge and top edge relative to the pen (Y up) */
+    const glyph_allocator_t* allocator; /* Source of the arrays above (NULL = GLYPH_MALLOC) */
+} glyph_ttf__outline_t;
+
+/* Releases the contours of a decoded outline */
+static void glyph_ttf__free_outline(glyph_ttf__outline_t* outline) {
+    for (int c = 0; c < outline->num_contours; ++c) {
+        glyph__free(outline->allocator, outline->contours[c]);
     }
+    glyph__free(outline->allocator, outline->contours);
+    glyph__free(outline->allocator, outline->contour_sizes);
+    outline->contours = NULL;
+    outline->contour_sizes = NULL;
+    outline->num_contours = 0;
+}
 
-    int numberOfContours = glyph_ttf__get16(data, g);
-    if (numberOfContours > 0) {
-        int xMin = glyph_ttf__get16(data, g + 2);
-        int yMin = glyph_ttf__get16(data, g + 4);
-        int xMax = glyph_ttf__get16(data, g + 6);
-        int yMax = glyph_ttf__get16(data, g + 8);
+/* Releases the points and contour table of a shape (its allocator is kept) */
+static void glyph_ttf__shape_free(glyph_ttf__shape_t* shape) {
+    const glyph_allocator_t* allocator = shape->allocator;
+    glyph__free(allocator, shape->points);
+    glyph__free(allocator, shape->contour_ends);
+    memset(shape, 0, sizeof(glyph_ttf__shape_t));
+    shape->allocator = allocator;
+}
 
-        int w = (int)ceilf((xMax - xMin) * scale_x) + 1;
-        int h = (int)ceilf((yMax - yMin) * scale_y) + 1;
-        if (w <= 0 || h <= 0) {
-            *width = 0;
-            *height = 0;
-            *xoff = 0;
-            *yoff = 0;
-            return NULL;
-        }
+/*
+ * Grows a shape to take extra points and contours
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static int glyph_ttf__shape_reserve(glyph_ttf__shape_t* shape, int extra_points, int extra_contours) {
+    if (shape->num_points + extra_points > shape->point_capacity) {
+        int capacity = shape->point_capacity * 2;
+        if (capacity < shape->num_points + extra_points) capacity = shape->num_points + extra_points;
+        glyph_point_t* points = (glyph_point_t*)glyph__realloc(shape->allocator, shape->points, capacity * sizeof(glyph_point_t));
+        if (!points) return 0;
+        shape->points = points;
+        shape->point_capacity = capacity;
+    }
+    if (shape->num_contours + extra_contours > shape->contour_capacity) {
+        int capacity = shape->contour_capacity * 2;
+        if (capacity < shape->num_contours + extra_contours) capacity = shape->num_contours + extra_contours;
+        int* ends = (int*)glyph__realloc(shape->allocator, shape->contour_ends, capacity * sizeof(int));
+        if (!ends) return 0;
+        shape->contour_ends = ends;
+        shape->contour_capacity = capacity;
+    }
+    return 1;
+}
 
-        unsigned char* bitmap = (unsigned char*)calloc(w * h, 1);
-        if (!bitmap) return NULL;
+/* Appends a point mapped through the affine transform m = {a, b, c, d, e, f} */
+static void glyph_ttf__shape_push(glyph_ttf__shape_t* shape, const float* m, float x, float y, int on_curve) {
+    glyph_point_t* point = &shape->points[shape->num_points++];
+    point->x = m[0] * x + m[2] * y + m[4];
+    point->y = m[1] * x + m[3] * y + m[5];
+    point->on_curve = on_curve;
+}
 
-        int endPtsOfContours = g + 10;
-        int instructionLength = glyph_ttf__get16u(data, endPtsOfContours + numberOfContours * 2);
-        int instructions = endPtsOfContours + numberOfContours * 2 + 2;
-        int flags_start = instructions + instructionLength;
+/*
+ * Decodes a simple glyph's flags and coordinates and appends its contours
+ *
+ * Parameters:
+ *   font: Font structure
+ *   g: Offset of the glyph in the glyf table
+ *   numberOfContours: Contour count from the glyph header (> 0)
+ *   m: Transform applied to every point
+ *   shape: Shape to append to (its allocator also holds the decoding temporaries)
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static int glyph_ttf__append_simple(const glyph_font_t* font, int g, int numberOfContours, const float* m, glyph_ttf__shape_t* shape) {
+    const unsigned char* data = font->data;
+    int endPtsOfContours = g + 10;
+    int instructionLength = glyph_ttf__get16u(data, endPtsOfContours + numberOfContours * 2);
+    int instructions = endPtsOfContours + numberOfContours * 2 + 2;
+    int flags_start = instructions + instructionLength;
+
+    int lastEndPt = glyph_ttf__get16u(data, endPtsOfContours + (numberOfContours - 1) * 2);
+    int n_points = lastEndPt + 1;
+
+    /* Every point may gain an implied midpoint */
+    if (!glyph_ttf__shape_reserve(shape, n_points * 2, numberOfContours)) return 0;
+    unsigned char* point_flags = (unsigned char*)glyph__alloc(shape->allocator, n_points);
+    int* x_coords = (int*)glyph__alloc(shape->allocator, n_points * sizeof(int));
+    int* y_coords = (int*)glyph__alloc(shape->allocator, n_points * sizeof(int));
+    if (!x_coords || !y_coords || !point_flags) {
+        glyph__free(shape->allocator, x_coords);
+        glyph__free(shape->allocator, y_coords);
+        glyph__free(shape->allocator, point_flags);
+        return 0;
+    }
 
-        int lastEndPt = glyph_ttf__get16u(data, endPtsOfContours + (numberOfContours - 1) * 2);
-        int n_points = lastEndPt + 1;
-
-        unsigned char* point_flags = (unsigned char*)GLYPH_MALLOC(n_points);
-        int* x_coords = (int*)GLYPH_MALLOC(n_points * sizeof(int));
-        int* y_coords = (int*)GLYPH_MALLOC(n_points * sizeof(int));
-
-        if (!x_coords || !y_coords || !point_flags) {
-            GLYPH_FREE(x_coords);
-            GLYPH_FREE(y_coords);
-            GLYPH_FREE(point_flags);
-            GLYPH_FREE(bitmap);
-            return NULL;
-        }
-
-        int flag_index = 0;
-        int data_index = flags_start;
-        while (flag_index < n_points) {
-            unsigned char flag = data[data_index++];
-            point_flags[flag_index++] = flag;
-            if (flag & 8) {
-                int repeat_count = data[data_index++];
-                for (int r = 0; r < repeat_count && flag_index < n_points; ++r) {
-                    point_flags[flag_index++] = flag;
-                }
+    int flag_index = 0;
+    int data_index = flags_start;
+    while (flag_index < n_points) {
+        unsigned char flag = data[data_index++];
+        point_flags[flag_index++] = flag;
+        if (flag & 8) {
+            int repeat_count = data[data_index++];
+            for (int r = 0; r < repeat_count && flag_index < n_points; ++r) {
+                point_flags[flag_index++] = flag;
             }
         }
+    }
 
-        int x = 0;
-        for (int i = 0; i < n_points; ++i) {
-            unsigned char flag = point_flags[i];
-            if (flag & 2) {
-                int dx = data[data_index++];
-                if (!(flag & 16)) dx = -dx;
-                x += dx;
-            } else if (!(flag & 16)) {
-                x += glyph_ttf__get16(data, data_index);
-                data_index += 2;
-            }
-            x_coords[i] = x;
-        }
-
-        int y = 0;
-        for (int i = 0; i < n_points; ++i) {
-            unsigned char flag = point_flags[i];
-            if (flag & 4) {
-                int dy = data[data_index++];
-                if (!(flag & 32)) dy = -dy;
-                y += dy;
-            } else if (!(flag & 32)) {
-                y += glyph_ttf__get16(data, data_index);
-                data_index += 2;
-            }
-            y_coords[i] = y;
-        }
-
-        glyph_point_t** contours = (glyph_point_t**)GLYPH_MALLOC(numberOfContours * sizeof(glyph_point_t*));
-        int* contour_sizes = (int*)GLYPH_MALLOC(numberOfContours * sizeof(int));
-        
-        if (!contours || !contour_sizes) {
-            GLYPH_FREE(contours);
-            GLYPH_FREE(contour_sizes);
-            GLYPH_FREE(x_coords);
-            GLYPH_FREE(y_coords);
-            GLYPH_FREE(point_flags);
-            GLYPH_FREE(bitmap);
-            return NULL;
-        }
-        
-        for (int c = 0; c < numberOfContours; ++c) {
-            int start_pt = (c == 0) ? 0 : glyph_ttf__get16u(data, endPtsOfContours + (c - 1) * 2) + 1;
-            int end_pt = glyph_ttf__get16u(data, endPtsOfContours + c * 2);
-            int contour_len = end_pt - start_pt + 1;
-            
-            glyph_point_t* contour = (glyph_point_t*)GLYPH_MALLOC(contour_len * 3 * sizeof(glyph_point_t));
-            if (!contour) {
-                contours[c] = NULL;
-                contour_sizes[c] = 0;
-                continue;
-            }
-            
-            int out_idx = 0;
-            for (int p = start_pt; p <= end_pt; ++p) {
-                int next_p = (p == end_pt) ? start_pt : p + 1;
-                
-                contour[out_idx].x = (x_coords[p] - xMin) * scale_x;
-                contour[out_idx].y = (yMax - y_coords[p]) * scale_y;
-                contour[out_idx].on_curve = point_flags[p] & 1;
-                out_idx++;
-                
-                if (!(point_flags[p] & 1) && !(point_flags[next_p] & 1)) {
-                    contour[out_idx].x = ((x_coords[p] + x_coords[next_p]) * 0.5f - xMin) * scale_x;
-                    contour[out_idx].y = (yMax - (y_coords[p] + y_coords[next_p]) * 0.5f) * scale_y;
-                    contour[out_idx].on_curve = 1;
-                    out_idx++;
-                }
-            }
-            
-            contours[c] = contour;
-            contour_sizes[c] = out_idx;
+    int x = 0;
+    for (int i = 0; i < n_points; ++i) {
+        unsigned char flag = point_flags[i];
+        if (flag & 2) {
+            int dx = data[data_index++];
+            if (!(flag & 16)) dx = -dx;
+            x += dx;
+        } else if (!(flag & 16)) {
+            x += glyph_ttf__get16(data, data_index);
+            data_index += 2;
         }
-        
-        glyph_ttf__rasterize_shape(bitmap, w, h, contours, contour_sizes, numberOfContours);
-        
-        for (int c = 0; c < numberOfContours; ++c) {
-            GLYPH_FREE(contours[c]);
+        x_coords[i] = x;
+    }
+
+    int y = 0;
+    for (int i = 0; i < n_points; ++i) {
+        unsigned char flag = point_flags[i];
+        if (flag & 4) {
+            int dy = data[data_index++];
+            if (!(flag & 32)) dy = -dy;
+            y += dy;
+        } else if (!(flag & 32)) {
+            y += glyph_ttf__get16(data, data_index);
+            data_index += 2;
         }
-        GLYPH_FREE(contours);
-        GLYPH_FREE(contour_sizes);
+        y_coords[i] = y;
+    }
+
+    int start_pt = 0;
+    for (int c = 0; c < numberOfContours; ++c) {
+        int end_pt = glyph_ttf__get16u(data, endPtsOfContours + c * 2);
+        if (end_pt >= n_points) end_pt = n_points - 1;
+        if (end_pt < start_pt) continue;
+
+        for (int p = start_pt; p <= end_pt; ++p) {
+            int next_p = (p == end_pt) ? start_pt : p + 1;
+            glyph_ttf__shape_push(shape, m, (float)x_coords[p], (float)y_coords[p], point_flags[p] & 1);
+            if (!(point_flags[p] & 1) && !(point_flags[next_p] & 1)) {
+                glyph_ttf__shape_push(shape, m, (x_coords[p] + x_coords[next_p]) * 0.5f, (y_coords[p] + y_coords[next_p]) * 0.5f, 1);
+            }
+        }
+        shape->contour_ends[shape->num_contours++] = shape->num_points;
+        start_pt = end_pt + 1;
+    }
+
+    glyph__free(shape->allocator, x_coords);
+    glyph__free(shape->allocator, y_coords);
+    glyph__free(shape->allocator, point_flags);
+    return 1;
+}
+
+/* Appends an already decoded shape mapped through the transform m */
+static int glyph_ttf__append_shape(const glyph_ttf__shape_t* src, const float* m, glyph_ttf__shape_t* shape) {
+    if (!glyph_ttf__shape_reserve(shape, src->num_points, src->num_contours)) return 0;
+    int base = shape->num_points;
+    for (int i = 0; i < src->num_points; ++i) {
+        glyph_ttf__shape_push(shape, m, src->points[i].x, src->points[i].y, src->points[i].on_curve);
+    }
+    for (int c = 0; c < src->num_contours; ++c) {
+        shape->contour_ends[shape->num_contours++] = base + src->contour_ends[c];
+    }
+    return 1;
+}
 
-        GLYPH_FREE(x_coords);
-        GLYPH_FREE(y_coords);
-        GLYPH_FREE(point_flags);
+/* Composite glyph component flags (glyf table) */
+#define GLYPH_TTF__ARG_1_AND_2_ARE_WORDS    0x0001
+#define GLYPH_TTF__ARGS_ARE_XY_VALUES       0x0002
+#define GLYPH_TTF__WE_HAVE_A_SCALE          0x0008
+#define GLYPH_TTF__MORE_COMPONENTS          0x0020
+#define GLYPH_TTF__WE_HAVE_AN_X_AND_Y_SCALE 0x0040
+#define GLYPH_TTF__WE_HAVE_A_TWO_BY_TWO     0x0080
+#define GLYPH_TTF__SCALED_COMPONENT_OFFSET  0x0800
+#define GLYPH_TTF__UNSCALED_COMPONENT_OFFSET 0x1000
+
+/* Maximum composite nesting followed before giving up (guards against cyclic fonts) */
+#define GLYPH_TTF__MAX_COMPONENT_DEPTH 8
+
+/*
+ * Reads one composite glyph component record
+ *
+ * Parameters:
+ *   data: Font data
+ *   p: Offset of the record
+ *   glyph_index: Receives the component glyph
+ *   m: Receives the component transform {a, b, c, d, e, f}
+ *
+ * Returns: Offset of the next record, or 0 if this was the last component
+ */
+static int glyph_ttf__read_component(const unsigned char* data, int p, int* glyph_index, float* m) {
+    int flags = glyph_ttf__get16u(data, p);
+    *glyph_index = glyph_ttf__get16u(data, p + 2);
+    p += 4;
+
+    float dx, dy;
+    if (flags & GLYPH_TTF__ARG_1_AND_2_ARE_WORDS) {
+        dx = (float)glyph_ttf__get16(data, p);
+        dy = (float)glyph_ttf__get16(data, p + 2);
+        p += 4;
+    } else {
+        dx = (float)(signed char)data[p];
+        dy = (float)(signed char)data[p + 1];
+        p += 2;
+    }
+    if (!(flags & GLYPH_TTF__ARGS_ARE_XY_VALUES)) {
+        /* Point-matched anchors need hinted point positions; place the component unshifted */
+        dx = dy = 0.0f;
+    }
 
-        *width = w;
-        *height = h;
-        *xoff = (int)(xMin * scale_x);
-        *yoff = (int)(yMax * scale_y);
+    m[0] = 1.0f; m[1] = 0.0f; m[2] = 0.0f; m[3] = 1.0f;
+    if (flags & GLYPH_TTF__WE_HAVE_A_SCALE) {
+        m[0] = m[3] = glyph_ttf__get16(data, p) / 16384.0f; /* F2Dot14 */
+        p += 2;
+    } else if (flags & GLYPH_TTF__WE_HAVE_AN_X_AND_Y_SCALE) {
+        m[0] = glyph_ttf__get16(data, p) / 16384.0f;
+        m[3] = glyph_ttf__get16(data, p + 2) / 16384.0f;
+        p += 4;
+    } else if (flags & GLYPH_TTF__WE_HAVE_A_TWO_BY_TWO) {
+        m[0] = glyph_ttf__get16(data, p) / 16384.0f;
+        m[1] = glyph_ttf__get16(data, p + 2) / 16384.0f;
+        m[2] = glyph_ttf__get16(data, p + 4) / 16384.0f;
+        m[3] = glyph_ttf__get16(data, p + 6) / 16384.0f;
+        p += 8;
+    }
 
-        return bitmap;
+    /* Offsets are unscaled unless the font asks otherwise (Microsoft default) */
+    if ((flags & GLYPH_TTF__SCALED_COMPONENT_OFFSET) && !(flags & GLYPH_TTF__UNSCALED_COMPONENT_OFFSET)) {
+        m[4] = m[0] * dx + m[2] * dy;
+        m[5] = m[1] * dx + m[3] * dy;
     } else {
-        *width = 0;
-        *height = 0;
-        *xoff = 0;
-        *yoff = 0;
+        m[4] = dx;
+        m[5] = dy;
+    }
+    return (flags & GLYPH_TTF__MORE_COMPONENTS) ? p : 0;
+}
+
+/* Looks up a decoded outline in the font's cache (NULL if not cached) */
+static const glyph_ttf__shape_t* glyph_ttf__outline_cache_find(const glyph_ttf_outline_cache_t* cache, int glyph_index) {
+    if (!cache || glyph_index < 0 || glyph_index >= cache->num_glyphs) return NULL;
+    int entry = cache->entry_of[glyph_index];
+    return entry >= 0 ? &cache->entries[entry] : NULL;
+}
+
+/*
+ * Appends a glyph's contours in font units, following composite components
+ *
+ * Outlines found in font->outline_cache are copied instead of decoded.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   glyph_index: Glyph to append
+ *   m: Transform applied to the glyph (component transforms are composed onto it)
+ *   shape: Shape to append to
+ *   depth: Composite nesting level of this glyph
+ *
+ * Returns: 1 on success (empty glyphs add nothing), 0 on allocation failure
+ */
+static int glyph_ttf__append_glyph(const glyph_font_t* font, int glyph_index, const float* m, glyph_ttf__shape_t* shape, int depth) {
+    const glyph_ttf__shape_t* cached = glyph_ttf__outline_cache_find(font->outline_cache, glyph_index);
+    if (cached) return glyph_ttf__append_shape(cached, m, shape);
+
+    int g = glyph_ttf__get_glyph_offset(font, glyph_index);
+    if (g < 0) return 1;
+    int numberOfContours = glyph_ttf__get16(font->data, g);
+    if (numberOfContours > 0) return glyph_ttf__append_simple(font, g, numberOfContours, m, shape);
+    if (numberOfContours == 0 || depth >= GLYPH_TTF__MAX_COMPONENT_DEPTH) return 1;
+
+    int p = g + 10;
+    while (p) {
+        int component;
+        float cm[6];
+        p = glyph_ttf__read_component(font->data, p, &component, cm);
+
+        /* Child first, then this glyph's transform */
+        float combined[6];
+        combined[0] = m[0] * cm[0] + m[2] * cm[1];
+        combined[1] = m[1] * cm[0] + m[3] * cm[1];
+        combined[2] = m[0] * cm[2] + m[2] * cm[3];
+        combined[3] = m[1] * cm[2] + m[3] * cm[3];
+        combined[4] = m[0] * cm[4] + m[2] * cm[5] + m[4];
+        combined[5] = m[1] * cm[4] + m[3] * cm[5] + m[5];
+        if (!glyph_ttf__append_glyph(font, component, combined, shape, depth + 1)) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Decodes the components of a composite glyph into the font's outline cache
+ *
+ * Shared bases ("e" in "é", "è", "ê") are then parsed once instead of once
+ * per accented glyph. The cache is created on first use and released by
+ * glyph_ttf_free_font. This mutates the font: call it before handing the
+ * font to concurrent rasterization, which only reads the cache.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   glyph_index: Glyph whose components should be cached (simple glyphs are ignored)
+ *
+ * Returns: 1 on success, 0 on allocation failure (rasterization still works uncached)
+ */
+static inline int glyph_ttf_cache_components(glyph_font_t* font, int glyph_index) {
+    return glyph_ttf__cache_components(font, glyph_index, 0);
+}
+
+/* Creates the font's outline cache on first use */
+static int glyph_ttf__outline_cache_init(glyph_font_t* font) {
+    if (font->outline_cache) return 1;
+    glyph_ttf_outline_cache_t* cache = (glyph_ttf_outline_cache_t*)GLYPH_MALLOC(sizeof(glyph_ttf_outline_cache_t));
+    int* entry_of = font->numGlyphs > 0 ? (int*)GLYPH_MALLOC(font->numGlyphs * sizeof(int)) : NULL;
+    if (!cache || !entry_of) {
+        GLYPH_FREE(cache);
+        GLYPH_FREE(entry_of);
+        return 0;
+    }
+    memset(cache, 0, sizeof(glyph_ttf_outline_cache_t));
+    for (int i = 0; i < font->numGlyphs; ++i) entry_of[i] = -1;
+    cache->entry_of = entry_of;
+    cache->num_glyphs = font->numGlyphs;
+    font->outline_cache = cache;
+    return 1;
+}
+
+/*
+ * Decodes one glyph into the outline cache
+ *
+ * Components already in the cache are copied rather than decoded again.
+ *
+ * Returns: 1 on success (or when already cached), 0 on allocation failure
+ */
+static int glyph_ttf__outline_cache_add(glyph_font_t* font, int glyph_index, int depth) {
+    if (!glyph_ttf__outline_cache_init(font)) return 0;
+    glyph_ttf_outline_cache_t* cache = font->outline_cache;
+    if (glyph_index < 0 || glyph_index >= cache->num_glyphs || glyph_ttf__outline_cache_find(cache, glyph_index)) return 1;
+
+    if (cache->count == cache->capacity) {
+        int capacity = cache->capacity ? cache->capacity * 2 : 16;
+        glyph_ttf__shape_t* entries = (glyph_ttf__shape_t*)GLYPH_REALLOC(cache->entries, capacity * sizeof(glyph_ttf__shape_t));
+        if (!entries) return 0;
+        cache->entries = entries;
+        cache->capacity = capacity;
+    }
+    const float identity[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    glyph_ttf__shape_t* entry = &cache->entries[cache->count];
+    memset(entry, 0, sizeof(glyph_ttf__shape_t));
+    if (!glyph_ttf__append_glyph(font, glyph_index, identity, entry, depth)) {
+        glyph_ttf__shape_free(entry);
+        return 0;
+    }
+    cache->entry_of[glyph_index] = cache->count++;
+    return 1;
+}
+
+static int glyph_ttf__cache_components(glyph_font_t* font, int glyph_index, int depth) {
+    int g = glyph_ttf__get_glyph_offset(font, glyph_index);
+    if (g < 0 || glyph_ttf__get16(font->data, g) >= 0 || depth >= GLYPH_TTF__MAX_COMPONENT_DEPTH) return 1;
+    if (!glyph_ttf__outline_cache_init(font)) return 0;
+
+    int p = g + 10;
+    while (p) {
+        int component;
+        float cm[6];
+        p = glyph_ttf__read_component(font->data, p, &component, cm);
+        if (glyph_ttf__outline_cache_find(font->outline_cache, component)) continue;
+
+        /* Nested composites cache their own components first, so this decode reuses them */
+        if (!glyph_ttf__cache_components(font, component, depth + 1)) return 0;
+        if (!glyph_ttf__outline_cache_add(font, component, depth + 1)) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Decodes a whole glyph outline into the font's outline cache
+ *
+ * The contours are kept in font units, so every later rasterization of the
+ * glyph (any size, coverage, SDF or MSDF) scales the cached points instead
+ * of decoding the glyf data again. Components are cached along the way.
+ * Like glyph_ttf_cache_components this mutates the font: call it before
+ * concurrent rasterization, which only reads the cache.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   glyph_index: Glyph to cache
+ *
+ * Returns: 1 on success, 0 on allocation failure (rasterization still works uncached)
+ */
+static inline int glyph_ttf_cache_outline(glyph_font_t* font, int glyph_index) {
+    if (!glyph_ttf__cache_components(font, glyph_index, 0)) return 0;
+    return glyph_ttf__outline_cache_add(font, glyph_index, 0);
+}
+
+/* Releases an outline cache and all of its decoded shapes */
+static void glyph_ttf__outline_cache_free(glyph_ttf_outline_cache_t* cache) {
+    if (!cache) return;
+    for (int i = 0; i < cache->count; ++i) glyph_ttf__shape_free(&cache->entries[i]);
+    GLYPH_FREE(cache->entries);
+    GLYPH_FREE(cache->entry_of);
+    GLYPH_FREE(cache);
+}
+
+/*
+ * Decodes a glyph's contours into pixel space
+ *
+ * Simple and composite glyphs are supported; composite components are
+ * placed with their offsets and scale/2x2 transforms.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   glyph_index: Glyph to decode
+ *   scale_x, scale_y: Font units to pixel scale factors
+ *   outline: Receives the contours and bitmap metrics
+ *   allocator: Source of the outline and decoding temporaries (NULL = GLYPH_MALLOC)
+ *
+ * Returns: 1 on success, 0 for empty glyphs or allocation failure
+ */
+static int glyph_ttf__load_outline(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, glyph_ttf__outline_t* outline,
+                                   const glyph_allocator_t* allocator) {
+    const unsigned char* data = font->data;
+    memset(outline, 0, sizeof(glyph_ttf__outline_t));
+    outline->allocator = allocator;
+    int g = glyph_ttf__get_glyph_offset(font, glyph_index);
+    if (g < 0) return 0;
+
+    int numberOfContours = glyph_ttf__get16(data, g);
+    if (numberOfContours == 0) return 0;
+
+    /* Composite headers carry the bounding box of the assembled glyph */
+    int xMin = glyph_ttf__get16(data, g + 2);
+    int yMax = glyph_ttf__get16(data, g + 8);
+    int xMax = glyph_ttf__get16(data, g + 6);
+    int yMin = glyph_ttf__get16(data, g + 4);
+
+    int w = (int)ceilf((xMax - xMin) * scale_x) + 1;
+    int h = (int)ceilf((yMax - yMin) * scale_y) + 1;
+    if (w <= 0 || h <= 0) return 0;
+
+    /* Cached outlines are scaled straight from the cache, anything else is decoded first */
+    glyph_ttf__shape_t shape;
+    memset(&shape, 0, sizeof(shape));
+    shape.allocator = allocator;
+    const glyph_ttf__shape_t* src = glyph_ttf__outline_cache_find(font->outline_cache, glyph_index);
+    if (!src) {
+        const float identity[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+        if (!glyph_ttf__append_glyph(font, glyph_index, identity, &shape, 0)) {
+            glyph_ttf__shape_free(&shape);
+            return 0;
+        }
+        src = &shape;
+    }
+    if (src->num_contours == 0) {
+        glyph_ttf__shape_free(&shape);
+        return 0;
+    }
+
+    glyph_point_t** contours = (glyph_point_t**)glyph__alloc(allocator, src->num_contours * sizeof(glyph_point_t*));
+    int* contour_sizes = (int*)glyph__alloc(allocator, src->num_contours * sizeof(int));
+    if (!contours || !contour_sizes) {
+        glyph__free(allocator, contours);
+        glyph__free(allocator, contour_sizes);
+        glyph_ttf__shape_free(&shape);
+        return 0;
+    }
+
+    /* Font units (Y up) to pixels relative to the top-left of the scaled box (Y down) */
+    int start = 0;
+    for (int c = 0; c < src->num_contours; ++c) {
+        int contour_len = src->contour_ends[c] - start;
+        glyph_point_t* contour = contour_len > 0 ? (glyph_point_t*)glyph__alloc(allocator, contour_len * sizeof(glyph_point_t)) : NULL;
+        contours[c] = contour;
+        contour_sizes[c] = contour ? contour_len : 0;
+        for (int i = 0; contour && i < contour_len; ++i) {
+            const glyph_point_t* point = &src->points[start + i];
+            contour[i].x = (point->x - xMin) * scale_x;
+            contour[i].y = (yMax - point->y) * scale_y;
+            contour[i].on_curve = point->on_curve;
+        }
+        start = src->contour_ends[c];
+    }
+
+    outline->contours = contours;
+    outline->contour_sizes = contour_sizes;
+    outline->num_contours = src->num_contours;
+    outline->width = w;
+    outline->height = h;
+    outline->xoff = (int)(xMin * scale_x);
+    outline->yoff = (int)(yMax * scale_y);
+    glyph_ttf__shape_free(&shape);
+    return 1;
+}
+
+/*
+ * Rewinds a scratch's temp arena and wraps it in the allocator interface
+ *
+ * Returns: temp, or NULL (GLYPH_MALLOC) when there is no scratch
+ */
+static const glyph_allocator_t* glyph_ttf__scratch_temp(glyph_raster_scratch_t* scratch, glyph_allocator_t* temp) {
+    if (!scratch) return NULL;
+    glyph_arena_reset(&scratch->temp);
+    scratch->temp.backing = scratch->allocator;
+    *temp = glyph_arena_allocator(&scratch->temp);
+    return temp;
+}
+
+/*
+ * Rasterizes a glyph, choosing where the bitmap is allocated
+ *
+ * Same as glyph_ttf_get_glyph_bitmap_ex, except that with temporary set the
+ * bitmap is placed in the scratch's temp arena: it must not be freed and
+ * stays valid until the next call with the same scratch. Used when the
+ * coverage only feeds a distance field.
+ */
+static unsigned char* glyph_ttf__get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y,
+                                                  int* width, int* height, int* xoff, int* yoff, glyph_raster_scratch_t* scratch, int temporary) {
+    glyph_ttf__outline_t outline;
+    glyph_allocator_t temp;
+    const glyph_allocator_t* temp_allocator = glyph_ttf__scratch_temp(scratch, &temp);
+    const glyph_allocator_t* output = scratch && !temporary ? scratch->allocator : temp_allocator;
+    *width = 0;
+    *height = 0;
+    *xoff = 0;
+    *yoff = 0;
+    if (!glyph_ttf__load_outline(font, glyph_index, scale_x, scale_y, &outline, temp_allocator)) return NULL;
+
+    unsigned char* bitmap = (unsigned char*)glyph__alloc(output, (size_t)outline.width * outline.height);
+    if (!bitmap || !glyph_ttf__rasterize_shape(bitmap, outline.width, outline.height, outline.contours, outline.contour_sizes,
+                                               outline.num_contours, scratch)) {
+        glyph__free(output, bitmap);
+        glyph_ttf__free_outline(&outline);
         return NULL;
     }
+    glyph_ttf__free_outline(&outline);
+
+    *width = outline.width;
+    *height = outline.height;
+    *xoff = outline.xoff;
+    *yoff = outline.yoff;
+    return bitmap;
+}
+
+/*
+ * Rasterizes a glyph into an 8-bit anti-aliased coverage bitmap
+ *
+ * Parameters:
+ *   font: Font structure
+ *   glyph_index: Glyph to rasterize
+ *   scale_x, scale_y: Font units to pixel scale factors
+ *   width, height: Receive the bitmap size
+ *   xoff, yoff: Receive the bitmap's left and top edges relative to the pen (Y up)
+ *   scratch: Working memory reused across calls, or NULL for temporary buffers
+ *
+ * Returns: Bitmap allocated from scratch->allocator, or with GLYPH_MALLOC
+ *          (free with glyph_ttf_free_bitmap) when there is no scratch or
+ *          allocator; NULL for empty glyphs and on failure
+ */
+static inline unsigned char* glyph_ttf_get_glyph_bitmap_ex(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y,
+                                                           int* width, int* height, int* xoff, int* yoff, glyph_raster_scratch_t* scratch) {
+    return glyph_ttf__get_glyph_bitmap(font, glyph_index, scale_x, scale_y, width, height, xoff, yoff, scratch, 0);
+}
+
+/* Rasterizes a glyph with a temporary accumulation buffer (see glyph_ttf_get_glyph_bitmap_ex) */
+static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int* width, int* height, int* xoff, int* yoff) {
+    return glyph_ttf_get_glyph_bitmap_ex(font, glyph_index, scale_x, scale_y, width, height, xoff, yoff, NULL);
 }
 
 static inline void glyph_ttf_free_bitmap(unsigned char* bitmap) {
@@ -646,120 +1827,354 @@ static glyph_image_t glyph_ttf_render_glyph_to_image(const glyph_font_t* font, i
     return img;
 }
 
+#ifndef GLYPHGL_NO_MMAP
+/*
+ * Maps a whole file read-only into memory
+ *
+ * Pages are only read from disk when first touched, so the unused parts of
+ * a large font never become resident.
+ *
+ * Returns: 1 on success (data/size set), 0 if the file cannot be mapped
+ */
+static int glyph_ttf__map_file(const char* filename, unsigned char** data, size_t* size) {
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 || (unsigned long long)file_size.QuadPart > (size_t)-1) {
+        CloseHandle(file);
+        return 0;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return 0;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); /* The view keeps the mapping alive */
+    if (!view) return 0;
+    *data = (unsigned char*)view;
+    *size = (size_t)file_size.QuadPart;
+    return 1;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* The mapping keeps the file referenced */
+    if (view == MAP_FAILED) return 0;
+#ifdef MADV_RANDOM
+    madvise(view, (size_t)st.st_size, MADV_RANDOM); /* Glyph access is scattered: skip read-ahead */
+#endif
+    *data = (unsigned char*)view;
+    *size = (size_t)st.st_size;
+    return 1;
+#endif
+}
+
+/* Releases a mapping created by glyph_ttf__map_file */
+static void glyph_ttf__unmap_file(unsigned char* data, size_t size) {
+#if defined(_WIN32) || defined(_WIN64)
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+#endif
+
+/*
+ * Loads a font file for parsing
+ *
+ * The file is memory-mapped when possible so tables are read in place and
+ * only touched pages are loaded; otherwise (or with GLYPHGL_NO_MMAP) it is
+ * read into a heap buffer. Either way glyph_ttf_free_font releases it.
+ *
+ * Parameters:
+ *   font: Font structure to initialize
+ *   filename: Path to a .ttf/.otf file
+ *
+ * Returns: 1 on success, 0 if the file cannot be read or is not a font
+ */
 static int glyph_ttf_load_font_from_file(glyph_font_t* font, const char* filename) {
+#ifndef GLYPHGL_NO_MMAP
+    unsigned char* mapped;
+    size_t mapped_size;
+    if (glyph_ttf__map_file(filename, &mapped, &mapped_size)) {
+        int result = mapped_size >= 12 && glyph_ttf_init(font, mapped, 0);
+        if (!result) {
+            glyph_ttf__unmap_file(mapped, mapped_size);
+            font->data = NULL;
+            return 0;
+        }
+        font->data_size = mapped_size;
+        font->data_source = GLYPH_TTF_DATA_MAPPED;
+        return 1;
+    }
+#endif
     FILE* f = fopen(filename, "rb");
     if (!f) return 0;
     fseek(f, 0, SEEK_END);
-    size_t size = ftell(f);
+    long length = ftell(f);
     fseek(f, 0, SEEK_SET);
+    if (length < 12) {
+        fclose(f);
+        return 0;
+    }
+    size_t size = (size_t)length;
     unsigned char* data = (unsigned char*)GLYPH_MALLOC(size);
     if (!data) {
         fclose(f);
         return 0;
     }
-    fread(data, 1, size, f);
+    size_t read = fread(data, 1, size, f);
     fclose(f);
-    int result = glyph_ttf_init(font, data, 0);
-    if (!result) GLYPH_FREE(data);
-    return result;
+    int result = read == size && glyph_ttf_init(font, data, 0);
+    if (!result) {
+        GLYPH_FREE(data);
+        font->data = NULL;
+        return 0;
+    }
+    font->data_size = size;
+    return 1;
+}
+
+/*
+ * Initializes a font from a caller-owned memory blob (e.g. an asset pack)
+ *
+ * Nothing is copied: the font reads the blob in place, so it must stay
+ * valid and unchanged until glyph_ttf_free_font, which leaves it untouched.
+ *
+ * Parameters:
+ *   font: Font structure to initialize
+ *   data: Font file contents
+ *   size: Size of data in bytes
+ *
+ * Returns: 1 on success, 0 if data is not a font
+ */
+static int glyph_ttf_load_font_from_memory(glyph_font_t* font, const unsigned char* data, size_t size) {
+    if (!data || size < 12 || !glyph_ttf_init(font, data, 0)) {
+        font->data = NULL;
+        return 0;
+    }
+    font->data_size = size;
+    font->data_source = GLYPH_TTF_DATA_BORROWED;
+    return 1;
 }
 
 static void glyph_ttf_free_font(glyph_font_t* font) {
-    if (font->data) GLYPH_FREE(font->data);
+    if (font->data) {
+#ifndef GLYPHGL_NO_MMAP
+        if (font->data_source == GLYPH_TTF_DATA_MAPPED) glyph_ttf__unmap_file(font->data, font->data_size);
+#endif
+        if (font->data_source == GLYPH_TTF_DATA_HEAP) GLYPH_FREE(font->data);
+    }
     font->data = NULL;
+    font->data_size = 0;
+    glyph_ttf__outline_cache_free(font->outline_cache);
+    font->outline_cache = NULL;
+    GLYPH_FREE(font->glyph_cache);
+    font->glyph_cache = NULL;
+    font->glyph_cache_size = 0;
+    GLYPH_FREE(font->kern_subtables);
+    font->kern_subtables = NULL;
+    font->num_kern_subtables = 0;
 }
 
 /*
- * Converts an alpha bitmap to a Signed Distance Field (SDF) representation
- *
- * SDFs store the distance from each pixel to the nearest edge, allowing for
- * high-quality scaling and effects. This implementation uses a two-pass
- * distance transform algorithm for accurate distance calculation.
+ * Releases the buffers of an SDF scratch and resets it for reuse (the allocator is kept)
  *
  * Parameters:
- *   bitmap: Input alpha bitmap (0-255 alpha values)
- *   w, h: Bitmap dimensions
- *   spread: Maximum distance to encode (in pixels)
+ *   scratch: Scratch to release
+ */
+static inline void glyph_sdf_scratch_free(glyph_sdf_scratch_t* scratch) {
+    if (!scratch) return;
+    glyph__free(scratch->allocator, scratch->outer);
+    glyph__free(scratch->allocator, scratch->inner);
+    glyph__free(scratch->allocator, scratch->f);
+    glyph__free(scratch->allocator, scratch->d);
+    glyph__free(scratch->allocator, scratch->z);
+    glyph__free(scratch->allocator, scratch->v);
+    const glyph_allocator_t* allocator = scratch->allocator;
+    memset(scratch, 0, sizeof(glyph_sdf_scratch_t));
+    scratch->allocator = allocator;
+}
+
+/*
+ * Grows an SDF scratch to hold a w x h grid
  *
- * Returns: New SDF bitmap with distance-encoded values (0-255)
- *          Negative distances (inside) map to 0-127, positive (outside) to 128-255
+ * Returns: 1 on success, 0 on allocation failure
  */
-static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitmap, int w, int h, int spread) {
-    /* Create binary mask from alpha bitmap */
-    unsigned char* mask = (unsigned char*)GLYPH_MALLOC(w * h);
-    for(int i = 0; i < w * h; i++) {
-        mask[i] = bitmap[i] > 127 ? 1 : 0;  /* Threshold to binary */
+static int glyph_sdf__scratch_reserve(glyph_sdf_scratch_t* scratch, int w, int h) {
+    size_t cells = (size_t)w * h;
+    if (cells > scratch->grid_capacity) {
+        float* outer = (float*)glyph__realloc(scratch->allocator, scratch->outer, cells * sizeof(float));
+        if (outer) scratch->outer = outer;
+        float* inner = (float*)glyph__realloc(scratch->allocator, scratch->inner, cells * sizeof(float));
+        if (inner) scratch->inner = inner;
+        if (!outer || !inner) return 0;
+        scratch->grid_capacity = cells;
     }
 
-    /* Distance transform for outside distances (dt1) */
-    float* dt1 = (float*)GLYPH_MALLOC(w * h * sizeof(float));
-    for(int i = 0; i < w * h; i++) dt1[i] = mask[i] ? 0.0f : 1e9f;  /* Init distances */
+    int line = w > h ? w : h;
+    if (line > scratch->line_capacity) {
+        float* f = (float*)glyph__realloc(scratch->allocator, scratch->f, line * sizeof(float));
+        if (f) scratch->f = f;
+        float* d = (float*)glyph__realloc(scratch->allocator, scratch->d, line * sizeof(float));
+        if (d) scratch->d = d;
+        float* z = (float*)glyph__realloc(scratch->allocator, scratch->z, (line + 1) * sizeof(float));
+        if (z) scratch->z = z;
+        int* v = (int*)glyph__realloc(scratch->allocator, scratch->v, line * sizeof(int));
+        if (v) scratch->v = v;
+        if (!f || !d || !z || !v) return 0;
+        scratch->line_capacity = line;
+    }
+    return 1;
+}
 
-    /* Forward pass (left to right, top to bottom) */
-    for(int y = 0; y < h; y++) {
-        for(int x = 0; x < w; x++) {
-            int idx = y * w + x;
-            if (x > 0) dt1[idx] = fminf(dt1[idx], dt1[idx-1] + 1.0f);
-        }
-        for(int x = w-1; x >= 0; x--) {
-            int idx = y * w + x;
-            if (x < w-1) dt1[idx] = fminf(dt1[idx], dt1[idx+1] + 1.0f);
+/*
+ * Exact 1D squared Euclidean distance transform (Felzenszwalb & Huttenlocher)
+ *
+ * Computes d[q] = min_p ((q - p)^2 + f[p]) as the lower envelope of the
+ * parabolas rooted at every sample, in O(n).
+ */
+static void glyph_sdf__edt_1d(const float* f, float* d, int* v, float* z, int n) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -1e20f;
+    z[1] = 1e20f;
+    for (int q = 1; q < n; q++) {
+        /* Pop parabolas hidden by the one rooted at q; z[0] = -1e20 stops the loop since f <= 1e20 */
+        float s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (float)(2 * (q - v[k]));
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (float)(2 * (q - v[k]));
         }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = 1e20f;
     }
-    for(int x = 0; x < w; x++) {
-        for(int y = 0; y < h; y++) {
-            int idx = y * w + x;
-            if (y > 0) dt1[idx] = fminf(dt1[idx], dt1[(y-1)*w + x] + 1.0f);
-        }
-        for(int y = h-1; y >= 0; y--) {
-            int idx = y * w + x;
-            if (y < h-1) dt1[idx] = fminf(dt1[idx], dt1[(y+1)*w + x] + 1.0f);
-        }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < (float)q) k++;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
     }
+}
 
-    /* Distance transform for inside distances (dt0) */
-    float* dt0 = (float*)GLYPH_MALLOC(w * h * sizeof(float));
-    for(int i = 0; i < w * h; i++) dt0[i] = mask[i] ? 1e9f : 0.0f;  /* Init distances */
+/*
+ * 2D squared Euclidean distance transform: columns, then rows
+ */
+static void glyph_sdf__edt_2d(float* grid, int w, int h, glyph_sdf_scratch_t* scratch) {
+    for (int x = 0; x < w; x++) {
+        for (int y = 0; y < h; y++) scratch->f[y] = grid[y * w + x];
+        glyph_sdf__edt_1d(scratch->f, scratch->d, scratch->v, scratch->z, h);
+        for (int y = 0; y < h; y++) grid[y * w + x] = scratch->d[y];
+    }
+    for (int y = 0; y < h; y++) {
+        memcpy(scratch->f, grid + (size_t)y * w, w * sizeof(float));
+        glyph_sdf__edt_1d(scratch->f, grid + (size_t)y * w, scratch->v, scratch->z, w);
+    }
+}
 
-    /* Forward pass for inside distances */
-    for(int y = 0; y < h; y++) {
-        for(int x = 0; x < w; x++) {
-            int idx = y * w + x;
-            if (x > 0) dt0[idx] = fminf(dt0[idx], dt0[idx-1] + 1.0f);
-        }
-        for(int x = w-1; x >= 0; x--) {
-            int idx = y * w + x;
-            if (x < w-1) dt0[idx] = fminf(dt0[idx], dt0[idx+1] + 1.0f);
-        }
+/*
+ * Converts an anti-aliased coverage bitmap to a Signed Distance Field
+ *
+ * Uses an exact Euclidean distance transform in O(pixels). Partially covered
+ * pixels seed sub-pixel distances from their coverage (the edge is taken to
+ * lie where coverage crosses 50%), so the field follows the anti-aliased
+ * outline rather than a thresholded mask.
+ *
+ * Parameters:
+ *   bitmap: Input coverage bitmap (0-255)
+ *   w, h: Bitmap dimensions
+ *   spread: Distance in pixels mapped to the ends of the 0-255 range
+ *   padding: Empty border added on every side so the field can fall off
+ *            outside the glyph box (usually equal to spread)
+ *   scratch: Reusable working memory, or NULL for temporary buffers
+ *
+ * Returns: New (w + 2*padding) x (h + 2*padding) bitmap allocated from
+ *          scratch->allocator (GLYPH_MALLOC without one), or NULL on failure. Outside maps to 0-127, the
+ *          edge to 127.5 and inside to 128-255, so an empty (zeroed) atlas
+ *          background reads as far outside under bilinear filtering
+ */
+static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap_ex(const unsigned char* bitmap, int w, int h, int spread, int padding,
+                                                               glyph_sdf_scratch_t* scratch) {
+    if (!bitmap || w <= 0 || h <= 0) return NULL;
+    if (spread < 1) spread = 1;
+    if (padding < 0) padding = 0;
+
+    glyph_sdf_scratch_t local;
+    memset(&local, 0, sizeof(local));
+    glyph_sdf_scratch_t* work = scratch ? scratch : &local;
+
+    int pw = w + 2 * padding;
+    int ph = h + 2 * padding;
+    unsigned char* sdf = (unsigned char*)glyph__alloc(work->allocator, (size_t)pw * ph);
+    if (!sdf || !glyph_sdf__scratch_reserve(work, pw, ph)) {
+        glyph__free(work->allocator, sdf);
+        glyph_sdf_scratch_free(&local);
+        return NULL;
     }
-    for(int x = 0; x < w; x++) {
-        for(int y = 0; y < h; y++) {
-            int idx = y * w + x;
-            if (y > 0) dt0[idx] = fminf(dt0[idx], dt0[(y-1)*w + x] + 1.0f);
-        }
-        for(int y = h-1; y >= 0; y--) {
-            int idx = y * w + x;
-            if (y < h-1) dt0[idx] = fminf(dt0[idx], dt0[(y+1)*w + x] + 1.0f);
+
+    /* Seed both fields: 0 on the reference side, squared sub-pixel edge distance on partial pixels */
+    const float inf = 1e20f;
+    for (int y = 0; y < ph; y++) {
+        for (int x = 0; x < pw; x++) {
+            int bx = x - padding;
+            int by = y - padding;
+            float a = (bx >= 0 && bx < w && by >= 0 && by < h) ? bitmap[by * w + bx] / 255.0f : 0.0f;
+            size_t i = (size_t)y * pw + x;
+            if (a >= 1.0f) {
+                work->outer[i] = 0.0f;
+                work->inner[i] = inf;
+            } else if (a <= 0.0f) {
+                work->outer[i] = inf;
+                work->inner[i] = 0.0f;
+            } else {
+                float out = a < 0.5f ? 0.5f - a : 0.0f;
+                float in = a > 0.5f ? a - 0.5f : 0.0f;
+                work->outer[i] = out * out;
+                work->inner[i] = in * in;
+            }
         }
     }
 
-    /* Generate final SDF bitmap */
-    unsigned char* sdf = (unsigned char*)GLYPH_MALLOC(w * h);
-    for(int i = 0; i < w * h; i++) {
-        /* Calculate signed distance (negative inside, positive outside) */
-        float dist = mask[i] ? -dt0[i] : dt1[i];
+    glyph_sdf__edt_2d(work->outer, pw, ph, work);
+    glyph_sdf__edt_2d(work->inner, pw, ph, work);
+
+    for (size_t i = 0; i < (size_t)pw * ph; i++) {
+        /* Signed distance: positive inside, negative outside */
+        float dist = sqrtf(work->inner[i]) - sqrtf(work->outer[i]);
+        float value = (dist / spread + 1.0f) * 0.5f * 255.0f;
         /* Clamp to spread range */
-        if (dist < -spread) dist = -spread;
-        if (dist > spread) dist = spread;
-        /* Map to 0-255 range: -spread -> 0, 0 -> 127, +spread -> 255 */
-        sdf[i] = (unsigned char)((dist / spread + 1.0f) * 0.5f * 255.0f);
+        sdf[i] = (unsigned char)(value <= 0.0f ? 0.0f : (value >= 255.0f ? 255.0f : value + 0.5f));
     }
 
-    /* Clean up temporary buffers */
-    GLYPH_FREE(mask);
-    GLYPH_FREE(dt1);
-    GLYPH_FREE(dt0);
+    glyph_sdf_scratch_free(&local);
     return sdf;
 }
 
+/*
+ * Converts an alpha bitmap to a Signed Distance Field (SDF) representation
+ *
+ * Same-size convenience wrapper around glyph_ttf_get_glyph_sdf_bitmap_ex
+ * without padding or a reusable scratch. Atlases use the padded variant.
+ *
+ * Parameters:
+ *   bitmap: Input alpha bitmap (0-255 alpha values)
+ *   w, h: Bitmap dimensions
+ *   spread: Maximum distance to encode (in pixels)
+ *
+ * Returns: New SDF bitmap with distance-encoded values (0-255)
+ *          Outside distances map to 0-127, inside distances to 128-255
+ */
+static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitmap, int w, int h, int spread) {
+    return glyph_ttf_get_glyph_sdf_bitmap_ex(bitmap, w, h, spread, 0, NULL);
+}
+
 #endif
\ No newline at end of file
@@ -5,9 +5,12 @@
  * utilities for the GlyphGL library. All memory operations can be overridden
  * by defining custom GLYPH_MALLOC, GLYPH_FREE, and GLYPH_REALLOC macros before
  * including this header, allowing integration with custom allocators.
+ * Atlas builds can additionally take a per-call allocator (glyph_allocator_t)
+ * and keep their scratch memory in bump arenas (glyph_arena_t).
  *
  * The debugging system provides conditional logging that can be enabled by
- * defining GLYPHGL_DEBUG before including GlyphGL headers.
+ * defining GLYPHGL_DEBUG before including GlyphGL headers. Defining
+ * GLYPHGL_STATS compiles in the hot-path counters and phase timers.
  */
 
 #ifndef GLYPH_UTIL_H
@@ -15,6 +18,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 /* Portable byte swap functions for C99 compatibility */
 static inline uint16_t glyph__bswap16(uint16_t val) {
@@ -55,6 +59,227 @@ static inline uint32_t glyph__bswap32(uint32_t val) {
 #define GLYPH_REALLOC realloc
 #endif
 
+/*
+ * Allocator interface with a user pointer
+ *
+ * Passed to atlas builds (glyph_atlas_config_t.allocator) and scratch
+ * buffers so memory can come from a pool or arena owned by the
+ * application. Set all three callbacks; a NULL allocator (or NULL alloc
+ * callback) falls back to GLYPH_MALLOC/GLYPH_REALLOC/GLYPH_FREE.
+ */
+typedef struct {
+    void* (*alloc)(void* user, size_t size);              /* Returns NULL on failure */
+    void* (*realloc)(void* user, void* ptr, size_t size); /* ptr may be NULL */
+    void (*free)(void* user, void* ptr);                  /* ptr may be NULL */
+    void* user;                                           /* Passed to every callback */
+} glyph_allocator_t;
+
+/* Allocates through an allocator, or GLYPH_MALLOC when it is NULL */
+static inline void* glyph__alloc(const glyph_allocator_t* allocator, size_t size) {
+    if (allocator && allocator->alloc) return allocator->alloc(allocator->user, size);
+    return GLYPH_MALLOC(size);
+}
+
+/* Resizes through an allocator, or GLYPH_REALLOC when it is NULL */
+static inline void* glyph__realloc(const glyph_allocator_t* allocator, void* ptr, size_t size) {
+    if (allocator && allocator->alloc) return allocator->realloc(allocator->user, ptr, size);
+    return GLYPH_REALLOC(ptr, size);
+}
+
+/* Frees through an allocator, or GLYPH_FREE when it is NULL */
+static inline void glyph__free(const glyph_allocator_t* allocator, void* ptr) {
+    if (!ptr) return;
+    if (allocator && allocator->alloc) {
+        allocator->free(allocator->user, ptr);
+    } else {
+        GLYPH_FREE(ptr);
+    }
+}
+
+/* Default size of the blocks an arena requests from its backing allocator */
+#ifndef GLYPH_ARENA_BLOCK_SIZE
+#define GLYPH_ARENA_BLOCK_SIZE 65536
+#endif
+
+/* Alignment of arena allocations; also the size of the header in front of each one */
+#define GLYPH_ARENA__ALIGN 16
+
+/* Arena block header, followed by the block's memory */
+typedef struct glyph_arena__block_t {
+    struct glyph_arena__block_t* next; /* Next block in allocation order */
+    size_t size;                       /* Usable bytes after the header */
+    size_t used;                       /* Bytes handed out, headers included */
+} glyph_arena__block_t;
+
+/*
+ * Bump allocator for short-lived memory
+ *
+ * Allocations are carved from large blocks and never freed one by one:
+ * glyph_arena_reset rewinds the arena while keeping its blocks for reuse,
+ * and glyph_arena_release returns every block to the backing allocator.
+ * The most recent allocation can grow in place. A zero-initialized arena
+ * is empty and ready to use with the default backing allocator and block
+ * size. Arenas are not thread-safe; use one per thread.
+ */
+typedef struct {
+    const glyph_allocator_t* backing;  /* Source of blocks (NULL = GLYPH_MALLOC) */
+    size_t block_size;                 /* Minimum block size (0 = GLYPH_ARENA_BLOCK_SIZE) */
+    glyph_arena__block_t* first;       /* First block, NULL while empty */
+    glyph_arena__block_t* current;     /* Block allocations are carved from */
+    void* last;                        /* Most recent allocation, may grow in place */
+} glyph_arena_t;
+
+/* Block header size padded to the arena alignment */
+#define GLYPH_ARENA__HEADER ((sizeof(glyph_arena__block_t) + GLYPH_ARENA__ALIGN - 1) & ~(size_t)(GLYPH_ARENA__ALIGN - 1))
+
+/* Start of a block's memory */
+static inline unsigned char* glyph_arena__block_data(glyph_arena__block_t* block) {
+    return (unsigned char*)block + GLYPH_ARENA__HEADER;
+}
+
+/*
+ * Allocates memory from an arena
+ *
+ * Parameters:
+ *   arena: Arena to allocate from
+ *   size: Bytes needed
+ *
+ * Returns: GLYPH_ARENA__ALIGN-aligned memory valid until the next reset or
+ *          release, or NULL when the backing allocator fails
+ */
+static inline void* glyph_arena_alloc(glyph_arena_t* arena, size_t size) {
+    size_t need = GLYPH_ARENA__ALIGN + ((size + GLYPH_ARENA__ALIGN - 1) & ~(size_t)(GLYPH_ARENA__ALIGN - 1));
+
+    /* Carry on in the current block, then in blocks kept by a reset */
+    glyph_arena__block_t* block = arena->current;
+    while (block && block->used + need > block->size) {
+        block = block->next;
+        if (block) block->used = 0;
+    }
+    if (!block) {
+        size_t block_size = arena->block_size ? arena->block_size : GLYPH_ARENA_BLOCK_SIZE;
+        if (block_size < need) block_size = need;
+        block = (glyph_arena__block_t*)glyph__alloc(arena->backing, GLYPH_ARENA__HEADER + block_size);
+        if (!block) return NULL;
+        block->size = block_size;
+        block->used = 0;
+        block->next = NULL;
+        if (arena->current) {
+            /* Link after the current block so kept blocks are still visited after a reset */
+            block->next = arena->current->next;
+            arena->current->next = block;
+        } else {
+            arena->first = block;
+        }
+    }
+    arena->current = block;
+
+    unsigned char* header = glyph_arena__block_data(block) + block->used;
+    block->used += need;
+    memcpy(header, &size, sizeof(size));
+    arena->last = header + GLYPH_ARENA__ALIGN;
+    return arena->last;
+}
+
+/*
+ * Resizes an arena allocation
+ *
+ * The most recent allocation grows in place while its block has room;
+ * anything else is copied into a new allocation (the old one stays
+ * reserved until the arena is reset).
+ *
+ * Parameters:
+ *   arena: Arena that owns ptr
+ *   ptr: Allocation to resize (NULL allocates)
+ *   size: New size in bytes
+ *
+ * Returns: Resized allocation, or NULL on failure (ptr stays valid)
+ */
+static inline void* glyph_arena_realloc(glyph_arena_t* arena, void* ptr, size_t size) {
+    if (!ptr) return glyph_arena_alloc(arena, size);
+
+    size_t old_size;
+    unsigned char* header = (unsigned char*)ptr - GLYPH_ARENA__ALIGN;
+    memcpy(&old_size, header, sizeof(old_size));
+    if (ptr == arena->last) {
+        glyph_arena__block_t* block = arena->current;
+        size_t start = (size_t)(header - glyph_arena__block_data(block));
+        size_t need = GLYPH_ARENA__ALIGN + ((size + GLYPH_ARENA__ALIGN - 1) & ~(size_t)(GLYPH_ARENA__ALIGN - 1));
+        if (start + need <= block->size) {
+            block->used = start + need;
+            memcpy(header, &size, sizeof(size));
+            return ptr;
+        }
+    }
+
+    void* grown = glyph_arena_alloc(arena, size);
+    if (grown) memcpy(grown, ptr, old_size < size ? old_size : size);
+    return grown;
+}
+
+/*
+ * Rewinds an arena, invalidating every allocation but keeping the blocks
+ *
+ * Parameters:
+ *   arena: Arena to rewind
+ */
+static inline void glyph_arena_reset(glyph_arena_t* arena) {
+    arena->current = arena->first;
+    if (arena->first) arena->first->used = 0;
+    arena->last = NULL;
+}
+
+/*
+ * Returns every block of an arena to its backing allocator
+ *
+ * Parameters:
+ *   arena: Arena to release (left empty and reusable)
+ */
+static inline void glyph_arena_release(glyph_arena_t* arena) {
+    glyph_arena__block_t* block = arena->first;
+    while (block) {
+        glyph_arena__block_t* next = block->next;
+        glyph__free(arena->backing, block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->last = NULL;
+}
+
+static inline void* glyph_arena__alloc_callback(void* user, size_t size) {
+    return glyph_arena_alloc((glyph_arena_t*)user, size);
+}
+
+static inline void* glyph_arena__realloc_callback(void* user, void* ptr, size_t size) {
+    return glyph_arena_realloc((glyph_arena_t*)user, ptr, size);
+}
+
+static inline void glyph_arena__free_callback(void* user, void* ptr) {
+    (void)user;
+    (void)ptr; /* Released with the arena */
+}
+
+/*
+ * Wraps an arena in the allocator interface
+ *
+ * Frees through the returned allocator are no-ops; the memory comes back
+ * when the arena is reset or released.
+ *
+ * Parameters:
+ *   arena: Arena to allocate from (must outlive the allocator's use)
+ *
+ * Returns: Allocator whose callbacks allocate from the arena
+ */
+static inline glyph_allocator_t glyph_arena_allocator(glyph_arena_t* arena) {
+    glyph_allocator_t allocator;
+    allocator.alloc = glyph_arena__alloc_callback;
+    allocator.realloc = glyph_arena__realloc_callback;
+    allocator.free = glyph_arena__free_callback;
+    allocator.user = arena;
+    return allocator;
+}
+
 /*
  * Debug logging macro - conditionally compiled based on GLYPHGL_DEBUG
  *
@@ -69,4 +294,45 @@ static inline uint32_t glyph__bswap32(uint32_t val) {
 #define GLYPH_LOG(...)
 #endif
 
+/*
+ * Statistics macro - conditionally compiled based on GLYPHGL_STATS
+ *
+ * When GLYPHGL_STATS is defined, the wrapped statement is compiled in as is.
+ * When not defined, it compiles to nothing, so counters cost nothing in
+ * regular builds.
+ *
+ * Usage: GLYPH_STAT(renderer->stats.draw_calls++);
+ */
+#ifdef GLYPHGL_STATS
+#define GLYPH_STAT(...) __VA_ARGS__
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+/* Wall clock in milliseconds, used by the bake phase timers (monotonic where the headers expose it) */
+static inline double glyph__stats_now_ms(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+#else
+    /* Strict ISO modes hide clock_gettime */
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_usec / 1000.0;
+#endif
+}
+#else
+#define GLYPH_STAT(...)
+#endif
+
 #endif
\ No newline at end of file